@@ -0,0 +1,77 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+/**
+ \file   chainiksolverpos_broyden_benchmark.cpp
+ \brief  Time-to-solution of ChainIkSolverPos_Masked with and without
+         Broyden updates of the Jacobian
+
+ Random reachable poses are solved from a nearby initial configuration,
+ first with the exact Jacobian in every iteration, then with a number of
+ rank-one updates between two exact Jacobians.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <models.hpp>
+#include <chainiksolverpos_masked.hpp>
+#include <chainfksolverpos_recursive.hpp>
+
+void benchmark(const std::string& name, const KDL::Chain& chain, unsigned int max_updates) {
+    const int num_of_trials = 10000;
+    unsigned int n = chain.getNrOfJoints();
+    KDL::ChainFkSolverPos_recursive fwdkin(chain);
+    KDL::ChainIkSolverPos_Masked solver(chain, KDL::TaskMask(), 100, 1e-8);
+    solver.setBroydenUpdates(max_updates);
+    KDL::JntArray q(n), q_init(n), q_sol(n);
+    KDL::Frame pos_goal;
+
+    //the same sequence of problems for every solver setting
+    srand(0);
+    int nrofresult_ok = 0;
+    unsigned long total_number_of_iter = 0;
+    unsigned long total_number_of_jac = 0;
+    double elapsed = 0.0;
+    for (int trial = 0; trial < num_of_trials; ++trial) {
+        q.data.setRandom();
+        q.data *= KDL::PI;
+        q_init.data.setRandom();
+        q_init.data = q.data + 0.2*q_init.data;
+        fwdkin.JntToCart(q, pos_goal);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int retval = solver.CartToJnt(q_init, pos_goal, q_sol);
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (retval >= 0)
+            nrofresult_ok++;
+        total_number_of_iter += solver.getNrOfIterations();
+        total_number_of_jac += solver.getNrOfJacobians();
+    }
+    std::cout << name << ", " << max_updates << " Broyden updates:"
+              << " successful " << nrofresult_ok << "/" << num_of_trials
+              << ", average iter " << (double)total_number_of_iter/num_of_trials
+              << ", average jacobians " << (double)total_number_of_jac/num_of_trials
+              << ", average time (us) " << elapsed/num_of_trials*1e6 << std::endl;
+}
+
+int main() {
+    std::cout << " This example compares the time to solve the inverse position kinematics\n"
+              << " with an exact Jacobian in every iteration against a few Broyden updates\n"
+              << " between two exact Jacobians.\n";
+    const unsigned int updates[] = {0, 2, 5, 10};
+    for (unsigned int i = 0; i < sizeof(updates)/sizeof(updates[0]); i++)
+        benchmark("Puma560", KDL::Puma560(), updates[i]);
+    for (unsigned int i = 0; i < sizeof(updates)/sizeof(updates[0]); i++)
+        benchmark("KukaLWR_DHnew", KDL::KukaLWR_DHnew(), updates[i]);
+    return 0;
+}
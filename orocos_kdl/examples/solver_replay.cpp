@@ -0,0 +1,272 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+/**
+ \file   solver_replay.cpp
+ \brief  Reruns a recorded solver log against the current build
+
+ Every stream of the log is replayed with a new solver of the recorded
+ class, constructed with the settings stored in the stream (see
+ ChainIkSolverPos_recorded), the defaults of the solver for settings
+ that were not recorded. Per stream the distribution of the recorded
+ and replayed call durations is reported, together with the calls
+ whose return value or outputs differ.
+
+ Usage:
+   solver_replay <log> [tolerance]
+   solver_replay --demo <log>   records a small workload on the KUKA LWR
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <solverrecorder.hpp>
+#include <chainfksolverpos_recursive.hpp>
+#include <chainiksolvervel_pinv.hpp>
+#include <chainiksolvervel_wdls.hpp>
+#include <chainiksolverpos_nr.hpp>
+#include <chainiksolverpos_nr_jl.hpp>
+#include <chainiksolverpos_lma.hpp>
+#include <chainidsolver_recursive_newton_euler.hpp>
+#include <treefksolverpos_recursive.hpp>
+#include <treeidsolver_recursive_newton_euler.hpp>
+#include <models.hpp>
+
+using namespace KDL;
+
+// The solvers that replay one stream, with the solvers they use
+struct Replayer {
+    std::unique_ptr<ChainFkSolverPos> fk;
+    std::unique_ptr<ChainIkSolverVel> ikvel;
+    std::unique_ptr<ChainIkSolverPos> ikpos;
+    std::unique_ptr<ChainIdSolver> id;
+    std::unique_ptr<TreeFkSolverPos> treefk;
+    std::unique_ptr<TreeIdSolver> treeid;
+};
+
+// a recorded setting that is a single number, or the given default
+double parameter(const SolverLogStream& stream, const std::string& name, double value) {
+    SolverParameters::const_iterator it = stream.parameters.find(name);
+    if (it != stream.parameters.end() && it->second.rows() == 1)
+        return it->second(0);
+    return value;
+}
+
+// a recorded setting that is a rows x cols matrix, stored row by row
+bool parameter(const SolverLogStream& stream, const std::string& name, unsigned int rows, unsigned int cols,
+               Eigen::MatrixXd& value) {
+    SolverParameters::const_iterator it = stream.parameters.find(name);
+    if (it == stream.parameters.end() || it->second.rows() != rows*cols)
+        return false;
+    value.resize(rows, cols);
+    for (unsigned int i = 0; i < rows; i++)
+        for (unsigned int j = 0; j < cols; j++)
+            value(i, j) = it->second(i*cols + j);
+    return true;
+}
+
+bool create(const SolverLogStream& stream, Replayer& r) {
+    const std::string& name = stream.solver;
+    unsigned int nj = stream.chain.getNrOfJoints();
+    Eigen::MatrixXd m;
+    switch (stream.type) {
+    case SolverLogStream::CHAIN_FK_POS:
+        if (name == "ChainFkSolverPos_recursive")
+            r.fk.reset(new ChainFkSolverPos_recursive(stream.chain));
+        return r.fk != 0;
+    case SolverLogStream::CHAIN_IK_VEL:
+        if (name == "ChainIkSolverVel_pinv")
+            r.ikvel.reset(new ChainIkSolverVel_pinv(stream.chain, parameter(stream, "eps", 0.00001),
+                                                    (int)parameter(stream, "maxiter", 150)));
+        else if (name == "ChainIkSolverVel_wdls") {
+            ChainIkSolverVel_wdls* wdls = new ChainIkSolverVel_wdls(stream.chain, parameter(stream, "eps", 0.00001),
+                                                                    (int)parameter(stream, "maxiter", 150));
+            r.ikvel.reset(wdls);
+            wdls->setLambda(parameter(stream, "lambda", 0.0));
+            if (parameter(stream, "weight_js", nj, nj, m))
+                wdls->setWeightJS(m);
+            if (parameter(stream, "weight_ts", 6, 6, m))
+                wdls->setWeightTS(m);
+        }
+        return r.ikvel != 0;
+    case SolverLogStream::CHAIN_IK_POS:
+        if (name == "ChainIkSolverPos_LMA") {
+            double eps = parameter(stream, "eps", 1E-5);
+            int maxiter = (int)parameter(stream, "maxiter", 500);
+            double eps_joints = parameter(stream, "eps_joints", 1E-15);
+            if (parameter(stream, "weights", 6, 1, m))
+                r.ikpos.reset(new ChainIkSolverPos_LMA(stream.chain, m, eps, maxiter, eps_joints));
+            else
+                r.ikpos.reset(new ChainIkSolverPos_LMA(stream.chain, eps, maxiter, eps_joints));
+        }
+        else if (name == "ChainIkSolverPos_NR" || name == "ChainIkSolverPos_NR_JL") {
+            unsigned int maxiter = (unsigned int)parameter(stream, "maxiter", 100);
+            double eps = parameter(stream, "eps", 1e-6);
+            r.fk.reset(new ChainFkSolverPos_recursive(stream.chain));
+            r.ikvel.reset(new ChainIkSolverVel_pinv(stream.chain, parameter(stream, "vel_eps", 0.00001),
+                                                    (int)parameter(stream, "vel_maxiter", 150)));
+            SolverParameters::const_iterator q_min = stream.parameters.find("q_min");
+            SolverParameters::const_iterator q_max = stream.parameters.find("q_max");
+            if (name == "ChainIkSolverPos_NR")
+                r.ikpos.reset(new ChainIkSolverPos_NR(stream.chain, *r.fk, *r.ikvel, maxiter, eps));
+            else if (q_min != stream.parameters.end() && q_max != stream.parameters.end())
+                r.ikpos.reset(new ChainIkSolverPos_NR_JL(stream.chain, q_min->second, q_max->second,
+                                                         *r.fk, *r.ikvel, maxiter, eps));
+            else
+                r.ikpos.reset(new ChainIkSolverPos_NR_JL(stream.chain, *r.fk, *r.ikvel, maxiter, eps));
+        }
+        return r.ikpos != 0;
+    case SolverLogStream::CHAIN_ID:
+        if (name == "ChainIdSolver_RNE")
+            r.id.reset(new ChainIdSolver_RNE(stream.chain, stream.gravity));
+        return r.id != 0;
+    case SolverLogStream::TREE_FK_POS:
+        if (name == "TreeFkSolverPos_recursive")
+            r.treefk.reset(new TreeFkSolverPos_recursive(stream.tree));
+        return r.treefk != 0;
+    case SolverLogStream::TREE_ID:
+        if (name == "TreeIdSolver_RNE")
+            r.treeid.reset(new TreeIdSolver_RNE(stream.tree, stream.gravity));
+        return r.treeid != 0;
+    }
+    return false;
+}
+
+void replay(const SolverLogStream& stream, Replayer& r, const SolverCall& call, SolverCall& result) {
+    switch (stream.type) {
+    case SolverLogStream::CHAIN_FK_POS: Replay(call, *r.fk, result); break;
+    case SolverLogStream::CHAIN_IK_VEL: Replay(call, *r.ikvel, result); break;
+    case SolverLogStream::CHAIN_IK_POS: Replay(call, *r.ikpos, result); break;
+    case SolverLogStream::CHAIN_ID: Replay(call, *r.id, result); break;
+    case SolverLogStream::TREE_FK_POS: Replay(call, *r.treefk, result); break;
+    case SolverLogStream::TREE_ID: Replay(call, *r.treeid, result); break;
+    }
+}
+
+// durations in microseconds at the given fraction of the sorted samples
+double percentile(const std::vector<double>& sorted, double fraction) {
+    return sorted[(size_t)(fraction*(sorted.size() - 1))]*1e6;
+}
+
+void report(const std::string& name, std::vector<double> durations) {
+    std::sort(durations.begin(), durations.end());
+    std::cout << "  " << std::setw(9) << name << " [us] p50 " << percentile(durations, 0.5)
+              << "  p90 " << percentile(durations, 0.9) << "  p99 " << percentile(durations, 0.99)
+              << "  max " << percentile(durations, 1.0) << std::endl;
+}
+
+void demo(const char* file) {
+    std::ofstream os(file, std::ios::binary);
+    SolverLogWriter log(os);
+    Chain chain = KukaLWR_DHnew();
+    unsigned int nj = chain.getNrOfJoints();
+    ChainFkSolverPos_recursive fk(chain);
+    ChainIkSolverVel_pinv ikvel(chain);
+    ChainIkSolverPos_NR ikpos(chain, fk, ikvel, 200, 1e-9);
+    ChainIdSolver_RNE id(chain, Vector(0.0, 0.0, -9.81));
+    ChainFkSolverPos_recorded rfk(fk, chain, log, "ChainFkSolverPos_recursive");
+    SolverParameters parameters;
+    parameters["maxiter"] = JntArray(1);
+    parameters["maxiter"](0) = 200;
+    parameters["eps"] = JntArray(1);
+    parameters["eps"](0) = 1e-9;
+    ChainIkSolverPos_recorded rikpos(ikpos, chain, log, "ChainIkSolverPos_NR", parameters);
+    ChainIdSolver_recorded rid(id, chain, Vector(0.0, 0.0, -9.81), log, "ChainIdSolver_RNE");
+    JntArray q(nj), qd(nj), qdd(nj), q_out(nj), torques(nj);
+    Wrenches f_ext(chain.getNrOfSegments(), Wrench::Zero());
+    Frame f;
+    for (unsigned int k = 0; k < 1000; k++) {
+        for (unsigned int i = 0; i < nj; i++) {
+            q(i) = 0.5*sin(0.01*k + i);
+            qd(i) = 0.005*cos(0.01*k + i);
+            qdd(i) = -0.00005*sin(0.01*k + i);
+        }
+        rfk.JntToCart(q, f);
+        // seed with the previous solution, as a control loop would
+        rikpos.CartToJnt(q_out, f, q_out);
+        rid.CartToJnt(q, qd, qdd, f_ext, torques);
+    }
+    std::cout << "recorded " << log.getNrOfCalls() << " calls in " << file << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--demo") {
+        demo(argv[2]);
+        return 0;
+    }
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <log> [tolerance]" << std::endl
+                  << "       " << argv[0] << " --demo <log>" << std::endl;
+        return 1;
+    }
+    double tolerance = argc == 3 ? atof(argv[2]) : 1e-9;
+    std::ifstream is(argv[1], std::ios::binary);
+    if (!is) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    SolverLog log(is);
+    const std::vector<SolverLogStream>& streams = log.getStreams();
+    const std::vector<SolverCall>& calls = log.getCalls();
+    std::cout << calls.size() << " calls of " << streams.size() << " solvers";
+    if (log.isTruncated())
+        std::cout << " (log is truncated)";
+    std::cout << std::endl;
+
+    std::vector<Replayer> replayers(streams.size());
+    std::vector<std::vector<double> > recorded(streams.size()), replayed(streams.size());
+    std::vector<unsigned int> result_differs(streams.size(), 0), output_differs(streams.size(), 0);
+    std::vector<double> divergence(streams.size(), 0.0);
+    std::vector<bool> supported(streams.size());
+    for (unsigned int s = 0; s < streams.size(); s++)
+        supported[s] = create(streams[s], replayers[s]);
+
+    SolverCall result;
+    for (unsigned int c = 0; c < calls.size(); c++) {
+        unsigned int s = calls[c].stream;
+        if (!supported[s])
+            continue;
+        replay(streams[s], replayers[s], calls[c], result);
+        recorded[s].push_back(calls[c].duration);
+        replayed[s].push_back(result.duration);
+        if (result.result != calls[c].result)
+            result_differs[s]++;
+        double d = Divergence(streams[s].type, calls[c], result);
+        if (d > tolerance)
+            output_differs[s]++;
+        divergence[s] = std::max(divergence[s], d);
+    }
+
+    bool diverged = false;
+    for (unsigned int s = 0; s < streams.size(); s++) {
+        std::cout << "stream " << s << ": " << streams[s].solver;
+        if (!supported[s]) {
+            std::cout << " is not supported, skipped" << std::endl;
+            continue;
+        }
+        std::cout << ", " << recorded[s].size() << " calls" << std::endl;
+        if (recorded[s].empty())
+            continue;
+        report("recorded", recorded[s]);
+        report("replayed", replayed[s]);
+        std::cout << "  different return value: " << result_differs[s]
+                  << ", outputs differing more than " << tolerance << ": " << output_differs[s]
+                  << " (max " << divergence[s] << ")" << std::endl;
+        diverged = diverged || result_differs[s] != 0 || output_differs[s] != 0;
+    }
+    return diverged ? 2 : 0;
+}
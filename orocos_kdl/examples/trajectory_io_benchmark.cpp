@@ -0,0 +1,97 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+/**
+ \file   trajectory_io_benchmark.cpp
+ \brief  Throughput of the text and binary I/O of trajectories
+
+ A library of trajectory segments along rounded composite paths is
+ written to memory and read back, once with Write()/Read() and once with
+ WriteBinary()/ReadBinary(), and the throughput and size of both are
+ reported.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <trajectory_segment.hpp>
+#include <path_roundedcomposite.hpp>
+#include <rotational_interpolation_sa.hpp>
+#include <velocityprofile_trap.hpp>
+
+using namespace KDL;
+
+Trajectory* segment(unsigned int i) {
+    Path_RoundedComposite* path = new Path_RoundedComposite(0.02, 0.05, new RotationalInterpolation_SingleAxis());
+    for (unsigned int k = 0; k < 10; k++)
+        path->Add(Frame(Rotation::RPY(0.1*k, 0.01*i, 0.0), Vector(0.1*k, 0.1*(k%2), 0.001*i)));
+    path->Finish();
+    VelocityProfile* prof = new VelocityProfile_Trap(0.5, 0.2);
+    prof->SetProfile(0, path->PathLength());
+    return new Trajectory_Segment(path, prof);
+}
+
+template <typename F>
+double measure(F f) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string& name, double size, double write, double read) {
+    std::cout << name << ": " << size/1e6 << " MB, write " << size/write/1e6 << " MB/s ("
+              << write*1e3 << " ms), read " << size/read/1e6 << " MB/s (" << read*1e3 << " ms)" << std::endl;
+}
+
+int main() {
+    const unsigned int n = 1000;
+    std::vector<Trajectory*> library(n);
+    for (unsigned int i = 0; i < n; i++)
+        library[i] = segment(i);
+    std::vector<Trajectory*> read(n);
+
+    std::stringstream text;
+    double write = measure([&]() {
+        for (unsigned int i = 0; i < n; i++)
+            library[i]->Write(text);
+    });
+    double size = text.str().size();
+    double reading = measure([&]() {
+        for (unsigned int i = 0; i < n; i++)
+            read[i] = Trajectory::Read(text);
+    });
+    report("text", size, write, reading);
+    for (unsigned int i = 0; i < n; i++)
+        delete read[i];
+
+    std::stringstream binary;
+    write = measure([&]() {
+        WriteBinaryHeader(binary);
+        for (unsigned int i = 0; i < n; i++)
+            library[i]->WriteBinary(binary);
+    });
+    size = binary.str().size();
+    reading = measure([&]() {
+        ReadBinaryHeader(binary);
+        for (unsigned int i = 0; i < n; i++)
+            read[i] = Trajectory::ReadBinary(binary);
+    });
+    report("binary", size, write, reading);
+    for (unsigned int i = 0; i < n; i++) {
+        delete read[i];
+        delete library[i];
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+/**
+ \file   treedynsolver_floatingbase_benchmark.cpp
+ \brief  Timing of the floating-base dynamics of a humanoid tree
+
+ A 33 DOF humanoid (legs, torso, neck, arms and grippers) is built, and
+ the time of the inverse dynamics, the bias forces and the mass matrix
+ of TreeDynSolver_FloatingBase is measured, next to the fixed-base
+ TreeIdSolver_RNE.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <tree.hpp>
+#include <treedynsolver_floatingbase.hpp>
+#include <treeidsolver_recursive_newton_euler.hpp>
+
+using namespace KDL;
+
+RigidBodyInertia link(double mass, const Vector& com) {
+    return RigidBodyInertia(mass, com, RotationalInertia(0.01*mass, 0.01*mass, 0.005*mass));
+}
+
+/**
+ * Adds a serial limb, one segment per joint axis, and returns the name
+ * of its last segment.
+ */
+std::string addLimb(Tree& tree, const std::string& parent, const std::string& name,
+                    const Joint::JointType* axes, const Vector* offsets, const double* masses, unsigned int n) {
+    std::string previous = parent;
+    for (unsigned int i = 0; i < n; i++) {
+        std::ostringstream segment;
+        segment << name << "_" << i;
+        tree.addSegment(Segment(segment.str(), Joint(segment.str() + "_joint", axes[i]), Frame(offsets[i]),
+                                link(masses[i], offsets[i]/2)), previous);
+        previous = segment.str();
+    }
+    return previous;
+}
+
+Tree humanoid() {
+    Tree tree("base");
+    tree.addSegment(Segment("pelvis", Joint("pelvis_fixed", Joint::Fixed), Frame::Identity(),
+                            link(8.0, Vector::Zero())), "base");
+
+    const Joint::JointType leg_axes[] = {Joint::RotZ, Joint::RotX, Joint::RotY, Joint::RotY, Joint::RotY, Joint::RotX};
+    const Vector leg_offsets[] = {Vector(0,0,-0.05), Vector(0,0,-0.05), Vector(0,0,-0.4), Vector(0,0,-0.4), Vector(0,0,-0.02), Vector(0.1,0,-0.05)};
+    const double leg_masses[] = {1.0, 1.0, 5.0, 3.0, 0.5, 1.0};
+    tree.addSegment(Segment("left_hip", Joint("left_hip_fixed", Joint::Fixed), Frame(Vector(0,0.1,-0.1))), "pelvis");
+    tree.addSegment(Segment("right_hip", Joint("right_hip_fixed", Joint::Fixed), Frame(Vector(0,-0.1,-0.1))), "pelvis");
+    addLimb(tree, "left_hip", "left_leg", leg_axes, leg_offsets, leg_masses, 6);
+    addLimb(tree, "right_hip", "right_leg", leg_axes, leg_offsets, leg_masses, 6);
+
+    const Joint::JointType torso_axes[] = {Joint::RotZ, Joint::RotY, Joint::RotX};
+    const Vector torso_offsets[] = {Vector(0,0,0.1), Vector(0,0,0.1), Vector(0,0,0.3)};
+    const double torso_masses[] = {2.0, 2.0, 15.0};
+    std::string chest = addLimb(tree, "pelvis", "torso", torso_axes, torso_offsets, torso_masses, 3);
+
+    const Joint::JointType neck_axes[] = {Joint::RotZ, Joint::RotY};
+    const Vector neck_offsets[] = {Vector(0,0,0.05), Vector(0,0,0.15)};
+    const double neck_masses[] = {0.5, 3.0};
+    addLimb(tree, chest, "neck", neck_axes, neck_offsets, neck_masses, 2);
+
+    const Joint::JointType arm_axes[] = {Joint::RotY, Joint::RotX, Joint::RotZ, Joint::RotY, Joint::RotZ, Joint::RotY, Joint::RotX, Joint::TransY};
+    const Vector arm_offsets[] = {Vector(0,0,0), Vector(0,0,0), Vector(0,0,-0.3), Vector(0,0,-0.25), Vector(0,0,0), Vector(0,0,0), Vector(0,0,-0.1), Vector(0,0,-0.05)};
+    const double arm_masses[] = {0.5, 0.5, 2.0, 1.5, 0.3, 0.3, 0.5, 0.2};
+    tree.addSegment(Segment("left_shoulder", Joint("left_shoulder_fixed", Joint::Fixed), Frame(Vector(0,0.2,0))), chest);
+    tree.addSegment(Segment("right_shoulder", Joint("right_shoulder_fixed", Joint::Fixed), Frame(Vector(0,-0.2,0))), chest);
+    addLimb(tree, "left_shoulder", "left_arm", arm_axes, arm_offsets, arm_masses, 8);
+    addLimb(tree, "right_shoulder", "right_arm", arm_axes, arm_offsets, arm_masses, 8);
+    return tree;
+}
+
+template <typename F>
+void measure(const std::string& name, unsigned int n, F f) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n; i++)
+        f();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed/n*1e6 << " us" << std::endl;
+}
+
+int main() {
+    Tree tree = humanoid();
+    unsigned int nj = tree.getNrOfJoints();
+    std::cout << "humanoid with " << nj << " joints and " << tree.getNrOfSegments() << " segments" << std::endl;
+
+    Vector grav(0.0, 0.0, -9.81);
+    TreeDynSolver_FloatingBase solver(tree, grav);
+    TreeIdSolver_RNE fixedsolver(tree, grav);
+    JntArray q(nj), q_dot(nj), q_dotdot(nj), torques(nj);
+    q.data.setRandom();
+    q_dot.data.setRandom();
+    q_dotdot.data.setRandom();
+    Rotation R_base = Rotation::RPY(0.1, -0.2, 0.3);
+    Twist v_base(Vector(0.3, 0.0, 0.1), Vector(0.0, 0.2, 0.1));
+    Twist a_base(Vector(0.5, 0.1, -0.2), Vector(0.1, 0.0, 0.3));
+    WrenchMap f_ext;
+    Wrench f_base;
+    JntSpaceInertiaMatrix H(6+nj);
+
+    const unsigned int n = 100000;
+    measure("fixed-base inverse dynamics (TreeIdSolver_RNE)", n,
+            [&]() {fixedsolver.CartToJnt(q, q_dot, q_dotdot, f_ext, torques);});
+    measure("floating-base inverse dynamics", n,
+            [&]() {solver.CartToJnt(R_base, v_base, a_base, q, q_dot, q_dotdot, f_ext, f_base, torques);});
+    measure("floating-base bias forces", n,
+            [&]() {solver.JntToBias(R_base, v_base, q, q_dot, f_base, torques);});
+    measure("floating-base mass matrix", n,
+            [&]() {solver.JntToMass(q, H);});
+    return 0;
+}
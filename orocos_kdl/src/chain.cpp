@@ -20,12 +20,16 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "chain.hpp"
+#include "jntarray.hpp"
+#include <map>
 
 namespace KDL {
 
     Chain::Chain():
             nrOfJoints(0),
             nrOfSegments(0),
+            nrOfCoupledJoints(0),
+            nrOfMultiDofJoints(0),
             segments(0)
     {
     }
@@ -33,19 +37,24 @@ namespace KDL {
     Chain::Chain(const Chain& in):
             nrOfJoints(0),
             nrOfSegments(0),
+            nrOfCoupledJoints(0),
+            nrOfMultiDofJoints(0),
             segments(0)
     {
-        for(unsigned int i=0;i<in.getNrOfSegments();i++)
-            this->addSegment(in.getSegment(i));
+        this->addChain(in);
     }
 
     Chain& Chain::operator=(const Chain& arg)
     {
+        if(this==&arg)
+            return *this;
         nrOfJoints=0;
         nrOfSegments=0;
+        nrOfCoupledJoints=0;
+        nrOfMultiDofJoints=0;
         segments.resize(0);
-        for(unsigned int i=0;i<arg.nrOfSegments;i++)
-            addSegment(arg.getSegment(i));
+        q_nrs.resize(0);
+        this->addChain(arg);
         return *this;
 
     }
@@ -54,14 +63,40 @@ namespace KDL {
     {
         segments.push_back(segment);
         nrOfSegments++;
-        if(segment.getJoint().getType()!=Joint::Fixed)
-            nrOfJoints++;
+        unsigned int dofs=segment.getJoint().getNrOfDofs();
+        if(dofs!=0)
+            q_nrs.push_back(nrOfJoints);
+        else
+            q_nrs.push_back(0);
+        nrOfJoints+=dofs;
+        if(dofs>1)
+            nrOfMultiDofJoints++;
+    }
+
+    bool Chain::addCoupledSegment(const Segment& segment, unsigned int q_nr)
+    {
+        if(segment.getJoint().getNrOfDofs()!=1 || q_nr>=nrOfJoints)
+            return false;
+        segments.push_back(segment);
+        nrOfSegments++;
+        nrOfCoupledJoints++;
+        q_nrs.push_back(q_nr);
+        return true;
     }
 
     void Chain::addChain(const Chain& chain)
     {
-        for(unsigned int i=0;i<chain.getNrOfSegments();i++)
-            this->addSegment(chain.getSegment(i));
+        //Joint coordinates of the added chain are appended after the
+        //existing ones, a segment that refers to an already added
+        //coordinate of that chain is coupled to it
+        unsigned int offset=nrOfJoints;
+        for(unsigned int i=0;i<chain.getNrOfSegments();i++){
+            const Segment& segment=chain.getSegment(i);
+            if(segment.getJoint().getNrOfDofs()==1 && chain.getQNr(i)<nrOfJoints-offset)
+                this->addCoupledSegment(segment,offset+chain.getQNr(i));
+            else
+                this->addSegment(segment);
+        }
     }
 
     const Segment& Chain::getSegment(unsigned int nr)const
@@ -74,6 +109,45 @@ namespace KDL {
         return segments[nr];
     }
 
+    bool Chain::getReducedChain(const std::vector<bool>& locked_joints, const JntArray& q_locked,
+                                Chain& reduced, std::vector<unsigned int>& full_q_nrs)const
+    {
+        if(locked_joints.size()!=nrOfJoints || q_locked.rows()!=nrOfJoints)
+            return false;
+        Chain result;
+        std::vector<unsigned int> result_q_nrs;
+        //coordinates of this chain that are already used in the reduced
+        //chain, further segments driven by them are coupled segments
+        std::map<unsigned int,unsigned int> q_nr_map;
+        for(unsigned int i=0;i<nrOfSegments;i++){
+            const Segment& segment=segments[i];
+            unsigned int dofs=segment.getJoint().getNrOfDofs();
+            unsigned int nr_locked=0;
+            for(unsigned int d=0;d<dofs;d++)
+                if(locked_joints[q_nrs[i]+d])
+                    nr_locked++;
+            if(dofs==0)
+                result.addSegment(segment);
+            else if(nr_locked==dofs)
+                result.addSegment(Segment(segment.getName(),Joint(segment.getJoint().getName(),Joint::Fixed),
+                                          segment.pose(q_locked,q_nrs[i]),segment.getInertia()));
+            else if(nr_locked!=0)
+                return false;
+            else if(dofs==1 && q_nr_map.find(q_nrs[i])!=q_nr_map.end())
+                result.addCoupledSegment(segment,q_nr_map[q_nrs[i]]);
+            else{
+                for(unsigned int d=0;d<dofs;d++){
+                    q_nr_map[q_nrs[i]+d]=result.getNrOfJoints()+d;
+                    result_q_nrs.push_back(q_nrs[i]+d);
+                }
+                result.addSegment(segment);
+            }
+        }
+        reduced=result;
+        full_q_nrs=result_q_nrs;
+        return true;
+    }
+
     Chain::~Chain()
     {
     }
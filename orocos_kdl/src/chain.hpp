@@ -30,12 +30,21 @@ namespace KDL {
 	  * \brief This class encapsulates a <strong>serial</strong> kinematic
 	  * interconnection structure. It is built out of segments.
      *
+     * Several segments can be driven by the same joint coordinate
+     * (see addCoupledSegment), in which case the solvers work in the
+     * reduced set of independent coordinates. Segments with a
+     * multi-DOF joint (see Joint::getNrOfDofs) occupy several
+     * consecutive joint coordinates, starting at getQNr().
+     *
      * @ingroup KinematicFamily
      */
     class Chain {
     private:
         unsigned int nrOfJoints;
         unsigned int nrOfSegments;
+        unsigned int nrOfCoupledJoints;
+        unsigned int nrOfMultiDofJoints;
+        std::vector<unsigned int> q_nrs;
     public:
         std::vector<Segment> segments;
         /**
@@ -52,6 +61,21 @@ namespace KDL {
          * @param segment The segment to add
          */
         void addSegment(const Segment& segment);
+        /**
+         * Adds a new segment to the <strong>end</strong> of the chain,
+         * whose joint is driven by the already existing joint
+         * coordinate q_nr instead of by a new one (mimic or coupled
+         * joint). The scale and offset of the segment's joint define
+         * the linear map from the shared coordinate to the joint motion.
+         * A coupled segment does not increase the number of joints.
+         *
+         * @param segment The segment to add
+         * @param q_nr index of the joint coordinate driving the segment
+         *
+         * @return false if the segment does not have a single axis
+         * joint or q_nr is not an existing joint coordinate of the chain.
+         */
+        bool addCoupledSegment(const Segment& segment, unsigned int q_nr);
         /**
          * Adds a complete chain to the <strong>end</strong> of the chain
          * The added chain is copied.
@@ -74,6 +98,28 @@ namespace KDL {
          * @return total number of segments
          */
         unsigned int getNrOfSegments()const {return nrOfSegments;};
+        /**
+         * Request the number of segments whose joint is coupled to the
+         * coordinate of another segment (see addCoupledSegment).
+         * @return total number of coupled joints
+         */
+        unsigned int getNrOfCoupledJoints()const {return nrOfCoupledJoints;};
+        /**
+         * Request the number of segments with a joint of more than one
+         * degree of freedom (Spherical, Planar or Floating).
+         * @return total number of multi-DOF joints
+         */
+        unsigned int getNrOfMultiDofJoints()const {return nrOfMultiDofJoints;};
+        /**
+         * Request the index of the (first) joint coordinate that drives
+         * the nr'd segment. There is no boundary checking, and the result
+         * has no meaning for segments with a fixed joint.
+         *
+         * @param nr the nr of the segment starting from 0
+         *
+         * @return index in the joint arrays of the chain
+         */
+        unsigned int getQNr(unsigned int nr)const {return q_nrs[nr];};
 
         /**
          * Request the nr'd segment of the chain. There is no boundary
@@ -95,6 +141,29 @@ namespace KDL {
          */
         Segment& getSegment(unsigned int nr);
 
+        /**
+         * Request a reduced copy of the chain in which the locked joint
+         * coordinates are frozen: every segment driven by a locked
+         * coordinate gets a fixed joint whose transform is its pose
+         * at the locked position. All solvers can then be used on the
+         * smaller chain.
+         *
+         * @param locked_joints true for every locked joint coordinate,
+         * size getNrOfJoints()
+         * @param q_locked joint positions of the locked coordinates,
+         * size getNrOfJoints(), the other entries are not used
+         * @param reduced the resulting chain
+         * @param full_q_nrs for every joint coordinate of the reduced chain,
+         * the index of the corresponding coordinate of this chain. Use
+         * it to expand results of the reduced chain back to the full
+         * configuration.
+         *
+         * @return false if the sizes do not match or only part of the
+         * coordinates of a multi-DOF joint is locked
+         */
+        bool getReducedChain(const std::vector<bool>& locked_joints, const JntArray& q_locked,
+                             Chain& reduced, std::vector<unsigned int>& full_q_nrs)const;
+
         virtual ~Chain();
     };
 
@@ -0,0 +1,317 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chaincalibrationsolver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace KDL
+{
+    //smaller sets of samples are not worth starting a thread for
+    static const unsigned int min_samples_per_thread = 64;
+
+    ChainCalibrationSolver::ChainCalibrationSolver(Chain& _chain, unsigned int _nr_of_threads):
+        chain(_chain), nj(0), ns(0), np(0), nr_of_threads(std::max(_nr_of_threads, 1u)),
+        workspaces(nr_of_threads), residual(0.0)
+    {
+        workers.reserve(nr_of_threads - 1);
+        updateInternalDataStructures();
+    }
+
+    void ChainCalibrationSolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        //segments added since the last update get the default parameters
+        for (unsigned int i = parameters.size(); i < ns; i++)
+            parameters.push_back(TIP_FRAME | (chain.getSegment(i).getJoint().getNrOfDofs() == 1 ? JOINT_OFFSET : 0));
+        parameters.resize(ns);
+        updateColumns();
+    }
+
+    void ChainCalibrationSolver::updateColumns()
+    {
+        columns.resize(ns);
+        np = 0;
+        for (unsigned int i = 0; i < ns; i++) {
+            columns[i] = np;
+            if (parameters[i] & TIP_FRAME)
+                np += 6;
+            if (parameters[i] & JOINT_OFFSET)
+                np += 1;
+            if (parameters[i] & JOINT_AXIS)
+                np += 2;
+        }
+        for (unsigned int t = 0; t < workspaces.size(); t++) {
+            workspaces[t].xi.resize(np);
+            workspaces[t].jac.resize(6, np);
+            workspaces[t].JtJ.resize(np, np);
+            workspaces[t].Jte.resize(np);
+        }
+        JtJ.resize(np, np);
+        Jte.resize(np);
+        svd = Eigen::JacobiSVD<Eigen::MatrixXd>(np, np, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        svd.setThreshold(1e-10);
+    }
+
+    ChainCalibrationSolver::~ChainCalibrationSolver()
+    {
+    }
+
+    int ChainCalibrationSolver::setParameters(unsigned int seg_nr, int _parameters)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (seg_nr >= ns)
+            return (error = E_OUT_OF_RANGE);
+        if ((_parameters & (JOINT_OFFSET | JOINT_AXIS)) && chain.getSegment(seg_nr).getJoint().getNrOfDofs() != 1)
+            return (error = E_NOT_IMPLEMENTED);
+        parameters[seg_nr] = _parameters;
+        updateColumns();
+        return (error = E_NOERROR);
+    }
+
+    void ChainCalibrationSolver::perpendicular(const Vector& axis, Vector& u1, Vector& u2)
+    {
+        //cross the axis with the base vector it is least aligned with
+        Vector e(1.0, 0.0, 0.0);
+        if (std::fabs(axis.y()) < std::fabs(axis.x()) && std::fabs(axis.y()) <= std::fabs(axis.z()))
+            e = Vector(0.0, 1.0, 0.0);
+        else if (std::fabs(axis.z()) < std::fabs(axis.x()))
+            e = Vector(0.0, 0.0, 1.0);
+        u1 = axis * e;
+        u1.Normalize();
+        u2 = axis * u1;
+        u2.Normalize();
+    }
+
+    static bool isRevolute(const Joint& joint)
+    {
+        Joint::JointType type = joint.getType();
+        return type == Joint::RotAxis || type == Joint::RotX || type == Joint::RotY || type == Joint::RotZ;
+    }
+
+    static Vector jointOrigin(const Joint& joint)
+    {
+        if (joint.getType() == Joint::RotAxis || joint.getType() == Joint::TransAxis)
+            return joint.JointOrigin();
+        return Vector::Zero();
+    }
+
+    static Rotation rotationVector(const Vector& r)
+    {
+        //Rotation::Rot and Vector::Norm have a tolerance, which is too coarse for small updates
+        double angle = std::sqrt(dot(r, r));
+        if (angle == 0.0)
+            return Rotation::Identity();
+        return Rotation::Rot2(r / angle, angle);
+    }
+
+    static Vector rotationError(const Rotation& R)
+    {
+        //Rotation::GetRot has a tolerance, which would stall the
+        //convergence, the rotation vector is taken from the skew part
+        //(pose errors are assumed to be well below 180 degrees)
+        Vector v(0.5*(R(2,1) - R(1,2)), 0.5*(R(0,2) - R(2,0)), 0.5*(R(1,0) - R(0,1)));
+        double s = std::sqrt(dot(v, v));
+        double angle = std::atan2(s, 0.5*(R(0,0) + R(1,1) + R(2,2) - 1.0));
+        if (s < 1e-12)
+            return v;
+        return v * (angle / s);
+    }
+
+    int ChainCalibrationSolver::JntToParamJac(const JntArray& q, Frame& pose, Eigen::MatrixXd& _jac)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        return (error = paramJac(q, pose, _jac, workspaces[0].xi));
+    }
+
+    int ChainCalibrationSolver::paramJac(const JntArray& q, Frame& pose, Eigen::MatrixXd& _jac, std::vector<Twist>& xi) const
+    {
+        if (q.rows() != nj || _jac.rows() != 6 || _jac.cols() != (int)np)
+            return E_SIZE_MISMATCH;
+        //Sweep from root to leaf, the displacement of every parameter is
+        //transformed to the base frame
+        Frame T = Frame::Identity();
+        Vector u[2];
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            const Joint& joint = segment.getJoint();
+            //pose of the joint and of the whole segment
+            Frame X = segment.pose(q, chain.getQNr(i));
+            Frame X_joint = X * segment.getFrameToTipZero().Inverse();
+            Frame T_joint = T * X_joint;
+            T = T * X;
+            unsigned int c = columns[i];
+            if (parameters[i] & TIP_FRAME) {
+                for (unsigned int k = 0; k < 3; k++) {
+                    Vector e = Vector::Zero();
+                    e(k) = 1.0;
+                    xi[c + k] = T * Twist(e, Vector::Zero());
+                    xi[c + 3 + k] = T * Twist(Vector::Zero(), e);
+                }
+                c += 6;
+            }
+            Vector axis = joint.JointAxis();
+            if (parameters[i] & JOINT_OFFSET) {
+                xi[c] = T_joint * (isRevolute(joint) ? Twist(Vector::Zero(), axis) : Twist(axis, Vector::Zero()));
+                c += 1;
+            }
+            if (parameters[i] & JOINT_AXIS) {
+                //rotating the axis by u rotates the joint motion X_joint to R(u)*X_joint*R(u)^T
+                perpendicular(axis, u[0], u[1]);
+                for (unsigned int k = 0; k < 2; k++) {
+                    if (isRevolute(joint))
+                        xi[c + k] = T_joint * Twist(Vector::Zero(), X_joint.M.Inverse(u[k]) - u[k]);
+                    else
+                        xi[c + k] = T_joint * Twist(u[k] * (X_joint.p - jointOrigin(joint)), Vector::Zero());
+                }
+            }
+        }
+        pose = T;
+        for (unsigned int p = 0; p < np; p++) {
+            Twist t = xi[p].RefPoint(T.p);
+            for (unsigned int r = 0; r < 6; r++)
+                _jac(r, p) = t(r);
+        }
+        return E_NOERROR;
+    }
+
+    void ChainCalibrationSolver::accumulate(const std::vector<JntArray>& q, const std::vector<Frame>& measured,
+                                            unsigned int begin, unsigned int end, Workspace& w) const
+    {
+        w.JtJ.setZero();
+        w.Jte.setZero();
+        w.sum = 0.0;
+        Frame pose;
+        Eigen::Matrix<double, 6, 1> e;
+        for (unsigned int s = begin; s < end; s++) {
+            if ((w.result = paramJac(q[s], pose, w.jac, w.xi)))
+                return;
+            Twist pose_error(measured[s].p - pose.p, rotationError(measured[s].M * pose.M.Inverse()));
+            for (unsigned int r = 0; r < 6; r++)
+                e(r) = pose_error(r);
+            w.JtJ.noalias() += w.jac.transpose() * w.jac;
+            w.Jte.noalias() += w.jac.transpose() * e;
+            w.sum += e.squaredNorm();
+        }
+        w.result = E_NOERROR;
+    }
+
+    int ChainCalibrationSolver::identify(const std::vector<JntArray>& q, const std::vector<Frame>& measured, Eigen::VectorXd& delta)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.size() != measured.size() || delta.size() != (int)np)
+            return (error = E_SIZE_MISMATCH);
+        //accumulate the normal equations of the stacked samples, every
+        //thread takes its own range of samples, the calling thread
+        //takes the last one
+        unsigned int n = q.size();
+        unsigned int nr_of_chunks = std::max(std::min(nr_of_threads, n/min_samples_per_thread), 1u);
+        unsigned int chunk = n/nr_of_chunks;
+        try {
+            for (unsigned int c = 0; c + 1 < nr_of_chunks; c++)
+                workers.push_back(std::thread(&ChainCalibrationSolver::accumulate, this, std::cref(q), std::cref(measured),
+                                              c*chunk, (c+1)*chunk, std::ref(workspaces[c+1])));
+        } catch (...) {
+            for (unsigned int c = 0; c < workers.size(); c++)
+                workers[c].join();
+            workers.clear();
+            throw;
+        }
+        accumulate(q, measured, (nr_of_chunks-1)*chunk, n, workspaces[0]);
+        for (unsigned int c = 0; c < workers.size(); c++)
+            workers[c].join();
+        workers.clear();
+
+        //reduce the normal equations of the threads
+        JtJ = workspaces[0].JtJ;
+        Jte = workspaces[0].Jte;
+        double sum = workspaces[0].sum;
+        for (unsigned int c = 0; c < nr_of_chunks; c++) {
+            if (workspaces[c].result)
+                return (error = workspaces[c].result);
+            if (c > 0) {
+                JtJ += workspaces[c].JtJ;
+                Jte += workspaces[c].Jte;
+                sum += workspaces[c].sum;
+            }
+        }
+        residual = n == 0 ? 0.0 : std::sqrt(sum / n);
+        svd.compute(JtJ);
+        delta = svd.solve(Jte);
+        return (error = E_NOERROR);
+    }
+
+    int ChainCalibrationSolver::updateChain(const Eigen::VectorXd& delta)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (delta.size() != (int)np)
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int i = 0; i < ns; i++) {
+            if (!parameters[i])
+                continue;
+            const Segment& segment = chain.getSegment(i);
+            const Joint& joint = segment.getJoint();
+            Frame f_tip = segment.getFrameToTipZero();
+            unsigned int c = columns[i];
+            if (parameters[i] & TIP_FRAME) {
+                Vector dp(delta(c), delta(c+1), delta(c+2));
+                Vector dr(delta(c+3), delta(c+4), delta(c+5));
+                f_tip = f_tip * Frame(rotationVector(dr), dp);
+                c += 6;
+            }
+            Joint new_joint = joint;
+            if (parameters[i] & (JOINT_OFFSET | JOINT_AXIS)) {
+                double offset = joint.getOffset();
+                if (parameters[i] & JOINT_OFFSET) {
+                    offset += delta(c);
+                    c += 1;
+                }
+                if (parameters[i] & JOINT_AXIS) {
+                    Vector u1, u2;
+                    perpendicular(joint.JointAxis(), u1, u2);
+                    Vector du = u1 * delta(c) + u2 * delta(c+1);
+                    Vector axis = rotationVector(du) * joint.JointAxis();
+                    new_joint = Joint(joint.getName(), jointOrigin(joint), axis, isRevolute(joint) ? Joint::RotAxis : Joint::TransAxis,
+                                      joint.getScale(), offset, joint.getInertia(), joint.getDamping(), joint.getStiffness());
+                } else if (joint.getType() == Joint::RotAxis || joint.getType() == Joint::TransAxis) {
+                    new_joint = Joint(joint.getName(), joint.JointOrigin(), joint.JointAxis(), joint.getType(),
+                                      joint.getScale(), offset, joint.getInertia(), joint.getDamping(), joint.getStiffness());
+                } else {
+                    new_joint = Joint(joint.getName(), joint.getType(),
+                                      joint.getScale(), offset, joint.getInertia(), joint.getDamping(), joint.getStiffness());
+                }
+            }
+            chain.getSegment(i) = Segment(segment.getName(), new_joint, new_joint.pose(0) * f_tip, segment.getInertia());
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainCalibrationSolver::calibrate(const std::vector<JntArray>& q, const std::vector<Frame>& measured, unsigned int maxiter, double eps)
+    {
+        Eigen::VectorXd delta(np);
+        for (unsigned int i = 0; i < maxiter; i++) {
+            if (identify(q, measured, delta))
+                return error;
+            updateChain(delta);
+            if (delta.norm() < eps)
+                return (error = E_NOERROR);
+        }
+        return (error = E_MAX_ITERATIONS_EXCEEDED);
+    }
+}
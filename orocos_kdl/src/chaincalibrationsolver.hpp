@@ -0,0 +1,192 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINCALIBRATIONSOLVER_HPP
+#define KDL_CHAINCALIBRATIONSOLVER_HPP
+
+#include "solveri.hpp"
+#include "chain.hpp"
+#include "jntarray.hpp"
+#include <Eigen/Dense>
+#include <thread>
+
+namespace KDL
+{
+    /**
+     * \brief Identification of the geometric parameters of a KDL::Chain
+     * from measured poses of its tip.
+     *
+     * Per segment three sets of parameters can be identified:
+     *  - TIP_FRAME: a small displacement of the pose from the end of the
+     *    joint to the tip of the segment, 3 translations followed by a
+     *    rotation vector, all expressed in the tip frame;
+     *  - JOINT_OFFSET: the offset of a single axis joint;
+     *  - JOINT_AXIS: two small rotations of the axis of a single axis
+     *    joint, about two directions perpendicular to the axis.
+     *
+     * The Jacobian of the pose of the tip with respect to these
+     * parameters (expressed in the base frame, with reference point at
+     * the tip) is calculated in one sweep per sample. calibrate()
+     * accumulates the normal equations of all samples, solves them with
+     * a truncated SVD, so that parameters that can not be distinguished
+     * get a minimum norm update, and writes the parameters back into
+     * the chain, until the update vanishes.
+     *
+     * Forming the normal equations squares the condition number of the
+     * stacked Jacobian: the singular values of J^T J below 1e-10 times
+     * the largest one are truncated, which corresponds to a relative
+     * singular value of 1e-5 of the Jacobian itself, and parameters
+     * that are only weakly observable lose about twice as many digits
+     * as with a factorization of the stacked Jacobian. The normal
+     * equations keep the memory independent of the number of samples.
+     *
+     * The samples are independent, for a large set they are split over
+     * several threads that each accumulate their own normal equations.
+     * The buffers are kept between calls, a ChainCalibrationSolver can
+     * only be used by one thread at a time.
+     *
+     * The chain is modified in place: joints with an updated axis become
+     * RotAxis or TransAxis joints, the number of joints and segments
+     * does not change.
+     */
+    class ChainCalibrationSolver : public SolverI
+    {
+    public:
+        enum {TIP_FRAME=1, JOINT_OFFSET=2, JOINT_AXIS=4};
+
+        /**
+         * Constructor of the solver, by default the tip frame of every
+         * segment and the offset of every single axis joint are
+         * identified.
+         *
+         * @param chain the chain to calibrate, an internal reference is
+         * stored and updated by updateChain() and calibrate()
+         * @param nr_of_threads number of threads that accumulate the
+         * samples of identify(), with 1 (or 0) all samples are processed
+         * by the calling thread
+         */
+        explicit ChainCalibrationSolver(Chain& chain, unsigned int nr_of_threads = 1);
+        virtual ~ChainCalibrationSolver();
+
+        /**
+         * Select the parameters to identify of a segment.
+         *
+         * @param seg_nr the nr of the segment starting from 0
+         * @param parameters combination of TIP_FRAME, JOINT_OFFSET and
+         * JOINT_AXIS, 0 to keep the segment as it is
+         * @return E_OUT_OF_RANGE for an unknown segment, E_NOT_IMPLEMENTED
+         * for joint parameters of a segment without single axis joint
+         */
+        int setParameters(unsigned int seg_nr, int parameters);
+
+        /**
+         * Request the total number of identified parameters, the size
+         * of the parameter vectors and the columns of the Jacobian.
+         */
+        unsigned int getNrOfParameters() const {return np;};
+
+        /**
+         * Calculate the pose of the tip of the chain and its Jacobian
+         * with respect to the parameters.
+         *
+         * @param q joint positions
+         * @param pose output pose of the tip
+         * @param jac output 6 x getNrOfParameters() Jacobian
+         * @return success/error code
+         */
+        int JntToParamJac(const JntArray& q, Frame& pose, Eigen::MatrixXd& jac);
+
+        /**
+         * Solve the linearized identification problem for a set of
+         * samples, without changing the chain.
+         *
+         * @param q joint positions per sample
+         * @param measured measured pose of the tip per sample
+         * @param delta output parameter update
+         * @return success/error code
+         */
+        int identify(const std::vector<JntArray>& q, const std::vector<Frame>& measured, Eigen::VectorXd& delta);
+
+        /**
+         * Apply a parameter update to the chain.
+         *
+         * @param delta parameter update, size getNrOfParameters()
+         * @return success/error code
+         */
+        int updateChain(const Eigen::VectorXd& delta);
+
+        /**
+         * Iteratively identify and apply the parameters that fit the
+         * measured poses best.
+         *
+         * @param q joint positions per sample
+         * @param measured measured pose of the tip per sample
+         * @param maxiter maximum number of iterations
+         * @param eps stop when the norm of the update is smaller
+         * @return E_NOERROR, E_MAX_ITERATIONS_EXCEEDED or an error code
+         */
+        int calibrate(const std::vector<JntArray>& q, const std::vector<Frame>& measured, unsigned int maxiter=20, double eps=1e-10);
+
+        /**
+         * Request the root mean square of the pose errors of the
+         * samples before the last update of identify() or calibrate().
+         */
+        double getResidual() const {return residual;};
+
+        /**
+         * Request the number of threads that accumulate the samples.
+         */
+        unsigned int getNrOfThreads() const {return nr_of_threads;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Buffers of one thread of identify()
+        struct Workspace {
+            //per parameter the displacement twist in the base frame, reference point in the base origin
+            std::vector<Twist> xi;
+            Eigen::MatrixXd jac;
+            Eigen::MatrixXd JtJ;
+            Eigen::VectorXd Jte;
+            double sum;
+            int result;
+        };
+
+        ///Helper function to count the parameters and assign their columns
+        void updateColumns();
+        ///Helper function calculating the Jacobian with the buffers of a thread
+        int paramJac(const JntArray& q, Frame& pose, Eigen::MatrixXd& jac, std::vector<Twist>& xi) const;
+        ///Helper function accumulating the samples [begin, end) into a workspace
+        void accumulate(const std::vector<JntArray>& q, const std::vector<Frame>& measured,
+                        unsigned int begin, unsigned int end, Workspace& w) const;
+        ///Helper function returning two unit vectors perpendicular to the axis
+        static void perpendicular(const Vector& axis, Vector& u1, Vector& u2);
+
+        Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        unsigned int np;
+        std::vector<int> parameters;
+        std::vector<unsigned int> columns;
+        unsigned int nr_of_threads;
+        std::vector<Workspace> workspaces;
+        std::vector<std::thread> workers;
+        Eigen::MatrixXd JtJ;
+        Eigen::VectorXd Jte;
+        Eigen::JacobiSVD<Eigen::MatrixXd> svd;
+        double residual;
+    };
+}
+#endif
@@ -0,0 +1,148 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chaincentroidalsolver.hpp"
+
+namespace KDL
+{
+    ChainCentroidalSolver::ChainCentroidalSolver(const Chain& _chain):
+        chain(_chain), nj(chain.getNrOfJoints()), ns(chain.getNrOfSegments()),
+        T(ns), I(ns), v(ns), a(ns), cmm(6, nj)
+    {
+    }
+
+    void ChainCentroidalSolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        T.resize(ns);
+        I.resize(ns);
+        v.resize(ns);
+        a.resize(ns);
+        cmm.resize(6, nj);
+    }
+
+    ChainCentroidalSolver::~ChainCentroidalSolver()
+    {
+    }
+
+    double ChainCentroidalSolver::getMass() const
+    {
+        double m = 0.0;
+        for (unsigned int i = 0; i < chain.getNrOfSegments(); i++)
+            m += chain.getSegment(i).getInertia().getMass();
+        return m;
+    }
+
+    int ChainCentroidalSolver::updateInertias(const JntArray& q)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+        Frame T_total = Frame::Identity();
+        I_total = RigidBodyInertia::Zero();
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            T_total = T_total * segment.pose(q, chain.getQNr(i));
+            T[i] = T_total;
+            I[i] = T_total * segment.getInertia();
+            I_total = I_total + I[i];
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainCentroidalSolver::JntToCoM(const JntArray& q, Vector& com)
+    {
+        if (updateInertias(q))
+            return error;
+        com = I_total.getCOG();
+        return (error = E_NOERROR);
+    }
+
+    int ChainCentroidalSolver::JntToCentroidalMomentumMatrix(const JntArray& q, Eigen::MatrixXd& cmm)
+    {
+        if (cmm.rows() != 6 || cmm.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (updateInertias(q))
+            return error;
+        Vector com = I_total.getCOG();
+        //Sweep from leaf to root, accumulating the composite inertia of the subchain
+        cmm.setZero();
+        RigidBodyInertia I_composite = RigidBodyInertia::Zero();
+        for (int i = ns - 1; i >= 0; i--) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            I_composite = I_composite + I[i];
+            Rotation R_joint = segment.pose(q, q_nr).M.Inverse();
+            for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++) {
+                //unit twist of the joint in the base frame, reference point in the base origin
+                Twist S = T[i] * (R_joint * segment.unitTwist(q, q_nr, d));
+                Wrench h = (I_composite * S).RefPoint(com);
+                //coupled joints add to the column of their coordinate
+                for (unsigned int k = 0; k < 3; k++) {
+                    cmm(k, q_nr + d) += h.force(k);
+                    cmm(k + 3, q_nr + d) += h.torque(k);
+                }
+            }
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainCentroidalSolver::JntToCoMJac(const JntArray& q, Vector& com, Eigen::MatrixXd& jac)
+    {
+        if (jac.rows() != 3 || jac.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (JntToCentroidalMomentumMatrix(q, cmm))
+            return error;
+        com = I_total.getCOG();
+        //the linear momentum is the mass times the velocity of the centre of mass
+        if (I_total.getMass() == 0.0)
+            jac.setZero();
+        else
+            jac = cmm.topRows<3>() / I_total.getMass();
+        return (error = E_NOERROR);
+    }
+
+    int ChainCentroidalSolver::JntToCentroidalMomentumMatrixDotQDot(const JntArrayVel& q, Wrench& cmm_dot_qdot)
+    {
+        if (q.qdot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+        if (updateInertias(q.q))
+            return error;
+        //Sweep from root to leaf with zero joint acceleration, the sum
+        //of the rates of change of the momenta of the segments is the
+        //rate of change of the momentum of the chain
+        Wrench hdot = Wrench::Zero();
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            Frame X = segment.pose(q.q, q_nr);
+            Twist vj = X.M.Inverse(segment.twist(q.q, q.qdot, q_nr));
+            Twist aj = X.M.Inverse(segment.biasTwist(q.q, q.qdot, q_nr));
+            if (i == 0) {
+                v[i] = vj;
+                a[i] = aj;
+            } else {
+                v[i] = X.Inverse(v[i-1]) + vj;
+                a[i] = X.Inverse(a[i-1]) + aj + v[i] * vj;
+            }
+            const RigidBodyInertia& Ii = segment.getInertia();
+            hdot += T[i] * (Ii * a[i] + v[i] * (Ii * v[i]));
+        }
+        //the centre of mass moves parallel to the linear momentum, so
+        //moving the reference point adds no velocity-product term
+        cmm_dot_qdot = hdot.RefPoint(I_total.getCOG());
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,110 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINCENTROIDALSOLVER_HPP
+#define KDL_CHAINCENTROIDALSOLVER_HPP
+
+#include "solveri.hpp"
+#include "chain.hpp"
+#include "jntarrayvel.hpp"
+#include <Eigen/Core>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the centre of mass and the centroidal momentum
+     * of a KDL::Chain.
+     *
+     * All quantities are expressed in the base frame of the chain. The
+     * centroidal momentum matrix A maps the joint velocities on the
+     * spatial momentum of the chain with reference point at its centre
+     * of mass, the first three rows are the linear momentum and the last
+     * three the angular momentum. Every function needs a single sweep
+     * over the segments: the columns are the composite inertia of the
+     * subchain moved by a joint times the unit twist of that joint.
+     */
+    class ChainCentroidalSolver : public SolverI
+    {
+    public:
+        explicit ChainCentroidalSolver(const Chain& chain);
+        virtual ~ChainCentroidalSolver();
+
+        /**
+         * Calculate the total mass of the chain.
+         */
+        double getMass() const;
+
+        /**
+         * Calculate the centre of mass of the chain.
+         *
+         * @param q input joint positions
+         * @param com output centre of mass, zero for a massless chain
+         * @return success/error code
+         */
+        int JntToCoM(const JntArray& q, Vector& com);
+
+        /**
+         * Calculate the centre of mass and its Jacobian, the 3 x nj
+         * matrix that maps the joint velocities on the velocity of the
+         * centre of mass.
+         *
+         * @param q input joint positions
+         * @param com output centre of mass
+         * @param jac output Jacobian of the centre of mass
+         * @return success/error code
+         */
+        int JntToCoMJac(const JntArray& q, Vector& com, Eigen::MatrixXd& jac);
+
+        /**
+         * Calculate the 6 x nj centroidal momentum matrix.
+         *
+         * @param q input joint positions
+         * @param cmm output centroidal momentum matrix
+         * @return success/error code
+         */
+        int JntToCentroidalMomentumMatrix(const JntArray& q, Eigen::MatrixXd& cmm);
+
+        /**
+         * Calculate the product of the time derivative of the
+         * centroidal momentum matrix and the joint velocities, the rate
+         * of change of the centroidal momentum at zero joint
+         * acceleration.
+         *
+         * @param q input joint positions and velocities
+         * @param cmm_dot_qdot output force: rate of change of the linear
+         * momentum, torque: rate of change of the angular momentum
+         * @return success/error code
+         */
+        int JntToCentroidalMomentumMatrixDotQDot(const JntArrayVel& q, Wrench& cmm_dot_qdot);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function to calculate the frames and inertias of the segments in the base frame
+        int updateInertias(const JntArray& q);
+
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        std::vector<Frame> T;
+        std::vector<RigidBodyInertia> I;
+        RigidBodyInertia I_total;
+        std::vector<Twist> v;
+        std::vector<Twist> a;
+        ///Centroidal momentum matrix used by JntToCoMJac
+        Eigen::MatrixXd cmm;
+    };
+}
+#endif
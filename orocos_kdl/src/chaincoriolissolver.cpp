@@ -0,0 +1,135 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chaincoriolissolver.hpp"
+
+namespace KDL
+{
+    ChainCoriolisSolver::ChainCoriolisSolver(const Chain& _chain):
+        chain(_chain), nj(chain.getNrOfJoints()), ns(chain.getNrOfSegments())
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainCoriolisSolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        T.resize(ns);
+        S.resize(ns);
+        S_dot.resize(ns);
+        Ic.resize(ns);
+        Ic_dot.resize(ns);
+        hc.resize(ns);
+        H_tmp.resize(nj, nj);
+    }
+
+    ChainCoriolisSolver::~ChainCoriolisSolver()
+    {
+    }
+
+    int ChainCoriolisSolver::calculate(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd* H, Eigen::MatrixXd& C)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || C.rows() != (int)nj || C.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int i = 0; i < ns; i++)
+            if (chain.getSegment(i).getJoint().getNrOfDofs() > 1)
+                return (error = E_NOT_IMPLEMENTED);
+
+        //Sweep from root to leaf: frames, velocities, unit twists and
+        //their derivatives, and the inertias in the base frame
+        Twist v = Twist::Zero();
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            Frame X = segment.pose(q, q_nr);
+            T[i] = i == 0 ? X : T[i - 1] * X;
+            if (segment.getJoint().getNrOfDofs() == 1) {
+                //unit twist in the base frame, reference point in the base origin
+                Twist s = T[i] * X.M.Inverse(segment.unitTwist(q, q_nr, 0));
+                v += s * q_dot(q_nr);
+                S[i] = toVector(s);
+                S_dot[i] = toVector(v * s);
+            }
+            inertiaMatrices(T[i] * segment.getInertia(), v, Ic[i], Ic_dot[i]);
+            hc[i].noalias() = Ic[i] * toVector(v);
+        }
+
+        //Sweep from leaf to root: accumulate the rest of the chain and
+        //match every joint with itself and the joints before it.
+        //Coupled joints add to the rows and columns of their coordinate.
+        C.setZero();
+        if (H)
+            H->setZero();
+        Vector6d F1, F2, F3, BS, SxH;
+        for (int i = ns - 1; i >= 0; i--) {
+            if (i + 1 < (int)ns) {
+                Ic[i] += Ic[i + 1];
+                Ic_dot[i] += Ic_dot[i + 1];
+                hc[i] += hc[i + 1];
+            }
+            const Joint& joint = chain.getSegment(i).getJoint();
+            if (joint.getNrOfDofs() == 0)
+                continue;
+            unsigned int k = chain.getQNr(i);
+            //B*S with B = (Ic_dot + (Ic*v) x-bar)/2, the Coriolis
+            //matrix of the rest of the chain
+            BS.noalias() = 0.5 * Ic_dot[i] * S[i];
+            SxH = toVector(toTwist(S[i]) * toWrench(hc[i]));
+            F1.noalias() = Ic[i] * S_dot[i];
+            F1 += BS + 0.5 * SxH;
+            F2.noalias() = Ic[i] * S[i];
+            F3 = BS - 0.5 * SxH;
+            C(k, k) += S[i].dot(F1);
+            if (H)
+                (*H)(k, k) += S[i].dot(F2) + joint.getInertia();
+            for (int j = i - 1; j >= 0; j--) {
+                if (chain.getSegment(j).getJoint().getNrOfDofs() == 0)
+                    continue;
+                unsigned int l = chain.getQNr(j);
+                C(l, k) += S[j].dot(F1);
+                C(k, l) += S_dot[j].dot(F2) + S[j].dot(F3);
+                if (H) {
+                    double Hkl = S[j].dot(F2);
+                    (*H)(k, l) += Hkl;
+                    (*H)(l, k) += Hkl;
+                }
+            }
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainCoriolisSolver::JntToCoriolisMatrix(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& C)
+    {
+        return calculate(q, q_dot, 0, C);
+    }
+
+    int ChainCoriolisSolver::JntToMassAndCoriolis(const JntArray& q, const JntArray& q_dot, JntSpaceInertiaMatrix& H, Eigen::MatrixXd& C)
+    {
+        if (H.rows() != nj || H.columns() != nj)
+            return (error = E_SIZE_MISMATCH);
+        return calculate(q, q_dot, &H.data, C);
+    }
+
+    int ChainCoriolisSolver::JntToMassDot(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& H_dot)
+    {
+        if (H_dot.rows() != (int)nj || H_dot.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (calculate(q, q_dot, 0, H_tmp))
+            return error;
+        H_dot = H_tmp + H_tmp.transpose();
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,108 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINCORIOLISSOLVER_HPP
+#define KDL_CHAINCORIOLISSOLVER_HPP
+
+#include "chain.hpp"
+#include "jntarray.hpp"
+#include "jntspaceinertiamatrix.hpp"
+#include "solveri.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <Eigen/StdVector>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the Coriolis matrix C(q,qdot) of a KDL::Chain.
+     *
+     * The Coriolis and centrifugal torques are C(q,qdot)*qdot, as
+     * calculated by ChainDynParam::JntToCoriolis. Of the many matrices
+     * that satisfy this, the solver calculates the one for which
+     * Hdot - 2C is skew-symmetric, as needed by passivity-based
+     * controllers:
+     *
+     * S. Echeandia, P. M. Wensing. Numerical methods to compute the
+     * Coriolis matrix and Christoffel symbols for rigid-body systems.
+     * Journal of Computational and Nonlinear Dynamics, 16(9), 2021
+     *
+     * All quantities are expressed in the base frame. In a sweep from
+     * tip to root the solver accumulates three things for the part of
+     * the chain beyond every joint: the inertia, its time derivative
+     * and the momentum. Every joint is then matched with the joints
+     * before it, which is O(n^2). The same sweep gives the mass matrix.
+     *
+     * Only single DOF joints (including coupled joints) are supported.
+     */
+    class ChainCoriolisSolver : public SolverI
+    {
+    public:
+        explicit ChainCoriolisSolver(const Chain& chain);
+        virtual ~ChainCoriolisSolver();
+
+        /**
+         * Calculate the nj x nj Coriolis matrix.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param C output Coriolis matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToCoriolisMatrix(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& C);
+
+        /**
+         * Calculate the mass matrix and the Coriolis matrix in one sweep.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param H output mass matrix
+         * @param C output Coriolis matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToMassAndCoriolis(const JntArray& q, const JntArray& q_dot, JntSpaceInertiaMatrix& H, Eigen::MatrixXd& C);
+
+        /**
+         * Calculate the time derivative of the mass matrix, C + C^T.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param H_dot output time derivative of the mass matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToMassDot(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& H_dot);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function with an optional mass matrix
+        int calculate(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd* H, Eigen::MatrixXd& C);
+
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        std::vector<Frame> T;
+        //unit twists of the joints and their time derivatives
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S_dot;
+        //inertia, its time derivative and the momentum of the
+        //segments, accumulated over the rest of the chain
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > Ic;
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > Ic_dot;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > hc;
+        Eigen::MatrixXd H_tmp;
+    };
+}
+
+#endif
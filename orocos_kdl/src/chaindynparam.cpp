@@ -23,6 +23,7 @@
 #include "chaindynparam.hpp"
 #include "frames_io.hpp"
 #include <iostream>
+#include "tracing.hpp"
 
 namespace KDL {
 
@@ -37,7 +38,7 @@ namespace KDL {
             chainidsolver_gravity( chain, grav),
             wrenchnull(ns,Wrench::Zero()),
             X(ns),
-            S(ns),
+            S(nj+chain.getNrOfCoupledJoints()),
             Ic(ns)
     {
         ag=-Twist(grav,Vector::Zero());
@@ -51,7 +52,7 @@ namespace KDL {
         chainidsolver_gravity.updateInternalDataStructures();
         wrenchnull.resize(ns,Wrench::Zero());
         X.resize(ns);
-        S.resize(ns);
+        S.resize(nj+chain.getNrOfCoupledJoints());
         Ic.resize(ns);
     }
 
@@ -59,34 +60,31 @@ namespace KDL {
     //calculate inertia matrix H
     int ChainDynParam::JntToMass(const JntArray &q, JntSpaceInertiaMatrix& H)
     {
+        KDL_TRACE_SPAN("ChainDynParam::JntToMass");
         if(nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
             return (error = E_NOT_UP_TO_DATE);
 	//Check sizes when in debug mode
         if(q.rows()!=nj || H.rows()!=nj || H.columns()!=nj )
             return (error = E_SIZE_MISMATCH);
-        unsigned int k=0;
-	double q_;
+        unsigned int k;
+        unsigned int s=0; //index of the first unit twist of the segment in S
 
 	//Sweep from root to leaf
         for(unsigned int i=0;i<ns;i++)
 	{
 	  //Collect RigidBodyInertia
           Ic[i]=chain.getSegment(i).getInertia();
-          if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed)
-	  {
-	      q_=q(k);
-	      k++;
-	  }
-	  else
-	  {
-	    q_=0.0;
-	  }
-	  X[i]=chain.getSegment(i).pose(q_);//Remark this is the inverse of the frame for transformations from the parent to the current coord frame
-	  S[i]=X[i].M.Inverse(chain.getSegment(i).twist(q_,1.0));
+	  X[i]=chain.getSegment(i).pose(q,chain.getQNr(i));//Remark this is the inverse of the frame for transformations from the parent to the current coord frame
+	  //one unit twist per DOF of the joint
+	  for(unsigned int d=0;d<chain.getSegment(i).getJoint().getNrOfDofs();d++)
+	      S[s++]=X[i].M.Inverse(chain.getSegment(i).unitTwist(q,chain.getQNr(i),d,X[i].M));
         }
-	//Sweep from leaf to root
-        int j,l;
-	k=nj-1; //reset k
+	//Sweep from leaf to root, coupled joints add their contributions
+	//to the rows and columns of their coordinate
+        unsigned int j;
+        int l;
+        unsigned int sl;
+        SetToZero(H);
         for(int i=ns-1;i>=0;i--)
 	{
 
@@ -96,27 +94,41 @@ namespace KDL {
 	      Ic[i-1]=Ic[i-1]+X[i]*Ic[i];
 	    }
 
-	  F=Ic[i]*S[i];
-      if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed)
+	  const Joint& joint=chain.getSegment(i).getJoint();
+	  s-=joint.getNrOfDofs();
+	  for(unsigned int d=0;d<joint.getNrOfDofs();d++)
 	  {
-          H(k,k)=dot(S[i],F);
-          H(k,k)+=chain.getSegment(i).getJoint().getInertia();  // add joint inertia
-	      j=k; //countervariable for the joints
+	      F=Ic[i]*S[s+d];
+	      k=chain.getQNr(i)+d;
+	      //coupling between the DOFs of the same joint
+	      for(unsigned int e=0;e<d;e++)
+	      {
+		  j=chain.getQNr(i)+e;
+		  double Hkj=dot(F,S[s+e]);
+		  H(k,j)+=Hkj;
+		  H(j,k)+=Hkj;
+	      }
+	      H(k,k)+=dot(S[s+d],F);
+	      if(joint.getNrOfDofs()==1)
+		  H(k,k)+=joint.getInertia();  // add joint inertia
 	      l=i; //countervariable for the segments
+	      sl=s;
 	      while(l!=0) //go from leaf to root starting at i
 		{
 		  //assumption that previous segment is parent
 		  F=X[l]*F; //calculate the unit force (cfr S) for every segment: F[l-1]=X[l]*F[l]
 		  l--; //go down a segment
 
-          if(chain.getSegment(l).getJoint().getType()!=Joint::Fixed) //if the joint connected to segment is not a fixed joint
+		  //match the unit force with every DOF of the joint connected to the segment
+		  sl-=chain.getSegment(l).getJoint().getNrOfDofs();
+		  for(unsigned int e=0;e<chain.getSegment(l).getJoint().getNrOfDofs();e++)
 		  {
-		    j--;
-		    H(k,j)=dot(F,S[l]); //here you actually match a certain not fixed joint with a segment
-		    H(j,k)=H(k,j);
+		    j=chain.getQNr(l)+e;
+		    double Hkj=dot(F,S[sl+e]);
+		    H(k,j)+=Hkj;
+		    H(j,k)+=Hkj;
 		  }
 		}
-	      k--; //this if-loop should be repeated nj times (k=nj-1 to k=0)
 	  }
 
 	}
@@ -126,6 +138,7 @@ namespace KDL {
     //calculate coriolis matrix C
     int ChainDynParam::JntToCoriolis(const JntArray &q, const JntArray &q_dot, JntArray &coriolis)
     {
+    KDL_TRACE_SPAN("ChainDynParam::JntToCoriolis");
     //make a null matrix with the size of q_dotdot and a null wrench
 	SetToZero(jntarraynull);
 
@@ -138,6 +151,7 @@ namespace KDL {
     //calculate gravity matrix G
     int ChainDynParam::JntToGravity(const JntArray &q,JntArray &gravity)
     {
+	KDL_TRACE_SPAN("ChainDynParam::JntToGravity");
 
 	//make a null matrix with the size of q_dotdot and a null wrench
 
@@ -0,0 +1,113 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainenergysolver.hpp"
+
+namespace KDL
+{
+    ChainEnergySolver::ChainEnergySolver(const Chain& _chain, Vector _grav):
+        chain(_chain), nj(chain.getNrOfJoints()), ns(chain.getNrOfSegments()), grav(_grav)
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainEnergySolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        T.resize(ns);
+        V.resize(ns);
+    }
+
+    ChainEnergySolver::~ChainEnergySolver()
+    {
+    }
+
+    int ChainEnergySolver::calculate(const JntArray& q, const JntArray& q_dot)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Sweep from root to tip, the twist in the tip frame and the
+        //frame in the base
+        Frame F = Frame::Identity();
+        Twist v = Twist::Zero();
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int j = chain.getQNr(i);
+            Frame X = segment.pose(q, j);
+            F = F * X;
+            v = X.Inverse(v) + X.M.Inverse(segment.twist(q, q_dot, j));
+            const RigidBodyInertia& I = segment.getInertia();
+            T[i] = 0.5 * dot(v, I * v);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                T[i] += 0.5 * segment.getJoint().getInertia() * q_dot(j) * q_dot(j);
+            V[i] = -I.getMass() * dot(grav, F * I.getCOG());
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainEnergySolver::JntToEnergy(const JntArray& q, const JntArray& q_dot, double& kinetic, double& potential)
+    {
+        if (calculate(q, q_dot))
+            return error;
+        kinetic = 0.0;
+        potential = 0.0;
+        for (unsigned int i = 0; i < ns; i++) {
+            kinetic += T[i];
+            potential += V[i];
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainEnergySolver::JntToSegmentEnergy(const JntArray& q, const JntArray& q_dot, std::vector<double>& kinetic, std::vector<double>& potential)
+    {
+        if (kinetic.size() != ns || potential.size() != ns)
+            return (error = E_SIZE_MISMATCH);
+        if (calculate(q, q_dot))
+            return error;
+        kinetic = T;
+        potential = V;
+        return (error = E_NOERROR);
+    }
+
+    int ChainEnergySolver::JntToPower(const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot, double& power)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || q_dotdot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //The power of segment i is v.(I*a + v x* I*v), of which the
+        //second term vanishes. Gravity enters as an acceleration of the
+        //base, as in ChainIdSolver_RNE.
+        Twist v = Twist::Zero();
+        Twist a = -Twist(grav, Vector::Zero());
+        power = 0.0;
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int j = chain.getQNr(i);
+            Frame X = segment.pose(q, j);
+            Twist vj = X.M.Inverse(segment.twist(q, q_dot, j));
+            Twist aj = X.M.Inverse(segment.twist(q, q_dotdot, j) + segment.biasTwist(q, q_dot, j));
+            v = X.Inverse(v) + vj;
+            a = X.Inverse(a) + aj + v * vj;
+            power += dot(v, segment.getInertia() * a);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                power += segment.getJoint().getInertia() * q_dot(j) * q_dotdot(j);
+        }
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,105 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINENERGYSOLVER_HPP
+#define KDL_CHAINENERGYSOLVER_HPP
+
+#include "chain.hpp"
+#include "jntarray.hpp"
+#include "solveri.hpp"
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the kinetic energy, the potential energy and the
+     * mechanical power of a KDL::Chain.
+     *
+     * The kinetic energy 1/2 qdot^T H qdot is calculated from the twists
+     * of the segments in one sweep from root to tip, without forming the
+     * mass matrix, which is O(n). The potential energy is that of the
+     * centers of mass of the segments in the gravity field, with the
+     * base origin at zero. The power is the rate of change of the total
+     * energy, which equals the power torques^T qdot that the joints
+     * deliver to the chain.
+     *
+     * The joint inertias (rotor inertias) are included in the kinetic
+     * energy and in the power. No memory is allocated at run time.
+     */
+    class ChainEnergySolver : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver
+         * \param chain The kinematic chain, an internal reference will be stored.
+         * \param grav The gravity vector to use during the calculation.
+         */
+        ChainEnergySolver(const Chain& chain, Vector grav);
+        virtual ~ChainEnergySolver();
+
+        /**
+         * Calculate the energy of the chain.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param kinetic output kinetic energy
+         * @param potential output potential energy
+         * @return success/error code
+         */
+        int JntToEnergy(const JntArray& q, const JntArray& q_dot, double& kinetic, double& potential);
+
+        /**
+         * Calculate the energy of every segment.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param kinetic output kinetic energy per segment, of size
+         * getNrOfSegments()
+         * @param potential output potential energy per segment, of size
+         * getNrOfSegments()
+         * @return success/error code
+         */
+        int JntToSegmentEnergy(const JntArray& q, const JntArray& q_dot, std::vector<double>& kinetic, std::vector<double>& potential);
+
+        /**
+         * Calculate the mechanical power, the rate of change of the
+         * kinetic and potential energy.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param q_dotdot input joint accelerations
+         * @param power output power
+         * @return success/error code
+         */
+        int JntToPower(const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot, double& power);
+
+        void setGravity(const Vector& _grav) {grav = _grav;};
+        const Vector& getGravity() const {return grav;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function that fills the energies of the segments
+        int calculate(const JntArray& q, const JntArray& q_dot);
+
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        Vector grav;
+        std::vector<double> T;
+        std::vector<double> V;
+    };
+}
+
+#endif
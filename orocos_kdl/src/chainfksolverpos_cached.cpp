@@ -0,0 +1,109 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainfksolverpos_cached.hpp"
+
+namespace KDL {
+
+    ChainFkSolverPos_cached::ChainFkSolverPos_cached(const Chain& _chain, unsigned int capacity, double resolution):
+        chain(_chain),
+        nj(chain.getNrOfJoints()),
+        ns(chain.getNrOfSegments()),
+        cache(chain.getNrOfJoints(), chain.getNrOfSegments(), capacity, resolution),
+        frames(chain.getNrOfSegments())
+    {
+    }
+
+    void ChainFkSolverPos_cached::updateInternalDataStructures()
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        cache.resize(nj, ns);
+        frames.resize(ns);
+    }
+
+    void ChainFkSolverPos_cached::clearCache()
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        cache.clear();
+    }
+
+    int ChainFkSolverPos_cached::lookup(const JntArray& q_in, unsigned int first, unsigned int count, Frame* p_out)
+    {
+        if (cache.lookup(q_in, first, count, p_out))
+            return E_NOERROR;
+
+        //on a miss all frames are calculated and stored
+        std::lock_guard<std::mutex> lock(write_mutex);
+        Frame total = Frame::Identity();
+        for (unsigned int i = 0; i < ns; i++) {
+            total = total*chain.getSegment(i).pose(q_in, chain.getQNr(i));
+            frames[i] = total;
+        }
+        cache.insert(q_in, frames.data());
+        for (unsigned int k = 0; k < count; k++)
+            p_out[k] = frames[first+k];
+        return E_NOERROR;
+    }
+
+    int ChainFkSolverPos_cached::JntToCart(const JntArray& q_in, Frame& p_out, int seg_nr)
+    {
+        unsigned int segmentNr;
+        if(seg_nr<0)
+            segmentNr=ns;
+        else
+            segmentNr = seg_nr;
+
+        p_out = Frame::Identity();
+
+        if(nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return E_NOT_UP_TO_DATE;
+        if(q_in.rows()!=nj)
+            return E_SIZE_MISMATCH;
+        else if(segmentNr>ns)
+            return E_OUT_OF_RANGE;
+        else if(segmentNr==0)
+            return E_NOERROR;
+        else
+            return lookup(q_in, segmentNr-1, 1, &p_out);
+    }
+
+    int ChainFkSolverPos_cached::JntToCart(const JntArray& q_in, std::vector<Frame>& p_out, int seg_nr)
+    {
+        unsigned int segmentNr;
+        if(seg_nr<0)
+            segmentNr=ns;
+        else
+            segmentNr = seg_nr;
+
+        if(nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return E_NOT_UP_TO_DATE;
+        if(q_in.rows()!=nj)
+            return E_SIZE_MISMATCH;
+        else if(segmentNr>ns)
+            return E_OUT_OF_RANGE;
+        else if(p_out.size() != segmentNr)
+            return E_SIZE_MISMATCH;
+        else if(segmentNr == 0)
+            return E_OUT_OF_RANGE;
+        else
+            return lookup(q_in, 0, segmentNr, p_out.data());
+    }
+
+    ChainFkSolverPos_cached::~ChainFkSolverPos_cached()
+    {
+    }
+
+}
@@ -0,0 +1,81 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDLCHAINFKSOLVERPOS_CACHED_HPP
+#define KDLCHAINFKSOLVERPOS_CACHED_HPP
+
+#include "chainfksolver.hpp"
+#include "framecache.hpp"
+#include <mutex>
+
+namespace KDL {
+
+    /**
+     * Forward position kinematics of a general kinematic chain
+     * (KDL::Chain) with a bounded cache of the frames of all segments
+     * in front of the recursive algorithm, for callers that request
+     * the same configurations over and over (graph search, lazy
+     * collision checking). See FrameCache for the caching policy.
+     *
+     * JntToCart can be called from several threads at the same time:
+     * cache hits are lock-free, misses are serialized. To keep the
+     * calls free of shared writes, the returned error codes are not
+     * stored for getError().
+     *
+     * @ingroup KinematicFamily
+     */
+    class ChainFkSolverPos_cached : public ChainFkSolverPos
+    {
+    public:
+        /**
+         * @param chain the chain to calculate forward kinematics for
+         * @param capacity number of configurations kept in the cache
+         * @param resolution quantization step of the joint positions
+         * used as cache key, 0 for exact keys
+         */
+        ChainFkSolverPos_cached(const Chain& chain, unsigned int capacity=1024, double resolution=0.0);
+        ~ChainFkSolverPos_cached();
+
+        virtual int JntToCart(const JntArray& q_in, Frame& p_out, int segmentNr=-1);
+        virtual int JntToCart(const JntArray& q_in, std::vector<Frame>& p_out, int segmentNr=-1);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures()
+        /// The cache is emptied.
+        virtual void updateInternalDataStructures();
+
+        /**
+         * Remove all configurations from the cache.
+         */
+        void clearCache();
+
+        /**
+         * Request the cache, e.g. for its hit and miss statistics.
+         */
+        const FrameCache& getCache() const {return cache;};
+        void resetStatistics() {cache.resetStatistics();};
+
+    private:
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        FrameCache cache;
+        std::mutex write_mutex;
+        std::vector<Frame> frames;
+
+        int lookup(const JntArray& q_in, unsigned int first, unsigned int count, Frame* p_out);
+    };
+
+}
+
+#endif
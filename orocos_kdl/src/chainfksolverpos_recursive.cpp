@@ -23,6 +23,7 @@
 
 #include "chainfksolverpos_recursive.hpp"
 #include <iostream>
+#include "tracing.hpp"
 
 namespace KDL {
 
@@ -32,6 +33,7 @@ namespace KDL {
     }
 
     int ChainFkSolverPos_recursive::JntToCart(const JntArray& q_in, Frame& p_out, int seg_nr)    {
+        KDL_TRACE_SPAN("ChainFkSolverPos_recursive::JntToCart");
         unsigned int segmentNr;
         if(seg_nr<0)
             segmentNr=chain.getNrOfSegments();
@@ -45,11 +47,9 @@ namespace KDL {
         else if(segmentNr>chain.getNrOfSegments())
             return (error = E_OUT_OF_RANGE);
         else{
-            int j=0;
             for(unsigned int i=0;i<segmentNr;i++){
                 if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                    p_out = p_out*chain.getSegment(i).pose(q_in(j));
-                    j++;
+                    p_out = p_out*chain.getSegment(i).pose(q_in,chain.getQNr(i));
                 }else{
                     p_out = p_out*chain.getSegment(i).pose(0.0);
                 }
@@ -58,6 +58,7 @@ namespace KDL {
         }
     }
     int ChainFkSolverPos_recursive::JntToCart(const JntArray& q_in, std::vector<Frame>& p_out, int seg_nr)    {
+        KDL_TRACE_SPAN("ChainFkSolverPos_recursive::JntToCart");
         unsigned int segmentNr;
         if(seg_nr<0)
             segmentNr=chain.getNrOfSegments();
@@ -73,18 +74,15 @@ namespace KDL {
         else if(segmentNr == 0)
             return -1;
         else{
-            int j=0;
             // Initialization
             if(chain.getSegment(0).getJoint().getType()!=Joint::Fixed) {
-                p_out[0] = chain.getSegment(0).pose(q_in(j));
-                j++;
+                p_out[0] = chain.getSegment(0).pose(q_in,chain.getQNr(0));
             }else
                 p_out[0] = chain.getSegment(0).pose(0.0);
 
             for(unsigned int i=1;i<segmentNr;i++){
                 if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                    p_out[i] = p_out[i-1]*chain.getSegment(i).pose(q_in(j));
-                    j++;
+                    p_out[i] = p_out[i-1]*chain.getSegment(i).pose(q_in,chain.getQNr(i));
                 }else{
                     p_out[i] = p_out[i-1]*chain.getSegment(i).pose(0.0);
                 }
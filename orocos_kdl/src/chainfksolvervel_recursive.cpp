@@ -22,6 +22,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "chainfksolvervel_recursive.hpp"
+#include "tracing.hpp"
 
 namespace KDL
 {
@@ -36,6 +37,7 @@ namespace KDL
 
     int ChainFkSolverVel_recursive::JntToCart(const JntArrayVel& in,FrameVel& out,int seg_nr)
     {
+        KDL_TRACE_SPAN("ChainFkSolverVel_recursive::JntToCart");
         unsigned int segmentNr;
         if(seg_nr<0)
             segmentNr=chain.getNrOfSegments();
@@ -49,13 +51,12 @@ namespace KDL
         else if(segmentNr>chain.getNrOfSegments())
             return (error = E_OUT_OF_RANGE);
         else{
-            int j=0;
             for (unsigned int i=0;i<segmentNr;i++) {
                 //Calculate new Frame_base_ee
                 if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                    out=out*FrameVel(chain.getSegment(i).pose(in.q(j)),
-                                     chain.getSegment(i).twist(in.q(j),in.qdot(j)));
-                    j++;//Only increase jointnr if the segment has a joint
+                    unsigned int j=chain.getQNr(i);
+                    out=out*FrameVel(chain.getSegment(i).pose(in.q,j),
+                                     chain.getSegment(i).twist(in.q,in.qdot,j));
                 }else{
                     out=out*FrameVel(chain.getSegment(i).pose(0.0),
                                      chain.getSegment(i).twist(0.0,0.0));
@@ -67,6 +68,7 @@ namespace KDL
 
     int ChainFkSolverVel_recursive::JntToCart(const JntArrayVel& in,std::vector<FrameVel>& out,int seg_nr)
     {
+        KDL_TRACE_SPAN("ChainFkSolverVel_recursive::JntToCart");
         unsigned int segmentNr;
         if(seg_nr<0)
             segmentNr=chain.getNrOfSegments();
@@ -84,12 +86,10 @@ namespace KDL
         else if(segmentNr == 0)
             return -1;
         else{
-            int j=0;
             // Initialization
             if(chain.getSegment(0).getJoint().getType()!=Joint::Fixed) {
-                out[0] = FrameVel(chain.getSegment(0).pose(in.q(0)),
-                                     chain.getSegment(0).twist(in.q(0),in.qdot(0)));
-                j++;
+                out[0] = FrameVel(chain.getSegment(0).pose(in.q,0),
+                                     chain.getSegment(0).twist(in.q,in.qdot,0));
             }else
                 out[0] = FrameVel(chain.getSegment(0).pose(0.0),
                                      chain.getSegment(0).twist(0.0,0.0));
@@ -97,9 +97,9 @@ namespace KDL
             for (unsigned int i=1;i<segmentNr;i++) {
                 //Calculate new Frame_base_ee
                 if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                    out[i]=out[i-1]*FrameVel(chain.getSegment(i).pose(in.q(j)),
-                                    chain.getSegment(i).twist(in.q(j),in.qdot(j)));
-                    j++;//Only increase jointnr if the segment has a joint
+                    unsigned int j=chain.getQNr(i);
+                    out[i]=out[i-1]*FrameVel(chain.getSegment(i).pose(in.q,j),
+                                    chain.getSegment(i).twist(in.q,in.qdot,j));
                 }else{
                     out[i]=out[i-1]*FrameVel(chain.getSegment(i).pose(0.0),
                                      chain.getSegment(i).twist(0.0,0.0));
@@ -63,6 +63,9 @@ int ChainHdSolver_Vereshchagin::CartToJnt(const JntArray &q, const JntArray &q_d
         return (error = E_SIZE_MISMATCH);
     if (alfa.columns() != nc || beta.rows() != nc)
         return (error = E_SIZE_MISMATCH);
+    //The articulated body recursion assumes one coordinate per joint
+    if (chain.getNrOfCoupledJoints() != 0 || chain.getNrOfMultiDofJoints() != 0)
+        return (error = E_NOT_IMPLEMENTED);
     //do an upward recursion for position, velocities and rigid-body bias forces
     this->initial_upwards_sweep(q, q_dot, q_dotdot, f_ext);
     //do an inward recursion for inertia, articulated bias forces and constraints
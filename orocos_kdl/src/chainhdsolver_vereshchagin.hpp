@@ -334,7 +334,7 @@ namespace KDL
  * Moreover, this implementation can only compute dynamics for **serial** type of chains, i.e. currently, **tree** robot structures are not supported
  * in this solver. Nevertheless, the original solver's derivation has been extended in [3] to account for multiple motion constraints imposed
  * on a **tree** robot structure. This extension does not only account for acceleration constraints imposed on multiple end-effectors but also for
- * acceleration constraints imposed on more proximal segments. However, the above-mentioned extensions are currently not implemented in this version of KDL.
+ * acceleration constraints imposed on more proximal segments. These extensions are implemented for trees in KDL::TreeHdSolver_Vereshchagin.
  *
  * ## REFERENCES
  * 
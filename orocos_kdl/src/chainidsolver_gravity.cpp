@@ -0,0 +1,83 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainidsolver_gravity.hpp"
+
+namespace KDL
+{
+    ChainIdSolver_Gravity::ChainIdSolver_Gravity(const Chain& _chain, Vector _grav):
+        chain(_chain), nj(chain.getNrOfJoints()), ns(chain.getNrOfSegments()), grav(_grav)
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainIdSolver_Gravity::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        M.resize(ns);
+        mc.resize(ns);
+        S.resize(ns);
+        X.resize(ns);
+        g.resize(ns);
+        h.resize(ns);
+        JntArray q(nj);
+        for (int i = ns - 1; i >= 0; i--) {
+            const Segment& segment = chain.getSegment(i);
+            const RigidBodyInertia& I = segment.getInertia();
+            M[i] = I.getMass() + (i + 1 < (int)ns ? M[i + 1] : 0.0);
+            mc[i] = I.getMass() * I.getCOG();
+            //a joint does not move its own axis, so the unit twist of a
+            //single DOF joint is the same in the tip frame for all q
+            if (segment.getJoint().getNrOfDofs() == 1)
+                S[i] = segment.pose(q, chain.getQNr(i)).M.Inverse(segment.unitTwist(q, chain.getQNr(i), 0));
+        }
+    }
+
+    ChainIdSolver_Gravity::~ChainIdSolver_Gravity()
+    {
+    }
+
+    int ChainIdSolver_Gravity::JntToGravity(const JntArray& q, JntArray& gravity)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || gravity.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Sweep from root to leaf: gravity in the segment frames
+        for (unsigned int i = 0; i < ns; i++) {
+            X[i] = chain.getSegment(i).pose(q, chain.getQNr(i));
+            g[i] = X[i].M.Inverse(i == 0 ? grav : g[i - 1]);
+        }
+
+        //Sweep from leaf to root: first moment of the subchain, the
+        //wrench that holds it and its projection on the joint
+        SetToZero(gravity);
+        for (int i = ns - 1; i >= 0; i--) {
+            h[i] = mc[i];
+            if (i + 1 < (int)ns)
+                h[i] += X[i + 1].M * h[i + 1] + M[i + 1] * X[i + 1].p;
+            Wrench W(-M[i] * g[i], g[i] * h[i]);
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                gravity(q_nr) += dot(S[i], W);
+            else {
+                for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++)
+                    gravity(q_nr + d) += dot(X[i].M.Inverse(segment.unitTwist(q, q_nr, d)), W);
+            }
+        }
+        return (error = E_NOERROR);
+    }
+}
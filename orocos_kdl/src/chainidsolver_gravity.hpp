@@ -0,0 +1,84 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAIN_IDSOLVER_GRAVITY_HPP
+#define KDL_CHAIN_IDSOLVER_GRAVITY_HPP
+
+#include "chain.hpp"
+#include "jntarray.hpp"
+#include "solveri.hpp"
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the joint torques that compensate gravity in a
+     * KDL::Chain.
+     *
+     * Gravity only depends on the orientation of the segments and on
+     * the mass and first mass moment of the part of the chain beyond
+     * every joint. The masses of these subchains, the first moments of
+     * the segments and the unit twists of the single DOF joints (which
+     * are constant in the tip frame of their segment) are calculated at
+     * construction. At run time there is one evaluation of the segment
+     * pose per joint, a sweep from root to tip that rotates the gravity
+     * vector into every segment, and a sweep from tip to root that
+     * accumulates the first moments. No twists, accelerations or
+     * inertia products are involved.
+     *
+     * The result equals ChainDynParam::JntToGravity.
+     */
+    class ChainIdSolver_Gravity : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver
+         * \param chain The kinematic chain, an internal reference will be stored.
+         * \param grav The gravity vector to use during the calculation.
+         */
+        ChainIdSolver_Gravity(const Chain& chain, Vector grav);
+        virtual ~ChainIdSolver_Gravity();
+
+        /**
+         * Calculate the joint torques that compensate gravity.
+         *
+         * @param q input joint positions
+         * @param gravity output joint torques
+         * @return success/error code
+         */
+        int JntToGravity(const JntArray& q, JntArray& gravity);
+
+        void setGravity(const Vector& _grav) {grav = _grav;};
+        const Vector& getGravity() const {return grav;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        Vector grav;
+        //mass of segment i and all segments after it
+        std::vector<double> M;
+        //first mass moment of every segment in its own frame
+        std::vector<Vector> mc;
+        //unit twist of single DOF joints in the tip frame
+        std::vector<Twist> S;
+        std::vector<Frame> X;
+        std::vector<Vector> g;
+        std::vector<Vector> h;
+    };
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "chainidsolver_recursive_newton_euler.hpp"
 #include "frames_io.hpp"
+#include "tracing.hpp"
 
 namespace KDL{
 
@@ -43,40 +44,41 @@ namespace KDL{
 
     int ChainIdSolver_RNE::CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const Wrenches& f_ext,JntArray &torques)
     {
+        KDL_TRACE_SPAN("ChainIdSolver_RNE::CartToJnt");
         if(nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
             return (error = E_NOT_UP_TO_DATE);
 
         //Check sizes when in debug mode
         if(q.rows()!=nj || q_dot.rows()!=nj || q_dotdot.rows()!=nj || torques.rows()!=nj || f_ext.size()!=ns)
             return (error = E_SIZE_MISMATCH);
-        unsigned int j=0;
-
         //Sweep from root to leaf
         for(unsigned int i=0;i<ns;i++){
-            double q_,qdot_,qdotdot_;
-            if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                q_=q(j);
-                qdot_=q_dot(j);
-                qdotdot_=q_dotdot(j);
-                j++;
-            }else
-                q_=qdot_=qdotdot_=0.0;
+            const Segment& segment=chain.getSegment(i);
+            unsigned int j=chain.getQNr(i);
 
             //Calculate segment properties: X,S,vj,cj
-            X[i]=chain.getSegment(i).pose(q_);//Remark this is the inverse of the
-                                                //frame for transformations from
-                                                //the parent to the current coord frame
+            X[i]=segment.pose(q,j);//Remark this is the inverse of the
+                                   //frame for transformations from
+                                   //the parent to the current coord frame
             //Transform velocity and unit velocity to segment frame
-            Twist vj=X[i].M.Inverse(chain.getSegment(i).twist(q_,qdot_));
-            S[i]=X[i].M.Inverse(chain.getSegment(i).twist(q_,1.0));
-            //We can take cj=0, see remark section 3.5, page 55 since the unit velocity vector S of our joints is always time constant
+            Twist vj,aj;
+            if(segment.getJoint().getNrOfDofs()==1){
+                //We can take cj=0 for single axis joints, see remark section 3.5, page 55 since their unit velocity vector S is time constant
+                S[i]=X[i].M.Inverse(segment.unitTwist(q,j,0,X[i].M));
+                vj=S[i]*q_dot(j);
+                aj=S[i]*q_dotdot(j);
+            }else{
+                //multi-DOF joints add their velocity-product acceleration cj to the joint acceleration
+                vj=X[i].M.Inverse(segment.twist(q,q_dot,j,X[i].M));
+                aj=X[i].M.Inverse(segment.twist(q,q_dotdot,j,X[i].M)+segment.biasTwist(q,q_dot,j,X[i].M));
+            }
             //calculate velocity and acceleration of the segment (in segment coordinates)
             if(i==0){
                 v[i]=vj;
-                a[i]=X[i].Inverse(ag)+S[i]*qdotdot_+v[i]*vj;
+                a[i]=X[i].Inverse(ag)+aj+v[i]*vj;
             }else{
                 v[i]=X[i].Inverse(v[i-1])+vj;
-                a[i]=X[i].Inverse(a[i-1])+S[i]*qdotdot_+v[i]*vj;
+                a[i]=X[i].Inverse(a[i-1])+aj+v[i]*vj;
             }
             //Calculate the force for the joint
             //Collect RigidBodyInertia and external forces
@@ -84,13 +86,18 @@ namespace KDL{
             f[i]=Ii*a[i]+v[i]*(Ii*v[i])-f_ext[i];
 	    //std::cout << "a[i]=" << a[i] << "\n f[i]=" << f[i] << "\n S[i]" << S[i] << std::endl;
         }
-        //Sweep from leaf to root
-        j=nj-1;
+        //Sweep from leaf to root, coupled joints add their torque to the one of their coordinate
+        SetToZero(torques);
         for(int i=ns-1;i>=0;i--){
-            if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                torques(j)=dot(S[i],f[i]);
-                torques(j)+=chain.getSegment(i).getJoint().getInertia()*q_dotdot(j);  // add torque from joint inertia
-                --j;
+            const Segment& segment=chain.getSegment(i);
+            unsigned int j=chain.getQNr(i);
+            if(segment.getJoint().getNrOfDofs()==1) {
+                torques(j)+=dot(S[i],f[i]);
+                torques(j)+=segment.getJoint().getInertia()*q_dotdot(j);  // add torque from joint inertia
+            }else{
+                //one generalized force per DOF of a multi-DOF joint
+                for(unsigned int d=0;d<segment.getJoint().getNrOfDofs();d++)
+                    torques(j+d)=dot(X[i].M.Inverse(segment.unitTwist(q,j,d,X[i].M)),f[i]);
             }
             if(i!=0)
                 f[i-1]=f[i-1]+X[i]*f[i];
@@ -30,6 +30,7 @@
 
 #include "chainiksolverpos_lma.hpp"
 #include <iostream>
+#include "tracing.hpp"
 
 namespace KDL {
 
@@ -69,8 +70,9 @@ ChainIkSolverPos_LMA::ChainIkSolverPos_LMA(
 	eps(_eps),
 	eps_joints(_eps_joints),
 	L(_l.cast<ScalarType>()),
-	T_base_jointroot(nj),
-	T_base_jointtip(nj),
+	T_base_jointroot(nj+chain.getNrOfCoupledJoints()),
+	T_base_jointtip(nj+chain.getNrOfCoupledJoints()),
+	q_jnt(nj),
 	q(nj),
 	A(nj, nj),
 	tmp(nj),
@@ -101,8 +103,9 @@ ChainIkSolverPos_LMA::ChainIkSolverPos_LMA(
 	maxiter(_maxiter),
 	eps(_eps),
 	eps_joints(_eps_joints),
-	T_base_jointroot(nj),
-	T_base_jointtip(nj),
+	T_base_jointroot(nj+chain.getNrOfCoupledJoints()),
+	T_base_jointtip(nj+chain.getNrOfCoupledJoints()),
+	q_jnt(nj),
 	q(nj),
 	A(nj, nj),
 	ldlt(nj),
@@ -125,8 +128,9 @@ void ChainIkSolverPos_LMA::updateInternalDataStructures() {
     lastSV.conservativeResize(nj>6?6:nj);
     jac.conservativeResize(Eigen::NoChange, nj);
     grad.conservativeResize(nj);
-    T_base_jointroot.resize(nj);
-    T_base_jointtip.resize(nj);
+    T_base_jointroot.resize(nj+chain.getNrOfCoupledJoints());
+    T_base_jointtip.resize(nj+chain.getNrOfCoupledJoints());
+    q_jnt.resize(nj);
     q.conservativeResize(nj);
     A.conservativeResize(nj, nj);
     ldlt = Eigen::LDLT<MatrixXq>(nj);
@@ -142,11 +146,12 @@ void ChainIkSolverPos_LMA::compute_fwdpos(const VectorXq& q) {
 	using namespace KDL;
 	unsigned int jointndx=0;
 	T_base_head = Frame::Identity(); // frame w.r.t. base of head
+	q_jnt.data = q.cast<double>();
 	for (unsigned int i=0;i<chain.getNrOfSegments();i++) {
 		const Segment& segment = chain.getSegment(i);
         if (segment.getJoint().getType()!=Joint::Fixed) {
 			T_base_jointroot[jointndx] = T_base_head;
-			T_base_head = T_base_head * segment.pose(q(jointndx));
+			T_base_head = T_base_head * segment.pose(q_jnt,chain.getQNr(i));
 			T_base_jointtip[jointndx] = T_base_head;
 			jointndx++;
 		} else {
@@ -158,17 +163,23 @@ void ChainIkSolverPos_LMA::compute_fwdpos(const VectorXq& q) {
 void ChainIkSolverPos_LMA::compute_jacobian(const VectorXq& q) {
 	using namespace KDL;
 	unsigned int jointndx=0;
+	q_jnt.data = q.cast<double>();
+	jac.setZero();
 	for (unsigned int i=0;i<chain.getNrOfSegments();i++) {
 		const Segment& segment = chain.getSegment(i);
         if (segment.getJoint().getType()!=Joint::Fixed) {
 			// compute twist of the end effector motion caused by joint [jointndx]; expressed in base frame, with vel. ref. point equal to the end effector
-			KDL::Twist t = ( T_base_jointroot[jointndx].M * segment.twist(q(jointndx),1.0) ).RefPoint( T_base_head.p - T_base_jointtip[jointndx].p);
-			jac(0,jointndx)=t[0];
-			jac(1,jointndx)=t[1];
-			jac(2,jointndx)=t[2];
-			jac(3,jointndx)=t[3];
-			jac(4,jointndx)=t[4];
-			jac(5,jointndx)=t[5];
+			// coupled joints add their twist to the column of their coordinate, multi-DOF joints fill one column per DOF
+			for (unsigned int d=0;d<segment.getJoint().getNrOfDofs();d++) {
+				unsigned int q_nr = chain.getQNr(i)+d;
+				KDL::Twist t = ( T_base_jointroot[jointndx].M * segment.unitTwist(q_jnt,chain.getQNr(i),d) ).RefPoint( T_base_head.p - T_base_jointtip[jointndx].p);
+				jac(0,q_nr)+=t[0];
+				jac(1,q_nr)+=t[1];
+				jac(2,q_nr)+=t[2];
+				jac(3,q_nr)+=t[3];
+				jac(4,q_nr)+=t[4];
+				jac(5,q_nr)+=t[5];
+			}
 			jointndx++;
 		}
 	}
@@ -185,6 +196,7 @@ void ChainIkSolverPos_LMA::display_jac(const KDL::JntArray& jval) {
 
 
 int ChainIkSolverPos_LMA::CartToJnt(const KDL::JntArray& q_init, const KDL::Frame& T_base_goal, KDL::JntArray& q_out) {
+  KDL_TRACE_SPAN("ChainIkSolverPos_LMA::CartToJnt");
   if (nj != chain.getNrOfJoints())
     return (error = E_NOT_UP_TO_DATE);
 
@@ -228,6 +228,8 @@ private:
 					// need 2 vectors because of the somewhat strange definition of segment.hpp
 					// you could also recompute jointtip out of jointroot,
     				// but then you'll need more expensive cos/sin functions.
+    KDL::JntArray q_jnt;
+					// joint positions passed to the segments, read by multi-DOF joints
 
 
     // the following are state of CartToJnt that is pre-allocated:
@@ -0,0 +1,137 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainiksolverpos_masked.hpp"
+#include <algorithm>
+
+namespace KDL
+{
+    ChainIkSolverPos_Masked::ChainIkSolverPos_Masked(const Chain& _chain, const TaskMask& _mask,
+                                                     unsigned int _maxiter, double _eps, double _eps_svd):
+        chain(_chain), nj(chain.getNrOfJoints()), mask(_mask),
+        fksolver(_chain), jacsolver(_chain),
+        maxiter(_maxiter), eps(_eps), eps_svd(_eps_svd),
+        max_updates(0), nr_of_iterations(0), nr_of_jacobians(0)
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainIkSolverPos_Masked::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        fksolver.updateInternalDataStructures();
+        jacsolver.updateInternalDataStructures();
+        jac.resize(nj);
+        delta_q.resize(nj);
+        setTaskMask(mask);
+    }
+
+    void ChainIkSolverPos_Masked::setTaskMask(const TaskMask& _mask)
+    {
+        mask = _mask;
+        J.resize(mask.getNrOfRows(), nj);
+        e.resize(mask.getNrOfRows());
+        e_prev.resize(mask.getNrOfRows());
+        y.resize(mask.getNrOfRows());
+        tmp.resize(std::min(mask.getNrOfRows(), nj));
+        H.resize(nj, mask.getNrOfRows());
+        Hy.resize(nj);
+        svd = Eigen::JacobiSVD<Eigen::MatrixXd>(mask.getNrOfRows(), nj, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    }
+
+    int ChainIkSolverPos_Masked::CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out)
+    {
+        if (nj != chain.getNrOfJoints())
+            return (error = E_NOT_UP_TO_DATE);
+
+        if (q_init.rows() != nj || q_out.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        q_out = q_init;
+        bool singular = false;
+        bool exact = true;
+        unsigned int updates = 0;
+        nr_of_jacobians = 0;
+        for (nr_of_iterations = 0; nr_of_iterations < maxiter; nr_of_iterations++) {
+            if (E_NOERROR > fksolver.JntToCart(q_out, f))
+                return (error = E_FKSOLVERPOS_FAILED);
+            mask.selectError(f, p_in, e);
+            if (e.size() == 0 || e.cwiseAbs().maxCoeff() < eps)
+                return (error = (singular ? E_DEGRADED : E_NOERROR));
+
+            if (nr_of_iterations > 0 && !exact) {
+                //rank-one (Broyden) update of the inverse while the error keeps
+                //decreasing: H += (s - H*y)*y'/(y'*y), with y the change of the
+                //pose caused by the last step s
+                y = e_prev - e;
+                double yy = y.squaredNorm();
+                bool decreased = e.squaredNorm() < e_prev.squaredNorm();
+                if (updates < max_updates && yy > 0.0 && decreased) {
+                    Hy.noalias() = H * y;
+                    Hy = delta_q.data - Hy;
+                    H.noalias() += Hy * (y.transpose() / yy);
+                    updates++;
+                } else {
+                    if (!decreased && updates > 0) {
+                        //undo the step of the updated inverse, the exact
+                        //Jacobian is calculated where it started
+                        Subtract(q_out, delta_q, q_out);
+                        e = e_prev;
+                    }
+                    exact = true;
+                }
+            }
+            if (exact) {
+                if (E_NOERROR > jacsolver.JntToJac(q_out, jac))
+                    return (error = E_JACSOLVER_FAILED);
+                mask.selectJacobian(p_in, jac, J);
+                nr_of_jacobians++;
+
+                //H = V*S^-1*U', with the small singular values truncated
+                svd.compute(J);
+                singular = false;
+                for (int k = 0; k < tmp.size(); k++) {
+                    if (svd.singularValues()(k) > eps_svd)
+                        tmp(k) = 1.0 / svd.singularValues()(k);
+                    else {
+                        tmp(k) = 0.0;
+                        singular = true;
+                    }
+                }
+                H.noalias() = svd.matrixV() * tmp.asDiagonal() * svd.matrixU().transpose();
+                updates = 0;
+                exact = max_updates == 0;
+            }
+            delta_q.data.noalias() = H * e;
+            e_prev = e;
+            Add(q_out, delta_q, q_out);
+        }
+        return (error = E_MAX_ITERATIONS_EXCEEDED);
+    }
+
+    void ChainIkSolverPos_Masked::setBroydenUpdates(unsigned int _max_updates)
+    {
+        max_updates = _max_updates;
+    }
+
+    ChainIkSolverPos_Masked::~ChainIkSolverPos_Masked()
+    {
+    }
+
+    const char* ChainIkSolverPos_Masked::strError(const int error) const
+    {
+        if (E_JACSOLVER_FAILED == error) return "Child Jacobian solver failed";
+        else if (E_FKSOLVERPOS_FAILED == error) return "Child FK solver failed";
+        else return SolverI::strError(error);
+    }
+}
@@ -0,0 +1,137 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDLCHAINIKSOLVERPOS_MASKED_HPP
+#define KDLCHAINIKSOLVERPOS_MASKED_HPP
+
+#include "chainiksolver.hpp"
+#include "chainfksolverpos_recursive.hpp"
+#include "chainjnttojacsolver.hpp"
+#include "taskmask.hpp"
+#include <Eigen/Dense>
+
+namespace KDL {
+
+    /**
+     * Implementation of an inverse position kinematics algorithm based
+     * on Newton-Raphson iterations for tasks with less than six
+     * coordinates, e.g. position only or a free rotation about the
+     * tool axis (see KDL::TaskMask).
+     *
+     * Only the selected coordinates of the pose error are driven to
+     * zero. Every iteration solves the reduced problem with the
+     * selected rows of the Jacobian, using a truncated SVD of that
+     * smaller matrix.
+     *
+     * Optionally (see setBroydenUpdates) the pseudo-inverse of the
+     * Jacobian is only calculated every few iterations. In between it
+     * gets a rank-one Broyden update from the last step and the change
+     * of the pose error it caused, which avoids the Jacobian and the
+     * SVD. As soon as the error does not decrease, the exact
+     * pseudo-inverse is calculated again.
+     *
+     * @ingroup KinematicFamily
+     */
+    class ChainIkSolverPos_Masked : public ChainIkSolverPos
+    {
+    public:
+        static const int E_JACSOLVER_FAILED = -100; //! Child Jacobian solver failed
+        static const int E_FKSOLVERPOS_FAILED = -101; //! Child FK solver failed
+
+        /**
+         * Constructor of the solver.
+         *
+         * @param chain the chain to calculate the inverse position for
+         * @param mask the coordinates of the task
+         * @param maxiter the maximum Newton-Raphson iterations,
+         * default: 100
+         * @param eps the precision for the selected coordinates of the
+         * pose error, used to end the iterations, default: 1e-6
+         * @param eps_svd singular values below this value are
+         * truncated, default: 1e-9
+         */
+        ChainIkSolverPos_Masked(const Chain& chain, const TaskMask& mask=TaskMask(),
+                                unsigned int maxiter=100, double eps=1e-6, double eps_svd=1e-9);
+        ~ChainIkSolverPos_Masked();
+
+        /**
+         * Find an output joint pose \a q_out, given a starting joint pose
+         * \a q_init and a desired cartesian pose \a p_in, of which only
+         * the masked coordinates are used.
+         *
+         * @return:
+         *  E_NOERROR=solution converged to <eps in maxiter
+         *  E_DEGRADED=solution converged to <eps in maxiter, but singular
+         *  values of the reduced Jacobian were truncated
+         *  E_MAX_ITERATIONS_EXCEEDED=solution did not converge
+         */
+        virtual int CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out);
+
+        /**
+         * Change the coordinates of the task.
+         */
+        void setTaskMask(const TaskMask& mask);
+        const TaskMask& getTaskMask() const {return mask;};
+
+        /**
+         * Set the maximum number of Broyden updates between two
+         * calculations of the exact Jacobian, 0 (the default) calculates
+         * it in every iteration.
+         */
+        void setBroydenUpdates(unsigned int max_updates);
+        unsigned int getBroydenUpdates() const {return max_updates;};
+
+        /**
+         * Request the number of iterations of the last call of CartToJnt.
+         */
+        unsigned int getNrOfIterations() const {return nr_of_iterations;};
+        /**
+         * Request the number of exact Jacobians calculated in the last
+         * call of CartToJnt.
+         */
+        unsigned int getNrOfJacobians() const {return nr_of_jacobians;};
+
+        /// @copydoc KDL::SolverI::strError()
+        virtual const char* strError(const int error) const;
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Chain& chain;
+        unsigned int nj;
+        TaskMask mask;
+        ChainFkSolverPos_recursive fksolver;
+        ChainJntToJacSolver jacsolver;
+        Frame f;
+        Jacobian jac;
+        Eigen::MatrixXd J;
+        Eigen::VectorXd e;
+        Eigen::VectorXd e_prev;
+        Eigen::VectorXd y;
+        Eigen::VectorXd tmp;
+        //approximation of the pseudo-inverse of J
+        Eigen::MatrixXd H;
+        Eigen::VectorXd Hy;
+        Eigen::JacobiSVD<Eigen::MatrixXd> svd;
+        JntArray delta_q;
+        unsigned int maxiter;
+        double eps;
+        double eps_svd;
+        unsigned int max_updates;
+        unsigned int nr_of_iterations;
+        unsigned int nr_of_jacobians;
+    };
+}
+#endif
@@ -20,6 +20,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "chainiksolverpos_nr.hpp"
+#include "tracing.hpp"
 
 namespace KDL
 {
@@ -41,6 +42,7 @@ namespace KDL
 
     int ChainIkSolverPos_NR::CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out)
     {
+        KDL_TRACE_SPAN("ChainIkSolverPos_NR::CartToJnt");
         if (nj != chain.getNrOfJoints())
             return (error = E_NOT_UP_TO_DATE);
 
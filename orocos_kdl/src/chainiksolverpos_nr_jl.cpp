@@ -24,6 +24,7 @@
 #include "chainiksolverpos_nr_jl.hpp"
 
 #include <limits>
+#include "tracing.hpp"
 
 namespace KDL
 {
@@ -61,6 +62,7 @@ namespace KDL
 
     int ChainIkSolverPos_NR_JL::CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out)
     {
+        KDL_TRACE_SPAN("ChainIkSolverPos_NR_JL::CartToJnt");
         if(nj != chain.getNrOfJoints())
             return (error = E_NOT_UP_TO_DATE);
 
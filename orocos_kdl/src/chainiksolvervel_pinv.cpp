@@ -20,6 +20,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "chainiksolvervel_pinv.hpp"
+#include "tracing.hpp"
 
 namespace KDL
 {
@@ -61,6 +62,7 @@ namespace KDL
 
     int ChainIkSolverVel_pinv::CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out)
     {
+        KDL_TRACE_SPAN("ChainIkSolverVel_pinv::CartToJnt");
         if (nj != chain.getNrOfJoints())
             return (error = E_NOT_UP_TO_DATE);
 
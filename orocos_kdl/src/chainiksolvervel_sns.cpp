@@ -0,0 +1,234 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainiksolvervel_sns.hpp"
+#include "utilities/svd_eigen_HH.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace KDL
+{
+    ChainIkSolverVel_sns::ChainIkSolverVel_sns(const Chain& _chain, const JntArray& _q_min, const JntArray& _q_max,
+                                               const JntArray& _v_max, double _dt, double _eps, int _maxiter):
+        chain(_chain),
+        jnt2jac(chain),
+        nj(chain.getNrOfJoints()),
+        q_min(_q_min),
+        q_max(_q_max),
+        v_max(_v_max),
+        dt(_dt),
+        eps(_eps),
+        maxiter(_maxiter),
+        svdResult(0),
+        scale(1.0),
+        nr_of_saturated(0)
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainIkSolverVel_sns::updateInternalDataStructures() {
+        jnt2jac.updateInternalDataStructures();
+        nj = chain.getNrOfJoints();
+        jac.resize(nj);
+        JW = Eigen::MatrixXd::Zero(6,nj);
+        U = Eigen::MatrixXd::Zero(6,nj);
+        S = Eigen::VectorXd::Zero(nj);
+        V = Eigen::MatrixXd::Zero(nj,nj);
+        tmp = Eigen::VectorXd::Zero(nj);
+        lower = Eigen::VectorXd::Zero(nj);
+        upper = Eigen::VectorXd::Zero(nj);
+        a = Eigen::VectorXd::Zero(nj);
+        b = Eigen::VectorXd::Zero(nj);
+        w = Eigen::VectorXd::Ones(nj);
+        qdot_sat = Eigen::VectorXd::Zero(nj);
+        w_best = Eigen::VectorXd::Ones(nj);
+        qdot_sat_best = Eigen::VectorXd::Zero(nj);
+    }
+
+    ChainIkSolverVel_sns::~ChainIkSolverVel_sns()
+    {
+    }
+
+    int ChainIkSolverVel_sns::setJointLimits(const JntArray& _q_min, const JntArray& _q_max)
+    {
+        if (nj != _q_min.rows() || nj != _q_max.rows())
+            return (error = E_SIZE_MISMATCH);
+        q_min = _q_min;
+        q_max = _q_max;
+        return (error = E_NOERROR);
+    }
+
+    int ChainIkSolverVel_sns::setVelocityLimits(const JntArray& _v_max)
+    {
+        if (nj != _v_max.rows())
+            return (error = E_SIZE_MISMATCH);
+        v_max = _v_max;
+        return (error = E_NOERROR);
+    }
+
+    int ChainIkSolverVel_sns::solve()
+    {
+        JW.noalias() = jac.data * w.asDiagonal();
+        svdResult = svd_eigen_HH(JW,U,S,V,tmp,maxiter);
+        if (0 != svdResult)
+            return -1;
+        int rank = 0;
+        for (unsigned int i = 0; i < nj; ++i)
+            if (fabs(S(i)) >= eps)
+                rank++;
+
+        // a = V*S_pinv*Ut*x
+        for (unsigned int i = 0; i < nj; ++i)
+            tmp(i) = fabs(S(i)) < eps ? 0.0 : U.col(i).dot(x) / S(i);
+        a.noalias() = V * tmp;
+
+        // b = qdot_sat - V*S_pinv*Ut*J*qdot_sat
+        x_tmp.noalias() = jac.data * qdot_sat;
+        for (unsigned int i = 0; i < nj; ++i)
+            tmp(i) = fabs(S(i)) < eps ? 0.0 : U.col(i).dot(x_tmp) / S(i);
+        b = qdot_sat;
+        b.noalias() -= V * tmp;
+        return rank;
+    }
+
+    double ChainIkSolverVel_sns::taskScale(unsigned int& critical) const
+    {
+        double s_min = 0.0;
+        double s_max = 1.0;
+        double violation = 0.0;
+        critical = nj;
+        for (unsigned int i = 0; i < nj; ++i) {
+            if (w(i) == 0.0)
+                continue;
+            if (fabs(a(i)) > 1e-12) {
+                double lo = (lower(i) - b(i)) / a(i);
+                double hi = (upper(i) - b(i)) / a(i);
+                if (a(i) < 0.0)
+                    std::swap(lo, hi);
+                s_min = std::max(s_min, lo);
+                if (hi < s_max) {
+                    s_max = hi;
+                    critical = i;
+                }
+            } else if (b(i) < lower(i) || b(i) > upper(i))
+                //no scale brings this joint within its bounds
+                s_min = std::numeric_limits<double>::infinity();
+        }
+        if (critical == nj) {
+            //no joint limits the scale below one, the violation is
+            //caused by the saturated joints, take the worst joint
+            for (unsigned int i = 0; i < nj; ++i) {
+                if (w(i) == 0.0)
+                    continue;
+                double qdot = a(i) + b(i);
+                double v = std::max(lower(i) - qdot, qdot - upper(i));
+                if (v > violation) {
+                    violation = v;
+                    critical = i;
+                }
+            }
+        }
+        if (s_min > s_max)
+            return 0.0;
+        return s_max;
+    }
+
+    int ChainIkSolverVel_sns::CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out)
+    {
+        if (nj != chain.getNrOfJoints())
+            return (error = E_NOT_UP_TO_DATE);
+
+        if (nj != q_in.rows() || nj != qdot_out.rows() || nj != q_min.rows() || nj != q_max.rows() || nj != v_max.rows())
+            return (error = E_SIZE_MISMATCH);
+
+        error = jnt2jac.JntToJac(q_in,jac);
+        if (error < E_NOERROR) return error;
+
+        //The bounds on the joint velocities: the velocity limit, and
+        //not passing the position limit within one time step. A joint
+        //outside its position range moves back at full speed.
+        for (unsigned int i = 0; i < nj; ++i) {
+            lower(i) = std::max(-v_max(i), (q_min(i) - q_in(i)) / dt);
+            upper(i) = std::min(v_max(i), (q_max(i) - q_in(i)) / dt);
+            if (lower(i) > upper(i)) {
+                if (q_in(i) > q_max(i))
+                    upper(i) = lower(i);
+                else
+                    lower(i) = upper(i);
+            }
+        }
+        for (unsigned int i = 0; i < 6; ++i)
+            x(i) = v_in(i);
+
+        w.setOnes();
+        qdot_sat.setZero();
+        double scale_best = 0.0;
+        w_best.setOnes();
+        qdot_sat_best.setZero();
+        int rank_task = 0;
+        nr_of_saturated = 0;
+        //every iteration saturates one more joint
+        for (unsigned int iter = 0; iter <= nj; ++iter) {
+            int rank = solve();
+            if (rank < 0) {
+                qdot_out.data.setZero();
+                return (error = E_SVD_FAILED);
+            }
+            if (iter == 0)
+                rank_task = rank;
+            else if (rank < rank_task)
+                //the free joints can not realize the task anymore
+                break;
+            qdot_out.data = a + b;
+            bool within_bounds = true;
+            for (unsigned int i = 0; i < nj && within_bounds; ++i)
+                within_bounds = qdot_out(i) >= lower(i) - 1e-12 && qdot_out(i) <= upper(i) + 1e-12;
+            if (within_bounds) {
+                scale = 1.0;
+                return (error = E_NOERROR);
+            }
+
+            unsigned int critical;
+            double s = taskScale(critical);
+            if (s > scale_best) {
+                scale_best = s;
+                w_best = w;
+                qdot_sat_best = qdot_sat;
+            }
+            if (critical == nj)
+                break;
+            w(critical) = 0.0;
+            qdot_sat(critical) = qdot_out(critical) > upper(critical) ? upper(critical) : lower(critical);
+            nr_of_saturated++;
+        }
+
+        //scale the task down with the best set of saturated joints
+        w = w_best;
+        qdot_sat = qdot_sat_best;
+        if (solve() < 0) {
+            qdot_out.data.setZero();
+            return (error = E_SVD_FAILED);
+        }
+        scale = scale_best;
+        nr_of_saturated = 0;
+        for (unsigned int i = 0; i < nj; ++i) {
+            if (w(i) == 0.0)
+                nr_of_saturated++;
+            //only has an effect if no scale was feasible
+            qdot_out(i) = std::min(std::max(b(i) + scale * a(i), lower(i)), upper(i));
+        }
+        return (error = E_DEGRADED);
+    }
+}
@@ -0,0 +1,167 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAIN_IKSOLVERVEL_SNS_HPP
+#define KDL_CHAIN_IKSOLVERVEL_SNS_HPP
+
+#include "chainiksolver.hpp"
+#include "chainjnttojacsolver.hpp"
+#include <Eigen/Core>
+
+namespace KDL
+{
+    /**
+     * Implementation of an inverse velocity kinematics algorithm that
+     * respects joint velocity and joint position limits by saturation
+     * in the null space (SNS):
+     *
+     * F. Flacco, A. De Luca, O. Khatib. Motion control of redundant
+     * robots under joint constraints: Saturation in the null space.
+     * IEEE International Conference on Robotics and Automation, 2012
+     *
+     * The pseudo-inverse solution is calculated, and as long as a joint
+     * violates its bounds, the most critical joint is fixed at the bound
+     * it violates and the task is solved again with the remaining
+     * joints. If the remaining joints can not realize the full task
+     * velocity anymore, the task velocity is scaled down along its
+     * direction, using the scale factor of the best set of saturated
+     * joints that was found. Unlike scaling the whole joint velocity
+     * vector, this keeps the joints that are not limited at full
+     * speed.
+     *
+     * The bounds of a joint velocity are the velocity limit and the
+     * velocity that reaches the position limit in one time step. Every
+     * iteration saturates one joint, so there are at most nj+1
+     * iterations, and no memory is allocated in CartToJnt.
+     *
+     * @ingroup KinematicFamily
+     */
+    class ChainIkSolverVel_sns : public ChainIkSolverVel
+    {
+    public:
+        /**
+         * Constructor of the solver
+         *
+         * @param chain the chain to calculate the inverse velocity
+         * kinematics for
+         * @param q_min the lower joint position limits
+         * @param q_max the upper joint position limits
+         * @param v_max the (symmetric) joint velocity limits
+         * @param dt the time step used to turn the distance to the
+         * position limits into velocity bounds
+         * @param eps if a singular value is below this value, its
+         * inverse is set to zero, default: 0.00001
+         * @param maxiter maximum iterations for the svd calculation,
+         * default: 150
+         */
+        ChainIkSolverVel_sns(const Chain& chain, const JntArray& q_min, const JntArray& q_max,
+                             const JntArray& v_max, double dt, double eps=0.00001, int maxiter=150);
+        ~ChainIkSolverVel_sns();
+
+        /**
+         * Find the joint velocities within the bounds that realize the
+         * largest fraction of v_in.
+         *
+         * @return E_NOERROR if the full twist is realized, E_DEGRADED
+         * if it had to be scaled down (see getTaskScale)
+         */
+        virtual int CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out);
+        /**
+         * not (yet) implemented.
+         *
+         */
+        virtual int CartToJnt(const JntArray& /*q_init*/, const FrameVel& /*v_in*/, JntArrayVel& /*q_out*/){return (error = E_NOT_IMPLEMENTED);};
+
+        /**
+         * Set the joint position limits
+         */
+        int setJointLimits(const JntArray& q_min, const JntArray& q_max);
+        /**
+         * Set the joint velocity limits
+         */
+        int setVelocityLimits(const JntArray& v_max);
+        /**
+         * Set the time step used to turn the position limits into
+         * velocity bounds
+         */
+        void setTimeStep(double _dt) {dt = _dt;};
+
+        /**
+         * Request the fraction of the twist that was realized in the
+         * last call of CartToJnt.
+         */
+        double getTaskScale() const {return scale;};
+        /**
+         * Request the number of joints that were saturated in the last
+         * call of CartToJnt.
+         */
+        unsigned int getNrOfSaturatedJoints() const {return nr_of_saturated;};
+        /**
+         * Retrieve the latest return code from the SVD algorithm
+         * @return 0 if CartToJnt() not yet called, otherwise latest SVD result code.
+         */
+        int getSVDResult() const {return svdResult;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Chain& chain;
+        ChainJntToJacSolver jnt2jac;
+        unsigned int nj;
+        Jacobian jac;
+        Eigen::MatrixXd JW;
+        Eigen::MatrixXd U;
+        Eigen::VectorXd S;
+        Eigen::MatrixXd V;
+        Eigen::VectorXd tmp;
+        Eigen::Matrix<double,6,1> x;
+        Eigen::Matrix<double,6,1> x_tmp;
+        Eigen::VectorXd lower;
+        Eigen::VectorXd upper;
+        //the contribution of the task and of the saturated joints to
+        //the joint velocities
+        Eigen::VectorXd a;
+        Eigen::VectorXd b;
+        //weights (1 free, 0 saturated) and velocities of the saturated
+        //joints, and the best ones found so far
+        Eigen::VectorXd w;
+        Eigen::VectorXd qdot_sat;
+        Eigen::VectorXd w_best;
+        Eigen::VectorXd qdot_sat_best;
+        JntArray q_min;
+        JntArray q_max;
+        JntArray v_max;
+        double dt;
+        double eps;
+        int maxiter;
+        int svdResult;
+        double scale;
+        unsigned int nr_of_saturated;
+
+        /**
+         * a = pinv(J*W)*x and b = qdot_sat - pinv(J*W)*J*qdot_sat, for
+         * the current weights.
+         *
+         * @return the rank of J*W, or -1 if the svd failed
+         */
+        int solve();
+        /**
+         * The largest scale s <= 1 for which b + s*a is within the
+         * bounds, and the joint that limits it.
+         */
+        double taskScale(unsigned int& critical) const;
+    };
+}
+#endif
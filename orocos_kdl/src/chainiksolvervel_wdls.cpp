@@ -21,6 +21,7 @@
 
 #include "chainiksolvervel_wdls.hpp"
 #include "utilities/svd_eigen_HH.hpp"
+#include "tracing.hpp"
 
 namespace KDL
 {
@@ -115,6 +116,7 @@ namespace KDL
 
     int ChainIkSolverVel_wdls::CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out)
     {
+        KDL_TRACE_SPAN("ChainIkSolverVel_wdls::CartToJnt");
         if(nj != chain.getNrOfJoints())
             return (error = E_NOT_UP_TO_DATE);
 
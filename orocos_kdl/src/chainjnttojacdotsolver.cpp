@@ -80,6 +80,9 @@ int ChainJntToJacDotSolver::JntToJacDot(const JntArrayVel& q_in, Jacobian& jdot,
         return (error = E_SIZE_MISMATCH);
     else if(segmentNr>chain.getNrOfSegments())
         return (error = E_OUT_OF_RANGE);
+    //The partial derivatives below assume one twist per jacobian column
+    else if(chain.getNrOfCoupledJoints()!=0 || chain.getNrOfMultiDofJoints()!=0)
+        return (error = E_NOT_IMPLEMENTED);
 
     // First compute the jacobian in the Hybrid representation
     if (jac_solver_.JntToJac(q_in.q,jac_,segmentNr) != E_NOERROR)
@@ -20,16 +20,32 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "chainjnttojacsolver.hpp"
+#include "tracing.hpp"
 
 namespace KDL
 {
     ChainJntToJacSolver::ChainJntToJacSolver(const Chain& _chain):
-        chain(_chain),locked_joints_(chain.getNrOfJoints(),false)
+        chain(_chain),locked_joints_(chain.getNrOfJoints(),false),
+        columns_(chain.getNrOfJoints())
     {
+        updateColumns();
     }
 
     void ChainJntToJacSolver::updateInternalDataStructures() {
         locked_joints_.resize(chain.getNrOfJoints(),false);
+        columns_.resize(chain.getNrOfJoints());
+        updateColumns();
+    }
+
+    void ChainJntToJacSolver::updateColumns()
+    {
+        //locked joints are left out, the remaining columns are packed
+        unsigned int k=0;
+        for(unsigned int j=0;j<columns_.size();j++){
+            columns_[j]=k;
+            if(!locked_joints_[j])
+                k++;
+        }
     }
     ChainJntToJacSolver::~ChainJntToJacSolver()
     {
@@ -42,11 +58,13 @@ namespace KDL
         if(locked_joints.size()!=locked_joints_.size())
             return (error = E_SIZE_MISMATCH);
         locked_joints_=locked_joints;
+        updateColumns();
         return (error = E_NOERROR);
     }
 
     int ChainJntToJacSolver::JntToJac(const JntArray& q_in, Jacobian& jac, int seg_nr)
     {
+        KDL_TRACE_SPAN("ChainJntToJacSolver::JntToJac");
         if(locked_joints_.size() != chain.getNrOfJoints())
             return (error = E_NOT_UP_TO_DATE);
         unsigned int segmentNr;
@@ -65,32 +83,27 @@ namespace KDL
 
         T_tmp = Frame::Identity();
         SetToZero(t_tmp);
-        int j=0;
-        int k=0;
-        Frame total;
+        Frame total, local;
         for (unsigned int i=0;i<segmentNr;i++) {
+            const Segment& segment=chain.getSegment(i);
+            unsigned int j=chain.getQNr(i);
             //Calculate new Frame_base_ee
-            if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-            	//pose of the new end-point expressed in the base
-                total = T_tmp*chain.getSegment(i).pose(q_in(j));
-                //changing base of new segment's twist to base frame if it is not locked
-                //t_tmp = T_tmp.M*chain.getSegment(i).twist(1.0);
-                if(!locked_joints_[j])
-                    t_tmp = T_tmp.M*chain.getSegment(i).twist(q_in(j),1.0);
-            }else{
-                total = T_tmp*chain.getSegment(i).pose(0.0);
-
-            }
+            //pose of the new end-point expressed in the base
+            local = segment.pose(q_in,j);
+            total = T_tmp*local;
 
             //Changing Refpoint of all columns to new ee
             changeRefPoint(jac,total.p-T_tmp.p,jac);
 
-            //Only increase jointnr if the segment has a joint
-            if(chain.getSegment(i).getJoint().getType()!=Joint::Fixed) {
-                //Only put the twist inside if it is not locked
-                if(!locked_joints_[j])
-                    jac.setColumn(k++,t_tmp);
-                j++;
+            //Only put the twist inside if the joint is not locked, changing
+            //base of the segment's twist to base frame. A multi-DOF joint
+            //fills one column per DOF, coupled segments add their twist
+            //to the column of their coordinate
+            for (unsigned int d=0;d<segment.getJoint().getNrOfDofs();d++) {
+                if(!locked_joints_[j+d]) {
+                    t_tmp = T_tmp.M*segment.unitTwist(q_in,j,d,local.M);
+                    jac.setColumn(columns_[j+d],jac.getColumn(columns_[j+d])+t_tmp);
+                }
             }
 
             T_tmp = total;
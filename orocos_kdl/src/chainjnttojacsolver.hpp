@@ -65,10 +65,14 @@ namespace KDL
         virtual void updateInternalDataStructures();
 
     private:
+        ///Helper function to map each joint coordinate to its jacobian column
+        void updateColumns();
+
         const Chain& chain;
         Twist t_tmp;
         Frame T_tmp;
         std::vector<bool> locked_joints_;
+        std::vector<unsigned int> columns_;
     };
 }
 #endif
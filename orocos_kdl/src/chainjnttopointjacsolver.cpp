@@ -0,0 +1,116 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainjnttopointjacsolver.hpp"
+#include <algorithm>
+
+namespace KDL
+{
+    ChainJntToPointJacSolver::ChainJntToPointJacSolver(const Chain& _chain):
+        chain(_chain)
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainJntToPointJacSolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        T.resize(ns+1);
+        offsets.resize(ns+1);
+        offsets[0] = 0;
+        for (unsigned int i = 0; i < ns; i++)
+            offsets[i+1] = offsets[i] + chain.getSegment(i).getJoint().getNrOfDofs();
+        S.resize(offsets[ns]);
+    }
+
+    ChainJntToPointJacSolver::~ChainJntToPointJacSolver()
+    {
+    }
+
+    int ChainJntToPointJacSolver::sweep(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q_in.rows() != nj || seg_nrs.size() != points.size())
+            return (error = E_SIZE_MISMATCH);
+        unsigned int last = 0;
+        for (unsigned int k = 0; k < seg_nrs.size(); k++) {
+            if (seg_nrs[k] > ns)
+                return (error = E_OUT_OF_RANGE);
+            last = std::max(last, seg_nrs[k]);
+        }
+        //only the segments up to the last requested one are needed
+        T[0] = Frame::Identity();
+        for (unsigned int i = 0; i < last; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            Frame X = segment.pose(q_in, q_nr);
+            T[i+1] = T[i] * X;
+            for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++)
+                S[offsets[i]+d] = T[i+1] * X.M.Inverse(segment.unitTwist(q_in, q_nr, d));
+        }
+        p.resize(points.size());
+        for (unsigned int k = 0; k < points.size(); k++)
+            p[k] = T[seg_nrs[k]] * points[k];
+        return (error = E_NOERROR);
+    }
+
+    int ChainJntToPointJacSolver::JntToJac(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points, std::vector<Jacobian>& jacs)
+    {
+        if (jacs.size() != points.size())
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int k = 0; k < jacs.size(); k++)
+            if (jacs[k].columns() != chain.getNrOfJoints())
+                return (error = E_SIZE_MISMATCH);
+        if (sweep(q_in, seg_nrs, points))
+            return error;
+        for (unsigned int k = 0; k < jacs.size(); k++) {
+            SetToZero(jacs[k]);
+            for (unsigned int i = 0; i < seg_nrs[k]; i++) {
+                unsigned int q_nr = chain.getQNr(i);
+                //coupled joints add to the column of their coordinate
+                for (unsigned int d = offsets[i]; d < offsets[i+1]; d++)
+                    jacs[k].setColumn(q_nr + d - offsets[i], jacs[k].getColumn(q_nr + d - offsets[i]) + S[d].RefPoint(p[k]));
+            }
+        }
+        return (error = E_NOERROR);
+    }
+
+    int ChainJntToPointJacSolver::JntToJac(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points, Eigen::MatrixXd& jac)
+    {
+        unsigned int rows;
+        if (jac.rows() == (int)(6*points.size()))
+            rows = 6;
+        else if (jac.rows() == (int)(3*points.size()))
+            rows = 3;
+        else
+            return (error = E_SIZE_MISMATCH);
+        if (jac.cols() != (int)chain.getNrOfJoints())
+            return (error = E_SIZE_MISMATCH);
+        if (sweep(q_in, seg_nrs, points))
+            return error;
+        jac.setZero();
+        for (unsigned int k = 0; k < points.size(); k++) {
+            for (unsigned int i = 0; i < seg_nrs[k]; i++) {
+                unsigned int q_nr = chain.getQNr(i);
+                for (unsigned int d = offsets[i]; d < offsets[i+1]; d++) {
+                    Twist t = S[d].RefPoint(p[k]);
+                    for (unsigned int r = 0; r < rows; r++)
+                        jac(rows*k + r, q_nr + d - offsets[i]) += t(r);
+                }
+            }
+        }
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,88 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINJNTTOPOINTJACSOLVER_HPP
+#define KDL_CHAINJNTTOPOINTJACSOLVER_HPP
+
+#include "solveri.hpp"
+#include "frames.hpp"
+#include "jacobian.hpp"
+#include "jntarray.hpp"
+#include "chain.hpp"
+
+namespace KDL
+{
+    /**
+     * @brief Class to calculate the jacobians of a set of points fixed
+     * to the segments of a general KDL::Chain, e.g. contact points.
+     *
+     * The frames and the joint twists of the chain are calculated in a
+     * single sweep and shared by all points, the columns of every point
+     * are the joint twists with their reference point moved to the
+     * point.
+     */
+    class ChainJntToPointJacSolver : public SolverI
+    {
+    public:
+
+        explicit ChainJntToPointJacSolver(const Chain& chain);
+        virtual ~ChainJntToPointJacSolver();
+
+        /**
+         * Calculate the jacobians of a set of points, expressed in the
+         * base frame of the chain with reference point at the point.
+         *
+         * @param q_in input joint positions
+         * @param seg_nrs per point the segment it is fixed to, the point
+         * moves with the tip frame of segment seg_nr-1, 0 is the base
+         * (as the segmentNr of the forward kinematic solvers)
+         * @param points per point its position in that tip frame
+         * @param jacs output jacobian per point
+         * @return success/error code
+         */
+        int JntToJac(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points, std::vector<Jacobian>& jacs);
+
+        /**
+         * Calculate the jacobians of a set of points stacked in one
+         * matrix, with 6 rows (velocity and rotational velocity) per
+         * point, or only the 3 velocity rows per point.
+         *
+         * @param q_in input joint positions
+         * @param seg_nrs per point the segment it is fixed to
+         * @param points per point its position in the tip frame of the segment
+         * @param jac output matrix of 6 or 3 times the number of points rows
+         * @return success/error code
+         */
+        int JntToJac(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points, Eigen::MatrixXd& jac);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function to calculate the frames, the joint twists and the points in the base frame
+        int sweep(const JntArray& q_in, const std::vector<unsigned int>& seg_nrs, const std::vector<Vector>& points);
+
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        //tip frames, T[0] is the base
+        std::vector<Frame> T;
+        //unit twists of all DOFs in the base frame with reference point
+        //in the base origin, those of segment i start at offsets[i]
+        std::vector<Twist> S;
+        std::vector<unsigned int> offsets;
+        std::vector<Vector> p;
+    };
+}
+#endif
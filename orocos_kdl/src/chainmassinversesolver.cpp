@@ -0,0 +1,104 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "chainmassinversesolver.hpp"
+
+namespace KDL
+{
+    ChainMassInverseSolver::ChainMassInverseSolver(const Chain& _chain):
+        chain(_chain), nj(chain.getNrOfJoints()), ns(chain.getNrOfSegments())
+    {
+        updateInternalDataStructures();
+    }
+
+    void ChainMassInverseSolver::updateInternalDataStructures() {
+        nj = chain.getNrOfJoints();
+        ns = chain.getNrOfSegments();
+        //every joint has to be the only one that moves its DOF
+        unsigned int k = 0;
+        supported = true;
+        for (unsigned int i = 0; i < ns; i++) {
+            unsigned int dofs = chain.getSegment(i).getJoint().getNrOfDofs();
+            if (dofs > 1 || (dofs == 1 && chain.getQNr(i) != k++))
+                supported = false;
+        }
+        supported = supported && k == nj;
+        I.resize(ns);
+        S.resize(nj);
+        U.resize(nj);
+        D.resize(nj);
+        F.resize(6, nj);
+    }
+
+    ChainMassInverseSolver::~ChainMassInverseSolver()
+    {
+    }
+
+    int ChainMassInverseSolver::JntToMassInverse(const JntArray& q, JntSpaceInertiaMatrix& H_inv)
+    {
+        if (nj != chain.getNrOfJoints() || ns != chain.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || H_inv.rows() != nj || H_inv.columns() != nj)
+            return (error = E_SIZE_MISMATCH);
+        if (!supported)
+            return (error = E_NOT_IMPLEMENTED);
+
+        //Sweep from root to tip: inertias and unit twists in the base frame
+        Frame T = Frame::Identity();
+        unsigned int k = 0;
+        for (unsigned int i = 0; i < ns; i++) {
+            const Segment& segment = chain.getSegment(i);
+            unsigned int q_nr = chain.getQNr(i);
+            Frame X = segment.pose(q, q_nr);
+            T = T * X;
+            if (segment.getJoint().getNrOfDofs() == 1)
+                S[k++] = toVector(T * X.M.Inverse(segment.unitTwist(q, q_nr, 0)));
+            inertiaMatrix(T * segment.getInertia(), I[i]);
+        }
+
+        //Sweep from tip to root: the articulated inertias and the rows
+        //of the inverse right of the diagonal, with only the forces of
+        //the unit torques beyond the joint
+        Eigen::MatrixXd& M = H_inv.data;
+        M.setZero();
+        IA.setZero();
+        F.setZero();
+        for (int i = ns - 1; i >= 0; i--) {
+            IA += I[i];
+            const Joint& joint = chain.getSegment(i).getJoint();
+            if (joint.getNrOfDofs() == 0)
+                continue;
+            k--;
+            U[k].noalias() = IA * S[k];
+            D[k] = S[k].dot(U[k]) + joint.getInertia();
+            unsigned int n = nj - k;
+            M(k, k) = 1.0 / D[k];
+            M.row(k).tail(n - 1).noalias() = -S[k].transpose() * F.rightCols(n - 1) / D[k];
+            F.rightCols(n).noalias() += U[k] * M.row(k).tail(n);
+            IA.noalias() -= U[k] * U[k].transpose() / D[k];
+        }
+
+        //Sweep from root to tip: correct the rows for the acceleration
+        //of the preceding joints, F now holds the accelerations
+        F.setZero();
+        for (k = 0; k < nj; k++) {
+            unsigned int n = nj - k;
+            M.row(k).tail(n).noalias() -= U[k].transpose() * F.rightCols(n) / D[k];
+            F.rightCols(n).noalias() += S[k] * M.row(k).tail(n);
+        }
+        for (k = 1; k < nj; k++)
+            M.row(k).head(k) = M.col(k).head(k).transpose();
+        return (error = E_NOERROR);
+    }
+}
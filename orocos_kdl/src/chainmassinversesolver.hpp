@@ -0,0 +1,84 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CHAINMASSINVERSESOLVER_HPP
+#define KDL_CHAINMASSINVERSESOLVER_HPP
+
+#include "chain.hpp"
+#include "jntarray.hpp"
+#include "jntspaceinertiamatrix.hpp"
+#include "solveri.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <Eigen/StdVector>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the inverse of the joint space inertia matrix of
+     * a KDL::Chain.
+     *
+     * The inverse is calculated directly, without forming the mass
+     * matrix, by running the articulated-body algorithm for all unit
+     * torques at once:
+     *
+     * J. Carpentier, N. Mansard. Analytical derivatives of rigid body
+     * dynamics algorithms. Robotics: Science and Systems, 2018
+     *
+     * The sweep from tip to root calculates the articulated inertias
+     * and the upper triangle of the inverse below the diagonal blocks,
+     * the sweep from root to tip propagates the accelerations of the
+     * unit torques. Both are O(n^2). All quantities are expressed in
+     * the base frame.
+     *
+     * Only chains of single DOF joints without coupled joints are
+     * supported.
+     */
+    class ChainMassInverseSolver : public SolverI
+    {
+    public:
+        explicit ChainMassInverseSolver(const Chain& chain);
+        virtual ~ChainMassInverseSolver();
+
+        /**
+         * Calculate the inverse of the joint space inertia matrix.
+         *
+         * @param q input joint positions
+         * @param H_inv output inverse of the mass matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF
+         * or coupled joints
+         */
+        int JntToMassInverse(const JntArray& q, JntSpaceInertiaMatrix& H_inv);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Chain& chain;
+        unsigned int nj;
+        unsigned int ns;
+        bool supported;
+        //inertias of the segments and unit twists of the joints
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > I;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S;
+        //articulated inertia times the unit twist, and its projection
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > U;
+        std::vector<double> D;
+        Matrix6d IA;
+        //forces (tip to root) and accelerations (root to tip) caused by
+        //the unit torques, one column per joint
+        Eigen::Matrix<double, 6, Eigen::Dynamic> F;
+    };
+}
+
+#endif
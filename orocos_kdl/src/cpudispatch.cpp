@@ -0,0 +1,152 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "cpudispatch.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef KDL_CPU_DISPATCH_X86
+#include <cpuid.h>
+#endif
+
+namespace KDL {
+
+    namespace {
+
+        const char* const level_names[CPU_NR_OF_LEVELS] = {"scalar", "sse4.2", "avx2", "avx512"};
+
+#ifdef KDL_CPU_DISPATCH_X86
+        unsigned long long xgetbv()
+        {
+            unsigned int eax, edx;
+            __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return ((unsigned long long)edx << 32) | eax;
+        }
+
+        CpuLevel detect()
+        {
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_2))
+                return CPU_SCALAR;
+            // the AVX registers have to be saved by the operating system
+            const bool osxsave = (ecx & bit_OSXSAVE) && (ecx & bit_AVX);
+            const bool fma = ecx & bit_FMA;
+            if (!osxsave || !fma || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+                return CPU_SSE4_2;
+            const unsigned long long xcr0 = xgetbv();
+            if ((xcr0 & 0x6) != 0x6 || !(ebx & bit_AVX2))
+                return CPU_SSE4_2;
+            const unsigned int avx512 = bit_AVX512F | bit_AVX512DQ | bit_AVX512VL;
+            if ((xcr0 & 0xe6) != 0xe6 || (ebx & avx512) != avx512)
+                return CPU_AVX2;
+            return CPU_AVX512;
+        }
+#else
+        CpuLevel detect()
+        {
+            return CPU_SCALAR;
+        }
+#endif
+
+        struct Dispatch {
+            CpuLevel supported;
+            std::atomic<int> level;
+            std::atomic<bool> check;
+            std::atomic<unsigned long> mismatches;
+
+            Dispatch():
+                supported(detect()), level(supported), check(false), mismatches(0)
+            {
+                const char* env = getenv("KDL_CPU_DISPATCH");
+                if (env == 0)
+                    return;
+                std::istringstream is(env);
+                std::string token;
+                while (std::getline(is, token, ',')) {
+                    if (token == "check") {
+                        check = true;
+                        continue;
+                    }
+                    unsigned int i = 0;
+                    while (i < CPU_NR_OF_LEVELS && token != level_names[i])
+                        i++;
+                    if (i == CPU_NR_OF_LEVELS)
+                        std::cerr << "KDL_CPU_DISPATCH: ignoring unknown value '" << token << "'" << std::endl;
+                    else if (i < (unsigned int)supported)
+                        level = i;
+                }
+            }
+        };
+
+        Dispatch& dispatch()
+        {
+            static Dispatch instance;
+            return instance;
+        }
+
+        // select the level when the library is loaded instead of in the first kernel call
+        const Dispatch& loaded = dispatch();
+    }
+
+    CpuLevel GetSupportedCpuLevel()
+    {
+        return dispatch().supported;
+    }
+
+    CpuLevel GetCpuLevel()
+    {
+        return (CpuLevel)dispatch().level.load(std::memory_order_relaxed);
+    }
+
+    bool SetCpuLevel(CpuLevel level)
+    {
+        if (level < CPU_SCALAR || level > dispatch().supported)
+            return false;
+        dispatch().level = level;
+        return true;
+    }
+
+    const char* CpuLevelName(CpuLevel level)
+    {
+        if (level < CPU_SCALAR || (unsigned int)level >= CPU_NR_OF_LEVELS)
+            return "unknown";
+        return level_names[level];
+    }
+
+    void SetCpuDispatchCheck(bool check)
+    {
+        dispatch().check = check;
+    }
+
+    bool GetCpuDispatchCheck()
+    {
+        return dispatch().check.load(std::memory_order_relaxed);
+    }
+
+    unsigned long GetNrOfCpuDispatchMismatches()
+    {
+        return dispatch().mismatches;
+    }
+
+    void ReportCpuDispatchMismatch(const char* kernel, CpuLevel level, double difference)
+    {
+        dispatch().mismatches++;
+        std::cerr << "KDL_CPU_DISPATCH: " << kernel << " variant " << CpuLevelName(level)
+                  << " differs " << difference << " from the scalar variant" << std::endl;
+    }
+
+}
@@ -0,0 +1,117 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_CPUDISPATCH_HPP
+#define KDL_CPUDISPATCH_HPP
+
+/**
+ * \file
+ * Runtime selection of the instruction set used by the vectorized
+ * kernels, e.g. the ones of frames_batch.hpp.
+ *
+ * The library is built for the baseline instruction set of the target
+ * (e.g. SSE2 on x86-64), so one build runs on every machine. A kernel
+ * is compiled once more for every CpuLevel, using the KDL_TARGET_*
+ * function attributes below, and keeps the variants in a table indexed
+ * by the level. When the library is loaded the best level supported by
+ * the processor and the operating system is determined with CPUID, the
+ * kernels call the variant of GetCpuLevel().
+ *
+ * The environment variable KDL_CPU_DISPATCH overrides the selection,
+ * it is a comma separated list of:
+ * - scalar, sse4.2, avx2 or avx512: the highest level to use, the
+ *   level used is never above GetSupportedCpuLevel()
+ * - check: enables the check mode, see SetCpuDispatchCheck()
+ *
+ * On other architectures and compilers only CPU_SCALAR is available.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KDL_CPU_DISPATCH_X86
+#define KDL_TARGET_SSE4_2 __attribute__((target("sse4.2")))
+#define KDL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define KDL_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#endif
+
+namespace KDL {
+
+    /**
+     * The instruction sets the kernels are compiled for, in increasing
+     * order.
+     */
+    enum CpuLevel {
+        CPU_SCALAR=0, ///< the baseline of the build, the reference of the other levels
+        CPU_SSE4_2=1, ///< SSE4.2
+        CPU_AVX2=2,   ///< AVX2 and FMA
+        CPU_AVX512=3  ///< AVX-512 F, DQ and VL
+    };
+
+    static const unsigned int CPU_NR_OF_LEVELS = 4;
+
+    /**
+     * Returns the best level supported by the processor and the
+     * operating system.
+     */
+    CpuLevel GetSupportedCpuLevel();
+
+    /**
+     * Returns the level of the kernel variants that are used.
+     */
+    CpuLevel GetCpuLevel();
+
+    /**
+     * Selects the level of the kernel variants, e.g. to compare them in
+     * a test. This is not synchronized with kernels that are running in
+     * other threads, these may still use the previous level.
+     *
+     * @return false, without changing the level, if the level is not
+     * supported
+     */
+    bool SetCpuLevel(CpuLevel level);
+
+    /**
+     * Returns the name of a level as used in KDL_CPU_DISPATCH.
+     */
+    const char* CpuLevelName(CpuLevel level);
+
+    /**
+     * Enables or disables the check mode. In check mode every kernel
+     * call also runs the scalar variant and all other supported
+     * variants, and compares their results with the one of the scalar
+     * variant. A difference above the rounding tolerance of the kernel
+     * is reported on std::cerr and counted, see
+     * GetNrOfCpuDispatchMismatches(). The kernels still return the
+     * result of the variant of GetCpuLevel().
+     *
+     * This is slow and meant for tests only.
+     */
+    void SetCpuDispatchCheck(bool check);
+
+    bool GetCpuDispatchCheck();
+
+    /**
+     * Returns the number of kernel calls in check mode of which a
+     * variant differed from the scalar variant.
+     */
+    unsigned long GetNrOfCpuDispatchMismatches();
+
+    /**
+     * Used by the kernels in check mode to report that the variant of
+     * the given level differed from the scalar variant.
+     */
+    void ReportCpuDispatchMismatch(const char* kernel, CpuLevel level, double difference);
+
+}
+
+#endif
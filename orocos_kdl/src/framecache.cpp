@@ -0,0 +1,113 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "framecache.hpp"
+#include "utilities/hash_combine.h"
+#include <cmath>
+
+namespace KDL {
+
+    FrameCache::FrameCache(unsigned int nr_of_joints, unsigned int nr_of_frames, unsigned int _capacity, double _resolution):
+        nj(0), nf(0), capacity(_capacity>0 ? _capacity : 1), resolution(_resolution), slot_size(0),
+        hits(0), misses(0)
+    {
+        resize(nr_of_joints, nr_of_frames);
+    }
+
+    void FrameCache::resize(unsigned int nr_of_joints, unsigned int nr_of_frames)
+    {
+        nj = nr_of_joints;
+        nf = nr_of_frames;
+        slot_size = nj + 12*nf;
+        //atomics can not be moved, so the storage is replaced as a whole
+        std::vector<std::atomic<unsigned int> >(capacity).swap(sequence);
+        std::vector<std::atomic<double> >(capacity*slot_size).swap(data);
+        clear();
+    }
+
+    double FrameCache::key(const JntArray& q, unsigned int i) const
+    {
+        if (resolution > 0.0)
+            return std::floor(q(i)/resolution + 0.5);
+        return q(i);
+    }
+
+    unsigned int FrameCache::slot(const JntArray& q) const
+    {
+        std::size_t seed = 0;
+        for (unsigned int i = 0; i < nj; i++)
+            hash_combine(seed, key(q, i));
+        return seed % capacity;
+    }
+
+    bool FrameCache::lookup(const JntArray& q, unsigned int first, unsigned int count, Frame* frames) const
+    {
+        unsigned int s = slot(q);
+        const std::atomic<double>* slot_data = data.data() + s*slot_size;
+        unsigned int seq = sequence[s].load(std::memory_order_acquire);
+        bool hit = (seq & 3) == VALID;
+        for (unsigned int i = 0; hit && i < nj; i++)
+            hit = slot_data[i].load(std::memory_order_relaxed) == key(q, i);
+        if (hit) {
+            const std::atomic<double>* frame_data = slot_data + nj + 12*first;
+            for (unsigned int k = 0; k < count; k++) {
+                for (unsigned int i = 0; i < 9; i++)
+                    frames[k].M.data[i] = frame_data[12*k+i].load(std::memory_order_relaxed);
+                for (unsigned int i = 0; i < 3; i++)
+                    frames[k].p.data[i] = frame_data[12*k+9+i].load(std::memory_order_relaxed);
+            }
+            //the slot must not have been rewritten while it was read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            hit = sequence[s].load(std::memory_order_relaxed) == seq;
+        }
+        if (hit)
+            hits.fetch_add(1, std::memory_order_relaxed);
+        else
+            misses.fetch_add(1, std::memory_order_relaxed);
+        return hit;
+    }
+
+    void FrameCache::insert(const JntArray& q, const Frame* frames)
+    {
+        unsigned int s = slot(q);
+        std::atomic<double>* slot_data = data.data() + s*slot_size;
+        unsigned int seq = sequence[s].load(std::memory_order_relaxed);
+        //readers that overlap with the write miss
+        sequence[s].store(seq | WRITING, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (unsigned int i = 0; i < nj; i++)
+            slot_data[i].store(key(q, i), std::memory_order_relaxed);
+        std::atomic<double>* frame_data = slot_data + nj;
+        for (unsigned int k = 0; k < nf; k++) {
+            for (unsigned int i = 0; i < 9; i++)
+                frame_data[12*k+i].store(frames[k].M.data[i], std::memory_order_relaxed);
+            for (unsigned int i = 0; i < 3; i++)
+                frame_data[12*k+9+i].store(frames[k].p.data[i], std::memory_order_relaxed);
+        }
+        sequence[s].store(nextVersion(seq) | VALID, std::memory_order_release);
+    }
+
+    void FrameCache::clear()
+    {
+        for (unsigned int s = 0; s < capacity; s++)
+            sequence[s].store(nextVersion(sequence[s].load(std::memory_order_relaxed)), std::memory_order_release);
+    }
+
+    void FrameCache::resetStatistics()
+    {
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+    }
+
+}
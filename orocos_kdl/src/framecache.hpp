@@ -0,0 +1,127 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_FRAMECACHE_HPP
+#define KDL_FRAMECACHE_HPP
+
+#include "frames.hpp"
+#include "jntarray.hpp"
+#include <atomic>
+#include <vector>
+
+namespace KDL {
+
+    /**
+     * \brief Bounded cache of the segment frames of a chain or tree,
+     * keyed on the joint positions.
+     *
+     * The cache has a fixed number of slots, a configuration is stored
+     * in the slot selected by the hash of its key and replaces the
+     * configuration that was stored there before. The key is either
+     * the exact joint positions or, with a resolution > 0, the joint
+     * positions rounded to multiples of the resolution. In the latter
+     * case all configurations in the same cell share the frames of the
+     * first one that was stored.
+     *
+     * lookup() is lock-free and can be called concurrently with other
+     * lookups and with one writer (insert or clear). Concurrent writers
+     * have to be serialized by the caller. Every slot is protected by a
+     * sequence counter: a reader that overlaps with a write of its slot
+     * reports a miss instead of returning torn data.
+     *
+     * @ingroup KinematicFamily
+     */
+    class FrameCache {
+    public:
+        /**
+         * Constructor of the cache.
+         *
+         * @param nr_of_joints size of the joint arrays used as key
+         * @param nr_of_frames number of frames stored per configuration
+         * @param capacity number of configurations kept in the cache
+         * @param resolution quantization step of the key, 0 for an
+         * exact key
+         */
+        FrameCache(unsigned int nr_of_joints, unsigned int nr_of_frames, unsigned int capacity, double resolution=0.0);
+
+        /**
+         * Change the size of the stored configurations, this empties the
+         * cache. Not safe to call concurrently with lookups.
+         */
+        void resize(unsigned int nr_of_joints, unsigned int nr_of_frames);
+
+        /**
+         * Request frames of a stored configuration.
+         *
+         * @param q the joint positions
+         * @param first index of the first requested frame
+         * @param count number of requested frames
+         * @param frames output array with room for count frames, its
+         * content is undefined if the lookup misses
+         *
+         * @return true on a hit
+         */
+        bool lookup(const JntArray& q, unsigned int first, unsigned int count, Frame* frames) const;
+
+        /**
+         * Store the frames of a configuration.
+         *
+         * @param q the joint positions
+         * @param frames nr_of_frames frames
+         */
+        void insert(const JntArray& q, const Frame* frames);
+
+        /**
+         * Remove all configurations from the cache.
+         */
+        void clear();
+
+        unsigned int getCapacity() const {return capacity;};
+        double getResolution() const {return resolution;};
+        /**
+         * Request the number of lookups that found their configuration.
+         */
+        unsigned long getNrOfHits() const {return hits.load(std::memory_order_relaxed);};
+        /**
+         * Request the number of lookups that did not find their configuration.
+         */
+        unsigned long getNrOfMisses() const {return misses.load(std::memory_order_relaxed);};
+        /**
+         * Set the hit and miss counters to zero.
+         */
+        void resetStatistics();
+
+    private:
+        unsigned int nj;
+        unsigned int nf;
+        unsigned int capacity;
+        double resolution;
+        unsigned int slot_size;
+        //sequence counter per slot: a version that changes with every
+        //write, and the WRITING and VALID flags in the lowest bits
+        enum {WRITING=1, VALID=2};
+        std::vector<std::atomic<unsigned int> > sequence;
+        //per slot the key followed by the 12 numbers of every frame
+        std::vector<std::atomic<double> > data;
+        mutable std::atomic<unsigned long> hits;
+        mutable std::atomic<unsigned long> misses;
+
+        double key(const JntArray& q, unsigned int i) const;
+        unsigned int slot(const JntArray& q) const;
+        static unsigned int nextVersion(unsigned int seq) {return (seq & ~3u) + 4;};
+    };
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "frames_batch.hpp"
+#include "cpudispatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace KDL {
+
+    namespace {
+
+        // The kernels are written once and inlined in a variant per
+        // level, the compiler vectorizes every variant for its
+        // instruction set. They read an element completely before
+        // writing it, so the output may alias an input.
+
+        inline void multiply(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n)
+        {
+            for (unsigned int i = 0; i < n; i++) {
+                const double* a = lhs[i].M.data;
+                const double* b = rhs[i].M.data;
+                const double* bp = rhs[i].p.data;
+                double M[9], p[3];
+                for (unsigned int r = 0; r < 3; r++) {
+                    for (unsigned int c = 0; c < 3; c++)
+                        M[3*r+c] = a[3*r]*b[c] + a[3*r+1]*b[3+c] + a[3*r+2]*b[6+c];
+                    p[r] = a[3*r]*bp[0] + a[3*r+1]*bp[1] + a[3*r+2]*bp[2] + lhs[i].p.data[r];
+                }
+                std::copy(M, M+9, out[i].M.data);
+                std::copy(p, p+3, out[i].p.data);
+            }
+        }
+
+        inline void transform(const Frame& f, const Vector* in, Vector* out, unsigned int n)
+        {
+            const double* M = f.M.data;
+            const double* p = f.p.data;
+            for (unsigned int i = 0; i < n; i++) {
+                const double x = in[i].data[0], y = in[i].data[1], z = in[i].data[2];
+                out[i].data[0] = M[0]*x + M[1]*y + M[2]*z + p[0];
+                out[i].data[1] = M[3]*x + M[4]*y + M[5]*z + p[1];
+                out[i].data[2] = M[6]*x + M[7]*y + M[8]*z + p[2];
+            }
+        }
+
+        typedef void (*MultiplyKernel)(const Frame*, const Frame*, Frame*, unsigned int);
+        typedef void (*TransformKernel)(const Frame&, const Vector*, Vector*, unsigned int);
+
+        void multiply_scalar(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n) {multiply(lhs, rhs, out, n);}
+        void transform_scalar(const Frame& f, const Vector* in, Vector* out, unsigned int n) {transform(f, in, out, n);}
+
+#ifdef KDL_CPU_DISPATCH_X86
+        KDL_TARGET_SSE4_2 void multiply_sse4_2(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n) {multiply(lhs, rhs, out, n);}
+        KDL_TARGET_SSE4_2 void transform_sse4_2(const Frame& f, const Vector* in, Vector* out, unsigned int n) {transform(f, in, out, n);}
+        KDL_TARGET_AVX2 void multiply_avx2(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n) {multiply(lhs, rhs, out, n);}
+        KDL_TARGET_AVX2 void transform_avx2(const Frame& f, const Vector* in, Vector* out, unsigned int n) {transform(f, in, out, n);}
+        KDL_TARGET_AVX512 void multiply_avx512(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n) {multiply(lhs, rhs, out, n);}
+        KDL_TARGET_AVX512 void transform_avx512(const Frame& f, const Vector* in, Vector* out, unsigned int n) {transform(f, in, out, n);}
+
+        const MultiplyKernel multiply_variants[CPU_NR_OF_LEVELS] = {multiply_scalar, multiply_sse4_2, multiply_avx2, multiply_avx512};
+        const TransformKernel transform_variants[CPU_NR_OF_LEVELS] = {transform_scalar, transform_sse4_2, transform_avx2, transform_avx512};
+#else
+        const MultiplyKernel multiply_variants[CPU_NR_OF_LEVELS] = {multiply_scalar, multiply_scalar, multiply_scalar, multiply_scalar};
+        const TransformKernel transform_variants[CPU_NR_OF_LEVELS] = {transform_scalar, transform_scalar, transform_scalar, transform_scalar};
+#endif
+
+        // Largest difference of the results of two variants, relative
+        // to the largest magnitude of a, the scalar reference.
+        double difference(const std::vector<Vector>& a, const std::vector<Vector>& b)
+        {
+            double scale = 1.0, result = 0.0;
+            for (unsigned int i = 0; i < a.size(); i++)
+                for (unsigned int j = 0; j < 3; j++) {
+                    scale = std::max(scale, std::fabs(a[i].data[j]));
+                    result = std::max(result, std::fabs(a[i].data[j] - b[i].data[j]));
+                }
+            return result/scale;
+        }
+
+        double difference(const std::vector<Frame>& a, const std::vector<Frame>& b)
+        {
+            double scale = 1.0, result = 0.0;
+            for (unsigned int i = 0; i < a.size(); i++) {
+                for (unsigned int j = 0; j < 3; j++) {
+                    scale = std::max(scale, std::fabs(a[i].p.data[j]));
+                    result = std::max(result, std::fabs(a[i].p.data[j] - b[i].p.data[j]));
+                }
+                for (unsigned int j = 0; j < 9; j++)
+                    result = std::max(result, std::fabs(a[i].M.data[j] - b[i].M.data[j]));
+            }
+            return result/scale;
+        }
+
+        // A fused multiply-add rounds once instead of twice, so the
+        // variants may differ a few ulp from the scalar one.
+        const double tolerance = 1e-12;
+    }
+
+    void BatchMultiply(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n)
+    {
+        const CpuLevel level = GetCpuLevel();
+        if (!GetCpuDispatchCheck() || n == 0) {
+            multiply_variants[level](lhs, rhs, out, n);
+            return;
+        }
+        std::vector<Frame> reference(n), result(n), used(n);
+        multiply_variants[CPU_SCALAR](lhs, rhs, &reference[0], n);
+        for (unsigned int l = CPU_SCALAR; l <= (unsigned int)GetSupportedCpuLevel(); l++) {
+            multiply_variants[l](lhs, rhs, &result[0], n);
+            double d = difference(reference, result);
+            if (d > tolerance)
+                ReportCpuDispatchMismatch("BatchMultiply", (CpuLevel)l, d);
+            if (l == (unsigned int)level)
+                used.swap(result);
+        }
+        std::copy(used.begin(), used.end(), out);
+    }
+
+    void BatchTransform(const Frame& f, const Vector* in, Vector* out, unsigned int n)
+    {
+        const CpuLevel level = GetCpuLevel();
+        if (!GetCpuDispatchCheck() || n == 0) {
+            transform_variants[level](f, in, out, n);
+            return;
+        }
+        std::vector<Vector> reference(n), result(n), used(n);
+        transform_variants[CPU_SCALAR](f, in, &reference[0], n);
+        for (unsigned int l = CPU_SCALAR; l <= (unsigned int)GetSupportedCpuLevel(); l++) {
+            transform_variants[l](f, in, &result[0], n);
+            double d = difference(reference, result);
+            if (d > tolerance)
+                ReportCpuDispatchMismatch("BatchTransform", (CpuLevel)l, d);
+            if (l == (unsigned int)level)
+                used.swap(result);
+        }
+        std::copy(used.begin(), used.end(), out);
+    }
+
+}
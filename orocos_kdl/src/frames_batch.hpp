@@ -0,0 +1,43 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_FRAMES_BATCH_HPP
+#define KDL_FRAMES_BATCH_HPP
+
+#include "frames.hpp"
+
+/**
+ * \file
+ * Operations on arrays of frames and vectors, vectorized for the
+ * instruction set selected by cpudispatch.hpp. The results equal the
+ * ones of the operators of frames.hpp up to rounding.
+ */
+
+namespace KDL {
+
+    /**
+     * Computes out[i] = lhs[i]*rhs[i] for i < n. out may be the same
+     * array as lhs or rhs.
+     */
+    void BatchMultiply(const Frame* lhs, const Frame* rhs, Frame* out, unsigned int n);
+
+    /**
+     * Computes out[i] = f*in[i] for i < n, e.g. to transform a point
+     * cloud. out may be the same array as in.
+     */
+    void BatchTransform(const Frame& f, const Vector* in, Vector* out, unsigned int n);
+
+}
+
+#endif
@@ -307,4 +307,64 @@ std::istream& operator >> (std::istream& is,Frame2& T)
     return is;
 }
 
+void WriteBinary(std::ostream& os,const Vector& v)
+{
+    for (int i=0;i<3;i++)
+        WriteBinary(os,v(i));
+}
+
+void WriteBinary(std::ostream& os,const Rotation& R)
+{
+    for (int i=0;i<9;i++)
+        WriteBinary(os,R.data[i]);
+}
+
+void WriteBinary(std::ostream& os,const Frame& T)
+{
+    WriteBinary(os,T.M);
+    WriteBinary(os,T.p);
+}
+
+void WriteBinary(std::ostream& os,const Twist& t)
+{
+    WriteBinary(os,t.vel);
+    WriteBinary(os,t.rot);
+}
+
+void WriteBinary(std::ostream& os,const Wrench& w)
+{
+    WriteBinary(os,w.force);
+    WriteBinary(os,w.torque);
+}
+
+void ReadBinary(std::istream& is,Vector& v)
+{
+    for (int i=0;i<3;i++)
+        ReadBinary(is,v(i));
+}
+
+void ReadBinary(std::istream& is,Rotation& R)
+{
+    for (int i=0;i<9;i++)
+        ReadBinary(is,R.data[i]);
+}
+
+void ReadBinary(std::istream& is,Frame& T)
+{
+    ReadBinary(is,T.M);
+    ReadBinary(is,T.p);
+}
+
+void ReadBinary(std::istream& is,Twist& t)
+{
+    ReadBinary(is,t.vel);
+    ReadBinary(is,t.rot);
+}
+
+void ReadBinary(std::istream& is,Wrench& w)
+{
+    ReadBinary(is,w.force);
+    ReadBinary(is,w.torque);
+}
+
 } // namespace Frame
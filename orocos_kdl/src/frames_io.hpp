@@ -77,6 +77,7 @@
 #define FRAMES_IO_H
 
 #include "utilities/utility_io.h"
+#include "utilities/binary_io.h"
 #include "frames.hpp"
 #include "jntarray.hpp"
 #include "jacobian.hpp"
@@ -108,6 +109,18 @@ namespace KDL {
     std::istream& operator >> (std::istream& is,Rotation2& R);
     std::istream& operator >> (std::istream& is,Frame2& T);
 
+    // Binary I/O, see utilities/binary_io.h
+    void WriteBinary(std::ostream& os,const Vector& v);
+    void WriteBinary(std::ostream& os,const Rotation& R);
+    void WriteBinary(std::ostream& os,const Frame& T);
+    void WriteBinary(std::ostream& os,const Twist& t);
+    void WriteBinary(std::ostream& os,const Wrench& w);
+    void ReadBinary(std::istream& is,Vector& v);
+    void ReadBinary(std::istream& is,Rotation& R);
+    void ReadBinary(std::istream& is,Frame& T);
+    void ReadBinary(std::istream& is,Twist& t);
+    void ReadBinary(std::istream& is,Wrench& w);
+
 
 } // namespace Frame
 
@@ -20,6 +20,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "joint.hpp"
+#include "jntarray.hpp"
 
 namespace KDL {
 
@@ -85,6 +86,7 @@ namespace KDL {
         case TransZ:
             return Frame(Vector(0.0,0.0,scale*q+offset));
         case Fixed:
+        default:
             return Frame::Identity();
         }
         return Frame::Identity();
@@ -110,11 +112,162 @@ namespace KDL {
         case TransZ:
             return Twist(Vector(0.0,0.0,scale*qdot),Vector(0.0,0.0,0.0));
         case Fixed:
+        default:
             return Twist::Zero();
         }
         return Twist::Zero();
     }
 
+    namespace {
+        // Coefficients of the exponential map of SO(3) and of its right
+        // Jacobian Jr(w) = I - a [w]x + b [w]x^2, with t = |w|:
+        // s = sin(t)/t, a = (1-cos(t))/t^2, b = (t-sin(t))/t^3, and the
+        // derivatives da = a'(t)/t, db = b'(t)/t. Series expansions are
+        // used close to the identity.
+        struct So3Coefficients {
+            double s, a, b, da, db;
+            explicit So3Coefficients(const Vector& w)
+            {
+                double t2 = dot(w,w);
+                if (t2 < 1e-4) {
+                    s = 1.0 - t2/6.0 + t2*t2/120.0;
+                    a = 0.5 - t2/24.0 + t2*t2/720.0;
+                    b = 1.0/6.0 - t2/120.0 + t2*t2/5040.0;
+                    da = -1.0/12.0 + t2/180.0 - t2*t2/6720.0;
+                    db = -1.0/60.0 + t2/1260.0 - t2*t2/60480.0;
+                } else {
+                    double t = sqrt(t2), st = sin(t), ct = cos(t);
+                    s = st/t;
+                    a = (1.0-ct)/t2;
+                    b = (t-st)/(t2*t);
+                    da = (t*st-2.0*(1.0-ct))/(t2*t2);
+                    db = (t*(1.0-ct)-3.0*(t-st))/(t2*t2*t);
+                }
+            }
+        };
+
+        // R = exp([w]x) = I + s [w]x + a [w]x^2
+        Rotation expRot(const Vector& w, const So3Coefficients& c)
+        {
+            double t2 = dot(w,w);
+            return Rotation(1.0+c.a*(w.x()*w.x()-t2), -c.s*w.z()+c.a*w.x()*w.y(), c.s*w.y()+c.a*w.x()*w.z(),
+                            c.s*w.z()+c.a*w.x()*w.y(), 1.0+c.a*(w.y()*w.y()-t2), -c.s*w.x()+c.a*w.y()*w.z(),
+                            -c.s*w.y()+c.a*w.x()*w.z(), c.s*w.x()+c.a*w.y()*w.z(), 1.0+c.a*(w.z()*w.z()-t2));
+        }
+
+        // body angular velocity Jr(w)*wdot
+        Vector rightJacobian(const Vector& w, const Vector& wdot, const So3Coefficients& c)
+        {
+            return wdot - c.a*(w*wdot) + c.b*(w*(w*wdot));
+        }
+
+        // (d/dt Jr(w))*wdot
+        Vector rightJacobianDot(const Vector& w, const Vector& wdot, const So3Coefficients& c)
+        {
+            double wu = dot(w,wdot);
+            Vector wxu = w*wdot;
+            return -c.da*wu*wxu + c.db*wu*(w*wxu) + c.b*(wdot*wxu);
+        }
+
+        Twist multiDofTwist(Joint::JointType type, const double* q, const double* qdot)
+        {
+            switch(type){
+            case Joint::Spherical: {
+                Vector w(q[0],q[1],q[2]);
+                So3Coefficients c(w);
+                return Twist(Vector::Zero(), expRot(w,c)*rightJacobian(w,Vector(qdot[0],qdot[1],qdot[2]),c));
+            }
+            case Joint::Planar:
+                return Twist(Vector(qdot[0],qdot[1],0.0), Vector(0.0,0.0,qdot[2]));
+            case Joint::Floating: {
+                Vector w(q[3],q[4],q[5]);
+                So3Coefficients c(w);
+                return Twist(Vector(qdot[0],qdot[1],qdot[2]), expRot(w,c)*rightJacobian(w,Vector(qdot[3],qdot[4],qdot[5]),c));
+            }
+            default:
+                return Twist::Zero();
+            }
+        }
+    }
+
+    Frame Joint::pose(const JntArray& q, unsigned int q_nr)const
+    {
+        switch(type){
+        case Fixed:
+            return Frame::Identity();
+        case Spherical: {
+            Vector w(q(q_nr),q(q_nr+1),q(q_nr+2));
+            return Frame(expRot(w,So3Coefficients(w)));
+        }
+        case Planar:
+            return Frame(Rotation::RotZ(q(q_nr+2)), Vector(q(q_nr),q(q_nr+1),0.0));
+        case Floating: {
+            Vector w(q(q_nr+3),q(q_nr+4),q(q_nr+5));
+            return Frame(expRot(w,So3Coefficients(w)), Vector(q(q_nr),q(q_nr+1),q(q_nr+2)));
+        }
+        default:
+            return pose(q(q_nr));
+        }
+    }
+
+    Twist Joint::twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const
+    {
+        switch(type){
+        case Fixed:
+            return Twist::Zero();
+        case Spherical:
+        case Planar:
+        case Floating:
+            return multiDofTwist(type, &q.data(q_nr), &qdot.data(q_nr));
+        default:
+            return twist(qdot(q_nr));
+        }
+    }
+
+    Twist Joint::unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof)const
+    {
+        switch(type){
+        case Fixed:
+            return Twist::Zero();
+        case Spherical:
+        case Planar:
+        case Floating: {
+            double unit[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
+            unit[dof] = 1.0;
+            return multiDofTwist(type, &q.data(q_nr), unit);
+        }
+        default:
+            return twist(1.0);
+        }
+    }
+
+    Twist Joint::biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const
+    {
+        switch(type){
+        case Spherical: {
+            Vector w(q(q_nr),q(q_nr+1),q(q_nr+2));
+            Vector wdot(qdot(q_nr),qdot(q_nr+1),qdot(q_nr+2));
+            So3Coefficients c(w);
+            return Twist(Vector::Zero(), expRot(w,c)*rightJacobianDot(w,wdot,c));
+        }
+        case Planar: {
+            // linear velocity of the end origin, rotating with the joint
+            Vector omega(0.0,0.0,qdot(q_nr+2));
+            return Twist(-(omega*Vector(qdot(q_nr),qdot(q_nr+1),0.0)), Vector::Zero());
+        }
+        case Floating: {
+            Vector w(q(q_nr+3),q(q_nr+4),q(q_nr+5));
+            Vector wdot(qdot(q_nr+3),qdot(q_nr+4),qdot(q_nr+5));
+            So3Coefficients c(w);
+            Rotation R = expRot(w,c);
+            Vector omega = R*rightJacobian(w,wdot,c);
+            return Twist(-(omega*Vector(qdot(q_nr),qdot(q_nr+1),qdot(q_nr+2))), R*rightJacobianDot(w,wdot,c));
+        }
+        default:
+            return Twist::Zero();
+        }
+    }
+
   Vector Joint::JointAxis() const
   {
     switch(type)
@@ -136,6 +289,7 @@ namespace KDL {
       case TransZ:
         return Vector(0.,0.,1.);
       case Fixed:
+      default:
         return Vector::Zero();
       }
     return Vector::Zero();
@@ -29,6 +29,8 @@
 
 namespace KDL {
 
+    class JntArray;
+
     /**
 	  * \brief This class encapsulates a simple joint, that is with one
 	  * parameterized degree of freedom and with scalar dynamic properties.
@@ -40,11 +42,24 @@ namespace KDL {
 	  *      - inertia, stiffness and damping: scalars representing the physical
 	  *      effects along/about the joint axis only.
      *
+     * Besides the single axis joints, three multi-DOF joint types are
+     * available. They occupy several consecutive entries of a JntArray,
+     * see getNrOfDofs(), and use exponential coordinates (rotation
+     * vector) for their orientation, so that every degree of freedom
+     * has exactly one position entry:
+     *      - Spherical: rotation vector (wx,wy,wz) about the joint origin.
+     *      - Planar: (x,y,theta), translation in and rotation about
+     *      the z-axis of the joint frame.
+     *      - Floating: (x,y,z,wx,wy,wz), free 6D motion of a floating base.
+     *
+     * Scale, offset, inertia, damping and stiffness are ignored for
+     * multi-DOF joints.
+     *
      * @ingroup KinematicFamily
      */
     class Joint {
     public:
-        typedef enum { RotAxis,RotX,RotY,RotZ,TransAxis,TransX,TransY,TransZ,Fixed,None=Fixed} JointType;
+        typedef enum { RotAxis,RotX,RotY,RotZ,TransAxis,TransX,TransY,TransZ,Fixed,None=Fixed,Spherical,Planar,Floating} JointType;
         /**
          * Constructor of a joint.
          *
@@ -128,6 +143,73 @@ namespace KDL {
          */
         Twist twist(const double& qdot)const;
 
+        /**
+         * Request the 6D-pose between the beginning and the end of
+         * the joint, reading the joint position from q starting at
+         * index q_nr. Works for joints of any number of DOFs.
+         *
+         * @param q the joint positions of the whole chain or tree
+         * @param q_nr index of the first DOF of this joint in q
+         *
+         * @return the resulting 6D-pose
+         */
+        Frame pose(const JntArray& q, unsigned int q_nr)const;
+        /**
+         * Request the resulting 6D-velocity, expressed in the base of
+         * the joint with reference point at the end of the joint.
+         *
+         * @param q the joint positions of the whole chain or tree
+         * @param qdot the joint velocities of the whole chain or tree
+         * @param q_nr index of the first DOF of this joint in q and qdot
+         *
+         * @return the resulting 6D-velocity
+         */
+        Twist twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const;
+        /**
+         * Request the 6D-velocity caused by a unit velocity of one DOF
+         * of the joint, in the same frame as twist(q,qdot,q_nr).
+         *
+         * @param q the joint positions of the whole chain or tree
+         * @param q_nr index of the first DOF of this joint in q
+         * @param dof which DOF of the joint, 0 <= dof < getNrOfDofs()
+         *
+         * @return the unit twist of DOF dof
+         */
+        Twist unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof)const;
+        /**
+         * Request the velocity-product acceleration of the joint, i.e.
+         * the 6D-acceleration at zero joint acceleration, in the same
+         * frame as twist(q,qdot,q_nr). Zero for single axis joints.
+         *
+         * @param q the joint positions of the whole chain or tree
+         * @param qdot the joint velocities of the whole chain or tree
+         * @param q_nr index of the first DOF of this joint in q and qdot
+         *
+         * @return the bias acceleration
+         */
+        Twist biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const;
+
+        /**
+         * Request the number of degrees of freedom of the joint.
+         *
+         * @return 0 for Fixed joints, 1 for single axis joints, 3 for
+         * Spherical and Planar joints and 6 for Floating joints
+         */
+        unsigned int getNrOfDofs() const
+        {
+            switch (type) {
+            case Fixed:
+                return 0;
+            case Spherical:
+            case Planar:
+                return 3;
+            case Floating:
+                return 6;
+            default:
+                return 1;
+            }
+        }
+
         /**
          * Request the Vector corresponding to the axis of a revolute joint.
          *
@@ -187,6 +269,12 @@ namespace KDL {
                 return "TransZ";
             case Fixed:
                 return "Fixed";
+            case Spherical:
+                return "Spherical";
+            case Planar:
+                return "Planar";
+            case Floating:
+                return "Floating";
             default:
                 return "Fixed";
             }
@@ -21,6 +21,8 @@
 
 #include "kinfam_io.hpp"
 #include "frames_io.hpp"
+#include "utilities/error.h"
+#include <set>
 #include <sstream>
 
 namespace KDL {
@@ -129,4 +131,191 @@ std::string tree2str(const Tree& tree, const std::string& separator, const std::
 	return tree2str(tree.getRootSegment(), separator, preamble, 0);
 }
 
+void WriteBinary(std::ostream& os, const Joint& joint) {
+    WriteBinary(os, joint.getName());
+    WriteBinary(os, (unsigned int)joint.getType());
+    WriteBinary(os, joint.getScale());
+    WriteBinary(os, joint.getOffset());
+    WriteBinary(os, joint.getInertia());
+    WriteBinary(os, joint.getDamping());
+    WriteBinary(os, joint.getStiffness());
+    WriteBinary(os, joint.JointAxis());
+    WriteBinary(os, joint.JointOrigin());
+}
+
+void ReadBinary(std::istream& is, Joint& joint) {
+    std::string name;
+    unsigned int type;
+    double scale, offset, inertia, damping, stiffness;
+    Vector axis, origin;
+    ReadBinary(is, name);
+    ReadBinary(is, type);
+    ReadBinary(is, scale);
+    ReadBinary(is, offset);
+    ReadBinary(is, inertia);
+    ReadBinary(is, damping);
+    ReadBinary(is, stiffness);
+    ReadBinary(is, axis);
+    ReadBinary(is, origin);
+    if (type > Joint::Floating)
+        throw Error_BasicIO_Binary();
+    if (type == Joint::RotAxis || type == Joint::TransAxis)
+        joint = Joint(name, origin, axis, (Joint::JointType)type, scale, offset, inertia, damping, stiffness);
+    else
+        joint = Joint(name, (Joint::JointType)type, scale, offset, inertia, damping, stiffness);
+}
+
+void WriteBinary(std::ostream& os, const RigidBodyInertia& I) {
+    //the inertia is stored as constructed: in the cog
+    double m = I.getMass();
+    Vector c = I.getCOG();
+    RotationalInertia Ic = I.getRotationalInertia();
+    for (unsigned int i = 0; i < 3; i++)
+        for (unsigned int j = 0; j < 3; j++)
+            Ic.data[3*i+j] += m*(c(i)*c(j) - (i == j ? dot(c, c) : 0.0));
+    WriteBinary(os, m);
+    WriteBinary(os, c);
+    for (unsigned int i = 0; i < 9; i++)
+        WriteBinary(os, Ic.data[i]);
+}
+
+void ReadBinary(std::istream& is, RigidBodyInertia& I) {
+    double m;
+    Vector c;
+    RotationalInertia Ic;
+    ReadBinary(is, m);
+    ReadBinary(is, c);
+    for (unsigned int i = 0; i < 9; i++)
+        ReadBinary(is, Ic.data[i]);
+    I = RigidBodyInertia(m, c, Ic);
+}
+
+void WriteBinary(std::ostream& os, const Segment& segment) {
+    WriteBinary(os, segment.getName());
+    WriteBinary(os, segment.getJoint());
+    WriteBinary(os, segment.getFrameToTip());
+    WriteBinary(os, segment.getInertia());
+}
+
+void ReadBinary(std::istream& is, Segment& segment) {
+    std::string name;
+    Joint joint;
+    Frame f_tip;
+    RigidBodyInertia I;
+    ReadBinary(is, name);
+    ReadBinary(is, joint);
+    ReadBinary(is, f_tip);
+    ReadBinary(is, I);
+    segment = Segment(name, joint, f_tip, I);
+}
+
+void WriteBinary(std::ostream& os, const Chain& chain) {
+    WriteBinary(os, chain.getNrOfSegments());
+    for (unsigned int i = 0; i < chain.getNrOfSegments(); i++) {
+        WriteBinary(os, chain.getSegment(i));
+        WriteBinary(os, chain.getQNr(i));
+    }
+}
+
+void ReadBinary(std::istream& is, Chain& chain) {
+    unsigned int nr_of_segments;
+    ReadBinary(is, nr_of_segments);
+    chain = Chain();
+    for (unsigned int i = 0; i < nr_of_segments; i++) {
+        Segment segment;
+        unsigned int q_nr;
+        ReadBinary(is, segment);
+        ReadBinary(is, q_nr);
+        if (segment.getJoint().getNrOfDofs() == 0 || q_nr == chain.getNrOfJoints())
+            chain.addSegment(segment);
+        else if (!chain.addCoupledSegment(segment, q_nr))
+            throw Error_BasicIO_Binary();
+    }
+}
+
+namespace {
+    //writes the parents of a segment before the segment itself
+    void writeTreeSegment(std::ostream& os, const Tree& tree, SegmentMap::const_iterator it,
+                          std::set<std::string>& written) {
+        if (it == tree.getRootSegment() || written.count(it->first))
+            return;
+        SegmentMap::const_iterator parent = GetTreeElementParent(it->second);
+        writeTreeSegment(os, tree, parent, written);
+        WriteBinary(os, parent->first);
+        WriteBinary(os, GetTreeElementSegment(it->second));
+        WriteBinary(os, GetTreeElementQNr(it->second));
+        written.insert(it->first);
+    }
+}
+
+void WriteBinary(std::ostream& os, const Tree& tree) {
+    WriteBinary(os, tree.getRootSegment()->first);
+    WriteBinary(os, tree.getNrOfSegments());
+    //The segments are written in the order in which their joint
+    //coordinates were assigned, so that reading them back gives the
+    //same numbering. Segments without an own coordinate follow.
+    const SegmentMap& segments = tree.getSegments();
+    std::vector<SegmentMap::const_iterator> owners(tree.getNrOfJoints(), segments.end());
+    for (SegmentMap::const_iterator it = segments.begin(); it != segments.end(); ++it) {
+        unsigned int q_nr = GetTreeElementQNr(it->second);
+        if (GetTreeElementSegment(it->second).getJoint().getNrOfDofs() == 0 || owners[q_nr] != segments.end())
+            continue;
+        //a segment coupled to q_nr may come first, the coordinate can
+        //only be assigned to a segment whose parents come before q_nr
+        bool owner = true;
+        for (SegmentMap::const_iterator p = GetTreeElementParent(it->second); owner && p != tree.getRootSegment(); p = GetTreeElementParent(p->second))
+            owner = GetTreeElementSegment(p->second).getJoint().getNrOfDofs() == 0 || GetTreeElementQNr(p->second) < q_nr;
+        if (owner)
+            owners[q_nr] = it;
+    }
+    std::set<std::string> written;
+    for (unsigned int q_nr = 0; q_nr < owners.size(); q_nr++)
+        if (owners[q_nr] != segments.end())
+            writeTreeSegment(os, tree, owners[q_nr], written);
+    for (SegmentMap::const_iterator it = segments.begin(); it != segments.end(); ++it)
+        writeTreeSegment(os, tree, it, written);
+}
+
+void ReadBinary(std::istream& is, Tree& tree) {
+    std::string root_name;
+    unsigned int nr_of_segments;
+    ReadBinary(is, root_name);
+    ReadBinary(is, nr_of_segments);
+    tree = Tree(root_name);
+    for (unsigned int i = 0; i < nr_of_segments; i++) {
+        std::string parent;
+        Segment segment;
+        unsigned int q_nr;
+        ReadBinary(is, parent);
+        ReadBinary(is, segment);
+        ReadBinary(is, q_nr);
+        bool added;
+        if (segment.getJoint().getNrOfDofs() == 0 || q_nr == tree.getNrOfJoints())
+            added = tree.addSegment(segment, parent);
+        else
+            added = tree.addCoupledSegment(segment, parent, q_nr);
+        if (!added)
+            throw Error_BasicIO_Binary();
+    }
+}
+
+void WriteBinary(std::ostream& os, const JntArray& array) {
+    WriteBinary(os, array.rows());
+    for (unsigned int i = 0; i < array.rows(); i++)
+        WriteBinary(os, array(i));
+}
+
+void ReadBinary(std::istream& is, JntArray& array) {
+    unsigned int size;
+    ReadBinary(is, size);
+    //grow while reading, a corrupt size must not allocate a huge array
+    array.data.resize(0);
+    for (unsigned int i = 0; i < size; i++) {
+        double value;
+        ReadBinary(is, value);
+        array.data.conservativeResize(i + 1);
+        array(i) = value;
+    }
+}
+
 }
@@ -60,6 +60,22 @@ std::istream& operator >>(std::istream& is, JntSpaceInertiaMatrix& jntspaceinert
 std::string tree2str(const Tree& tree, const std::string& separator="  ", const std::string& preamble="");
 std::string tree2str(const SegmentMap::const_iterator it, const std::string& separator="  ", const std::string& preamble="", unsigned int level=0);
 
+// Binary I/O, see utilities/binary_io.h. Reading an invalid model
+// throws Error_BasicIO_Binary. Chains and trees keep their joint
+// numbering, including coupled joints.
+void WriteBinary(std::ostream& os, const Joint& joint);
+void WriteBinary(std::ostream& os, const RigidBodyInertia& I);
+void WriteBinary(std::ostream& os, const Segment& segment);
+void WriteBinary(std::ostream& os, const Chain& chain);
+void WriteBinary(std::ostream& os, const Tree& tree);
+void WriteBinary(std::ostream& os, const JntArray& array);
+void ReadBinary(std::istream& is, Joint& joint);
+void ReadBinary(std::istream& is, RigidBodyInertia& I);
+void ReadBinary(std::istream& is, Segment& segment);
+void ReadBinary(std::istream& is, Chain& chain);
+void ReadBinary(std::istream& is, Tree& tree);
+void ReadBinary(std::istream& is, JntArray& array);
+
     /*
 template<typename T>
 std::ostream& operator<<(std::ostream& os, const std::vector<T>& vec) {
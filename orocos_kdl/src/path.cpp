@@ -51,6 +51,7 @@
 #include "path_composite.hpp"
 #include "path_roundedcomposite.hpp"
 #include "path_cyclic_closed.hpp"
+#include "path_spline.hpp"
 #include <memory>
 #include <string.h>
 
@@ -157,11 +158,80 @@ Path* Path::Read(std::istream& is) {
 		IOTracePop();
 		IOTracePop();
 		return new Path_Cyclic_Closed(tr.release(),times);
+	} else if (strcmp(storage,"SPLINE")==0) {
+		IOTrace("SPLINE");
+		double eqradius;
+		is >> eqradius;
+		int size;
+		is >> size;
+		//read frame by frame, a corrupt size must not allocate a huge vector
+		std::vector<Frame> frames;
+		for (int i=0;i<size;i++) {
+			Frame f;
+			is >> f;
+			frames.push_back(f);
+		}
+		EatEnd(is,']');
+		IOTracePop();
+		IOTracePop();
+		return new Path_Spline(frames,eqradius);
 	} else {
 		throw Error_MotionIO_Unexpected_Traj();
 	}
 	return NULL; // just to avoid the warning;
 }
 
+void Path::WriteBinary(std::ostream& /*os*/) {
+	throw Error_Not_Implemented();
+}
+
+Path* Path::ReadBinary(std::istream& is) {
+	unsigned int type;
+	KDL::ReadBinary(is,type);
+	switch (type) {
+	case ID_POINT: {
+		Frame startpos;
+		KDL::ReadBinary(is,startpos);
+		return new Path_Point(startpos);
+	}
+	case ID_LINE:
+		return Path_Line::ReadBinaryContent(is);
+	case ID_CIRCLE:
+		return Path_Circle::ReadBinaryContent(is);
+	case ID_COMPOSITE: {
+		unsigned int size;
+		KDL::ReadBinary(is,size);
+		scoped_ptr<Path_Composite> tr( new Path_Composite() );
+		for (unsigned int i=0;i<size;i++)
+			tr->Add(Path::ReadBinary(is));
+		return tr.release();
+	}
+	case ID_ROUNDED_COMPOSITE:
+		return Path_RoundedComposite::ReadBinaryContent(is);
+	case ID_CYCLIC_CLOSED: {
+		scoped_ptr<Path> tr( Path::ReadBinary(is) );
+		unsigned int times;
+		KDL::ReadBinary(is,times);
+		return new Path_Cyclic_Closed(tr.release(),times);
+	}
+	case ID_SPLINE: {
+		double eqradius;
+		unsigned int size;
+		KDL::ReadBinary(is,eqradius);
+		KDL::ReadBinary(is,size);
+		//read frame by frame, a corrupt size must not allocate a huge vector
+		std::vector<Frame> frames;
+		for (unsigned int i=0;i<size;i++) {
+			Frame f;
+			KDL::ReadBinary(is,f);
+			frames.push_back(f);
+		}
+		return new Path_Spline(frames,eqradius);
+	}
+	default:
+		throw Error_MotionIO_Unexpected_Traj();
+	}
+}
+
 }
 
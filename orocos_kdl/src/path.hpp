@@ -64,7 +64,8 @@ class Path
 			ID_COMPOSITE=3,
 			ID_ROUNDED_COMPOSITE=4,
 			ID_POINT=5,
-			ID_CYCLIC_CLOSED=6
+			ID_CYCLIC_CLOSED=6,
+			ID_SPLINE=7
 		};
 		/**
 		 * LengthToS() converts a physical length along the trajectory
@@ -116,6 +117,21 @@ class Path
 		 */
 		static Path* Read(std::istream& is);
 
+		/**
+		 * Writes the complete state of one of the derived objects to the
+		 * stream in the binary format of utilities/binary_io.h, starting
+		 * with getIdentifier() as type tag.
+		 * Throws Error_Not_Implemented if the derived object does not
+		 * support it.
+		 */
+		virtual void WriteBinary(std::ostream& os);
+
+		/**
+		 * Reads an object written by WriteBinary() and returns a pointer
+		 * (factory method). The read object owns all its parts.
+		 */
+		static Path* ReadBinary(std::istream& is);
+
 		/**
 		 * Virtual constructor, constructing by copying,
 		 * Returns a deep copy of this Path Object
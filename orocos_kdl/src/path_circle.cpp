@@ -42,6 +42,7 @@
 
 #include "path_circle.hpp"
 #include "utilities/error.h"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -167,4 +168,38 @@ void Path_Circle::Write(std::ostream& os) {
 	os << "]"<< std::endl;
 }
 
+Path_Circle::Path_Circle():
+	orient(NULL),
+	radius(0),
+	eqradius(0),
+	pathlength(0),
+	scalelin(1),
+	scalerot(1),
+	aggregate(true)
+{
+}
+
+void Path_Circle::WriteBinary(std::ostream& os) {
+	KDL::WriteBinary(os,(unsigned int)ID_CIRCLE);
+	orient->WriteBinary(os);
+	KDL::WriteBinary(os,radius);
+	KDL::WriteBinary(os,F_base_center);
+	KDL::WriteBinary(os,eqradius);
+	KDL::WriteBinary(os,pathlength);
+	KDL::WriteBinary(os,scalelin);
+	KDL::WriteBinary(os,scalerot);
+}
+
+Path_Circle* Path_Circle::ReadBinaryContent(std::istream& is) {
+	scoped_ptr<Path_Circle> path( new Path_Circle() );
+	path->orient = RotationalInterpolation::ReadBinary(is);
+	KDL::ReadBinary(is,path->radius);
+	KDL::ReadBinary(is,path->F_base_center);
+	KDL::ReadBinary(is,path->eqradius);
+	KDL::ReadBinary(is,path->pathlength);
+	KDL::ReadBinary(is,path->scalelin);
+	KDL::ReadBinary(is,path->scalerot);
+	return path.release();
+}
+
 }
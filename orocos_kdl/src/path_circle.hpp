@@ -77,6 +77,7 @@ class Path_Circle : public Path
 
 		bool aggregate;
 
+		Path_Circle();
 	public:
 
 		/**
@@ -100,6 +101,11 @@ class Path_Circle : public Path
 		virtual Twist Acc(double s,double sd,double sdd) const;
 		virtual Path* Clone();
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static Path_Circle* ReadBinaryContent(std::istream& is);
 
 		/**
 		 * gets an identifier indicating the type of this Path object
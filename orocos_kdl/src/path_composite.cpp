@@ -127,6 +127,13 @@ void Path_Composite::Write(std::ostream& os)  {
 	os << "]" << std::endl;
 }
 
+void Path_Composite::WriteBinary(std::ostream& os)  {
+	KDL::WriteBinary(os,(unsigned int)ID_COMPOSITE);
+	KDL::WriteBinary(os,(unsigned int)dv.size());
+	for (unsigned int i=0;i<dv.size();i++)
+		gv[i].first->WriteBinary(os);
+}
+
 int Path_Composite::GetNrOfSegments() {
 	return static_cast<int>(dv.size());
 }
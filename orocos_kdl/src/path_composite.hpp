@@ -123,6 +123,7 @@ namespace KDL {
 		 * Writes one of the derived objects to the stream
 		 */
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
 
 		/**
 		 * returns the number of underlying segments.
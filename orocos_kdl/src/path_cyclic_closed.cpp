@@ -86,5 +86,11 @@ void Path_Cyclic_Closed::Write(std::ostream& os)  {
 	os << "]"  << std::endl;
 }
 
+void Path_Cyclic_Closed::WriteBinary(std::ostream& os)  {
+	KDL::WriteBinary(os,(unsigned int)ID_CYCLIC_CLOSED);
+	geom->WriteBinary(os);
+	KDL::WriteBinary(os,(unsigned int)times);
+}
+
 }
 
@@ -71,6 +71,7 @@ namespace KDL {
 		virtual Twist Acc(double s,double sd,double sdd) const;
 
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
 		static Path* Read(std::istream& is);
 		virtual Path* Clone();
 		/**
@@ -41,6 +41,7 @@
 
 
 #include "path_line.hpp"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -126,6 +127,16 @@ Path_Line::Path_Line(const Frame& startpos,
         }
    }
 
+Path_Line::Path_Line():
+	orient(NULL),
+	eqradius(0),
+	pathlength(0),
+	scalelin(1),
+	scalerot(1),
+	aggregate(true)
+   {
+   }
+
 double Path_Line::LengthToS(double length) {
 	return length/scalelin;
 }
@@ -179,6 +190,31 @@ void Path_Line::Write(std::ostream& os)  {
 	os << "]"  << std::endl;
 }
 
+void Path_Line::WriteBinary(std::ostream& os)  {
+	KDL::WriteBinary(os,(unsigned int)ID_LINE);
+	orient->WriteBinary(os);
+	KDL::WriteBinary(os,V_base_start);
+	KDL::WriteBinary(os,V_base_end);
+	KDL::WriteBinary(os,V_start_end);
+	KDL::WriteBinary(os,eqradius);
+	KDL::WriteBinary(os,pathlength);
+	KDL::WriteBinary(os,scalelin);
+	KDL::WriteBinary(os,scalerot);
+}
+
+Path_Line* Path_Line::ReadBinaryContent(std::istream& is)  {
+	scoped_ptr<Path_Line> path( new Path_Line() );
+	path->orient = RotationalInterpolation::ReadBinary(is);
+	KDL::ReadBinary(is,path->V_base_start);
+	KDL::ReadBinary(is,path->V_base_end);
+	KDL::ReadBinary(is,path->V_start_end);
+	KDL::ReadBinary(is,path->eqradius);
+	KDL::ReadBinary(is,path->pathlength);
+	KDL::ReadBinary(is,path->scalelin);
+	KDL::ReadBinary(is,path->scalerot);
+	return path.release();
+}
+
 
 }
 
@@ -74,6 +74,8 @@ class Path_Line : public Path
 		double scalerot;
 
 		bool aggregate;
+
+		Path_Line();
 	public:
 		/**
 		 * Constructs a Line Path
@@ -120,6 +122,11 @@ class Path_Line : public Path
 		virtual Twist Vel(double s,double sd) const ;
 		virtual Twist Acc(double s,double sd,double sdd) const;
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static Path_Line* ReadBinaryContent(std::istream& is);
 		virtual Path* Clone();
 
 		/**
@@ -78,6 +78,11 @@ void Path_Point::Write(std::ostream& os)  {
 	os << "POINT[ "<< F_base_start  << "]"  << std::endl;
 }
 
+void Path_Point::WriteBinary(std::ostream& os)  {
+	KDL::WriteBinary(os,(unsigned int)ID_POINT);
+	KDL::WriteBinary(os,F_base_start);
+}
+
 
 }
 
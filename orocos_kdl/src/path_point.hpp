@@ -72,6 +72,7 @@ class Path_Point : public Path
 		virtual Twist Vel(double s,double sd) const ;
 		virtual Twist Acc(double s,double sd,double sdd) const;
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
 		virtual Path* Clone();
 
 		/**
@@ -169,6 +169,39 @@ void Path_RoundedComposite::Write(std::ostream& os) {
 	comp->Write(os);
 }
 
+void Path_RoundedComposite::WriteBinary(std::ostream& os) {
+	KDL::WriteBinary(os,(unsigned int)ID_ROUNDED_COMPOSITE);
+	comp->WriteBinary(os);
+	KDL::WriteBinary(os,radius);
+	KDL::WriteBinary(os,eqradius);
+	orient->WriteBinary(os);
+	KDL::WriteBinary(os,(unsigned int)nrofpoints);
+	KDL::WriteBinary(os,F_base_start);
+	KDL::WriteBinary(os,F_base_via);
+}
+
+Path_RoundedComposite* Path_RoundedComposite::ReadBinaryContent(std::istream& is) {
+	scoped_ptr<Path> comp( Path::ReadBinary(is) );
+	if (comp->getIdentifier()!=ID_COMPOSITE)
+		throw Error_MotionIO_Unexpected_Traj();
+	double radius;
+	double eqradius;
+	KDL::ReadBinary(is,radius);
+	KDL::ReadBinary(is,eqradius);
+	scoped_ptr<RotationalInterpolation> orient( RotationalInterpolation::ReadBinary(is) );
+	unsigned int nrofpoints;
+	KDL::ReadBinary(is,nrofpoints);
+	Frame F_base_start;
+	Frame F_base_via;
+	KDL::ReadBinary(is,F_base_start);
+	KDL::ReadBinary(is,F_base_via);
+	Path_RoundedComposite* path = new Path_RoundedComposite(
+		static_cast<Path_Composite*>(comp.release()),radius,eqradius,orient.release(),true,nrofpoints);
+	path->F_base_start = F_base_start;
+	path->F_base_via = F_base_via;
+	return path;
+}
+
 int Path_RoundedComposite::GetNrOfSegments() {
 	return comp->GetNrOfSegments();
 }
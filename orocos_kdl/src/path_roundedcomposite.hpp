@@ -154,6 +154,11 @@ class Path_RoundedComposite : public Path
 		 * Writes one of the derived objects to the stream
 		 */
 		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static Path_RoundedComposite* ReadBinaryContent(std::istream& is);
 
 		/**
 		 * returns the number of underlying segments.
@@ -0,0 +1,177 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "path_simplifier.hpp"
+#include "utilities/error.h"
+#include "utilities/scoped_ptr.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace KDL {
+
+    //the errors of shorter splits are not worth starting a thread for
+    static const unsigned int min_frames_per_thread = 2048;
+
+    PathSimplifier::PathSimplifier(double _pos_tolerance, double _rot_tolerance, double _eqradius, unsigned int _nr_of_threads):
+        pos_tolerance(_pos_tolerance), rot_tolerance(_rot_tolerance), eqradius(_eqradius), nr_of_threads(_nr_of_threads)
+    {
+        if (pos_tolerance <= 0 || rot_tolerance <= 0 || nr_of_threads == 0)
+            throw Error_MotionPlanning_Not_Feasible(1);
+        workers.reserve(nr_of_threads - 1);
+    }
+
+    void PathSimplifier::Score(unsigned int i, unsigned int j, unsigned int begin, unsigned int end)
+    {
+        //line segment between i and j
+        double dx = px[j]-px[i], dy = py[j]-py[i], dz = pz[j]-pz[i];
+        double d2 = dx*dx+dy*dy+dz*dz;
+        double inv_d2 = d2 > 0 ? 1/d2 : 0;
+        //single axis interpolation between i and j
+        double c = qx[i]*qx[j]+qy[i]*qy[j]+qz[i]*qz[j]+qw[i]*qw[j];
+        double sign = c < 0 ? -1 : 1;
+        double theta = std::acos(std::min(1.0, sign*c));
+        double sin_theta = std::sin(theta);
+        double dl = length[j]-length[i];
+        double inv_dl = dl > 0 ? 1/dl : 0;
+
+        for (unsigned int k = begin; k < end; k++) {
+            double ex = px[k]-px[i], ey = py[k]-py[i], ez = pz[k]-pz[i];
+            double t = std::min(1.0, std::max(0.0, (ex*dx+ey*dy+ez*dz)*inv_d2));
+            ex -= t*dx;
+            ey -= t*dy;
+            ez -= t*dz;
+            double pos_error = std::sqrt(ex*ex+ey*ey+ez*ez);
+
+            double f = (length[k]-length[i])*inv_dl;
+            double wi = 1-f, wj = f;
+            if (sin_theta > 1e-9) {
+                wi = std::sin((1-f)*theta)/sin_theta;
+                wj = std::sin(f*theta)/sin_theta;
+            }
+            wj *= sign;
+            double ix = wi*qx[i]+wj*qx[j], iy = wi*qy[i]+wj*qy[j];
+            double iz = wi*qz[i]+wj*qz[j], iw = wi*qw[i]+wj*qw[j];
+            double inorm = std::sqrt(ix*ix+iy*iy+iz*iz+iw*iw);
+            double cos_half = std::fabs(ix*qx[k]+iy*qy[k]+iz*qz[k]+iw*qw[k])/inorm;
+            double rot_error = 2*std::acos(std::min(1.0, cos_half));
+
+            score[k] = std::max(pos_error/pos_tolerance, rot_error/rot_tolerance);
+        }
+    }
+
+    void PathSimplifier::Simplify(const std::vector<Frame>& frames, std::vector<unsigned int>& indices)
+    {
+        const unsigned int n = frames.size();
+        indices.clear();
+        if (n == 0)
+            return;
+
+        px.resize(n);
+        py.resize(n);
+        pz.resize(n);
+        qx.resize(n);
+        qy.resize(n);
+        qz.resize(n);
+        qw.resize(n);
+        length.resize(n);
+        for (unsigned int k = 0; k < n; k++) {
+            px[k] = frames[k].p.x();
+            py[k] = frames[k].p.y();
+            pz[k] = frames[k].p.z();
+            frames[k].M.GetQuaternion(qx[k], qy[k], qz[k], qw[k]);
+            if (k == 0)
+                length[k] = 0;
+            else {
+                double dist = (frames[k].p - frames[k-1].p).Norm();
+                double c = std::fabs(qx[k-1]*qx[k]+qy[k-1]*qy[k]+qz[k-1]*qz[k]+qw[k-1]*qw[k]);
+                double angle = 2*std::acos(std::min(1.0, c));
+                length[k] = length[k-1] + std::max(dist, eqradius*angle);
+            }
+        }
+
+        keep.assign(n, false);
+        keep[0] = keep[n-1] = true;
+        score.resize(n);
+        todo.clear();
+        if (n > 2)
+            todo.push_back(std::make_pair(0u, n-1));
+        while (!todo.empty()) {
+            unsigned int i = todo.back().first;
+            unsigned int j = todo.back().second;
+            todo.pop_back();
+
+            //every thread scores its own range of frames, the calling
+            //thread takes the last one
+            unsigned int nr_of_chunks = std::min(nr_of_threads, (j-i-1)/min_frames_per_thread);
+            if (nr_of_chunks > 1) {
+                unsigned int chunk = (j-i-1)/nr_of_chunks;
+                try {
+                    for (unsigned int c = 0; c + 1 < nr_of_chunks; c++) {
+                        unsigned int begin = i+1 + c*chunk;
+                        workers.push_back(std::thread(&PathSimplifier::Score, this, i, j, begin, begin+chunk));
+                    }
+                } catch (...) {
+                    for (unsigned int c = 0; c < workers.size(); c++)
+                        workers[c].join();
+                    workers.clear();
+                    throw;
+                }
+                Score(i, j, i+1 + (nr_of_chunks-1)*chunk, j);
+                for (unsigned int c = 0; c < workers.size(); c++)
+                    workers[c].join();
+                workers.clear();
+            } else
+                Score(i, j, i+1, j);
+
+            unsigned int worst = std::max_element(score.begin()+i+1, score.begin()+j) - score.begin();
+            if (score[worst] > 1) {
+                keep[worst] = true;
+                if (worst - i > 1)
+                    todo.push_back(std::make_pair(i, worst));
+                if (j - worst > 1)
+                    todo.push_back(std::make_pair(worst, j));
+            }
+        }
+
+        for (unsigned int k = 0; k < n; k++)
+            if (keep[k])
+                indices.push_back(k);
+    }
+
+    void PathSimplifier::Simplify(const std::vector<Frame>& frames, std::vector<Frame>& _reduced)
+    {
+        Simplify(frames, kept);
+        _reduced.resize(kept.size());
+        for (unsigned int k = 0; k < kept.size(); k++)
+            _reduced[k] = frames[kept[k]];
+    }
+
+    Path_RoundedComposite* PathSimplifier::RoundedComposite(const std::vector<Frame>& frames, double radius, RotationalInterpolation* orient)
+    {
+        Simplify(frames, reduced);
+        scoped_ptr<Path_RoundedComposite> path(new Path_RoundedComposite(radius, eqradius, orient));
+        for (unsigned int k = 0; k < reduced.size(); k++)
+            path->Add(reduced[k]);
+        path->Finish();
+        return path.release();
+    }
+
+    Path_Spline* PathSimplifier::Spline(const std::vector<Frame>& frames)
+    {
+        Simplify(frames, reduced);
+        return new Path_Spline(reduced, eqradius);
+    }
+
+}
@@ -0,0 +1,129 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_MOTION_PATH_SIMPLIFIER_H
+#define KDL_MOTION_PATH_SIMPLIFIER_H
+
+#include "frames.hpp"
+#include "path_roundedcomposite.hpp"
+#include "path_spline.hpp"
+#include "rotational_interpolation.hpp"
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace KDL {
+
+    /**
+     * \brief Reduces a dense sequence of frames to the way-points that
+     * are needed to stay within a position and orientation tolerance.
+     *
+     * The reduction is the Douglas-Peucker algorithm in SE(3). A
+     * sequence between two kept way-points is replaced by a line as in
+     * Path_Line with single axis rotational interpolation. A frame in
+     * between is within tolerance if its origin is within the position
+     * tolerance of the line segment, and its orientation is within the
+     * orientation tolerance of the interpolated orientation. The
+     * interpolated orientation is taken at the fraction of the
+     * equivalent length (see Path_Line) of the original sequence up to
+     * that frame. Otherwise the frame with the largest relative error
+     * is kept and both halves are reduced further.
+     *
+     * The tolerances hold for lines between the kept way-points. The
+     * rounding of RoundedComposite() and the curvature of Spline() add
+     * deviation on top of this.
+     *
+     * The errors of the frames between two way-points are independent,
+     * for a long sequence they are evaluated by several threads. The
+     * buffers of the reduction are kept between calls, a
+     * PathSimplifier can only be used by one thread at a time.
+     *
+     * @ingroup Motion
+     */
+    class PathSimplifier
+    {
+    public:
+        /**
+         * @param pos_tolerance maximum distance of a removed frame to the
+         * reduced path, > 0
+         * @param rot_tolerance maximum angle between a removed frame and
+         * the reduced path, > 0
+         * @param eqradius equivalent radius : serves to compare rotations
+         * and translations, see Path_Line
+         * @param nr_of_threads number of threads that evaluate the errors
+         * of a long sequence, with 1 all errors are evaluated by the
+         * calling thread
+         *
+         * throws Error_MotionPlanning_Not_Feasible if a tolerance is not
+         * positive or nr_of_threads is 0.
+         */
+        PathSimplifier(double pos_tolerance, double rot_tolerance, double eqradius, unsigned int nr_of_threads = 1);
+
+        /**
+         * Request the indices of the frames that are kept, in increasing
+         * order. The first and the last frame are always kept.
+         */
+        void Simplify(const std::vector<Frame>& frames, std::vector<unsigned int>& indices);
+
+        /**
+         * Request the frames that are kept.
+         */
+        void Simplify(const std::vector<Frame>& frames, std::vector<Frame>& reduced);
+
+        /**
+         * Builds a rounded composite path through the kept frames.
+         *
+         * @param radius radius of the roundings
+         * @param orient rotational interpolation, owned by the returned path
+         *
+         * @warning Can throw Error_MotionPlanning_Not_Feasible, see
+         * Path_RoundedComposite::Add
+         */
+        Path_RoundedComposite* RoundedComposite(const std::vector<Frame>& frames, double radius, RotationalInterpolation* orient);
+
+        /**
+         * Builds a spline path through the kept frames.
+         */
+        Path_Spline* Spline(const std::vector<Frame>& frames);
+
+        double getPosTolerance() const {return pos_tolerance;};
+        double getRotTolerance() const {return rot_tolerance;};
+        double getEqRadius() const {return eqradius;};
+        unsigned int getNrOfThreads() const {return nr_of_threads;};
+
+    private:
+        //errors of the frames begin..end-1 relative to the line from i to j
+        void Score(unsigned int i, unsigned int j, unsigned int begin, unsigned int end);
+
+        double pos_tolerance;
+        double rot_tolerance;
+        double eqradius;
+        unsigned int nr_of_threads;
+        //positions, quaternions and equivalent length along the sequence,
+        //stored per component so that the error loop runs over
+        //contiguous arrays
+        std::vector<double> px, py, pz;
+        std::vector<double> qx, qy, qz, qw;
+        std::vector<double> length;
+        std::vector<double> score;
+        std::vector<bool> keep;
+        std::vector<std::pair<unsigned int, unsigned int> > todo;
+        std::vector<unsigned int> kept;
+        std::vector<Frame> reduced;
+        std::vector<std::thread> workers;
+    };
+
+}
+
+#endif
@@ -0,0 +1,254 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "path_spline.hpp"
+#include "utilities/error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace KDL {
+
+namespace {
+
+	const unsigned int NR_OF_CHANNELS = 7;
+
+	/**
+	 * Angular velocity and acceleration, towards the spline parameter,
+	 * of the normalized quaternion spline with value P and derivatives
+	 * dP and ddP (layout x,y,z,w).
+	 */
+	void QuaternionRates(const double* P,const double* dP,const double* ddP,Vector& w,Vector& a)
+	{
+		double n = std::sqrt(P[0]*P[0]+P[1]*P[1]+P[2]*P[2]+P[3]*P[3]);
+		double q[4],dq[4],ddq[4];
+		double r = 0;
+		for (unsigned int i=0;i<4;i++) {
+			q[i] = P[i]/n;
+			r += q[i]*dP[i];
+		}
+		double dr = 0;
+		for (unsigned int i=0;i<4;i++) {
+			dq[i] = (dP[i]-q[i]*r)/n;
+			dr += dq[i]*dP[i]+q[i]*ddP[i];
+		}
+		for (unsigned int i=0;i<4;i++)
+			ddq[i] = (ddP[i]-2*dq[i]*r-q[i]*dr)/n;
+		// w = 2 vec(dq*conj(q)) and a = 2 vec(ddq*conj(q))
+		Vector qv(q[0],q[1],q[2]);
+		Vector dqv(dq[0],dq[1],dq[2]);
+		Vector ddqv(ddq[0],ddq[1],ddq[2]);
+		w = 2*(q[3]*dqv-dq[3]*qv-dqv*qv);
+		a = 2*(q[3]*ddqv-ddq[3]*qv-ddqv*qv);
+	}
+
+}
+
+Path_Spline::Path_Spline(const std::vector<Frame>& _frames,double _eqradius):
+	frames(_frames),
+	eqradius(_eqradius)
+{
+	if (frames.size()<2)
+		throw Error_MotionPlanning_Not_Feasible(1);
+	nrofsegments = frames.size()-1;
+	Interpolate();
+	Tabulate();
+}
+
+void Path_Spline::Interpolate()
+{
+	const unsigned int n = frames.size();
+	const unsigned int nc = NR_OF_CHANNELS;
+	// values of the channels at the way-points
+	std::vector<double> y(nc*n);
+	for (unsigned int i=0;i<n;i++) {
+		double* yi = &y[nc*i];
+		yi[0] = frames[i].p.x();
+		yi[1] = frames[i].p.y();
+		yi[2] = frames[i].p.z();
+		frames[i].M.GetQuaternion(yi[3],yi[4],yi[5],yi[6]);
+		if (i>0) {
+			// q and -q are the same orientation, take the closest one
+			const double* yp = &y[nc*(i-1)];
+			if (yi[3]*yp[3]+yi[4]*yp[4]+yi[5]*yp[5]+yi[6]*yp[6]<0)
+				for (unsigned int c=3;c<nc;c++)
+					yi[c] = -yi[c];
+		}
+	}
+	// second derivatives at the way-points, zero at both ends.
+	// For unit knot spacing M(i-1)+4M(i)+M(i+1)=6(y(i+1)-2y(i)+y(i-1)),
+	// solved with the Thomas algorithm.
+	std::vector<double> M(nc*n,0.0);
+	std::vector<double> cp(n,0.0);
+	for (unsigned int i=1;i+1<n;i++) {
+		double denom = 4-cp[i-1];
+		cp[i] = 1/denom;
+		for (unsigned int c=0;c<nc;c++)
+			M[nc*i+c] = (6*(y[nc*(i+1)+c]-2*y[nc*i+c]+y[nc*(i-1)+c])-M[nc*(i-1)+c])/denom;
+	}
+	for (unsigned int i=n-2;i>0;i--)
+		for (unsigned int c=0;c<nc;c++)
+			M[nc*i+c] -= cp[i]*M[nc*(i+1)+c];
+
+	coefficients.resize(nrofsegments*nc*4);
+	for (unsigned int i=0;i<nrofsegments;i++) {
+		for (unsigned int c=0;c<nc;c++) {
+			double y0 = y[nc*i+c];
+			double y1 = y[nc*(i+1)+c];
+			double M0 = M[nc*i+c];
+			double M1 = M[nc*(i+1)+c];
+			double* k = &coefficients[(nc*i+c)*4];
+			k[0] = y0;
+			k[1] = y1-y0-(2*M0+M1)/6;
+			k[2] = M0/2;
+			k[3] = (M1-M0)/6;
+		}
+	}
+}
+
+void Path_Spline::Tabulate()
+{
+	const unsigned int N = TABLE_RESOLUTION;
+	const double h = 1.0/N;
+	double value[NR_OF_CHANNELS],d1[NR_OF_CHANNELS],d2[NR_OF_CHANNELS];
+	Vector w,a;
+	// linear and equivalent speed towards the spline parameter at
+	// the samples and the midpoints between them
+	std::vector<double> lin(2*N*nrofsegments+1);
+	std::vector<double> eq(lin.size());
+	for (unsigned int j=0;j<lin.size();j++) {
+		Evaluate(0.5*h*j,value,d1,d2);
+		QuaternionRates(value+3,d1+3,d2+3,w,a);
+		lin[j] = Vector(d1[0],d1[1],d1[2]).Norm();
+		eq[j] = std::max(lin[j],eqradius*w.Norm());
+	}
+	// Simpson's rule on every sample interval
+	lengths.resize(N*nrofsegments+1);
+	speeds.resize(lengths.size());
+	lengths[0] = 0;
+	speeds[0] = lin[0];
+	pathlength = 0;
+	for (unsigned int j=0;j+1<lengths.size();j++) {
+		lengths[j+1] = lengths[j]+h/6*(lin[2*j]+4*lin[2*j+1]+lin[2*j+2]);
+		speeds[j+1] = lin[2*j+2];
+		pathlength += h/6*(eq[2*j]+4*eq[2*j+1]+eq[2*j+2]);
+	}
+	scale = pathlength>0 ? nrofsegments/pathlength : 0;
+}
+
+void Path_Spline::Evaluate(double u,double* value,double* d1,double* d2) const
+{
+	// outside of [0,nrofsegments] the first and last segment are extrapolated
+	unsigned int i = 0;
+	if (u>=nrofsegments)
+		i = nrofsegments-1;
+	else if (u>0)
+		i = (unsigned int)u;
+	double t = u-i;
+	const double* k = &coefficients[i*NR_OF_CHANNELS*4];
+	for (unsigned int c=0;c<NR_OF_CHANNELS;c++,k+=4) {
+		value[c] = k[0]+t*(k[1]+t*(k[2]+t*k[3]));
+		d1[c] = k[1]+t*(2*k[2]+t*3*k[3]);
+		d2[c] = 2*k[2]+t*6*k[3];
+	}
+}
+
+double Path_Spline::LengthToS(double length)
+{
+	if (scale==0)
+		return 0;
+	int j = std::upper_bound(lengths.begin(),lengths.end(),length)-lengths.begin()-1;
+	j = std::max(0,std::min(j,(int)lengths.size()-2));
+	double h = 1.0/TABLE_RESOLUTION;
+	double dl = lengths[j+1]-lengths[j];
+	double t = 0;
+	if (dl>0) {
+		// linear estimate improved with a Newton step on the cubic
+		// Hermite interpolation of the length over the sample interval
+		t = (length-lengths[j])/dl;
+		double m0 = speeds[j]*h;
+		double m1 = speeds[j+1]*h;
+		double t2 = t*t;
+		double t3 = t2*t;
+		double l = (2*t3-3*t2+1)*lengths[j]+(t3-2*t2+t)*m0+(-2*t3+3*t2)*lengths[j+1]+(t3-t2)*m1;
+		double dldt = (6*t2-6*t)*lengths[j]+(3*t2-4*t+1)*m0+(-6*t2+6*t)*lengths[j+1]+(3*t2-2*t)*m1;
+		if (dldt>0)
+			t -= (l-length)/dldt;
+	}
+	return (j+t)*h/scale;
+}
+
+double Path_Spline::PathLength()
+{
+	return pathlength;
+}
+
+Frame Path_Spline::Pos(double s) const
+{
+	double value[NR_OF_CHANNELS],d1[NR_OF_CHANNELS],d2[NR_OF_CHANNELS];
+	Evaluate(s*scale,value,d1,d2);
+	double n = std::sqrt(value[3]*value[3]+value[4]*value[4]+value[5]*value[5]+value[6]*value[6]);
+	return Frame(Rotation::Quaternion(value[3]/n,value[4]/n,value[5]/n,value[6]/n),
+		Vector(value[0],value[1],value[2]));
+}
+
+Twist Path_Spline::Vel(double s,double sd) const
+{
+	double value[NR_OF_CHANNELS],d1[NR_OF_CHANNELS],d2[NR_OF_CHANNELS];
+	Vector w,a;
+	Evaluate(s*scale,value,d1,d2);
+	QuaternionRates(value+3,d1+3,d2+3,w,a);
+	double ud = sd*scale;
+	return Twist(Vector(d1[0],d1[1],d1[2])*ud,w*ud);
+}
+
+Twist Path_Spline::Acc(double s,double sd,double sdd) const
+{
+	double value[NR_OF_CHANNELS],d1[NR_OF_CHANNELS],d2[NR_OF_CHANNELS];
+	Vector w,a;
+	Evaluate(s*scale,value,d1,d2);
+	QuaternionRates(value+3,d1+3,d2+3,w,a);
+	double ud = sd*scale;
+	double udd = sdd*scale;
+	return Twist(Vector(d2[0],d2[1],d2[2])*ud*ud+Vector(d1[0],d1[1],d1[2])*udd,
+		a*ud*ud+w*udd);
+}
+
+void Path_Spline::Write(std::ostream& os)
+{
+	os << "SPLINE[ " << eqradius << std::endl;
+	os << "  " << frames.size() << std::endl;
+	for (unsigned int i=0;i<frames.size();i++)
+		os << "  " << frames[i] << std::endl;
+	os << "]" << std::endl;
+}
+
+void Path_Spline::WriteBinary(std::ostream& os)
+{
+	KDL::WriteBinary(os,(unsigned int)ID_SPLINE);
+	KDL::WriteBinary(os,eqradius);
+	KDL::WriteBinary(os,(unsigned int)frames.size());
+	for (unsigned int i=0;i<frames.size();i++)
+		KDL::WriteBinary(os,frames[i]);
+}
+
+Path* Path_Spline::Clone()
+{
+	return new Path_Spline(frames,eqradius);
+}
+
+Path_Spline::~Path_Spline()
+{
+}
+
+}
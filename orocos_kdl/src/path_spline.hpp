@@ -0,0 +1,122 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_MOTION_PATH_SPLINE_H
+#define KDL_MOTION_PATH_SPLINE_H
+
+#include "path.hpp"
+#include <vector>
+
+namespace KDL {
+
+/**
+ * A smooth path through a list of frames.
+ *
+ * The position is a natural cubic spline through the origins of the
+ * frames, the orientation is a natural cubic spline through the unit
+ * quaternions of the frames (signs chosen so that successive
+ * quaternions are in the same half-space), normalized onto the unit
+ * sphere. Both are twice continuously differentiable, so the path has
+ * no curvature or angular acceleration jumps at the way-points.
+ *
+ * The way-points are uniformly parameterized: the path parameter s is
+ * proportional to the spline parameter, s=0 is the first frame and
+ * s=PathLength() the last. The spline segment of s is found in constant
+ * time and the polynomial coefficients of all segments are stored in
+ * one contiguous array.
+ *
+ * PathLength() is the equivalent length of the path: the integral of
+ * the largest of the linear velocity and eqradius times the angular
+ * velocity, as in Path_Line. Since s is not an arc length, the speed
+ * along the path varies with the spacing of the way-points.
+ * LengthToS() uses a table of the linear arc length that is computed
+ * at construction.
+ *
+ * @ingroup Motion
+ */
+class Path_Spline : public Path
+	{
+		std::vector<Frame> frames;
+		double eqradius;
+
+		unsigned int nrofsegments;
+		//per segment 7 channels (x,y,z,qx,qy,qz,qw) with 4 polynomial
+		//coefficients each, in increasing order of the power
+		std::vector<double> coefficients;
+		//linear arc length and its derivative to the spline parameter
+		//at TABLE_RESOLUTION samples per segment
+		std::vector<double> lengths;
+		std::vector<double> speeds;
+
+		double pathlength;
+		//derivative of the spline parameter to s
+		double scale;
+
+		/**
+		 * Evaluates the channels of the spline and their first and
+		 * second derivatives towards the spline parameter u.
+		 */
+		void Evaluate(double u,double* value,double* d1,double* d2) const;
+		void Interpolate();
+		void Tabulate();
+	public:
+		enum {TABLE_RESOLUTION=32};
+
+		/**
+		 * Constructs a spline path.
+		 *
+		 * @param frames the way-points, at least two
+		 * @param eqradius equivalent radius : serves to compare
+		 * rotations and translations, see Path_Line
+		 *
+		 * throws Error_MotionPlanning_Not_Feasible if less than two
+		 * frames are given.
+		 */
+		Path_Spline(const std::vector<Frame>& frames,double eqradius);
+
+		virtual double LengthToS(double length);
+		virtual double PathLength();
+		virtual Frame Pos(double s) const;
+		virtual Twist Vel(double s,double sd) const;
+		virtual Twist Acc(double s,double sd,double sdd) const;
+		virtual void Write(std::ostream& os);
+		virtual void WriteBinary(std::ostream& os);
+		virtual Path* Clone();
+
+		/**
+		 * gets an identifier indicating the type of this Path object
+		 */
+		virtual IdentifierType getIdentifier() const {
+			return ID_SPLINE;
+		}
+
+		/**
+		 * The number of way-points of the path.
+		 */
+		unsigned int GetNrOfFrames() const {
+			return frames.size();
+		}
+		/**
+		 * The i-th way-point of the path.
+		 */
+		const Frame& GetFrame(unsigned int i) const {
+			return frames[i];
+		}
+
+		virtual ~Path_Spline();
+	};
+
+}
+
+#endif
@@ -79,4 +79,19 @@ RotationalInterpolation* RotationalInterpolation::Read(std::istream& is) {
 	return NULL; // just to avoid the warning;
 }
 
+void RotationalInterpolation::WriteBinary(std::ostream& /*os*/) const {
+	throw Error_Not_Implemented();
+}
+
+RotationalInterpolation* RotationalInterpolation::ReadBinary(std::istream& is) {
+	unsigned int type;
+	KDL::ReadBinary(is,type);
+	switch (type) {
+	case BINARY_SINGLEAXIS:
+		return RotationalInterpolation_SingleAxis::ReadBinaryContent(is);
+	default:
+		throw Error_MotionIO_Unexpected_Traj();
+	}
+}
+
 }
@@ -104,6 +104,27 @@ class RotationalInterpolation
 		 */
 		static RotationalInterpolation* Read(std::istream& is);
 
+		/**
+		 * Type tags of the binary format.
+		 */
+		enum BinaryType {
+			BINARY_SINGLEAXIS=1
+		};
+
+		/**
+		 * Writes the complete state of one of the derived objects to the
+		 * stream in the binary format of utilities/binary_io.h.
+		 * Throws Error_Not_Implemented if the derived object does not
+		 * support it.
+		 */
+		virtual void WriteBinary(std::ostream& os) const;
+
+		/**
+		 * Reads an object written by WriteBinary() and returns a pointer
+		 * (factory method)
+		 */
+		static RotationalInterpolation* ReadBinary(std::istream& is);
+
 		/**
 		 * virtual constructor,  construction by copying ..
 		 */
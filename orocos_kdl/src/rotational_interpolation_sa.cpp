@@ -42,6 +42,7 @@
 
 #include "rotational_interpolation_sa.hpp"
 #include "trajectory.hpp"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -73,7 +74,24 @@ double RotationalInterpolation_SingleAxis::Angle() {
 }
 
 void RotationalInterpolation_SingleAxis::Write(std::ostream& os) const {
-	os << "SingleAxis[] " << std::endl;
+	os << "SINGLEAXIS[] " << std::endl;
+}
+
+void RotationalInterpolation_SingleAxis::WriteBinary(std::ostream& os) const {
+	KDL::WriteBinary(os,(unsigned int)BINARY_SINGLEAXIS);
+	KDL::WriteBinary(os,R_base_start);
+	KDL::WriteBinary(os,R_base_end);
+	KDL::WriteBinary(os,rot_start_end);
+	KDL::WriteBinary(os,angle);
+}
+
+RotationalInterpolation_SingleAxis* RotationalInterpolation_SingleAxis::ReadBinaryContent(std::istream& is) {
+	scoped_ptr<RotationalInterpolation_SingleAxis> r( new RotationalInterpolation_SingleAxis() );
+	KDL::ReadBinary(is,r->R_base_start);
+	KDL::ReadBinary(is,r->R_base_end);
+	KDL::ReadBinary(is,r->rot_start_end);
+	KDL::ReadBinary(is,r->angle);
+	return r.release();
 }
 
 RotationalInterpolation_SingleAxis::~RotationalInterpolation_SingleAxis() {
@@ -74,6 +74,11 @@ class RotationalInterpolation_SingleAxis: public RotationalInterpolation
 		virtual Vector Vel(double th,double thd) const;
 		virtual Vector Acc(double th,double thd,double thdd)   const;
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static RotationalInterpolation_SingleAxis* ReadBinaryContent(std::istream& is);
 		virtual RotationalInterpolation* Clone() const;
 		virtual ~RotationalInterpolation_SingleAxis();
 	};
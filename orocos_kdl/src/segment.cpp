@@ -18,6 +18,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
 
 #include "segment.hpp"
+#include "jntarray.hpp"
 
 namespace KDL {
 
@@ -64,6 +65,42 @@ namespace KDL {
         return joint.twist(qdot).RefPoint(joint.pose(q).M * f_tip.p);
     }
 
+    Frame Segment::pose(const JntArray& q, unsigned int q_nr)const
+    {
+        return joint.pose(q,q_nr)*f_tip;
+    }
+
+    Twist Segment::twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const
+    {
+        return joint.twist(q,qdot,q_nr).RefPoint(joint.pose(q,q_nr).M * f_tip.p);
+    }
+
+    Twist Segment::unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof)const
+    {
+        return joint.unitTwist(q,q_nr,dof).RefPoint(joint.pose(q,q_nr).M * f_tip.p);
+    }
+
+    Twist Segment::biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const
+    {
+        return joint.biasTwist(q,qdot,q_nr).RefPoint(joint.pose(q,q_nr).M * f_tip.p);
+    }
+
+    //M*f_tip.M.Inverse() is the rotation of the joint
+    Twist Segment::twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr, const Rotation& M)const
+    {
+        return joint.twist(q,qdot,q_nr).RefPoint(M * f_tip.M.Inverse(f_tip.p));
+    }
+
+    Twist Segment::unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof, const Rotation& M)const
+    {
+        return joint.unitTwist(q,q_nr,dof).RefPoint(M * f_tip.M.Inverse(f_tip.p));
+    }
+
+    Twist Segment::biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr, const Rotation& M)const
+    {
+        return joint.biasTwist(q,qdot,q_nr).RefPoint(M * f_tip.M.Inverse(f_tip.p));
+    }
+
     void Segment::setFrameToTip(const Frame& f_tip_new)
     {
         f_tip = joint.pose(0).Inverse() * f_tip_new;
@@ -99,6 +99,68 @@ namespace KDL {
          */
         Twist twist(const double& q,const double& qdot)const;
 
+        /**
+         * Request the pose of the segment, reading the joint position
+         * from q starting at index q_nr. Works for joints of any number
+         * of DOFs, see Joint::getNrOfDofs().
+         *
+         * @param q joint positions of the whole chain or tree
+         * @param q_nr index of the first DOF of the joint in q
+         *
+         * @return pose from the root to the tip of the segment
+         */
+        Frame pose(const JntArray& q, unsigned int q_nr)const;
+        /**
+         * Request the 6D-velocity of the tip of the segment, reading
+         * the joint position and velocity starting at index q_nr.
+         *
+         * @param q joint positions of the whole chain or tree
+         * @param qdot joint velocities of the whole chain or tree
+         * @param q_nr index of the first DOF of the joint in q and qdot
+         *
+         * @return 6D-velocity of the tip of the segment, expressed
+         *in the base-frame of the segment(root) and with the tip of
+         *the segment as reference point.
+         */
+        Twist twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const;
+        /**
+         * Request the 6D-velocity of the tip of the segment caused by a
+         * unit velocity of one DOF of the joint, in the same frame as
+         * twist(q,qdot,q_nr).
+         *
+         * @param q joint positions of the whole chain or tree
+         * @param q_nr index of the first DOF of the joint in q
+         * @param dof which DOF of the joint
+         *
+         * @return unit twist of the tip of the segment
+         */
+        Twist unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof)const;
+        /**
+         * Request the velocity-product acceleration of the tip of the
+         * segment due to the joint motion, in the same frame as
+         * twist(q,qdot,q_nr). Zero for single axis joints.
+         *
+         * @param q joint positions of the whole chain or tree
+         * @param qdot joint velocities of the whole chain or tree
+         * @param q_nr index of the first DOF of the joint in q and qdot
+         *
+         * @return bias acceleration of the tip of the segment
+         */
+        Twist biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr)const;
+
+        /**
+         * Same as twist(q,qdot,q_nr) for solvers that already
+         * calculated pose(q,q_nr): the joint pose is not evaluated
+         * again.
+         *
+         * @param M the rotation of pose(q,q_nr)
+         */
+        Twist twist(const JntArray& q, const JntArray& qdot, unsigned int q_nr, const Rotation& M)const;
+        /// Same as unitTwist(q,q_nr,dof), see twist(q,qdot,q_nr,M)
+        Twist unitTwist(const JntArray& q, unsigned int q_nr, unsigned int dof, const Rotation& M)const;
+        /// Same as biasTwist(q,qdot,q_nr), see twist(q,qdot,q_nr,M)
+        Twist biasTwist(const JntArray& q, const JntArray& qdot, unsigned int q_nr, const Rotation& M)const;
+
         /**
          * Request the name of the segment
          *
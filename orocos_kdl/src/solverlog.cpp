@@ -0,0 +1,333 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "solverlog.hpp"
+#include "frames_io.hpp"
+#include "kinfam_io.hpp"
+#include "utilities/error.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace KDL {
+
+    namespace {
+
+        enum RecordType {STREAM_RECORD=1, CALL_RECORD=2};
+
+        void writeCall(std::ostream& os, SolverLogStream::Type type, const SolverCall& call)
+        {
+            WriteBinary(os, call.stream);
+            WriteBinary(os, call.q);
+            switch (type) {
+            case SolverLogStream::CHAIN_FK_POS:
+                WriteBinary(os, (unsigned int)call.segment_nr);
+                WriteBinary(os, call.frame);
+                break;
+            case SolverLogStream::CHAIN_IK_VEL:
+                WriteBinary(os, call.twist);
+                WriteBinary(os, call.q_out);
+                break;
+            case SolverLogStream::CHAIN_IK_POS:
+                WriteBinary(os, call.frame);
+                WriteBinary(os, call.q_out);
+                break;
+            case SolverLogStream::CHAIN_ID:
+                WriteBinary(os, call.qdot);
+                WriteBinary(os, call.qdotdot);
+                WriteBinary(os, (unsigned int)call.f_ext.size());
+                for (unsigned int i = 0; i < call.f_ext.size(); i++)
+                    WriteBinary(os, call.f_ext[i]);
+                WriteBinary(os, call.q_out);
+                break;
+            case SolverLogStream::TREE_FK_POS:
+                WriteBinary(os, call.segment_name);
+                WriteBinary(os, call.frame);
+                break;
+            case SolverLogStream::TREE_ID:
+                WriteBinary(os, call.qdot);
+                WriteBinary(os, call.qdotdot);
+                WriteBinary(os, (unsigned int)call.f_ext_tree.size());
+                for (WrenchMap::const_iterator it = call.f_ext_tree.begin(); it != call.f_ext_tree.end(); ++it) {
+                    WriteBinary(os, it->first);
+                    WriteBinary(os, it->second);
+                }
+                WriteBinary(os, call.q_out);
+                break;
+            }
+            WriteBinary(os, (unsigned int)call.result);
+            WriteBinary(os, call.duration);
+        }
+
+        void readCall(std::istream& is, const std::vector<SolverLogStream>& streams, SolverCall& call)
+        {
+            unsigned int value;
+            ReadBinary(is, call.stream);
+            if (call.stream >= streams.size())
+                throw Error_BasicIO_Binary();
+            ReadBinary(is, call.q);
+            switch (streams[call.stream].type) {
+            case SolverLogStream::CHAIN_FK_POS:
+                ReadBinary(is, value);
+                call.segment_nr = (int)value;
+                ReadBinary(is, call.frame);
+                break;
+            case SolverLogStream::CHAIN_IK_VEL:
+                ReadBinary(is, call.twist);
+                ReadBinary(is, call.q_out);
+                break;
+            case SolverLogStream::CHAIN_IK_POS:
+                ReadBinary(is, call.frame);
+                ReadBinary(is, call.q_out);
+                break;
+            case SolverLogStream::CHAIN_ID:
+                ReadBinary(is, call.qdot);
+                ReadBinary(is, call.qdotdot);
+                ReadBinary(is, value);
+                call.f_ext.clear();
+                for (unsigned int i = 0; i < value; i++) {
+                    Wrench f;
+                    ReadBinary(is, f);
+                    call.f_ext.push_back(f);
+                }
+                ReadBinary(is, call.q_out);
+                break;
+            case SolverLogStream::TREE_FK_POS:
+                ReadBinary(is, call.segment_name);
+                ReadBinary(is, call.frame);
+                break;
+            case SolverLogStream::TREE_ID:
+                ReadBinary(is, call.qdot);
+                ReadBinary(is, call.qdotdot);
+                ReadBinary(is, value);
+                call.f_ext_tree.clear();
+                for (unsigned int i = 0; i < value; i++) {
+                    std::string name;
+                    Wrench f;
+                    ReadBinary(is, name);
+                    ReadBinary(is, f);
+                    call.f_ext_tree[name] = f;
+                }
+                ReadBinary(is, call.q_out);
+                break;
+            }
+            ReadBinary(is, value);
+            call.result = (int)value;
+            ReadBinary(is, call.duration);
+        }
+
+        double now()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        double divergence(const JntArray& a, const JntArray& b)
+        {
+            if (a.rows() != b.rows())
+                return std::numeric_limits<double>::infinity();
+            double result = 0.0;
+            for (unsigned int i = 0; i < a.rows(); i++)
+                result = std::max(result, std::fabs(a(i) - b(i)));
+            return result;
+        }
+
+        double divergence(const Frame& a, const Frame& b)
+        {
+            Twist t = diff(a, b);
+            return std::max(t.vel.Norm(), t.rot.Norm());
+        }
+    }
+
+    SolverLogStream::SolverLogStream():
+        type(CHAIN_FK_POS), gravity(Vector::Zero())
+    {
+    }
+
+    SolverLogStream::SolverLogStream(Type _type, const std::string& _solver, const Chain& _chain, const Vector& _gravity):
+        type(_type), solver(_solver), chain(_chain), gravity(_gravity)
+    {
+    }
+
+    SolverLogStream::SolverLogStream(Type _type, const std::string& _solver, const Tree& _tree, const Vector& _gravity):
+        type(_type), solver(_solver), tree(_tree), gravity(_gravity)
+    {
+    }
+
+    SolverCall::SolverCall():
+        stream(0), segment_nr(-1), result(0), duration(0.0)
+    {
+    }
+
+    SolverLogWriter::SolverLogWriter(std::ostream& _os):
+        os(_os), nr_of_calls(0)
+    {
+        WriteBinaryHeader(os);
+        os.flush();
+    }
+
+    unsigned int SolverLogWriter::addStream(const SolverLogStream& stream)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        WriteBinary(os, (unsigned int)STREAM_RECORD);
+        WriteBinary(os, (unsigned int)stream.type);
+        WriteBinary(os, stream.solver);
+        if (stream.isTree())
+            WriteBinary(os, stream.tree);
+        else
+            WriteBinary(os, stream.chain);
+        WriteBinary(os, stream.gravity);
+        WriteBinary(os, (unsigned int)stream.parameters.size());
+        for (SolverParameters::const_iterator it = stream.parameters.begin(); it != stream.parameters.end(); ++it) {
+            WriteBinary(os, it->first);
+            WriteBinary(os, it->second);
+        }
+        types.push_back(stream.type);
+        return types.size() - 1;
+    }
+
+    void SolverLogWriter::addCall(const SolverCall& call)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (call.stream >= types.size())
+            return;
+        WriteBinary(os, (unsigned int)CALL_RECORD);
+        writeCall(os, types[call.stream], call);
+        nr_of_calls++;
+    }
+
+    unsigned int SolverLogWriter::getNrOfStreams() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return types.size();
+    }
+
+    unsigned long SolverLogWriter::getNrOfCalls() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nr_of_calls;
+    }
+
+    SolverLog::SolverLog(std::istream& is):
+        truncated(false)
+    {
+        ReadBinaryHeader(is);
+        while (is.peek() != std::char_traits<char>::eof()) {
+            try {
+                unsigned int record;
+                ReadBinary(is, record);
+                if (record == STREAM_RECORD) {
+                    SolverLogStream stream;
+                    unsigned int type;
+                    ReadBinary(is, type);
+                    if (type < SolverLogStream::CHAIN_FK_POS || type > SolverLogStream::TREE_ID)
+                        throw Error_BasicIO_Binary();
+                    stream.type = (SolverLogStream::Type)type;
+                    ReadBinary(is, stream.solver);
+                    if (stream.isTree())
+                        ReadBinary(is, stream.tree);
+                    else
+                        ReadBinary(is, stream.chain);
+                    ReadBinary(is, stream.gravity);
+                    unsigned int nr_of_parameters;
+                    ReadBinary(is, nr_of_parameters);
+                    for (unsigned int i = 0; i < nr_of_parameters; i++) {
+                        std::string name;
+                        ReadBinary(is, name);
+                        ReadBinary(is, stream.parameters[name]);
+                    }
+                    streams.push_back(stream);
+                }
+                else if (record == CALL_RECORD) {
+                    SolverCall call;
+                    readCall(is, streams, call);
+                    calls.push_back(call);
+                }
+                else
+                    throw Error_BasicIO_Binary();
+            }
+            catch (const Error_BasicIO_File&) {
+                truncated = true;
+                return;
+            }
+        }
+    }
+
+    int Replay(const SolverCall& call, ChainFkSolverPos& solver, SolverCall& result)
+    {
+        result = call;
+        result.frame = Frame::Identity();
+        double start = now();
+        result.result = solver.JntToCart(call.q, result.frame, call.segment_nr);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    int Replay(const SolverCall& call, ChainIkSolverVel& solver, SolverCall& result)
+    {
+        result = call;
+        SetToZero(result.q_out);
+        double start = now();
+        result.result = solver.CartToJnt(call.q, call.twist, result.q_out);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    int Replay(const SolverCall& call, ChainIkSolverPos& solver, SolverCall& result)
+    {
+        result = call;
+        SetToZero(result.q_out);
+        double start = now();
+        result.result = solver.CartToJnt(call.q, call.frame, result.q_out);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    int Replay(const SolverCall& call, ChainIdSolver& solver, SolverCall& result)
+    {
+        result = call;
+        SetToZero(result.q_out);
+        double start = now();
+        result.result = solver.CartToJnt(call.q, call.qdot, call.qdotdot, call.f_ext, result.q_out);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    int Replay(const SolverCall& call, TreeFkSolverPos& solver, SolverCall& result)
+    {
+        result = call;
+        result.frame = Frame::Identity();
+        double start = now();
+        result.result = solver.JntToCart(call.q, result.frame, call.segment_name);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    int Replay(const SolverCall& call, TreeIdSolver& solver, SolverCall& result)
+    {
+        result = call;
+        SetToZero(result.q_out);
+        double start = now();
+        result.result = solver.CartToJnt(call.q, call.qdot, call.qdotdot, call.f_ext_tree, result.q_out);
+        result.duration = now() - start;
+        return result.result;
+    }
+
+    double Divergence(SolverLogStream::Type type, const SolverCall& a, const SolverCall& b)
+    {
+        if (type == SolverLogStream::CHAIN_FK_POS || type == SolverLogStream::TREE_FK_POS)
+            return divergence(a.frame, b.frame);
+        return divergence(a.q_out, b.q_out);
+    }
+
+}
@@ -0,0 +1,218 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_SOLVERLOG_HPP
+#define KDL_SOLVERLOG_HPP
+
+#include "chain.hpp"
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "chainfksolver.hpp"
+#include "chainiksolver.hpp"
+#include "chainidsolver.hpp"
+#include "treefksolver.hpp"
+#include "treeidsolver.hpp"
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace KDL {
+
+    /**
+     * Settings of a solver by name, a single number is stored as an
+     * array of size 1.
+     */
+    typedef std::map<std::string, JntArray> SolverParameters;
+
+    /**
+     * \brief A solver whose calls are recorded in a solver log: the
+     * model it works on, the name of its class and its settings.
+     *
+     * @ingroup KinematicFamily
+     */
+    class SolverLogStream {
+    public:
+        /**
+         * The solver interface of the recorded calls.
+         */
+        enum Type {
+            CHAIN_FK_POS=1, ///< ChainFkSolverPos::JntToCart
+            CHAIN_IK_VEL=2, ///< ChainIkSolverVel::CartToJnt
+            CHAIN_IK_POS=3, ///< ChainIkSolverPos::CartToJnt
+            CHAIN_ID=4,     ///< ChainIdSolver::CartToJnt
+            TREE_FK_POS=5,  ///< TreeFkSolverPos::JntToCart
+            TREE_ID=6       ///< TreeIdSolver::CartToJnt
+        };
+
+        SolverLogStream();
+        SolverLogStream(Type type, const std::string& solver, const Chain& chain, const Vector& gravity=Vector::Zero());
+        SolverLogStream(Type type, const std::string& solver, const Tree& tree, const Vector& gravity=Vector::Zero());
+
+        bool isTree() const {return type == TREE_FK_POS || type == TREE_ID;};
+
+        Type type;
+        /// Class name of the recorded solver, used to select the
+        /// solver that replays the calls.
+        std::string solver;
+        /// The model of a chain solver
+        Chain chain;
+        /// The model of a tree solver
+        Tree tree;
+        /// Gravity of the dynamics solvers
+        Vector gravity;
+        /// Settings the recorded solver was constructed with, used to
+        /// construct the solver that replays the calls the same way.
+        /// Empty if the solver uses its defaults.
+        SolverParameters parameters;
+    };
+
+    /**
+     * \brief The inputs and outputs of one recorded solver call.
+     *
+     * Only the members used by the interface of its stream are stored
+     * in a log:
+     * - CHAIN_FK_POS: q, segment_nr -> frame
+     * - CHAIN_IK_VEL: q, twist -> q_out
+     * - CHAIN_IK_POS: q, frame -> q_out
+     * - CHAIN_ID: q, qdot, qdotdot, f_ext -> q_out (the torques)
+     * - TREE_FK_POS: q, segment_name -> frame
+     * - TREE_ID: q, qdot, qdotdot, f_ext_tree -> q_out (the torques)
+     *
+     * @ingroup KinematicFamily
+     */
+    class SolverCall {
+    public:
+        SolverCall();
+
+        /// Index of the stream of the call in the log
+        unsigned int stream;
+        JntArray q;
+        JntArray qdot;
+        JntArray qdotdot;
+        /// The target of an IK call or the result of a FK call
+        Frame frame;
+        Twist twist;
+        Wrenches f_ext;
+        WrenchMap f_ext_tree;
+        int segment_nr;
+        std::string segment_name;
+        JntArray q_out;
+        /// Return value of the call
+        int result;
+        /// Duration of the call in seconds
+        double duration;
+    };
+
+    /**
+     * \brief Writes the calls of one or more solvers to a compact
+     * binary log, see ChainFkSolverPos_recorded and friends.
+     *
+     * The log starts with the header of utilities/binary_io.h and
+     * contains stream and call records in the order in which they were
+     * added, so a log that is cut off (e.g. by a crash of the
+     * recording process) can still be read up to its last complete
+     * record.
+     *
+     * Writing is serialized, so one log can be shared by solvers that
+     * are called from several threads.
+     *
+     * @ingroup KinematicFamily
+     */
+    class SolverLogWriter {
+    public:
+        /**
+         * @param os the stream to write the log to, opened in binary
+         * mode. It has to outlive the writer.
+         */
+        explicit SolverLogWriter(std::ostream& os);
+
+        /**
+         * Adds a solver to the log.
+         *
+         * @return the index of the stream, to use in its calls
+         */
+        unsigned int addStream(const SolverLogStream& stream);
+
+        /**
+         * Adds a call of an added solver to the log.
+         */
+        void addCall(const SolverCall& call);
+
+        unsigned int getNrOfStreams() const;
+        unsigned long getNrOfCalls() const;
+
+    private:
+        std::ostream& os;
+        mutable std::mutex mutex;
+        std::vector<SolverLogStream::Type> types;
+        unsigned long nr_of_calls;
+
+        SolverLogWriter(const SolverLogWriter&);
+        SolverLogWriter& operator=(const SolverLogWriter&);
+    };
+
+    /**
+     * \brief The content of a solver log, read completely into memory.
+     *
+     * Throws Error_BasicIO_Binary if the stream is not a solver log.
+     * A last record that is cut off is ignored, see isTruncated().
+     *
+     * @ingroup KinematicFamily
+     */
+    class SolverLog {
+    public:
+        explicit SolverLog(std::istream& is);
+
+        const std::vector<SolverLogStream>& getStreams() const {return streams;};
+        const std::vector<SolverCall>& getCalls() const {return calls;};
+        /**
+         * Request if the log ended in the middle of a record.
+         */
+        bool isTruncated() const {return truncated;};
+
+    private:
+        std::vector<SolverLogStream> streams;
+        std::vector<SolverCall> calls;
+        bool truncated;
+    };
+
+    /**
+     * Reruns a recorded call on a solver for the model of its stream.
+     * The outputs, return value and duration are stored in result,
+     * its inputs are copied from call.
+     *
+     * @return the return value of the solver
+     */
+    int Replay(const SolverCall& call, ChainFkSolverPos& solver, SolverCall& result);
+    int Replay(const SolverCall& call, ChainIkSolverVel& solver, SolverCall& result);
+    int Replay(const SolverCall& call, ChainIkSolverPos& solver, SolverCall& result);
+    int Replay(const SolverCall& call, ChainIdSolver& solver, SolverCall& result);
+    int Replay(const SolverCall& call, TreeFkSolverPos& solver, SolverCall& result);
+    int Replay(const SolverCall& call, TreeIdSolver& solver, SolverCall& result);
+
+    /**
+     * Request the largest difference between the outputs of two calls
+     * of a stream of the given type: the largest absolute difference
+     * of the joint values, or the largest translation and rotation
+     * angle between the frames. The return values are not compared.
+     *
+     * @return the difference, infinity if the sizes differ
+     */
+    double Divergence(SolverLogStream::Type type, const SolverCall& a, const SolverCall& b);
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "solverrecorder.hpp"
+#include <chrono>
+
+namespace KDL {
+
+    namespace {
+        double now()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    ChainFkSolverPos_recorded::ChainFkSolverPos_recorded(ChainFkSolverPos& _solver, const Chain& _chain, SolverLogWriter& _log, const std::string& _name):
+        solver(_solver), chain(_chain), log(_log), name(_name)
+    {
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::CHAIN_FK_POS, name, chain));
+    }
+
+    void ChainFkSolverPos_recorded::updateInternalDataStructures()
+    {
+        solver.updateInternalDataStructures();
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::CHAIN_FK_POS, name, chain));
+    }
+
+    int ChainFkSolverPos_recorded::JntToCart(const JntArray& q_in, Frame& p_out, int segmentNr)
+    {
+        call.q = q_in;
+        call.segment_nr = segmentNr;
+        double start = now();
+        call.result = solver.JntToCart(q_in, p_out, segmentNr);
+        call.duration = now() - start;
+        call.frame = p_out;
+        log.addCall(call);
+        return call.result;
+    }
+
+    int ChainFkSolverPos_recorded::JntToCart(const JntArray& q_in, std::vector<Frame>& p_out, int segmentNr)
+    {
+        return solver.JntToCart(q_in, p_out, segmentNr);
+    }
+
+    ChainIkSolverVel_recorded::ChainIkSolverVel_recorded(ChainIkSolverVel& _solver, const Chain& _chain, SolverLogWriter& _log, const std::string& _name,
+                                                         const SolverParameters& _parameters):
+        solver(_solver), chain(_chain), log(_log), name(_name), parameters(_parameters)
+    {
+        SolverLogStream stream(SolverLogStream::CHAIN_IK_VEL, name, chain);
+        stream.parameters = parameters;
+        call.stream = log.addStream(stream);
+    }
+
+    void ChainIkSolverVel_recorded::updateInternalDataStructures()
+    {
+        solver.updateInternalDataStructures();
+        SolverLogStream stream(SolverLogStream::CHAIN_IK_VEL, name, chain);
+        stream.parameters = parameters;
+        call.stream = log.addStream(stream);
+    }
+
+    int ChainIkSolverVel_recorded::CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out)
+    {
+        call.q = q_in;
+        call.twist = v_in;
+        double start = now();
+        call.result = solver.CartToJnt(q_in, v_in, qdot_out);
+        call.duration = now() - start;
+        call.q_out = qdot_out;
+        log.addCall(call);
+        return call.result;
+    }
+
+    int ChainIkSolverVel_recorded::CartToJnt(const JntArray& q_init, const FrameVel& v_in, JntArrayVel& q_out)
+    {
+        return solver.CartToJnt(q_init, v_in, q_out);
+    }
+
+    ChainIkSolverPos_recorded::ChainIkSolverPos_recorded(ChainIkSolverPos& _solver, const Chain& _chain, SolverLogWriter& _log, const std::string& _name,
+                                                         const SolverParameters& _parameters):
+        solver(_solver), chain(_chain), log(_log), name(_name), parameters(_parameters)
+    {
+        SolverLogStream stream(SolverLogStream::CHAIN_IK_POS, name, chain);
+        stream.parameters = parameters;
+        call.stream = log.addStream(stream);
+    }
+
+    void ChainIkSolverPos_recorded::updateInternalDataStructures()
+    {
+        solver.updateInternalDataStructures();
+        SolverLogStream stream(SolverLogStream::CHAIN_IK_POS, name, chain);
+        stream.parameters = parameters;
+        call.stream = log.addStream(stream);
+    }
+
+    int ChainIkSolverPos_recorded::CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out)
+    {
+        call.q = q_init;
+        call.frame = p_in;
+        double start = now();
+        call.result = solver.CartToJnt(q_init, p_in, q_out);
+        call.duration = now() - start;
+        call.q_out = q_out;
+        log.addCall(call);
+        return call.result;
+    }
+
+    ChainIdSolver_recorded::ChainIdSolver_recorded(ChainIdSolver& _solver, const Chain& _chain, const Vector& _gravity, SolverLogWriter& _log, const std::string& _name):
+        solver(_solver), chain(_chain), gravity(_gravity), log(_log), name(_name)
+    {
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::CHAIN_ID, name, chain, gravity));
+    }
+
+    void ChainIdSolver_recorded::updateInternalDataStructures()
+    {
+        solver.updateInternalDataStructures();
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::CHAIN_ID, name, chain, gravity));
+    }
+
+    int ChainIdSolver_recorded::CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const Wrenches& f_ext, JntArray &torques)
+    {
+        call.q = q;
+        call.qdot = q_dot;
+        call.qdotdot = q_dotdot;
+        call.f_ext = f_ext;
+        double start = now();
+        call.result = solver.CartToJnt(q, q_dot, q_dotdot, f_ext, torques);
+        call.duration = now() - start;
+        call.q_out = torques;
+        log.addCall(call);
+        return call.result;
+    }
+
+    TreeFkSolverPos_recorded::TreeFkSolverPos_recorded(TreeFkSolverPos& _solver, const Tree& _tree, SolverLogWriter& _log, const std::string& _name):
+        solver(_solver), tree(_tree), log(_log), name(_name)
+    {
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::TREE_FK_POS, name, tree));
+    }
+
+    void TreeFkSolverPos_recorded::updateInternalDataStructures()
+    {
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::TREE_FK_POS, name, tree));
+    }
+
+    int TreeFkSolverPos_recorded::JntToCart(const JntArray& q_in, Frame& p_out, std::string segmentName)
+    {
+        call.q = q_in;
+        call.segment_name = segmentName;
+        double start = now();
+        call.result = solver.JntToCart(q_in, p_out, segmentName);
+        call.duration = now() - start;
+        call.frame = p_out;
+        log.addCall(call);
+        return call.result;
+    }
+
+    TreeIdSolver_recorded::TreeIdSolver_recorded(TreeIdSolver& _solver, const Tree& _tree, const Vector& _gravity, SolverLogWriter& _log, const std::string& _name):
+        solver(_solver), tree(_tree), gravity(_gravity), log(_log), name(_name)
+    {
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::TREE_ID, name, tree, gravity));
+    }
+
+    void TreeIdSolver_recorded::updateInternalDataStructures()
+    {
+        solver.updateInternalDataStructures();
+        call.stream = log.addStream(SolverLogStream(SolverLogStream::TREE_ID, name, tree, gravity));
+    }
+
+    int TreeIdSolver_recorded::CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const WrenchMap& f_ext, JntArray &torques)
+    {
+        call.q = q;
+        call.qdot = q_dot;
+        call.qdotdot = q_dotdot;
+        call.f_ext_tree = f_ext;
+        double start = now();
+        call.result = solver.CartToJnt(q, q_dot, q_dotdot, f_ext, torques);
+        call.duration = now() - start;
+        call.q_out = torques;
+        log.addCall(call);
+        return call.result;
+    }
+
+}
@@ -0,0 +1,175 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_SOLVERRECORDER_HPP
+#define KDL_SOLVERRECORDER_HPP
+
+#include "solverlog.hpp"
+
+namespace KDL {
+
+    /**
+     * Solvers that forward to another solver of the same interface and
+     * record every call in a SolverLogWriter, to rerun real workloads
+     * later with Replay(). The model is added to the log at
+     * construction and again by updateInternalDataStructures(), the
+     * name should be the class name of the wrapped solver, it is used
+     * to select the replaying solver.
+     *
+     * Only the calls of the interface listed in SolverCall are
+     * recorded, other calls are forwarded unrecorded. The wrapped
+     * solver, model and log have to outlive the recorder.
+     *
+     * The IK recorders also store the settings the wrapped solver was
+     * constructed with, see SolverLogStream::parameters. The names
+     * understood by examples/solver_replay.cpp are the constructor
+     * arguments of the solver: "eps", "maxiter", "lambda", "weight_js"
+     * and "weight_ts" (row by row) for the velocity solvers,
+     * "eps_joints" and "weights" for ChainIkSolverPos_LMA, "q_min" and
+     * "q_max" for ChainIkSolverPos_NR_JL, and "vel_eps" and
+     * "vel_maxiter" for the ChainIkSolverVel_pinv used by the
+     * Newton-Raphson solvers.
+     *
+     * @ingroup KinematicFamily
+     */
+    class ChainFkSolverPos_recorded : public ChainFkSolverPos
+    {
+    public:
+        ChainFkSolverPos_recorded(ChainFkSolverPos& solver, const Chain& chain, SolverLogWriter& log, const std::string& name);
+
+        virtual int JntToCart(const JntArray& q_in, Frame& p_out, int segmentNr=-1);
+        virtual int JntToCart(const JntArray& q_in, std::vector<Frame>& p_out, int segmentNr=-1);
+        virtual void updateInternalDataStructures();
+        virtual int getError() const {return solver.getError();};
+        virtual const char* strError(const int error) const {return solver.strError(error);};
+
+    private:
+        ChainFkSolverPos& solver;
+        const Chain& chain;
+        SolverLogWriter& log;
+        std::string name;
+        SolverCall call;
+    };
+
+    /// @copydoc KDL::ChainFkSolverPos_recorded
+    class ChainIkSolverVel_recorded : public ChainIkSolverVel
+    {
+    public:
+        ChainIkSolverVel_recorded(ChainIkSolverVel& solver, const Chain& chain, SolverLogWriter& log, const std::string& name,
+                                  const SolverParameters& parameters=SolverParameters());
+
+        virtual int CartToJnt(const JntArray& q_in, const Twist& v_in, JntArray& qdot_out);
+        virtual int CartToJnt(const JntArray& q_init, const FrameVel& v_in, JntArrayVel& q_out);
+        virtual void updateInternalDataStructures();
+        virtual int getError() const {return solver.getError();};
+        virtual const char* strError(const int error) const {return solver.strError(error);};
+
+    private:
+        ChainIkSolverVel& solver;
+        const Chain& chain;
+        SolverLogWriter& log;
+        std::string name;
+        SolverParameters parameters;
+        SolverCall call;
+    };
+
+    /// @copydoc KDL::ChainFkSolverPos_recorded
+    class ChainIkSolverPos_recorded : public ChainIkSolverPos
+    {
+    public:
+        ChainIkSolverPos_recorded(ChainIkSolverPos& solver, const Chain& chain, SolverLogWriter& log, const std::string& name,
+                                  const SolverParameters& parameters=SolverParameters());
+
+        virtual int CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out);
+        virtual void updateInternalDataStructures();
+        virtual int getError() const {return solver.getError();};
+        virtual const char* strError(const int error) const {return solver.strError(error);};
+
+    private:
+        ChainIkSolverPos& solver;
+        const Chain& chain;
+        SolverLogWriter& log;
+        std::string name;
+        SolverParameters parameters;
+        SolverCall call;
+    };
+
+    /// @copydoc KDL::ChainFkSolverPos_recorded
+    /// The gravity the wrapped solver was constructed with is stored
+    /// with the model.
+    class ChainIdSolver_recorded : public ChainIdSolver
+    {
+    public:
+        ChainIdSolver_recorded(ChainIdSolver& solver, const Chain& chain, const Vector& gravity, SolverLogWriter& log, const std::string& name);
+
+        virtual int CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const Wrenches& f_ext, JntArray &torques);
+        virtual void updateInternalDataStructures();
+        virtual int getError() const {return solver.getError();};
+        virtual const char* strError(const int error) const {return solver.strError(error);};
+
+    private:
+        ChainIdSolver& solver;
+        const Chain& chain;
+        Vector gravity;
+        SolverLogWriter& log;
+        std::string name;
+        SolverCall call;
+    };
+
+    /// @copydoc KDL::ChainFkSolverPos_recorded
+    class TreeFkSolverPos_recorded : public TreeFkSolverPos
+    {
+    public:
+        TreeFkSolverPos_recorded(TreeFkSolverPos& solver, const Tree& tree, SolverLogWriter& log, const std::string& name);
+
+        virtual int JntToCart(const JntArray& q_in, Frame& p_out, std::string segmentName);
+        /**
+         * Adds the current model to the log, call it after the tree
+         * changed.
+         */
+        void updateInternalDataStructures();
+
+    private:
+        TreeFkSolverPos& solver;
+        const Tree& tree;
+        SolverLogWriter& log;
+        std::string name;
+        SolverCall call;
+    };
+
+    /// @copydoc KDL::ChainFkSolverPos_recorded
+    /// The gravity the wrapped solver was constructed with is stored
+    /// with the model.
+    class TreeIdSolver_recorded : public TreeIdSolver
+    {
+    public:
+        TreeIdSolver_recorded(TreeIdSolver& solver, const Tree& tree, const Vector& gravity, SolverLogWriter& log, const std::string& name);
+
+        virtual int CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const WrenchMap& f_ext, JntArray &torques);
+        virtual void updateInternalDataStructures();
+        virtual int getError() const {return solver.getError();};
+        virtual const char* strError(const int error) const {return solver.strError(error);};
+
+    private:
+        TreeIdSolver& solver;
+        const Tree& tree;
+        Vector gravity;
+        SolverLogWriter& log;
+        std::string name;
+        SolverCall call;
+    };
+
+}
+
+#endif
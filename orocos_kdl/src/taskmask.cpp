@@ -0,0 +1,79 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "taskmask.hpp"
+#include <cmath>
+
+namespace KDL
+{
+    TaskMask::TaskMask(bool vx, bool vy, bool vz, bool wx, bool wy, bool wz, Reference _reference):
+        reference(_reference), rows(0)
+    {
+        mask[0] = vx; mask[1] = vy; mask[2] = vz;
+        mask[3] = wx; mask[4] = wy; mask[5] = wz;
+        for (unsigned int i = 0; i < 6; i++)
+            if (mask[i])
+                rows++;
+    }
+
+    TaskMask TaskMask::Position()
+    {
+        return TaskMask(true, true, true, false, false, false);
+    }
+
+    TaskMask TaskMask::FreeToolZ()
+    {
+        //the rotation error about the target z-axis is left out, in the
+        //solution the z-axes of the tool and the target coincide
+        return TaskMask(true, true, true, true, true, false, TARGET);
+    }
+
+    void TaskMask::selectError(const Frame& current, const Frame& target, Eigen::VectorXd& out, unsigned int row) const
+    {
+        Twist t = diff(current, target);
+        if (reference == TARGET && mask[3] + mask[4] + mask[5] == 2) {
+            //swing rotation that aligns the axis about which the rotation is free
+            unsigned int k = !mask[3] ? 0 : (!mask[4] ? 1 : 2);
+            Vector axes_current[3] = {current.M.UnitX(), current.M.UnitY(), current.M.UnitZ()};
+            Vector axes_target[3] = {target.M.UnitX(), target.M.UnitY(), target.M.UnitZ()};
+            const Vector& a_current = axes_current[k];
+            const Vector& a_target = axes_target[k];
+            Vector w = a_current * a_target;
+            double s = std::sqrt(dot(w, w));
+            if (s >= 1e-12)
+                t.rot = w * (std::atan2(s, dot(a_current, a_target)) / s);
+            else if (dot(a_current, a_target) < 0)
+                //opposite axes: half a turn about any perpendicular axis
+                t.rot = axes_current[(k + 1) % 3] * PI;
+            else
+                t.rot = Vector::Zero();
+        }
+        if (reference == TARGET)
+            t = target.M.Inverse(t);
+        for (unsigned int i = 0; i < 6; i++)
+            if (mask[i])
+                out(row++) = t(i);
+    }
+
+    void TaskMask::selectJacobian(const Frame& target, const Jacobian& jac, Eigen::MatrixXd& out, unsigned int row) const
+    {
+        for (unsigned int j = 0; j < jac.columns(); j++) {
+            Twist t = reference == TARGET ? target.M.Inverse(jac.getColumn(j)) : jac.getColumn(j);
+            unsigned int r = row;
+            for (unsigned int i = 0; i < 6; i++)
+                if (mask[i])
+                    out(r++, j) = t(i);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TASKMASK_HPP
+#define KDL_TASKMASK_HPP
+
+#include "frames.hpp"
+#include "jacobian.hpp"
+#include <Eigen/Core>
+
+namespace KDL
+{
+    /**
+     * \brief Selection of the Cartesian coordinates of a task.
+     *
+     * A mask selects some of the six coordinates of a twist (velocity
+     * x,y,z followed by rotational velocity x,y,z), either expressed in
+     * the base frame or in the frame of the target. The selected rows
+     * form the selection matrix that reduces a pose error and a
+     * Jacobian to the task, e.g. the position only, or the pose with a
+     * free rotation about the z-axis of the tool.
+     */
+    class TaskMask
+    {
+    public:
+        enum Reference {BASE, TARGET};
+
+        /**
+         * Constructor of a mask, by default all coordinates are
+         * selected.
+         */
+        explicit TaskMask(bool vx=true, bool vy=true, bool vz=true, bool wx=true, bool wy=true, bool wz=true, Reference reference=BASE);
+
+        /**
+         * A mask that selects the position of the target, 3 coordinates.
+         */
+        static TaskMask Position();
+
+        /**
+         * A mask that selects the position and the direction of the
+         * z-axis of the target, the rotation about that axis is free,
+         * 5 coordinates.
+         */
+        static TaskMask FreeToolZ();
+
+        bool isSelected(unsigned int i) const {return mask[i];};
+        Reference getReference() const {return reference;};
+        /**
+         * Request the number of selected coordinates.
+         */
+        unsigned int getNrOfRows() const {return rows;};
+
+        /**
+         * Select the coordinates of the error between a pose and its
+         * target, the twist that moves the pose to the target.
+         *
+         * With the TARGET reference and exactly one free rotation, the
+         * rotational error is the smallest rotation that aligns that
+         * axis of the pose with the one of the target, which has no
+         * component along the free axis. When the axes are opposite it
+         * is half a turn about another axis of the pose.
+         *
+         * @param current the current pose
+         * @param target pose of the target
+         * @param out output vector, the selected coordinates are stored
+         * starting at row
+         * @param row first row to write in out
+         */
+        void selectError(const Frame& current, const Frame& target, Eigen::VectorXd& out, unsigned int row=0) const;
+
+        /**
+         * Select the rows of a Jacobian.
+         *
+         * @param target pose of the target, used for the TARGET reference
+         * @param jac Jacobian expressed in the base frame
+         * @param out output matrix with jac.columns() columns, the
+         * selected rows are stored starting at row
+         * @param row first row to write in out
+         */
+        void selectJacobian(const Frame& target, const Jacobian& jac, Eigen::MatrixXd& out, unsigned int row=0) const;
+
+    private:
+        bool mask[6];
+        Reference reference;
+        unsigned int rows;
+    };
+}
+#endif
@@ -0,0 +1,198 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "tracing.hpp"
+
+#ifdef KDL_ENABLE_TRACING
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <vector>
+#endif
+
+namespace KDL {
+
+#ifdef KDL_ENABLE_TRACING
+    namespace {
+
+        //one slot more than the spans that are kept: the slot the owner
+        //may be writing can not be exported
+        const unsigned long RING_SIZE = TRACE_BUFFER_SIZE + 1;
+
+        struct TraceEvent {
+            std::atomic<const char*> name;
+            std::atomic<long long> begin;
+            std::atomic<long long> end;
+        };
+
+        //Ring buffer of one thread. Buffers are never freed: the spans
+        //of a thread stay available after it exited, and its buffer is
+        //taken over by the next thread that starts tracing.
+        struct TraceBuffer {
+            TraceBuffer(unsigned int _id):
+                id(_id), head(0), cleared(0), in_use(true), next(0)
+            {}
+            unsigned int id;
+            //number of spans ever written, only changed by the owner
+            std::atomic<unsigned long> head;
+            //spans before this index were discarded by ClearTrace
+            std::atomic<unsigned long> cleared;
+            std::atomic<bool> in_use;
+            //immutable once the buffer is in the list
+            TraceBuffer* next;
+            TraceEvent events[RING_SIZE];
+        };
+
+        std::atomic<TraceBuffer*> buffers(0);
+        std::atomic<unsigned int> nr_of_buffers(0);
+
+        TraceBuffer* claimBuffer()
+        {
+            for (TraceBuffer* b = buffers.load(std::memory_order_acquire); b != 0; b = b->next) {
+                bool free = false;
+                if (b->in_use.compare_exchange_strong(free, true, std::memory_order_acquire))
+                    return b;
+            }
+            TraceBuffer* b = new TraceBuffer(nr_of_buffers.fetch_add(1, std::memory_order_relaxed) + 1);
+            b->next = buffers.load(std::memory_order_relaxed);
+            while (!buffers.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed))
+                ;
+            return b;
+        }
+
+        struct TraceBufferOwner {
+            TraceBufferOwner(): buffer(claimBuffer()) {}
+            ~TraceBufferOwner() { buffer->in_use.store(false, std::memory_order_release); }
+            TraceBuffer* buffer;
+        };
+
+        thread_local TraceBufferOwner owner;
+
+        long long now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        //writes nanoseconds as the microseconds used by the trace format
+        void writeMicroseconds(std::ostream& os, long long ns)
+        {
+            os << ns/1000 << '.' << std::setw(3) << std::setfill('0') << ns%1000;
+        }
+
+        void writeName(std::ostream& os, const char* name)
+        {
+            os << '"';
+            for (const char* c = name; *c != 0; c++) {
+                if (*c == '"' || *c == '\\')
+                    os << '\\';
+                os << *c;
+            }
+            os << '"';
+        }
+    }
+
+    TraceSpan::TraceSpan(const char* _name):
+        name(_name), begin(now())
+    {}
+
+    TraceSpan::~TraceSpan()
+    {
+        long long end = now();
+        TraceBuffer* b = owner.buffer;
+        unsigned long i = b->head.load(std::memory_order_relaxed);
+        //a reader that sees the new content of the slot also sees that
+        //the span it held before was overwritten
+        std::atomic_thread_fence(std::memory_order_release);
+        TraceEvent& e = b->events[i % RING_SIZE];
+        e.name.store(name, std::memory_order_relaxed);
+        e.begin.store(begin, std::memory_order_relaxed);
+        e.end.store(end, std::memory_order_relaxed);
+        b->head.store(i + 1, std::memory_order_release);
+    }
+
+    bool TracingEnabled()
+    {
+        return true;
+    }
+
+    void WriteChromeTrace(std::ostream& os)
+    {
+        struct Span {
+            const char* name;
+            long long begin;
+            long long end;
+        };
+        std::vector<Span> spans;
+        std::ios::fmtflags flags = os.flags();
+        char fill = os.fill();
+        bool first = true;
+        os << "{\"traceEvents\":[";
+        for (TraceBuffer* b = buffers.load(std::memory_order_acquire); b != 0; b = b->next) {
+            unsigned long head = b->head.load(std::memory_order_acquire);
+            unsigned long begin = b->cleared.load(std::memory_order_relaxed);
+            if (head > TRACE_BUFFER_SIZE && begin < head - TRACE_BUFFER_SIZE)
+                begin = head - TRACE_BUFFER_SIZE;
+            spans.clear();
+            for (unsigned long i = begin; i < head; i++) {
+                const TraceEvent& e = b->events[i % RING_SIZE];
+                Span s = {e.name.load(std::memory_order_relaxed),
+                          e.begin.load(std::memory_order_relaxed),
+                          e.end.load(std::memory_order_relaxed)};
+                spans.push_back(s);
+            }
+            //skip the spans the owner overwrote while they were copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            unsigned long current = b->head.load(std::memory_order_relaxed);
+            unsigned long skip = 0;
+            if (current >= begin + RING_SIZE)
+                skip = current - (begin + RING_SIZE) + 1;
+            for (unsigned long k = skip; k < spans.size(); k++) {
+                os << (first ? "\n" : ",\n") << "{\"name\":";
+                writeName(os, spans[k].name);
+                os << ",\"cat\":\"kdl\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->id << ",\"ts\":";
+                writeMicroseconds(os, spans[k].begin);
+                os << ",\"dur\":";
+                writeMicroseconds(os, spans[k].end - spans[k].begin);
+                os << "}";
+                first = false;
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        os.flags(flags);
+        os.fill(fill);
+    }
+
+    void ClearTrace()
+    {
+        for (TraceBuffer* b = buffers.load(std::memory_order_acquire); b != 0; b = b->next)
+            b->cleared.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+#else
+    bool TracingEnabled()
+    {
+        return false;
+    }
+
+    void WriteChromeTrace(std::ostream& os)
+    {
+        os << "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    void ClearTrace()
+    {
+    }
+#endif
+
+}
@@ -0,0 +1,92 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TRACING_HPP
+#define KDL_TRACING_HPP
+
+#include "config.h"
+#include <ostream>
+
+/**
+ * \file
+ * Tracing spans of the solver calls.
+ *
+ * The solvers mark their calls and major internal phases with
+ * KDL_TRACE_SPAN. When the library is configured with
+ * KDL_ENABLE_TRACING=ON every span records its begin and end time in a
+ * fixed-size ring buffer of the calling thread, otherwise the macro
+ * expands to nothing and has no cost at all.
+ *
+ * Recording is lock-free: a thread only writes its own buffer, and
+ * WriteChromeTrace() can be called at any time from any thread. When a
+ * buffer is full the oldest spans of that thread are overwritten.
+ */
+
+#ifdef KDL_ENABLE_TRACING
+#define KDL_TRACE_CONCAT_(a, b) a##b
+#define KDL_TRACE_CONCAT(a, b) KDL_TRACE_CONCAT_(a, b)
+/**
+ * Records a span from this point to the end of the enclosing scope.
+ * The name has to be a string literal.
+ */
+#define KDL_TRACE_SPAN(name) KDL::TraceSpan KDL_TRACE_CONCAT(kdl_trace_span_, __LINE__)(name)
+#else
+#define KDL_TRACE_SPAN(name) do {} while (0)
+#endif
+
+namespace KDL {
+
+    /**
+     * Number of spans kept per thread.
+     */
+    static const unsigned int TRACE_BUFFER_SIZE = 16384;
+
+#ifdef KDL_ENABLE_TRACING
+    /**
+     * \brief Records the time between its construction and destruction
+     * in the trace buffer of the calling thread, use KDL_TRACE_SPAN.
+     */
+    class TraceSpan {
+    public:
+        explicit TraceSpan(const char* _name);
+        ~TraceSpan();
+    private:
+        const char* name;
+        long long begin;
+
+        TraceSpan(const TraceSpan&);
+        TraceSpan& operator=(const TraceSpan&);
+    };
+#endif
+
+    /**
+     * Returns true if the library was built with KDL_ENABLE_TRACING.
+     */
+    bool TracingEnabled();
+
+    /**
+     * Writes the recorded spans of all threads as Chrome trace JSON,
+     * which can be opened in chrome://tracing or the Perfetto UI.
+     * Without tracing support an empty trace is written.
+     */
+    void WriteChromeTrace(std::ostream& os);
+
+    /**
+     * Discards the spans recorded so far.
+     */
+    void ClearTrace();
+
+}
+
+#endif
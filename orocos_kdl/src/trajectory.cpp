@@ -46,6 +46,9 @@
 #include "trajectory.hpp"
 #include "path.hpp"
 #include "trajectory_segment.hpp"
+#include "trajectory_composite.hpp"
+#include "trajectory_stationary.hpp"
+#include "trajectory_stream.hpp"
 
 #include <memory>
 #include <cstring>
@@ -66,10 +69,80 @@ Trajectory* Trajectory::Read(std::istream& is) {
 		IOTracePop();
 		IOTracePop();
 		return new  Trajectory_Segment(geom.release(),motprof.release());
+	} else if (strcmp(storage,"STREAM")==0) {
+		IOTrace("STREAM");
+		unsigned int capacity;
+		double starttime;
+		unsigned int size;
+		is >> capacity;
+		is >> starttime;
+		is >> size;
+		if (!is || capacity > Trajectory_Stream::MAX_READ_CAPACITY || size > capacity)
+			throw Error_MotionIO_Unexpected_Traj();
+		scoped_ptr<Trajectory_Stream> tr( new Trajectory_Stream(capacity,starttime) );
+		for (unsigned int i=0;i<size;i++) {
+			scoped_ptr<Trajectory> elem( Trajectory::Read(is) );
+			tr->Add(elem.release());
+		}
+		EatEnd(is,']');
+		IOTracePop();
+		IOTracePop();
+		return tr.release();
 	} else {
 		throw Error_MotionIO_Unexpected_Traj();
 	}
 	return NULL; // just to avoid the warning;
 }
 
+void Trajectory::WriteBinary(std::ostream& /*os*/) const {
+	throw Error_Not_Implemented();
+}
+
+Trajectory* Trajectory::ReadBinary(std::istream& is) {
+	unsigned int type;
+	KDL::ReadBinary(is,type);
+	switch (type) {
+	case BINARY_SEGMENT: {
+		scoped_ptr<Path>      geom(    Path::ReadBinary(is)       );
+		scoped_ptr<VelocityProfile> motprof( VelocityProfile::ReadBinary(is)  );
+		return new  Trajectory_Segment(geom.release(),motprof.release());
+	}
+	case BINARY_COMPOSITE: {
+		unsigned int size;
+		KDL::ReadBinary(is,size);
+		scoped_ptr<Trajectory_Composite> tr( new Trajectory_Composite() );
+		for (unsigned int i=0;i<size;i++)
+			tr->Add(Trajectory::ReadBinary(is));
+		return tr.release();
+	}
+	case BINARY_STATIONARY: {
+		double duration;
+		Frame pos;
+		KDL::ReadBinary(is,duration);
+		KDL::ReadBinary(is,pos);
+		return new Trajectory_Stationary(duration,pos);
+	}
+	case BINARY_STREAM: {
+		unsigned int capacity;
+		double starttime;
+		unsigned int size;
+		KDL::ReadBinary(is,capacity);
+		KDL::ReadBinary(is,starttime);
+		KDL::ReadBinary(is,size);
+		if (capacity > Trajectory_Stream::MAX_READ_CAPACITY || size > capacity)
+			throw Error_BasicIO_Binary();
+		scoped_ptr<Trajectory_Stream> tr( new Trajectory_Stream(capacity,starttime) );
+		for (unsigned int i=0;i<size;i++) {
+			scoped_ptr<Trajectory> elem( Trajectory::ReadBinary(is) );
+			if (!tr->Add(elem.get()))
+				throw Error_BasicIO_Binary();
+			elem.release();
+		}
+		return tr.release();
+	}
+	default:
+		throw Error_MotionIO_Unexpected_Traj();
+	}
+}
+
 }
@@ -92,6 +92,26 @@ namespace KDL {
 		virtual Trajectory* Clone() const = 0;
 		virtual void Write(std::ostream& os) const = 0;
 		static Trajectory* Read(std::istream& is);
+
+		enum BinaryType {
+			BINARY_SEGMENT=1,
+			BINARY_COMPOSITE=2,
+			BINARY_STATIONARY=3,
+			BINARY_STREAM=4
+		};
+		// Type tags of the binary format.
+
+		virtual void WriteBinary(std::ostream& os) const;
+		// Writes the complete state of the trajectory, including its
+		// paths and velocity profiles, in the format of
+		// utilities/binary_io.h. A stream starts with
+		// WriteBinaryHeader(), followed by any number of trajectories.
+		// Throws Error_Not_Implemented if the derived class does not
+		// support it.
+
+		static Trajectory* ReadBinary(std::istream& is);
+		// Reads a trajectory written by WriteBinary(). The read
+		// trajectory owns all its parts.
 		virtual ~Trajectory() {}
 		// note : you cannot declare this destructor abstract
 		// it is always called by the descendant's destructor !
@@ -113,6 +113,14 @@ namespace KDL {
         os << "]" << std::endl;
     }
 
+    void Trajectory_Composite::WriteBinary(std::ostream& os) const {
+        KDL::WriteBinary(os, (unsigned int)BINARY_COMPOSITE);
+        KDL::WriteBinary(os, (unsigned int)vt.size());
+        for (unsigned int i=0;i<vt.size();i++) {
+            vt[i]->WriteBinary(os);
+        }
+    }
+
     Trajectory* Trajectory_Composite::Clone() const{
         Trajectory_Composite* comp = new Trajectory_Composite();
         for (unsigned int i = 0; i < vt.size(); ++i) {
@@ -52,6 +52,7 @@ class Trajectory_Composite: public Trajectory
 
 		virtual void Destroy();
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
 		virtual Trajectory* Clone() const;
 
 		virtual ~Trajectory_Composite();
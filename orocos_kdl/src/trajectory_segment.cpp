@@ -89,6 +89,13 @@ void Trajectory_Segment::Write(std::ostream& os) const
 	os << "]";
 }
 
+void Trajectory_Segment::WriteBinary(std::ostream& os) const
+{
+	KDL::WriteBinary(os,(unsigned int)BINARY_SEGMENT);
+	geom->WriteBinary(os);
+	motprof->WriteBinary(os);
+}
+
 Trajectory_Segment::~Trajectory_Segment()
 {
     if (aggregate)
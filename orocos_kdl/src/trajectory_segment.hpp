@@ -95,6 +95,7 @@ namespace KDL {
 			}
 
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
 
 	    virtual Path* GetPath();
 
@@ -24,4 +24,10 @@ void Trajectory_Stationary::Write(std::ostream& os) const {
 	os << "]";
 }
 
+void Trajectory_Stationary::WriteBinary(std::ostream& os) const {
+    KDL::WriteBinary(os,(unsigned int)BINARY_STATIONARY);
+    KDL::WriteBinary(os,duration);
+    KDL::WriteBinary(os,pos);
+}
+
 }
@@ -45,6 +45,7 @@ namespace KDL {
 			return Twist::Zero();
 		}
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
 
 		virtual Trajectory* Clone() const {
 			return new Trajectory_Stationary(duration,pos);
@@ -0,0 +1,170 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "trajectory_stream.hpp"
+
+namespace KDL {
+
+    Trajectory_Stream::Trajectory_Stream(unsigned int _capacity,double _starttime):
+        capacity(_capacity>0 ? _capacity : 1),
+        elements(capacity),
+        head(0),
+        tail(0),
+        endtime(_starttime),
+        starttime(_starttime),
+        cursor(0)
+    {
+    }
+
+    bool Trajectory_Stream::Add(Trajectory* elem)
+    {
+        unsigned long h = head.load(std::memory_order_relaxed);
+        //the consumer must be done with a slot before it is reused
+        if (h - tail.load(std::memory_order_acquire) >= capacity)
+            return false;
+        Element& e = elements[h % capacity];
+        e.traj = elem;
+        e.start = endtime;
+        endtime += elem->Duration();
+        e.end = endtime;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Trajectory_Stream::Retire(double time)
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        while (t + 1 < h && elements[t % capacity].end <= time) {
+            Element& e = elements[t % capacity];
+            delete e.traj;
+            e.traj = NULL;
+            t++;
+            tail.store(t, std::memory_order_release);
+        }
+    }
+
+    bool Trajectory_Stream::Lookup(double time,const Element*& element) const
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        if (h == t)
+            return false;
+        if (cursor < t)
+            cursor = t;
+        while (cursor + 1 < h && time >= elements[cursor % capacity].end)
+            cursor++;
+        while (cursor > t && time < elements[cursor % capacity].start)
+            cursor--;
+        element = &elements[cursor % capacity];
+        return true;
+    }
+
+    double Trajectory_Stream::Duration() const
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        if (h == tail.load(std::memory_order_relaxed))
+            return starttime;
+        return elements[(h - 1) % capacity].end;
+    }
+
+    double Trajectory_Stream::StartTime() const
+    {
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t)
+            return starttime;
+        return elements[t % capacity].start;
+    }
+
+    unsigned int Trajectory_Stream::GetNrOfSegments() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    }
+
+    Frame Trajectory_Stream::Pos(double time) const
+    {
+        const Element* e;
+        if (!Lookup(time, e))
+            return Frame::Identity();
+        if (time < e->start)
+            return e->traj->Pos(0);
+        if (time >= e->end)
+            return e->traj->Pos(e->traj->Duration());
+        return e->traj->Pos(time - e->start);
+    }
+
+    Twist Trajectory_Stream::Vel(double time) const
+    {
+        const Element* e;
+        if (!Lookup(time, e))
+            return Twist::Zero();
+        if (time < e->start)
+            return e->traj->Vel(0);
+        if (time >= e->end)
+            return e->traj->Vel(e->traj->Duration());
+        return e->traj->Vel(time - e->start);
+    }
+
+    Twist Trajectory_Stream::Acc(double time) const
+    {
+        const Element* e;
+        if (!Lookup(time, e))
+            return Twist::Zero();
+        if (time < e->start)
+            return e->traj->Acc(0);
+        if (time >= e->end)
+            return e->traj->Acc(e->traj->Duration());
+        return e->traj->Acc(time - e->start);
+    }
+
+    void Trajectory_Stream::Write(std::ostream& os) const
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        os << "STREAM[ " << capacity << " " << StartTime() << " " << h - t << std::endl;
+        for (unsigned long i = t; i < h; i++)
+            elements[i % capacity].traj->Write(os);
+        os << "]" << std::endl;
+    }
+
+    void Trajectory_Stream::WriteBinary(std::ostream& os) const
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        KDL::WriteBinary(os, (unsigned int)BINARY_STREAM);
+        KDL::WriteBinary(os, capacity);
+        KDL::WriteBinary(os, StartTime());
+        KDL::WriteBinary(os, (unsigned int)(h - t));
+        for (unsigned long i = t; i < h; i++)
+            elements[i % capacity].traj->WriteBinary(os);
+    }
+
+    Trajectory* Trajectory_Stream::Clone() const
+    {
+        unsigned long h = head.load(std::memory_order_acquire);
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        Trajectory_Stream* stream = new Trajectory_Stream(capacity, StartTime());
+        for (unsigned long i = t; i < h; i++)
+            stream->Add(elements[i % capacity].traj->Clone());
+        return stream;
+    }
+
+    Trajectory_Stream::~Trajectory_Stream()
+    {
+        unsigned long h = head.load(std::memory_order_relaxed);
+        for (unsigned long i = tail.load(std::memory_order_relaxed); i < h; i++)
+            delete elements[i % capacity].traj;
+    }
+
+}
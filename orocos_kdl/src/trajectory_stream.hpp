@@ -0,0 +1,139 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_MOTION_TRAJECTORY_STREAM_H
+#define KDL_MOTION_TRAJECTORY_STREAM_H
+
+#include "trajectory.hpp"
+#include <atomic>
+#include <vector>
+
+namespace KDL {
+
+/**
+ * \brief A trajectory to which segments are appended while it is being
+ * executed.
+ *
+ * The segments are kept in a ring buffer of fixed capacity: Add()
+ * appends a segment after the last one, Retire() deletes the segments
+ * that are finished at a given time, which makes room for new ones. The
+ * time of the trajectory is not reset by retiring, so a stream can run
+ * for an unlimited time with bounded memory.
+ *
+ * Add() can be called by one producer thread while one consumer thread
+ * evaluates and retires, without locks. All other methods, and
+ * evaluating the same stream from several threads, are restricted to
+ * the consumer. The consumer only sees segments of which Add() has
+ * returned.
+ *
+ * The segment of a time is searched starting from the segment of the
+ * previous evaluation, so evaluating at increasing times costs O(1).
+ * Before the first segment the stream is at the start of the first
+ * segment, after the last one at the end of the last segment. A stream
+ * without segments is at the identity frame.
+ *
+ * @ingroup Motion
+ */
+class Trajectory_Stream : public Trajectory
+	{
+	public:
+		/**
+		 * Constructs an empty stream.
+		 *
+		 * @param capacity maximum number of segments kept at the same time
+		 * @param starttime time at which the first segment starts
+		 */
+		Trajectory_Stream(unsigned int capacity,double starttime=0.0);
+
+		/**
+		 * Appends a segment after the last one, the stream takes
+		 * ownership of the segment. Producer side.
+		 *
+		 * @return false if the stream is full, the ownership of the
+		 * segment then stays with the caller
+		 */
+		bool Add(Trajectory* elem);
+
+		/**
+		 * Deletes the segments that end before or at time, except the
+		 * last one. Consumer side.
+		 */
+		void Retire(double time);
+
+		/**
+		 * The time at which the stream ends: the end of the last segment.
+		 */
+		virtual double Duration() const;
+		virtual Frame Pos(double time) const;
+		virtual Twist Vel(double time) const;
+		virtual Twist Acc(double time) const;
+
+		/**
+		 * Time at which the first segment that is not retired starts.
+		 */
+		double StartTime() const;
+		/**
+		 * Number of segments that are not retired.
+		 */
+		unsigned int GetNrOfSegments() const;
+		unsigned int GetCapacity() const {return capacity;};
+
+		/**
+		 * Largest capacity that Trajectory::Read() and
+		 * Trajectory::ReadBinary() accept. The ring buffer is allocated
+		 * before the segments are read, so a corrupt capacity must not
+		 * allocate an unbounded amount of memory.
+		 */
+		static const unsigned int MAX_READ_CAPACITY = 1u << 20;
+
+		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
+		/**
+		 * Copies the segments that are not retired into a new stream
+		 * with the same capacity and timing.
+		 */
+		virtual Trajectory* Clone() const;
+
+		virtual ~Trajectory_Stream();
+
+	private:
+		struct Element {
+			Trajectory* traj;
+			double start;
+			double end;
+		};
+		unsigned int capacity;
+		std::vector<Element> elements;
+		//number of segments ever added, written by the producer
+		std::atomic<unsigned long> head;
+		//number of segments ever retired, written by the consumer
+		std::atomic<unsigned long> tail;
+		//end of the last added segment, producer only
+		double endtime;
+		double starttime;
+		//segment of the last evaluation, consumer only
+		mutable unsigned long cursor;
+
+		Trajectory_Stream(const Trajectory_Stream&);
+		Trajectory_Stream& operator=(const Trajectory_Stream&);
+
+		/**
+		 * Finds the segment of time, returns false if there are none.
+		 */
+		bool Lookup(double time,const Element*& element) const;
+	};
+
+}
+
+#endif
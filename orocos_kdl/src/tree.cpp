@@ -20,6 +20,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "tree.hpp"
+#include "jntarray.hpp"
 #include <sstream>
 
 namespace KDL {
@@ -52,14 +53,29 @@ Tree& Tree::operator=(const Tree& in) {
 }
 
 bool Tree::addSegment(const Segment& segment, const std::string& hook_name) {
+    unsigned int dofs = segment.getJoint().getNrOfDofs();
+    unsigned int q_nr = dofs != 0 ? nrOfJoints : 0;
+    if (!this->insertSegment(segment, hook_name, q_nr))
+        return false;
+    //increase number of joints
+    nrOfJoints += dofs;
+    return true;
+}
+
+bool Tree::addCoupledSegment(const Segment& segment, const std::string& hook_name, unsigned int q_nr) {
+    //a coupled segment needs a single axis joint and an existing coordinate
+    if (segment.getJoint().getNrOfDofs() != 1 || q_nr >= nrOfJoints)
+        return false;
+    return this->insertSegment(segment, hook_name, q_nr);
+}
+
+bool Tree::insertSegment(const Segment& segment, const std::string& hook_name, unsigned int q_nr) {
     SegmentMap::iterator parent = segments.find(hook_name);
     //check if parent exists
     if (parent == segments.end())
         return false;
     std::pair<SegmentMap::iterator, bool> retval;
     //insert new element
-    unsigned int q_nr = segment.getJoint().getType() != Joint::Fixed ? nrOfJoints : 0;
-
 #ifdef KDL_USE_NEW_TREE_INTERFACE
     retval = segments.insert(make_pair(segment.getName(), TreeElementType( new TreeElement(segment, parent, q_nr))));
 #else //#ifdef KDL_USE_NEW_TREE_INTERFACE
@@ -73,17 +89,22 @@ bool Tree::addSegment(const Segment& segment, const std::string& hook_name) {
     GetTreeElementChildren(parent->second).push_back(retval.first);
     //increase number of segments
     nrOfSegments++;
-    //increase number of joints
-    if (segment.getJoint().getType() != Joint::Fixed)
-        nrOfJoints++;
     return true;
 }
 
 bool Tree::addChain(const Chain& chain, const std::string& hook_name) {
     std::string parent_name = hook_name;
+    //joint coordinates of the chain are appended after the existing ones
+    unsigned int offset = nrOfJoints;
     for (unsigned int i = 0; i < chain.getNrOfSegments(); i++) {
-        if (this->addSegment(chain.getSegment(i), parent_name))
-            parent_name = chain.getSegment(i).getName();
+        const Segment& segment = chain.getSegment(i);
+        bool added;
+        if (segment.getJoint().getNrOfDofs() == 1 && chain.getQNr(i) < nrOfJoints - offset)
+            added = this->addCoupledSegment(segment, parent_name, offset + chain.getQNr(i));
+        else
+            added = this->addSegment(segment, parent_name);
+        if (added)
+            parent_name = segment.getName();
         else
             return false;
     }
@@ -91,19 +112,32 @@ bool Tree::addChain(const Chain& chain, const std::string& hook_name) {
 }
 
 bool Tree::addTree(const Tree& tree, const std::string& hook_name) {
-    return this->addTreeRecursive(tree.getRootSegment(), hook_name);
+    std::map<unsigned int,unsigned int> q_nr_map;
+    return this->addTreeRecursive(tree.getRootSegment(), hook_name, q_nr_map);
 }
 
-bool Tree::addTreeRecursive(SegmentMap::const_iterator root, const std::string& hook_name) {
+bool Tree::addTreeRecursive(SegmentMap::const_iterator root, const std::string& hook_name, std::map<unsigned int,unsigned int>& q_nr_map) {
     //get iterator for root-segment
     SegmentMap::const_iterator child;
     //try to add all of root's children
     for (unsigned int i = 0; i < GetTreeElementChildren(root->second).size(); i++) {
         child = GetTreeElementChildren(root->second)[i];
+        const Segment& segment = GetTreeElementSegment(child->second);
+        bool added;
+        //a joint coordinate that was already added drives a coupled segment
+        std::map<unsigned int,unsigned int>::const_iterator q_nr = q_nr_map.find(GetTreeElementQNr(child->second));
+        if (segment.getJoint().getType() == Joint::Fixed)
+            added = this->addSegment(segment, hook_name);
+        else if (segment.getJoint().getNrOfDofs() == 1 && q_nr != q_nr_map.end())
+            added = this->addCoupledSegment(segment, hook_name, q_nr->second);
+        else {
+            q_nr_map[GetTreeElementQNr(child->second)] = nrOfJoints;
+            added = this->addSegment(segment, hook_name);
+        }
         //Try to add the child
-        if (this->addSegment(GetTreeElementSegment(child->second), hook_name)) {
+        if (added) {
             //if child is added, add all the child's children
-            if (!(this->addTreeRecursive(child, child->first)))
+            if (!(this->addTreeRecursive(child, child->first, q_nr_map)))
                 //if it didn't work, return false
                 return false;
         } else
@@ -113,6 +147,21 @@ bool Tree::addTreeRecursive(SegmentMap::const_iterator root, const std::string&
     return true;
 }
 
+static void addChainSegment(Chain& chain, const Segment& segment, unsigned int q_nr, std::map<unsigned int,unsigned int>& q_nr_map)
+{
+    if (segment.getJoint().getType() == Joint::Fixed) {
+        chain.addSegment(segment);
+        return;
+    }
+    std::map<unsigned int,unsigned int>::const_iterator chain_q_nr = q_nr_map.find(q_nr);
+    if (segment.getJoint().getNrOfDofs() == 1 && chain_q_nr != q_nr_map.end())
+        chain.addCoupledSegment(segment, chain_q_nr->second);
+    else {
+        q_nr_map[q_nr] = chain.getNrOfJoints();
+        chain.addSegment(segment);
+    }
+}
+
 bool Tree::getChain(const std::string& chain_root, const std::string& chain_tip, Chain& chain)const
 {
     // clear chain
@@ -142,22 +191,32 @@ bool Tree::getChain(const std::string& chain_root, const std::string& chain_tip,
     parents_chain_root.push_back(last_segment);
 
 
+    // joint coordinates of the tree that are already used in the chain,
+    // any further segment driven by them is added as a coupled segment
+    std::map<unsigned int,unsigned int> q_nr_map;
+
     // add the segments from the root to the common frame
     for (unsigned int s=0; s<parents_chain_root.size()-1; s++){
-        Segment seg = GetTreeElementSegment(getSegment(parents_chain_root[s])->second);
+        SegmentMap::const_iterator element = getSegment(parents_chain_root[s]);
+        Segment seg = GetTreeElementSegment(element->second);
         Frame f_tip = seg.pose(0.0).Inverse();
         Joint jnt = seg.getJoint();
+        // multi-DOF joints can not be traversed in reverse direction
+        if (jnt.getNrOfDofs() > 1)
+            return false;
         if (jnt.getType() == Joint::RotX || jnt.getType() == Joint::RotY || jnt.getType() == Joint::RotZ || jnt.getType() == Joint::RotAxis)
-            jnt = Joint(jnt.getName(), f_tip*jnt.JointOrigin(), f_tip.M*(-jnt.JointAxis()), Joint::RotAxis);
+            jnt = Joint(jnt.getName(), f_tip*jnt.JointOrigin(), f_tip.M*(-jnt.JointAxis()), Joint::RotAxis, jnt.getScale(), jnt.getOffset());
         else if (jnt.getType() == Joint::TransX || jnt.getType() == Joint::TransY || jnt.getType() == Joint::TransZ || jnt.getType() == Joint::TransAxis)
-            jnt = Joint(jnt.getName(),f_tip*jnt.JointOrigin(), f_tip.M*(-jnt.JointAxis()), Joint::TransAxis);
-        chain.addSegment(Segment(GetTreeElementSegment(getSegment(parents_chain_root[s+1])->second).getName(),
-                                 jnt, f_tip, GetTreeElementSegment(getSegment(parents_chain_root[s+1])->second).getInertia()));
+            jnt = Joint(jnt.getName(),f_tip*jnt.JointOrigin(), f_tip.M*(-jnt.JointAxis()), Joint::TransAxis, jnt.getScale(), jnt.getOffset());
+        addChainSegment(chain, Segment(GetTreeElementSegment(getSegment(parents_chain_root[s+1])->second).getName(),
+                                       jnt, f_tip, GetTreeElementSegment(getSegment(parents_chain_root[s+1])->second).getInertia()),
+                        GetTreeElementQNr(element->second), q_nr_map);
     }
 
     // add the segments from the common frame to the tip frame
     for (auto rit=parents_chain_tip.rbegin(); rit != parents_chain_tip.rend(); ++rit){
-        chain.addSegment(GetTreeElementSegment(getSegment(*rit)->second));
+        SegmentMap::const_iterator element = getSegment(*rit);
+        addChainSegment(chain, GetTreeElementSegment(element->second), GetTreeElementQNr(element->second), q_nr_map);
     }
     return true;
 }
@@ -170,7 +229,80 @@ bool Tree::getSubTree(const std::string& segment_name, Tree& tree) const
     return false;
   //init the tree, segment_name is the new root.
   tree = Tree(root->first);
-  return tree.addTreeRecursive(root, segment_name);
+  std::map<unsigned int,unsigned int> q_nr_map;
+  return tree.addTreeRecursive(root, segment_name, q_nr_map);
+}
+
+static bool addReducedTreeRecursive(SegmentMap::const_iterator root, const std::string& hook_name, Tree& tree,
+                                    const std::vector<bool>& locked_joints, const JntArray& q_locked,
+                                    std::map<unsigned int,unsigned int>& q_nr_map, std::vector<unsigned int>& full_q_nrs)
+{
+    for (unsigned int i = 0; i < GetTreeElementChildren(root->second).size(); i++) {
+        SegmentMap::const_iterator child = GetTreeElementChildren(root->second)[i];
+        const Segment& segment = GetTreeElementSegment(child->second);
+        unsigned int q_nr = GetTreeElementQNr(child->second);
+        unsigned int dofs = segment.getJoint().getNrOfDofs();
+        unsigned int nr_locked = 0;
+        for (unsigned int d = 0; d < dofs; d++)
+            if (locked_joints[q_nr + d])
+                nr_locked++;
+        bool added;
+        if (dofs == 0)
+            added = tree.addSegment(segment, hook_name);
+        else if (nr_locked == dofs)
+            //a locked joint becomes a fixed joint at its locked pose
+            added = tree.addSegment(Segment(segment.getName(), Joint(segment.getJoint().getName(), Joint::Fixed),
+                                            segment.pose(q_locked, q_nr), segment.getInertia()), hook_name);
+        else if (nr_locked != 0)
+            return false;
+        else if (dofs == 1 && q_nr_map.find(q_nr) != q_nr_map.end())
+            added = tree.addCoupledSegment(segment, hook_name, q_nr_map[q_nr]);
+        else {
+            for (unsigned int d = 0; d < dofs; d++) {
+                q_nr_map[q_nr + d] = tree.getNrOfJoints() + d;
+                full_q_nrs.push_back(q_nr + d);
+            }
+            added = tree.addSegment(segment, hook_name);
+        }
+        if (!added || !addReducedTreeRecursive(child, child->first, tree, locked_joints, q_locked, q_nr_map, full_q_nrs))
+            return false;
+    }
+    return true;
+}
+
+bool Tree::getReducedTree(const std::vector<bool>& locked_joints, const JntArray& q_locked,
+                          Tree& tree, std::vector<unsigned int>& full_q_nrs)const
+{
+    if (locked_joints.size() != nrOfJoints || q_locked.rows() != nrOfJoints)
+        return false;
+    Tree result(root_name);
+    std::vector<unsigned int> result_q_nrs;
+    std::map<unsigned int,unsigned int> q_nr_map;
+    if (!addReducedTreeRecursive(getRootSegment(), root_name, result, locked_joints, q_locked, q_nr_map, result_q_nrs))
+        return false;
+    tree = result;
+    full_q_nrs = result_q_nrs;
+    return true;
+}
+
+static void addDepthFirstSegments(SegmentMap::const_iterator it, int parent,
+                                  std::vector<SegmentMap::const_iterator>& elements, std::vector<int>& parents)
+{
+    int index = elements.size();
+    elements.push_back(it);
+    parents.push_back(parent);
+    for (unsigned int i = 0; i < GetTreeElementChildren(it->second).size(); i++)
+        addDepthFirstSegments(GetTreeElementChildren(it->second)[i], index, elements, parents);
+}
+
+void Tree::getDepthFirstSegments(std::vector<SegmentMap::const_iterator>& elements,
+                                 std::vector<int>& parents)const
+{
+    elements.clear();
+    parents.clear();
+    elements.reserve(segments.size());
+    parents.reserve(segments.size());
+    addDepthFirstSegments(getRootSegment(), -1, elements, parents);
 }
 
 }//end of namespace
@@ -105,7 +105,8 @@ namespace KDL
 
         std::string root_name;
 
-        bool addTreeRecursive(SegmentMap::const_iterator root, const std::string& hook_name);
+        bool addTreeRecursive(SegmentMap::const_iterator root, const std::string& hook_name, std::map<unsigned int,unsigned int>& q_nr_map);
+        bool insertSegment(const Segment& segment, const std::string& hook_name, unsigned int q_nr);
 
     public:
         /**
@@ -127,6 +128,26 @@ namespace KDL
          */
          bool addSegment(const Segment& segment, const std::string& hook_name);
 
+        /**
+         * Adds a new segment to the end of the segment with
+         * hook_name as segment_name, whose joint is driven by the
+         * already existing joint coordinate q_nr instead of by a new
+         * one (mimic or coupled joint). The scale and offset of the
+         * segment's joint define the linear map from the shared
+         * coordinate to the joint motion. A coupled segment does not
+         * increase the number of joints.
+         *
+         * @param segment new segment to add
+         * @param hook_name name of the segment to connect this
+         * segment with.
+         * @param q_nr index of the joint coordinate driving the segment
+         *
+         * @return false if hook_name could not be found, the segment does
+         * not have a single axis joint or q_nr is not an existing joint
+         * coordinate.
+         */
+        bool addCoupledSegment(const Segment& segment, const std::string& hook_name, unsigned int q_nr);
+
         /**
          * Adds a complete chain to the end of the segment with
          * hook_name as segment_name.
@@ -192,6 +213,8 @@ namespace KDL
            * Request the chain of the tree between chain_root and chain_tip.  The chain_root
            * and chain_tip can be in different branches of the tree, the chain_root can be
            * an ancestor of chain_tip, and chain_tip can be an ancestor of chain_root.
+           * Multi-DOF joints (see Joint::getNrOfDofs) can only be part of the chain
+           * in the direction from the root of the tree to its leaves.
            *
            * @param chain_root the name of the root segment of the chain
            * @param chain_tip the name of the tip segment of the chain
@@ -215,6 +238,40 @@ namespace KDL
            */
         bool getSubTree(const std::string& segment_name, Tree& tree)const;
 
+          /**
+           * Request a reduced copy of the tree in which the locked joint
+           * coordinates are frozen: every segment driven by a locked
+           * coordinate gets a fixed joint whose transform is its pose at
+           * the locked position. All solvers can then be used on the
+           * smaller tree.
+           *
+           * @param locked_joints true for every locked joint coordinate,
+           * size getNrOfJoints()
+           * @param q_locked joint positions of the locked coordinates,
+           * size getNrOfJoints(), the other entries are not used
+           * @param tree the resulting tree
+           * @param full_q_nrs for every joint coordinate of the reduced
+           * tree, the index of the corresponding coordinate of this tree
+           *
+           * @return false if the sizes do not match or only part of the
+           * coordinates of a multi-DOF joint is locked
+           */
+        bool getReducedTree(const std::vector<bool>& locked_joints, const JntArray& q_locked,
+                            Tree& tree, std::vector<unsigned int>& full_q_nrs)const;
+
+          /**
+           * Request the segments of the tree in depth-first order,
+           * starting at the root. Every segment comes after its parent
+           * and the segments of a subtree are contiguous, so the
+           * recursions of the tree solvers become loops over this list.
+           *
+           * @param elements the segments in depth-first order
+           * @param parents for every segment the index of its parent in
+           * elements, -1 for the root
+           */
+        void getDepthFirstSegments(std::vector<SegmentMap::const_iterator>& elements,
+                                   std::vector<int>& parents)const;
+
         const SegmentMap& getSegments()const
         {
             return segments;
@@ -0,0 +1,152 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treecentroidalsolver.hpp"
+
+namespace KDL
+{
+    TreeCentroidalSolver::TreeCentroidalSolver(const Tree& _tree):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments())
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeCentroidalSolver::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        tree.getDepthFirstSegments(elements, parents);
+        T.resize(elements.size());
+        I.resize(elements.size());
+        I_composite.resize(elements.size());
+        v.resize(elements.size());
+        a.resize(elements.size());
+        cmm.resize(6, nj);
+    }
+
+    TreeCentroidalSolver::~TreeCentroidalSolver()
+    {
+    }
+
+    double TreeCentroidalSolver::getMass() const
+    {
+        double m = 0.0;
+        for (SegmentMap::const_iterator it = tree.getSegments().begin(); it != tree.getSegments().end(); ++it)
+            m += GetTreeElementSegment(it->second).getInertia().getMass();
+        return m;
+    }
+
+    int TreeCentroidalSolver::updateInertias(const JntArray& q)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+        I_total = RigidBodyInertia::Zero();
+        //parents come before their children
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            Frame X = segment.pose(q, GetTreeElementQNr(elements[i]->second));
+            T[i] = parents[i] < 0 ? X : T[parents[i]] * X;
+            I[i] = T[i] * segment.getInertia();
+            I_total = I_total + I[i];
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeCentroidalSolver::JntToCoM(const JntArray& q, Vector& com)
+    {
+        if (updateInertias(q))
+            return error;
+        com = I_total.getCOG();
+        return (error = E_NOERROR);
+    }
+
+    int TreeCentroidalSolver::JntToCentroidalMomentumMatrix(const JntArray& q, Eigen::MatrixXd& cmm)
+    {
+        if (cmm.rows() != 6 || cmm.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (updateInertias(q))
+            return error;
+        Vector com = I_total.getCOG();
+        //Sweep from leaf to root, accumulating the composite inertia of the subtrees
+        cmm.setZero();
+        for (unsigned int i = 0; i < elements.size(); i++)
+            I_composite[i] = I[i];
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            Rotation R_joint = segment.pose(q, q_nr).M.Inverse();
+            for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++) {
+                //unit twist of the joint in the base frame, reference point in the base origin
+                Twist S = T[i] * (R_joint * segment.unitTwist(q, q_nr, d));
+                Wrench h = (I_composite[i] * S).RefPoint(com);
+                //coupled joints add to the column of their coordinate
+                for (unsigned int k = 0; k < 3; k++) {
+                    cmm(k, q_nr + d) += h.force(k);
+                    cmm(k + 3, q_nr + d) += h.torque(k);
+                }
+            }
+            if (parents[i] >= 0)
+                I_composite[parents[i]] = I_composite[parents[i]] + I_composite[i];
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeCentroidalSolver::JntToCoMJac(const JntArray& q, Vector& com, Eigen::MatrixXd& jac)
+    {
+        if (jac.rows() != 3 || jac.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (JntToCentroidalMomentumMatrix(q, cmm))
+            return error;
+        com = I_total.getCOG();
+        //the linear momentum is the mass times the velocity of the centre of mass
+        if (I_total.getMass() == 0.0)
+            jac.setZero();
+        else
+            jac = cmm.topRows<3>() / I_total.getMass();
+        return (error = E_NOERROR);
+    }
+
+    int TreeCentroidalSolver::JntToCentroidalMomentumMatrixDotQDot(const JntArrayVel& q, Wrench& cmm_dot_qdot)
+    {
+        if (q.qdot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+        if (updateInertias(q.q))
+            return error;
+        //Sweep from root to leaf with zero joint acceleration, the sum
+        //of the rates of change of the momenta of the segments is the
+        //rate of change of the momentum of the tree
+        Wrench hdot = Wrench::Zero();
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q.q, q_nr);
+            Twist vj = X.M.Inverse(segment.twist(q.q, q.qdot, q_nr));
+            Twist aj = X.M.Inverse(segment.biasTwist(q.q, q.qdot, q_nr));
+            if (parents[i] < 0) {
+                v[i] = vj;
+                a[i] = aj;
+            } else {
+                v[i] = X.Inverse(v[parents[i]]) + vj;
+                a[i] = X.Inverse(a[parents[i]]) + aj + v[i] * vj;
+            }
+            const RigidBodyInertia& Ii = segment.getInertia();
+            hdot += T[i] * (Ii * a[i] + v[i] * (Ii * v[i]));
+        }
+        //the centre of mass moves parallel to the linear momentum, so
+        //moving the reference point adds no velocity-product term
+        cmm_dot_qdot = hdot.RefPoint(I_total.getCOG());
+        return (error = E_NOERROR);
+    }
+}
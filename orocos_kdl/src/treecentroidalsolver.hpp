@@ -0,0 +1,112 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREECENTROIDALSOLVER_HPP
+#define KDL_TREECENTROIDALSOLVER_HPP
+
+#include "solveri.hpp"
+#include "tree.hpp"
+#include "jntarrayvel.hpp"
+#include <Eigen/Core>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the centre of mass and the centroidal momentum
+     * of a KDL::Tree.
+     *
+     * This is the tree version of KDL::ChainCentroidalSolver, all
+     * quantities are expressed in the frame of the root segment. The
+     * centroidal momentum matrix A maps the joint velocities on the
+     * spatial momentum of the tree with reference point at its centre
+     * of mass. The segments are visited in depth-first order, without
+     * lookups by name, and the composite inertias of the subtrees are
+     * accumulated in one sweep from the leaves to the root.
+     */
+    class TreeCentroidalSolver : public SolverI
+    {
+    public:
+        explicit TreeCentroidalSolver(const Tree& tree);
+        virtual ~TreeCentroidalSolver();
+
+        /**
+         * Calculate the total mass of the tree.
+         */
+        double getMass() const;
+
+        /**
+         * Calculate the centre of mass of the tree.
+         *
+         * @param q input joint positions
+         * @param com output centre of mass, zero for a massless chain
+         * @return success/error code
+         */
+        int JntToCoM(const JntArray& q, Vector& com);
+
+        /**
+         * Calculate the centre of mass and its Jacobian, the 3 x nj
+         * matrix that maps the joint velocities on the velocity of the
+         * centre of mass.
+         *
+         * @param q input joint positions
+         * @param com output centre of mass
+         * @param jac output Jacobian of the centre of mass
+         * @return success/error code
+         */
+        int JntToCoMJac(const JntArray& q, Vector& com, Eigen::MatrixXd& jac);
+
+        /**
+         * Calculate the 6 x nj centroidal momentum matrix.
+         *
+         * @param q input joint positions
+         * @param cmm output centroidal momentum matrix
+         * @return success/error code
+         */
+        int JntToCentroidalMomentumMatrix(const JntArray& q, Eigen::MatrixXd& cmm);
+
+        /**
+         * Calculate the product of the time derivative of the
+         * centroidal momentum matrix and the joint velocities, the rate
+         * of change of the centroidal momentum at zero joint
+         * acceleration.
+         *
+         * @param q input joint positions and velocities
+         * @param cmm_dot_qdot output force: rate of change of the linear
+         * momentum, torque: rate of change of the angular momentum
+         * @return success/error code
+         */
+        int JntToCentroidalMomentumMatrixDotQDot(const JntArrayVel& q, Wrench& cmm_dot_qdot);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function to calculate the frames and inertias of the segments in the base frame
+        int updateInertias(const JntArray& q);
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::vector<Frame> T;
+        std::vector<RigidBodyInertia> I;
+        std::vector<RigidBodyInertia> I_composite;
+        RigidBodyInertia I_total;
+        std::vector<Twist> v;
+        std::vector<Twist> a;
+        ///Centroidal momentum matrix used by JntToCoMJac
+        Eigen::MatrixXd cmm;
+    };
+}
+#endif
@@ -0,0 +1,133 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treecoriolissolver.hpp"
+
+namespace KDL
+{
+    TreeCoriolisSolver::TreeCoriolisSolver(const Tree& _tree):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments())
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeCoriolisSolver::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        tree.getDepthFirstSegments(elements, parents);
+        T.resize(elements.size());
+        v.resize(elements.size());
+        S.resize(elements.size());
+        S_dot.resize(elements.size());
+        Ic.resize(elements.size());
+        Ic_dot.resize(elements.size());
+        hc.resize(elements.size());
+        H_tmp.resize(nj, nj);
+    }
+
+    TreeCoriolisSolver::~TreeCoriolisSolver()
+    {
+    }
+
+    int TreeCoriolisSolver::calculate(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd* H, Eigen::MatrixXd& C)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || C.rows() != (int)nj || C.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int i = 0; i < elements.size(); i++)
+            if (GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs() > 1)
+                return (error = E_NOT_IMPLEMENTED);
+
+        //Sweep from root to leaf: frames, velocities, unit twists and
+        //their derivatives, and the inertias in the base frame
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q, q_nr);
+            T[i] = parents[i] < 0 ? X : T[parents[i]] * X;
+            v[i] = parents[i] < 0 ? Twist::Zero() : v[parents[i]];
+            if (segment.getJoint().getNrOfDofs() == 1) {
+                Twist s = T[i] * X.M.Inverse(segment.unitTwist(q, q_nr, 0));
+                v[i] += s * q_dot(q_nr);
+                S[i] = toVector(s);
+                S_dot[i] = toVector(v[i] * s);
+            }
+            inertiaMatrices(T[i] * segment.getInertia(), v[i], Ic[i], Ic_dot[i]);
+            hc[i].noalias() = Ic[i] * toVector(v[i]);
+        }
+
+        //Sweep from leaf to root, the children of a segment come after
+        //it, so its subtree is complete when it is reached
+        C.setZero();
+        if (H)
+            H->setZero();
+        Vector6d F1, F2, F3, BS, SxH;
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            if (parents[i] >= 0) {
+                Ic[parents[i]] += Ic[i];
+                Ic_dot[parents[i]] += Ic_dot[i];
+                hc[parents[i]] += hc[i];
+            }
+            const Joint& joint = GetTreeElementSegment(elements[i]->second).getJoint();
+            if (joint.getNrOfDofs() == 0)
+                continue;
+            unsigned int k = GetTreeElementQNr(elements[i]->second);
+            BS.noalias() = 0.5 * Ic_dot[i] * S[i];
+            SxH = toVector(toTwist(S[i]) * toWrench(hc[i]));
+            F1.noalias() = Ic[i] * S_dot[i];
+            F1 += BS + 0.5 * SxH;
+            F2.noalias() = Ic[i] * S[i];
+            F3 = BS - 0.5 * SxH;
+            C(k, k) += S[i].dot(F1);
+            if (H)
+                (*H)(k, k) += S[i].dot(F2) + joint.getInertia();
+            for (int j = parents[i]; j >= 0; j = parents[j]) {
+                if (GetTreeElementSegment(elements[j]->second).getJoint().getNrOfDofs() == 0)
+                    continue;
+                unsigned int l = GetTreeElementQNr(elements[j]->second);
+                C(l, k) += S[j].dot(F1);
+                C(k, l) += S_dot[j].dot(F2) + S[j].dot(F3);
+                if (H) {
+                    double Hkl = S[j].dot(F2);
+                    (*H)(k, l) += Hkl;
+                    (*H)(l, k) += Hkl;
+                }
+            }
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeCoriolisSolver::JntToCoriolisMatrix(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& C)
+    {
+        return calculate(q, q_dot, 0, C);
+    }
+
+    int TreeCoriolisSolver::JntToMassAndCoriolis(const JntArray& q, const JntArray& q_dot, JntSpaceInertiaMatrix& H, Eigen::MatrixXd& C)
+    {
+        if (H.rows() != nj || H.columns() != nj)
+            return (error = E_SIZE_MISMATCH);
+        return calculate(q, q_dot, &H.data, C);
+    }
+
+    int TreeCoriolisSolver::JntToMassDot(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& H_dot)
+    {
+        if (H_dot.rows() != (int)nj || H_dot.cols() != (int)nj)
+            return (error = E_SIZE_MISMATCH);
+        if (calculate(q, q_dot, 0, H_tmp))
+            return error;
+        H_dot = H_tmp + H_tmp.transpose();
+        return (error = E_NOERROR);
+    }
+}
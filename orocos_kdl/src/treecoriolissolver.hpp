@@ -0,0 +1,100 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREECORIOLISSOLVER_HPP
+#define KDL_TREECORIOLISSOLVER_HPP
+
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "jntspaceinertiamatrix.hpp"
+#include "solveri.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <Eigen/StdVector>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the Coriolis matrix C(q,qdot) of a KDL::Tree.
+     *
+     * This is the tree version of KDL::ChainCoriolisSolver: C*qdot are
+     * the Coriolis and centrifugal torques and Hdot - 2C is
+     * skew-symmetric. The inertias, their time derivatives and the
+     * momenta are accumulated over the subtrees, and every joint is
+     * matched with the joints on its path to the root. The segments are
+     * visited in depth-first order from preallocated arrays.
+     *
+     * Only single DOF joints (including coupled joints) are supported.
+     */
+    class TreeCoriolisSolver : public SolverI
+    {
+    public:
+        explicit TreeCoriolisSolver(const Tree& tree);
+        virtual ~TreeCoriolisSolver();
+
+        /**
+         * Calculate the nj x nj Coriolis matrix.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param C output Coriolis matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToCoriolisMatrix(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& C);
+
+        /**
+         * Calculate the mass matrix and the Coriolis matrix in one sweep.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param H output mass matrix
+         * @param C output Coriolis matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToMassAndCoriolis(const JntArray& q, const JntArray& q_dot, JntSpaceInertiaMatrix& H, Eigen::MatrixXd& C);
+
+        /**
+         * Calculate the time derivative of the mass matrix, C + C^T.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param H_dot output time derivative of the mass matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF joints
+         */
+        int JntToMassDot(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd& H_dot);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function with an optional mass matrix
+        int calculate(const JntArray& q, const JntArray& q_dot, Eigen::MatrixXd* H, Eigen::MatrixXd& C);
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::vector<Frame> T;
+        std::vector<Twist> v;
+        //unit twists of the joints and their time derivatives
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S_dot;
+        //inertia, its time derivative and the momentum of the subtrees
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > Ic;
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > Ic_dot;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > hc;
+        Eigen::MatrixXd H_tmp;
+    };
+}
+
+#endif
@@ -0,0 +1,186 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treedynsolver_floatingbase.hpp"
+
+namespace KDL
+{
+    TreeDynSolver_FloatingBase::TreeDynSolver_FloatingBase(const Tree& _tree, Vector _grav):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments()), grav(_grav)
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeDynSolver_FloatingBase::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        first_dof.clear();
+        indices.clear();
+        tree.getDepthFirstSegments(elements, parents);
+        unsigned int nr_of_dofs = 0;
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            indices[elements[i]->first] = i;
+            first_dof.push_back(nr_of_dofs);
+            nr_of_dofs += GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs();
+        }
+        X.resize(elements.size());
+        S.resize(nr_of_dofs);
+        v.resize(elements.size());
+        a.resize(elements.size());
+        f.resize(elements.size());
+        Ic.resize(elements.size());
+        q_dotdot_zero.resize(nj);
+    }
+
+    TreeDynSolver_FloatingBase::~TreeDynSolver_FloatingBase()
+    {
+    }
+
+    int TreeDynSolver_FloatingBase::CartToJnt(const Rotation& R_base, const Twist& v_base, const Twist& a_base,
+                                              const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot,
+                                              const WrenchMap& f_ext, Wrench& f_base, JntArray& torques)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || q_dotdot.rows() != nj || torques.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //gravity as an acceleration of the base, in base coordinates
+        Twist ag = R_base.Inverse(Twist(-grav, Vector::Zero()));
+
+        //Sweep from root to leaf, parents come before their children
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& seg = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            X[i] = seg.pose(q, j);
+            Twist vj = X[i].M.Inverse(seg.twist(q, q_dot, j));
+            Twist aj = X[i].M.Inverse(seg.twist(q, q_dotdot, j) + seg.biasTwist(q, q_dot, j));
+            if (parents[i] < 0) {
+                v[i] = X[i].Inverse(v_base) + vj;
+                a[i] = X[i].Inverse(a_base + ag) + aj + v[i] * vj;
+            } else {
+                v[i] = X[i].Inverse(v[parents[i]]) + vj;
+                a[i] = X[i].Inverse(a[parents[i]]) + aj + v[i] * vj;
+            }
+            const RigidBodyInertia& I = seg.getInertia();
+            f[i] = I * a[i] + v[i] * (I * v[i]);
+        }
+
+        //External forces, only the segments that have one are looked up
+        for (WrenchMap::const_iterator ext = f_ext.begin(); ext != f_ext.end(); ++ext) {
+            std::map<std::string, unsigned int>::const_iterator index = indices.find(ext->first);
+            if (index != indices.end())
+                f[index->second] = f[index->second] - ext->second;
+        }
+
+        //Sweep from leaf to root, coupled joints add their effort to
+        //the one of their coordinate
+        SetToZero(torques);
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            const Segment& seg = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            if (seg.getJoint().getNrOfDofs() == 1) {
+                torques(j) += dot(X[i].M.Inverse(seg.unitTwist(q, j, 0)), f[i]);
+                torques(j) += seg.getJoint().getInertia() * q_dotdot(j);
+            } else {
+                for (unsigned int d = 0; d < seg.getJoint().getNrOfDofs(); d++)
+                    torques(j + d) = dot(X[i].M.Inverse(seg.unitTwist(q, j, d)), f[i]);
+            }
+            if (parents[i] >= 0)
+                f[parents[i]] = f[parents[i]] + X[i] * f[i];
+        }
+        f_base = f[0];
+        return (error = E_NOERROR);
+    }
+
+    int TreeDynSolver_FloatingBase::JntToBias(const Rotation& R_base, const Twist& v_base, const JntArray& q,
+                                              const JntArray& q_dot, Wrench& f_base, JntArray& bias)
+    {
+        return CartToJnt(R_base, v_base, Twist::Zero(), q, q_dot, q_dotdot_zero, f_ext_none, f_base, bias);
+    }
+
+    int TreeDynSolver_FloatingBase::JntToMass(const JntArray& q, JntSpaceInertiaMatrix& H)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || H.rows() != 6 + nj || H.columns() != 6 + nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Sweep from root to leaf
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& seg = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            X[i] = seg.pose(q, j);
+            Ic[i] = seg.getInertia();
+            for (unsigned int d = 0; d < seg.getJoint().getNrOfDofs(); d++)
+                S[first_dof[i] + d] = X[i].M.Inverse(seg.unitTwist(q, j, d));
+        }
+
+        //Sweep from leaf to root, the children of a segment come after
+        //it, so its composite inertia is complete when it is reached.
+        //Coupled joints add their contributions to the rows and columns
+        //of their coordinate.
+        SetToZero(H);
+        Wrench F;
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            if (parents[i] >= 0)
+                Ic[parents[i]] = Ic[parents[i]] + X[i] * Ic[i];
+
+            const Joint& joint = GetTreeElementSegment(elements[i]->second).getJoint();
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            for (unsigned int d = 0; d < joint.getNrOfDofs(); d++) {
+                F = Ic[i] * S[first_dof[i] + d];
+                unsigned int k = 6 + q_nr + d;
+                //coupling between the DOFs of the same joint
+                for (unsigned int e = 0; e < d; e++) {
+                    double Hkj = dot(F, S[first_dof[i] + e]);
+                    H(k, 6 + q_nr + e) += Hkj;
+                    H(6 + q_nr + e, k) += Hkj;
+                }
+                H(k, k) += dot(S[first_dof[i] + d], F);
+                if (joint.getNrOfDofs() == 1)
+                    H(k, k) += joint.getInertia();
+                //go from the segment to the root, matching the unit force
+                //with the DOFs of every joint on the way
+                int l = i;
+                while (parents[l] >= 0) {
+                    F = X[l] * F;
+                    l = parents[l];
+                    const Joint& joint_l = GetTreeElementSegment(elements[l]->second).getJoint();
+                    unsigned int q_nr_l = GetTreeElementQNr(elements[l]->second);
+                    for (unsigned int e = 0; e < joint_l.getNrOfDofs(); e++) {
+                        double Hkj = dot(F, S[first_dof[l] + e]);
+                        H(k, 6 + q_nr_l + e) += Hkj;
+                        H(6 + q_nr_l + e, k) += Hkj;
+                    }
+                }
+                //the unit force in the root frame couples with the base
+                for (unsigned int r = 0; r < 6; r++) {
+                    H(r, k) += F(r);
+                    H(k, r) += F(r);
+                }
+            }
+        }
+
+        //composite inertia of the whole tree
+        for (unsigned int c = 0; c < 6; c++) {
+            Twist t = Twist::Zero();
+            t(c) = 1.0;
+            F = Ic[0] * t;
+            for (unsigned int r = 0; r < 6; r++)
+                H(r, c) = F(r);
+        }
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,128 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREEDYNSOLVER_FLOATINGBASE_HPP
+#define KDL_TREEDYNSOLVER_FLOATINGBASE_HPP
+
+#include "treeidsolver.hpp"
+#include "jntspaceinertiamatrix.hpp"
+
+namespace KDL
+{
+    /**
+     * \brief Inverse dynamics and mass matrix of a KDL::Tree with a
+     * floating (6 DOF) base.
+     *
+     * The root frame of the tree is the base body, the segments that
+     * are connected to it by fixed joints belong to the base. The
+     * motion of the base is given by its twist and its acceleration,
+     * both expressed in the root frame with the reference point at its
+     * origin (the body twist). The acceleration is the time derivative
+     * of that twist. Gravity is given in the world frame, together
+     * with the orientation of the base in the world.
+     *
+     * The generalized coordinates are the 6 base velocities (linear
+     * first, then angular, as in a Twist) followed by the joints. The
+     * generalized force of the base is the wrench on the root frame
+     * (force first, then torque) that realizes the motion, it is zero
+     * for a consistent free-floating motion.
+     *
+     * The inverse dynamics is the recursive Newton-Euler algorithm of
+     * KDL::TreeIdSolver_RNE with the base motion as start of the
+     * recursion, the mass matrix is calculated with the composite
+     * rigid body algorithm. The segments are visited in depth-first
+     * order from preallocated arrays, no memory is allocated after
+     * construction.
+     */
+    class TreeDynSolver_FloatingBase : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver
+         * \param tree The kinematic tree, an internal reference will be stored.
+         * \param grav The gravity vector in the world frame.
+         */
+        TreeDynSolver_FloatingBase(const Tree& tree, Vector grav);
+        virtual ~TreeDynSolver_FloatingBase();
+
+        /**
+         * Calculate the base wrench and joint torques of a motion.
+         *
+         * @param R_base orientation of the base in the world frame
+         * @param v_base twist of the base
+         * @param a_base acceleration of the base
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param q_dotdot input joint accelerations
+         * @param f_ext the external forces (no gravity) on the segments,
+         * wrenches on segments that are not in the tree are ignored
+         * @param f_base output wrench on the base
+         * @param torques output joint torques
+         * @return success/error code
+         */
+        int CartToJnt(const Rotation& R_base, const Twist& v_base, const Twist& a_base,
+                      const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot,
+                      const WrenchMap& f_ext, Wrench& f_base, JntArray& torques);
+
+        /**
+         * Calculate the bias forces: the gravity, Coriolis and
+         * centrifugal forces, the result of CartToJnt at zero
+         * acceleration and without external forces.
+         *
+         * @param R_base orientation of the base in the world frame
+         * @param v_base twist of the base
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param f_base output bias wrench on the base
+         * @param bias output bias joint torques
+         * @return success/error code
+         */
+        int JntToBias(const Rotation& R_base, const Twist& v_base, const JntArray& q,
+                      const JntArray& q_dot, Wrench& f_base, JntArray& bias);
+
+        /**
+         * Calculate the (6+nj) x (6+nj) mass matrix, the base
+         * coordinates first.
+         *
+         * @param q input joint positions
+         * @param H output mass matrix, of size 6+nj
+         * @return success/error code
+         */
+        int JntToMass(const JntArray& q, JntSpaceInertiaMatrix& H);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        Vector grav;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::map<std::string, unsigned int> indices;
+        //index of the first unit twist of every segment in S
+        std::vector<unsigned int> first_dof;
+        std::vector<Frame> X;
+        std::vector<Twist> S;
+        std::vector<Twist> v;
+        std::vector<Twist> a;
+        std::vector<Wrench> f;
+        std::vector<RigidBodyInertia> Ic;
+        JntArray q_dotdot_zero;
+        WrenchMap f_ext_none;
+    };
+}
+
+#endif
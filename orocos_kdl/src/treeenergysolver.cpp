@@ -0,0 +1,126 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treeenergysolver.hpp"
+#include <iterator>
+
+namespace KDL
+{
+    TreeEnergySolver::TreeEnergySolver(const Tree& _tree, Vector _grav):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments()), grav(_grav)
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeEnergySolver::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        tree.getDepthFirstSegments(elements, parents);
+        //the segment map is sorted by name, the root is not reported
+        indices.resize(elements.size());
+        unsigned int root = std::distance(tree.getSegments().begin(), elements[0]);
+        for (unsigned int i = 1; i < elements.size(); i++) {
+            indices[i] = std::distance(tree.getSegments().begin(), elements[i]);
+            if (indices[i] > root)
+                indices[i]--;
+        }
+        F.resize(elements.size());
+        v.resize(elements.size());
+        a.resize(elements.size());
+        T.resize(ns);
+        V.resize(ns);
+    }
+
+    TreeEnergySolver::~TreeEnergySolver()
+    {
+    }
+
+    int TreeEnergySolver::calculate(const JntArray& q, const JntArray& q_dot)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Sweep from root to leaf, the twist in the tip frame and the
+        //frame in the base, the root segment does not move
+        F[0] = Frame::Identity();
+        v[0] = Twist::Zero();
+        for (unsigned int i = 1; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q, j);
+            F[i] = F[parents[i]] * X;
+            v[i] = X.Inverse(v[parents[i]]) + X.M.Inverse(segment.twist(q, q_dot, j));
+            const RigidBodyInertia& I = segment.getInertia();
+            unsigned int k = indices[i];
+            T[k] = 0.5 * dot(v[i], I * v[i]);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                T[k] += 0.5 * segment.getJoint().getInertia() * q_dot(j) * q_dot(j);
+            V[k] = -I.getMass() * dot(grav, F[i] * I.getCOG());
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeEnergySolver::JntToEnergy(const JntArray& q, const JntArray& q_dot, double& kinetic, double& potential)
+    {
+        if (calculate(q, q_dot))
+            return error;
+        kinetic = 0.0;
+        potential = 0.0;
+        for (unsigned int k = 0; k < ns; k++) {
+            kinetic += T[k];
+            potential += V[k];
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeEnergySolver::JntToSegmentEnergy(const JntArray& q, const JntArray& q_dot, std::vector<double>& kinetic, std::vector<double>& potential)
+    {
+        if (kinetic.size() != ns || potential.size() != ns)
+            return (error = E_SIZE_MISMATCH);
+        if (calculate(q, q_dot))
+            return error;
+        kinetic = T;
+        potential = V;
+        return (error = E_NOERROR);
+    }
+
+    int TreeEnergySolver::JntToPower(const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot, double& power)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || q_dotdot.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Gravity enters as an acceleration of the root, as in
+        //TreeIdSolver_RNE
+        v[0] = Twist::Zero();
+        a[0] = -Twist(grav, Vector::Zero());
+        power = 0.0;
+        for (unsigned int i = 1; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q, j);
+            Twist vj = X.M.Inverse(segment.twist(q, q_dot, j));
+            Twist aj = X.M.Inverse(segment.twist(q, q_dotdot, j) + segment.biasTwist(q, q_dot, j));
+            v[i] = X.Inverse(v[parents[i]]) + vj;
+            a[i] = X.Inverse(a[parents[i]]) + aj + v[i] * vj;
+            power += dot(v[i], segment.getInertia() * a[i]);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                power += segment.getJoint().getInertia() * q_dot(j) * q_dotdot(j);
+        }
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,106 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREEENERGYSOLVER_HPP
+#define KDL_TREEENERGYSOLVER_HPP
+
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "solveri.hpp"
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the kinetic energy, the potential energy and the
+     * mechanical power of a KDL::Tree.
+     *
+     * This is the tree version of KDL::ChainEnergySolver. The segments
+     * are visited in depth-first order from preallocated arrays. The
+     * energies per segment are reported in the order of
+     * Tree::getSegments() (which is sorted by name), without the root
+     * segment.
+     */
+    class TreeEnergySolver : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver
+         * \param tree The tree, an internal reference will be stored.
+         * \param grav The gravity vector to use during the calculation.
+         */
+        TreeEnergySolver(const Tree& tree, Vector grav);
+        virtual ~TreeEnergySolver();
+
+        /**
+         * Calculate the energy of the tree.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param kinetic output kinetic energy
+         * @param potential output potential energy
+         * @return success/error code
+         */
+        int JntToEnergy(const JntArray& q, const JntArray& q_dot, double& kinetic, double& potential);
+
+        /**
+         * Calculate the energy of every segment.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param kinetic output kinetic energy per segment, of size
+         * getNrOfSegments()
+         * @param potential output potential energy per segment, of size
+         * getNrOfSegments()
+         * @return success/error code
+         */
+        int JntToSegmentEnergy(const JntArray& q, const JntArray& q_dot, std::vector<double>& kinetic, std::vector<double>& potential);
+
+        /**
+         * Calculate the mechanical power, the rate of change of the
+         * kinetic and potential energy.
+         *
+         * @param q input joint positions
+         * @param q_dot input joint velocities
+         * @param q_dotdot input joint accelerations
+         * @param power output power
+         * @return success/error code
+         */
+        int JntToPower(const JntArray& q, const JntArray& q_dot, const JntArray& q_dotdot, double& power);
+
+        void setGravity(const Vector& _grav) {grav = _grav;};
+        const Vector& getGravity() const {return grav;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function that fills the energies of the segments
+        int calculate(const JntArray& q, const JntArray& q_dot);
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        Vector grav;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        //position of every element in the reported energies
+        std::vector<unsigned int> indices;
+        std::vector<Frame> F;
+        std::vector<Twist> v;
+        std::vector<Twist> a;
+        std::vector<double> T;
+        std::vector<double> V;
+    };
+}
+
+#endif
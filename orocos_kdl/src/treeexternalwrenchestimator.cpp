@@ -0,0 +1,195 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treeexternalwrenchestimator.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace KDL {
+
+TreeExternalWrenchEstimator::TreeExternalWrenchEstimator(const Tree& _tree, const Vector& gravity, const std::vector<std::string>& _contact_segments,
+                                                         const double sample_frequency, const double estimation_gain, const double filter_constant,
+                                                         const double damping) :
+    tree(_tree),
+    DT_SEC(1.0 / sample_frequency), FILTER_CONST(filter_constant), DAMPING(damping),
+    tolerance(0.0),
+    nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments()), nc(_contact_segments.size()),
+    contact_segments(_contact_segments),
+    ESTIMATION_GAIN(Eigen::VectorXd::Constant(nj, estimation_gain)),
+    factorization(6 * nc),
+    coriolis_solver(_tree),
+    gravity_solver(_tree, gravity)
+{
+    updateInternalDataStructures();
+}
+
+TreeExternalWrenchEstimator::~TreeExternalWrenchEstimator()
+{
+}
+
+void TreeExternalWrenchEstimator::updateInternalDataStructures()
+{
+    nj = tree.getNrOfJoints();
+    ns = tree.getNrOfSegments();
+    tree.getDepthFirstSegments(elements, parents);
+    contact_elements.assign(nc, -1);
+    for (unsigned int k = 0; k < nc; k++)
+        for (unsigned int i = 1; i < elements.size(); i++)
+            if (elements[i]->first == contact_segments[k])
+                contact_elements[k] = i;
+    T.resize(elements.size());
+    S.resize(elements.size());
+    jnt_mass_matrix.resize(nj);
+    coriolis_matrix.resize(nj, nj);
+    initial_jnt_momentum.resize(nj);
+    estimated_momentum_integral.resize(nj);
+    filtered_estimated_ext_torque.resize(nj);
+    gravity_torque.resize(nj);
+    total_torque.resize(nj);
+    estimated_ext_torque.resize(nj);
+    factorized_position.resize(nj);
+    ESTIMATION_GAIN.conservativeResizeLike(Eigen::VectorXd::Constant(nj, ESTIMATION_GAIN(0)));
+    contact_jacobian_transpose.resize(nj, 6 * nc);
+    normal_matrix.resize(6 * nc, 6 * nc);
+    rhs.resize(6 * nc);
+    stacked_wrench.resize(6 * nc);
+    factorized = false;
+    nr_of_factorizations = 0;
+    coriolis_solver.updateInternalDataStructures();
+    gravity_solver.updateInternalDataStructures();
+}
+
+int TreeExternalWrenchEstimator::setInitialMomentum(const JntArray& joint_position, const JntArray& joint_velocity)
+{
+    if (joint_position.rows() != nj || joint_velocity.rows() != nj)
+        return (error = E_SIZE_MISMATCH);
+
+    if (E_NOERROR != coriolis_solver.JntToMassAndCoriolis(joint_position, joint_velocity, jnt_mass_matrix, coriolis_matrix))
+        return (error = E_CORIOLISSOLVER_FAILED);
+
+    initial_jnt_momentum.data = jnt_mass_matrix.data * joint_velocity.data;
+
+    // Reset data because of the new momentum offset
+    SetToZero(estimated_momentum_integral);
+    SetToZero(filtered_estimated_ext_torque);
+
+    return (error = E_NOERROR);
+}
+
+void TreeExternalWrenchEstimator::setRefactorizationTolerance(const double _tolerance)
+{
+    tolerance = _tolerance;
+}
+
+void TreeExternalWrenchEstimator::factorize(const JntArray& joint_position)
+{
+    // Frames and unit twists in the base frame, base origin as reference point
+    T[0] = Frame::Identity();
+    for (unsigned int i = 1; i < elements.size(); i++) {
+        const Segment& segment = GetTreeElementSegment(elements[i]->second);
+        unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+        Frame X = segment.pose(joint_position, q_nr);
+        T[i] = T[parents[i]] * X;
+        if (segment.getJoint().getNrOfDofs() == 1)
+            S[i] = T[i] * X.M.Inverse(segment.unitTwist(joint_position, q_nr, 0));
+    }
+
+    // Every joint between a contact and the root feels its wrench, the
+    // unit twists are expressed in the contact frame so that the wrench
+    // is as well
+    contact_jacobian_transpose.setZero();
+    for (unsigned int k = 0; k < nc; k++) {
+        const Frame& contact = T[contact_elements[k]];
+        for (int i = contact_elements[k]; i > 0; i = parents[i]) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                contact_jacobian_transpose.block(GetTreeElementQNr(elements[i]->second), 6 * k, 1, 6) +=
+                    toVector(contact.Inverse(S[i])).transpose();
+        }
+    }
+    normal_matrix.noalias() = contact_jacobian_transpose.transpose() * contact_jacobian_transpose;
+    normal_matrix.diagonal().array() += DAMPING * DAMPING;
+    factorization.compute(normal_matrix);
+    factorized_position = joint_position;
+    factorized = true;
+    nr_of_factorizations++;
+}
+
+int TreeExternalWrenchEstimator::JntToExtWrench(const JntArray& joint_position, const JntArray& joint_velocity, const JntArray& joint_torque,
+                                                std::vector<Wrench>& external_wrenches)
+{
+    if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+        return (error = E_NOT_UP_TO_DATE);
+    if (joint_position.rows() != nj || joint_velocity.rows() != nj || joint_torque.rows() != nj || external_wrenches.size() != nc)
+        return (error = E_SIZE_MISMATCH);
+    for (unsigned int k = 0; k < nc; k++)
+        if (contact_elements[k] < 0)
+            return (error = E_OUT_OF_RANGE);
+
+    /**
+     * Part I: the momentum observer for the external joint torques
+     */
+    if (E_NOERROR != coriolis_solver.JntToMassAndCoriolis(joint_position, joint_velocity, jnt_mass_matrix, coriolis_matrix))
+        return (error = E_CORIOLISSOLVER_FAILED);
+
+    if (E_NOERROR != gravity_solver.JntToGravity(joint_position, gravity_torque))
+        return (error = E_GRAVITYSOLVER_FAILED);
+
+    // Total torque exerted on the joints, Hdot*qdot - C*qdot = C^T*qdot
+    total_torque.data = joint_torque.data - gravity_torque.data;
+    total_torque.data.noalias() += coriolis_matrix.transpose() * joint_velocity.data;
+
+    // Accumulate main integral
+    estimated_momentum_integral.data += (total_torque.data + filtered_estimated_ext_torque.data) * DT_SEC;
+
+    // Estimate external joint torque
+    estimated_ext_torque.data = jnt_mass_matrix.data * joint_velocity.data;
+    estimated_ext_torque.data -= estimated_momentum_integral.data + initial_jnt_momentum.data;
+    estimated_ext_torque.data = ESTIMATION_GAIN.asDiagonal() * estimated_ext_torque.data;
+
+    // First order low-pass filter, turned off by setting FILTER_CONST to 0
+    filtered_estimated_ext_torque.data = FILTER_CONST * filtered_estimated_ext_torque.data + (1.0 - FILTER_CONST) * estimated_ext_torque.data;
+
+    /**
+     * Part II: distribute the external joint torques over the contacts
+     */
+    bool moved = !factorized;
+    for (unsigned int i = 0; !moved && i < nj; i++)
+        moved = std::fabs(joint_position(i) - factorized_position(i)) > tolerance;
+    if (moved)
+        factorize(joint_position);
+
+    rhs.noalias() = contact_jacobian_transpose.transpose() * filtered_estimated_ext_torque.data;
+    stacked_wrench = factorization.solve(rhs);
+    for (unsigned int k = 0; k < nc; k++)
+        external_wrenches[k] = toWrench(stacked_wrench.segment<6>(6 * k));
+
+    return (error = E_NOERROR);
+}
+
+void TreeExternalWrenchEstimator::getEstimatedJntTorque(JntArray& external_joint_torque) const
+{
+    assert(external_joint_torque.rows() == filtered_estimated_ext_torque.rows());
+    external_joint_torque = filtered_estimated_ext_torque;
+}
+
+const char* TreeExternalWrenchEstimator::strError(const int error) const
+{
+    if (E_CORIOLISSOLVER_FAILED == error) return "Internally-used Coriolis matrix solver failed";
+    else if (E_GRAVITYSOLVER_FAILED == error) return "Internally-used gravity solver failed";
+    else return SolverI::strError(error);
+}
+
+} // namespace
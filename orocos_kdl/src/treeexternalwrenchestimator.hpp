@@ -0,0 +1,144 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREE_EXTERNAL_WRENCH_ESTIMATOR_HPP
+#define KDL_TREE_EXTERNAL_WRENCH_ESTIMATOR_HPP
+
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "jntspaceinertiamatrix.hpp"
+#include "solveri.hpp"
+#include "treecoriolissolver.hpp"
+#include "treeidsolver_gravity.hpp"
+#include <Eigen/Cholesky>
+
+namespace KDL {
+
+    /**
+     * \brief First-order momentum observer for the estimation of
+     * external wrenches applied on several contact segments of a tree.
+     *
+     * The tree version of KDL::ChainExternalWrenchEstimator. The
+     * observer estimates the external joint torques once, for the
+     * whole tree:
+     *
+     * S. Haddadin, A. De Luca and A. Albu-Schäffer,
+     * "Robot Collisions: A Survey on Detection, Isolation, and Identification,"
+     * in IEEE Transactions on Robotics, vol. 33(6), pp. 1292-1312, 2017.
+     *
+     * The mass matrix and the Coriolis matrix come from one sweep of
+     * KDL::TreeCoriolisSolver, so Hdot*qdot - C*qdot = C^T*qdot is exact
+     * and needs no finite difference of the mass matrix.
+     *
+     * The external joint torques are then distributed over the contact
+     * segments with the stacked contact Jacobian Jc, as the damped
+     * least-squares solution of Jc^T * w = tau_ext. The normal
+     * equations Jc*Jc^T + damping^2*I are factorized with an LDLT that
+     * is kept between calls. With a refactorization tolerance > 0 the
+     * factorization is only updated when a joint has moved more than
+     * the tolerance since the last update, which saves the Jacobian
+     * and the factorization at high sensor rates at the cost of a
+     * slightly outdated contact geometry.
+     *
+     * Every wrench is expressed in the frame of its contact segment.
+     * Only trees of single DOF joints are supported.
+     */
+    class TreeExternalWrenchEstimator : public SolverI
+    {
+    public:
+        static const int E_CORIOLISSOLVER_FAILED = -100; //! Internally-used Coriolis matrix solver failed
+        static const int E_GRAVITYSOLVER_FAILED = -101; //! Internally-used gravity solver failed
+
+        /**
+         * Constructor for the estimator, it will allocate all the necessary memory
+         * \param tree The tree of the robot, an internal reference will be stored.
+         * \param gravity The gravity-acceleration vector to use during the calculation.
+         * \param contact_segments The segments on which the external wrenches act.
+         * \param sample_frequency Frequency at which users updates it estimation loop (in Hz).
+         * \param estimation_gain Parameter used to control the estimator's convergence
+         * \param filter_constant Parameter of the low-pass filter of the estimated torques, between 0 and 1,
+         *                        0 turns the filter off.
+         * \param damping Damping of the least-squares distribution over the contacts. Default: 0.00001
+         */
+        TreeExternalWrenchEstimator(const Tree& tree, const Vector& gravity, const std::vector<std::string>& contact_segments,
+                                    const double sample_frequency, const double estimation_gain, const double filter_constant,
+                                    const double damping = 0.00001);
+        virtual ~TreeExternalWrenchEstimator();
+
+        /**
+         * Calculates robot's initial momentum in the joint space.
+         * If this method is not called by the user, zero values will be taken for the initial momentum.
+         */
+        int setInitialMomentum(const JntArray& joint_position, const JntArray& joint_velocity);
+
+        /**
+         * Sets the joint motion after which the contact Jacobian and its
+         * factorization are updated, 0 (the default) updates them every call.
+         */
+        void setRefactorizationTolerance(const double tolerance);
+
+        /**
+         * Calculates the external wrenches that are applied on the contact segments.
+         *
+         * \param joint_position The current (measured) joint positions.
+         * \param joint_velocity The current (measured) joint velocities.
+         * \param joint_torque The commanded or measured joint torques.
+         * \param external_wrenches The estimated wrench of every contact, expressed
+         *                          in the frame of its segment.
+         *
+         * @return error/success code, E_OUT_OF_RANGE for an unknown contact segment
+         */
+        int JntToExtWrench(const JntArray& joint_position, const JntArray& joint_velocity, const JntArray& joint_torque,
+                           std::vector<Wrench>& external_wrenches);
+
+        /// Returns the external joint torques estimated by the observer
+        void getEstimatedJntTorque(JntArray& external_joint_torque) const;
+        /// Returns the number of updates of the contact factorization
+        unsigned int getNrOfFactorizations() const {return nr_of_factorizations;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures()
+        virtual void updateInternalDataStructures();
+        /// @copydoc KDL::SolverI::strError()
+        virtual const char* strError(const int error) const;
+
+    private:
+        ///Calculates the transposed contact Jacobian and factorizes it
+        void factorize(const JntArray& joint_position);
+        const Tree& tree;
+        const double DT_SEC, FILTER_CONST, DAMPING;
+        double tolerance;
+        unsigned int nj, ns, nc;
+        std::vector<std::string> contact_segments;
+        std::vector<int> contact_elements;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::vector<Frame> T;
+        std::vector<Twist> S;
+        JntSpaceInertiaMatrix jnt_mass_matrix;
+        Eigen::MatrixXd coriolis_matrix;
+        JntArray initial_jnt_momentum, estimated_momentum_integral, filtered_estimated_ext_torque,
+                 gravity_torque, total_torque, estimated_ext_torque, factorized_position;
+        Eigen::VectorXd ESTIMATION_GAIN;
+        //transposed stacked contact Jacobian and its normal equations
+        Eigen::MatrixXd contact_jacobian_transpose, normal_matrix;
+        Eigen::LDLT<Eigen::MatrixXd> factorization;
+        Eigen::VectorXd rhs, stacked_wrench;
+        bool factorized;
+        unsigned int nr_of_factorizations;
+        TreeCoriolisSolver coriolis_solver;
+        TreeIdSolver_Gravity gravity_solver;
+    };
+}
+
+#endif
@@ -26,10 +26,10 @@
 #include <string>
 
 #include "tree.hpp"
-//#include "framevel.hpp"
+#include "framevel.hpp"
 //#include "frameacc.hpp"
 #include "jntarray.hpp"
-//#include "jntarrayvel.hpp"
+#include "jntarrayvel.hpp"
 //#include "jntarrayacc.hpp"
 
 namespace KDL {
@@ -63,21 +63,22 @@ namespace KDL {
      *
      * @ingroup KinematicFamily
      */
-//    class TreeFkSolverVel {
-//    public:
+    class TreeFkSolverVel {
+    public:
         /**
          * Calculate forward position and velocity kinematics, from
          * joint coordinates to cartesian coordinates.
          *
          * @param q_in input joint coordinates (position and velocity)
          * @param out output cartesian coordinates (position and velocity)
+         * @param segmentName name of the segment
          *
          * @return if < 0 something went wrong
          */
-//        virtual int JntToCart(const JntArrayVel& q_in, FrameVel& out,int segmentNr=-1)=0;
+        virtual int JntToCart(const JntArrayVel& q_in, FrameVel& out, std::string segmentName)=0;
 
-//        virtual ~TreeFkSolverVel(){};
-//    };
+        virtual ~TreeFkSolverVel(){};
+    };
     
     /**
      * \brief This <strong>abstract</strong> class encapsulates a solver
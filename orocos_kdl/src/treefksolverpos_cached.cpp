@@ -0,0 +1,62 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treefksolverpos_cached.hpp"
+
+namespace KDL {
+
+    TreeFkSolverPos_cached::TreeFkSolverPos_cached(const Tree& _tree, unsigned int capacity, double resolution):
+        tree(_tree),
+        cache(tree.getNrOfJoints(), tree.getNrOfSegments()+1, capacity, resolution),
+        frames(tree.getNrOfSegments()+1)
+    {
+        tree.getDepthFirstSegments(segments, parents);
+        for (unsigned int i = 0; i < segments.size(); i++)
+            indices[segments[i]->first] = i;
+    }
+
+    void TreeFkSolverPos_cached::clearCache()
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        cache.clear();
+    }
+
+    int TreeFkSolverPos_cached::JntToCart(const JntArray& q_in, Frame& p_out, std::string segmentName)
+    {
+        std::map<std::string, unsigned int>::const_iterator index = indices.find(segmentName);
+
+        if(q_in.rows() != tree.getNrOfJoints())
+            return -1;
+        else if(index == indices.end()) //if the segment name is not found
+            return -2;
+        else if(cache.lookup(q_in, index->second, 1, &p_out))
+            return 0;
+
+        //on a miss the frames of all segments are calculated and stored
+        std::lock_guard<std::mutex> lock(write_mutex);
+        for (unsigned int i = 0; i < segments.size(); i++) {
+            const TreeElementType& element = segments[i]->second;
+            Frame pose = GetTreeElementSegment(element).pose(q_in, GetTreeElementQNr(element));
+            frames[i] = parents[i] < 0 ? pose : frames[parents[i]]*pose;
+        }
+        cache.insert(q_in, frames.data());
+        p_out = frames[index->second];
+        return 0;
+    }
+
+    TreeFkSolverPos_cached::~TreeFkSolverPos_cached()
+    {
+    }
+
+}
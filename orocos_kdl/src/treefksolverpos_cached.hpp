@@ -0,0 +1,76 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDLTREEFKSOLVERPOS_CACHED_HPP
+#define KDLTREEFKSOLVERPOS_CACHED_HPP
+
+#include "treefksolver.hpp"
+#include "framecache.hpp"
+#include <map>
+#include <mutex>
+
+namespace KDL {
+
+    /**
+     * Forward position kinematics of a general kinematic tree
+     * (KDL::Tree) with a bounded cache of the frames of all segments.
+     * On a miss the frames of all segments are calculated in one pass
+     * from the root and stored, so requests for other segments at the
+     * same configuration are hits. See FrameCache for the caching
+     * policy.
+     *
+     * JntToCart can be called from several threads at the same time:
+     * cache hits are lock-free, misses are serialized.
+     *
+     * @ingroup KinematicFamily
+     */
+    class TreeFkSolverPos_cached : public TreeFkSolverPos
+    {
+    public:
+        /**
+         * @param tree the tree to calculate forward kinematics for
+         * @param capacity number of configurations kept in the cache
+         * @param resolution quantization step of the joint positions
+         * used as cache key, 0 for exact keys
+         */
+        TreeFkSolverPos_cached(const Tree& tree, unsigned int capacity=1024, double resolution=0.0);
+        ~TreeFkSolverPos_cached();
+
+        virtual int JntToCart(const JntArray& q_in, Frame& p_out, std::string segmentName);
+
+        /**
+         * Remove all configurations from the cache.
+         */
+        void clearCache();
+
+        /**
+         * Request the cache, e.g. for its hit and miss statistics.
+         */
+        const FrameCache& getCache() const {return cache;};
+        void resetStatistics() {cache.resetStatistics();};
+
+    private:
+        const Tree tree;
+        //segments ordered from the root to the leaves, with the index of their parent
+        std::vector<SegmentMap::const_iterator> segments;
+        std::vector<int> parents;
+        std::map<std::string, unsigned int> indices;
+        FrameCache cache;
+        std::mutex write_mutex;
+        std::vector<Frame> frames;
+    };
+
+}
+
+#endif
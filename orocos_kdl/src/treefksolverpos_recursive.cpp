@@ -22,6 +22,7 @@
 
 #include "treefksolverpos_recursive.hpp"
 #include <iostream>
+#include "tracing.hpp"
 
 namespace KDL {
 
@@ -32,6 +33,7 @@ namespace KDL {
 
     int TreeFkSolverPos_recursive::JntToCart(const JntArray& q_in, Frame& p_out, std::string segmentName)
     {      
+		KDL_TRACE_SPAN("TreeFkSolverPos_recursive::JntToCart");
 		SegmentMap::const_iterator it = tree.getSegment(segmentName); 
        
         
@@ -49,7 +51,7 @@ namespace KDL {
 	{
 		//gets the frame for the current element (segment)
         const TreeElementType& currentElement = it->second;
-        Frame currentFrame = GetTreeElementSegment(currentElement).pose(q_in(GetTreeElementQNr(currentElement)));
+        Frame currentFrame = GetTreeElementSegment(currentElement).pose(q_in,GetTreeElementQNr(currentElement));
 
 		SegmentMap::const_iterator rootIterator = tree.getRootSegment();
 		if(it == rootIterator){
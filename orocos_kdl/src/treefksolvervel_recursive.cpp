@@ -0,0 +1,111 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treefksolvervel_recursive.hpp"
+
+namespace KDL {
+
+    TreeFkSolverVel_recursive::TreeFkSolverVel_recursive(const Tree& _tree):
+        tree(_tree)
+    {
+        tree.getDepthFirstSegments(elements, parents);
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            names.push_back(elements[i]->first);
+            indices[elements[i]->first] = i;
+        }
+        //constructed in place, the implicit copy of FrameVel is deprecated
+        frames = std::vector<FrameVel>(elements.size());
+        needed.resize(elements.size());
+    }
+
+    int TreeFkSolverVel_recursive::getSegmentIndex(const std::string& segmentName) const
+    {
+        std::map<std::string, unsigned int>::const_iterator index = indices.find(segmentName);
+        if (index == indices.end())
+            return -1;
+        return index->second;
+    }
+
+    void TreeFkSolverVel_recursive::computeFrame(const JntArrayVel& q_in, unsigned int i)
+    {
+        const TreeElementType& element = elements[i]->second;
+        const Segment& segment = GetTreeElementSegment(element);
+        unsigned int q_nr = GetTreeElementQNr(element);
+        FrameVel local(segment.pose(q_in.q, q_nr), segment.twist(q_in.q, q_in.qdot, q_nr));
+        if (parents[i] < 0)
+            frames[i] = local;
+        else
+            frames[i] = frames[parents[i]]*local;
+    }
+
+    int TreeFkSolverVel_recursive::JntToCart(const JntArrayVel& q_in, FrameVel& out, std::string segmentName)
+    {
+        int index = getSegmentIndex(segmentName);
+
+        if (q_in.q.rows() != tree.getNrOfJoints() || q_in.qdot.rows() != tree.getNrOfJoints())
+            return -1;
+        else if (index < 0) //if the segment name is not found
+            return -2;
+        else {
+            //walk from the segment to the root, then propagate back down
+            std::fill(needed.begin(), needed.end(), false);
+            for (int i = index; i >= 0 && !needed[i]; i = parents[i])
+                needed[i] = true;
+            for (unsigned int i = 0; i <= (unsigned int)index; i++)
+                if (needed[i])
+                    computeFrame(q_in, i);
+            out = frames[index];
+            return 0;
+        }
+    }
+
+    int TreeFkSolverVel_recursive::JntToCart(const JntArrayVel& q_in, std::vector<FrameVel>& out)
+    {
+        if (q_in.q.rows() != tree.getNrOfJoints() || q_in.qdot.rows() != tree.getNrOfJoints() || out.size() != frames.size())
+            return -1;
+        for (unsigned int i = 0; i < frames.size(); i++) {
+            computeFrame(q_in, i);
+            out[i] = frames[i];
+        }
+        return 0;
+    }
+
+    int TreeFkSolverVel_recursive::JntToCart(const JntArrayVel& q_in, const std::vector<unsigned int>& segments, std::vector<FrameVel>& out)
+    {
+        if (q_in.q.rows() != tree.getNrOfJoints() || q_in.qdot.rows() != tree.getNrOfJoints() || out.size() != segments.size())
+            return -1;
+        //mark the requested segments and their ancestors
+        std::fill(needed.begin(), needed.end(), false);
+        unsigned int last = 0;
+        for (unsigned int k = 0; k < segments.size(); k++) {
+            if (segments[k] >= frames.size())
+                return -2;
+            for (int i = segments[k]; i >= 0 && !needed[i]; i = parents[i])
+                needed[i] = true;
+            last = std::max(last, segments[k]);
+        }
+        //parents come before their children
+        for (unsigned int i = 0; i <= last && !segments.empty(); i++)
+            if (needed[i])
+                computeFrame(q_in, i);
+        for (unsigned int k = 0; k < segments.size(); k++)
+            out[k] = frames[segments[k]];
+        return 0;
+    }
+
+    TreeFkSolverVel_recursive::~TreeFkSolverVel_recursive()
+    {
+    }
+
+}
@@ -0,0 +1,99 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDLTREEFKSOLVERVEL_RECURSIVE_HPP
+#define KDLTREEFKSOLVERVEL_RECURSIVE_HPP
+
+#include "treefksolver.hpp"
+#include <map>
+#include <algorithm>
+
+namespace KDL {
+
+    /**
+     * Implementation of a recursive forward position and velocity
+     * kinematics algorithm to calculate the pose and twist of the
+     * segments of a general kinematic tree (KDL::Tree).
+     *
+     * Frames and twists are propagated from the root to the leaves, so
+     * that the results of shared parent segments are calculated only
+     * once. Besides a single segment, the solver fills a buffer with all
+     * segments, indexed as in getSegmentNames(), or with a subset of
+     * them, in which case only the requested segments and their
+     * ancestors are visited.
+     *
+     * @ingroup KinematicFamily
+     */
+    class TreeFkSolverVel_recursive : public TreeFkSolverVel
+    {
+    public:
+        TreeFkSolverVel_recursive(const Tree& tree);
+        ~TreeFkSolverVel_recursive();
+
+        virtual int JntToCart(const JntArrayVel& q_in, FrameVel& out, std::string segmentName);
+
+        /**
+         * Calculate the pose and twist of all segments, including the
+         * root segment, in one pass.
+         *
+         * @param q_in input joint coordinates (position and velocity)
+         * @param out pose and twist per segment, in the order of
+         * getSegmentNames(), size getNrOfSegments()+1 of the tree
+         *
+         * @return if < 0 something went wrong
+         */
+        int JntToCart(const JntArrayVel& q_in, std::vector<FrameVel>& out);
+
+        /**
+         * Calculate the pose and twist of a subset of the segments.
+         *
+         * @param q_in input joint coordinates (position and velocity)
+         * @param segments indices of the requested segments, see
+         * getSegmentIndex()
+         * @param out pose and twist of every requested segment, same
+         * size as segments
+         *
+         * @return if < 0 something went wrong
+         */
+        int JntToCart(const JntArrayVel& q_in, const std::vector<unsigned int>& segments, std::vector<FrameVel>& out);
+
+        /**
+         * Request the names of the segments in the order of the
+         * buffers of JntToCart, parents come before their children.
+         */
+        const std::vector<std::string>& getSegmentNames() const {return names;};
+
+        /**
+         * Request the index of a segment in the buffers of JntToCart.
+         *
+         * @return the index, -1 if the segment is not part of the tree
+         */
+        int getSegmentIndex(const std::string& segmentName) const;
+
+    private:
+        const Tree tree;
+        //segments ordered from the root to the leaves, with the index of their parent
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::vector<std::string> names;
+        std::map<std::string, unsigned int> indices;
+        std::vector<FrameVel> frames;
+        std::vector<bool> needed;
+
+        void computeFrame(const JntArrayVel& q_in, unsigned int i);
+    };
+
+}
+
+#endif
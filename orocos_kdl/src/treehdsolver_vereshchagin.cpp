@@ -0,0 +1,228 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treehdsolver_vereshchagin.hpp"
+#include "utilities/svd_eigen_HH.hpp"
+#include <cassert>
+
+namespace KDL
+{
+    TreeHdSolver_Vereshchagin::TreeHdSolver_Vereshchagin(const Tree& _tree, const Twist& root_acc, const std::vector<std::string>& _constraint_segments):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments()), nc(_constraint_segments.size()),
+        acc_root(root_acc), constraint_segments(_constraint_segments)
+    {
+        Um = Eigen::MatrixXd::Identity(nc, nc);
+        Vm = Eigen::MatrixXd::Identity(nc, nc);
+        Sm = Eigen::VectorXd::Ones(nc);
+        tmpm = Eigen::VectorXd::Ones(nc);
+        nu = Eigen::VectorXd::Zero(nc);
+        nu_sum.resize(nc);
+        updateInternalDataStructures();
+    }
+
+    void TreeHdSolver_Vereshchagin::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        tree.getDepthFirstSegments(elements, parents);
+
+        //The articulated body recursion assumes one coordinate per joint
+        unsigned int nr_of_joints = 0;
+        std::vector<bool> used(nj, false);
+        supported = true;
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            unsigned int dofs = GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs();
+            if (dofs == 0)
+                continue;
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            supported = supported && dofs == 1 && !used[q_nr];
+            used[q_nr] = true;
+            nr_of_joints++;
+        }
+        supported = supported && nr_of_joints == nj;
+
+        constraint_elements.assign(nc, -1);
+        for (unsigned int k = 0; k < nc; k++)
+            for (unsigned int i = 1; i < elements.size(); i++)
+                if (elements[i]->first == constraint_segments[k])
+                    constraint_elements[k] = i;
+
+        T.resize(elements.size());
+        v.resize(elements.size());
+        S.resize(elements.size());
+        c.resize(elements.size());
+        a.resize(elements.size());
+        IA.resize(elements.size());
+        pA.resize(elements.size());
+        U.resize(elements.size());
+        D.resize(elements.size());
+        u.resize(elements.size());
+        E.resize(elements.size());
+        M.resize(elements.size());
+        G.resize(elements.size());
+        EZ.resize(elements.size());
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            E[i].resize(6, nc);
+            M[i].resize(nc, nc);
+            G[i].resize(nc);
+            EZ[i].resize(nc);
+        }
+        total_torques = Eigen::VectorXd::Zero(nj);
+    }
+
+    TreeHdSolver_Vereshchagin::~TreeHdSolver_Vereshchagin()
+    {
+    }
+
+    int TreeHdSolver_Vereshchagin::CartToJnt(const JntArray& q, const JntArray& q_dot, JntArray& q_dotdot, const Jacobian& alfa, const JntArray& beta,
+                                             const WrenchMap& f_ext, const JntArray& ff_torques, JntArray& constraint_torques)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || q_dot.rows() != nj || q_dotdot.rows() != nj || ff_torques.rows() != nj || constraint_torques.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+        if (alfa.columns() != nc || beta.rows() != nc)
+            return (error = E_SIZE_MISMATCH);
+        if (!supported)
+            return (error = E_NOT_IMPLEMENTED);
+        for (unsigned int k = 0; k < nc; k++)
+            if (constraint_elements[k] < 0)
+                return (error = E_OUT_OF_RANGE);
+
+        //Sweep from root to leaf: frames, velocities, unit twists, the
+        //velocity product accelerations and the rigid body bias forces,
+        //in the base frame with the base origin as reference point
+        T[0] = Frame::Identity();
+        v[0] = Twist::Zero();
+        IA[0].setZero();
+        pA[0].setZero();
+        for (unsigned int i = 1; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q, j);
+            T[i] = T[parents[i]] * X;
+            v[i] = v[parents[i]];
+            c[i].setZero();
+            if (segment.getJoint().getNrOfDofs() == 1) {
+                Twist s = T[i] * X.M.Inverse(segment.unitTwist(q, j, 0));
+                v[i] += s * q_dot(j);
+                S[i] = toVector(s);
+                c[i] = toVector(v[i] * (s * q_dot(j)));
+            }
+            RigidBodyInertia I = T[i] * segment.getInertia();
+            inertiaMatrix(I, IA[i]);
+            Wrench p = v[i] * (I * v[i]);
+            WrenchMap::const_iterator f = f_ext.find(elements[i]->first);
+            if (f != f_ext.end())
+                p -= f->second.RefPoint(-T[i].p);
+            pA[i] = toVector(p);
+        }
+
+        //The unit constraint forces act on their own segment
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            E[i].setZero();
+            M[i].setZero();
+            G[i].setZero();
+        }
+        for (unsigned int k = 0; k < nc; k++) {
+            int i = constraint_elements[k];
+            Wrench alfa_k(Vector(alfa(0, k), alfa(1, k), alfa(2, k)), Vector(alfa(3, k), alfa(4, k), alfa(5, k)));
+            E[i].col(k) = toVector(alfa_k.RefPoint(-T[i].p));
+        }
+
+        //Sweep from leaf to root: articulated inertias, bias forces and
+        //acceleration energies, the children of a segment come after it
+        //so its subtree is complete when it is reached
+        for (int i = elements.size() - 1; i > 0; i--) {
+            const Joint& joint = GetTreeElementSegment(elements[i]->second).getJoint();
+            int p = parents[i];
+            if (joint.getNrOfDofs() == 0) {
+                IA[p] += IA[i];
+                pA[p] += pA[i];
+                E[p] += E[i];
+                M[p] += M[i];
+                G[p] += G[i];
+                continue;
+            }
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            U[i].noalias() = IA[i] * S[i];
+            D[i] = S[i].dot(U[i]) + joint.getInertia();
+            u[i] = ff_torques(j) - S[i].dot(pA[i]);
+            EZ[i].noalias() = E[i].transpose() * S[i];
+            //acceleration energy of the bias forces, with the unprojected
+            //unit constraint forces
+            G[p] += G[i];
+            G[p].noalias() += E[i].transpose() * (c[i] + S[i] * (u[i] / D[i]));
+            G[p].noalias() -= EZ[i] * (U[i].dot(c[i]) / D[i]);
+            M[p] += M[i];
+            M[p].noalias() -= EZ[i] * EZ[i].transpose() / D[i];
+            E[p] += E[i];
+            E[p].noalias() -= U[i] * EZ[i].transpose() / D[i];
+            IA[p] += IA[i];
+            IA[p].noalias() -= U[i] * U[i].transpose() / D[i];
+            pA[p] += pA[i];
+            pA[p].noalias() += IA[i] * c[i] + U[i] * ((u[i] - U[i].dot(c[i])) / D[i]);
+        }
+
+        //The magnitudes of the constraint forces, with a truncated SVD
+        //in case the constraints can not all be met
+        a[0] = toVector(acc_root);
+        if (nc > 0) {
+            svd_eigen_HH(M[0], Um, Sm, Vm, tmpm);
+            for (unsigned int k = 0; k < nc; k++)
+                Sm(k) = Sm(k) < 1e-14 ? 0.0 : 1.0 / Sm(k);
+            nu_sum.noalias() = beta.data - E[0].transpose() * a[0] - G[0];
+            tmpm.noalias() = Um.transpose() * nu_sum;
+            tmpm = Sm.cwiseProduct(tmpm);
+            nu.noalias() = Vm * tmpm;
+        }
+
+        //Sweep from root to leaf: joint and segment accelerations
+        for (unsigned int i = 1; i < elements.size(); i++) {
+            const Joint& joint = GetTreeElementSegment(elements[i]->second).getJoint();
+            int p = parents[i];
+            if (joint.getNrOfDofs() == 0) {
+                a[i] = a[p];
+                continue;
+            }
+            unsigned int j = GetTreeElementQNr(elements[i]->second);
+            constraint_torques(j) = -EZ[i].dot(nu);
+            total_torques(j) = u[i] - U[i].dot(a[p] + c[i]) + constraint_torques(j);
+            q_dotdot(j) = total_torques(j) / D[i];
+            a[i] = a[p] + c[i] + S[i] * q_dotdot(j);
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeHdSolver_Vereshchagin::getLinkAcceleration(const std::string& segment_name, Twist& x_dotdot)
+    {
+        for (unsigned int i = 0; i < elements.size(); i++)
+            if (elements[i]->first == segment_name) {
+                x_dotdot = toTwist(a[i]).RefPoint(T[i].p);
+                return (error = E_NOERROR);
+            }
+        return (error = E_OUT_OF_RANGE);
+    }
+
+    void TreeHdSolver_Vereshchagin::getTotalTorque(JntArray& total_tau) const
+    {
+        assert(total_tau.data.size() == total_torques.size());
+        total_tau.data = total_torques;
+    }
+
+    void TreeHdSolver_Vereshchagin::getConstraintForceMagnitude(Eigen::VectorXd& nu_) const
+    {
+        assert(nu_.size() == nu.size());
+        nu_ = nu;
+    }
+}
@@ -0,0 +1,154 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREEHDSOLVER_VERESHCHAGIN_HPP
+#define KDL_TREEHDSOLVER_VERESHCHAGIN_HPP
+
+#include "tree.hpp"
+#include "jacobian.hpp"
+#include "jntarray.hpp"
+#include "solveri.hpp"
+#include "treeidsolver.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <Eigen/StdVector>
+
+namespace KDL
+{
+    /**
+     * \brief Acceleration constrained hybrid dynamics for a KDL::Tree,
+     * with constraints on any set of segments.
+     *
+     * This is the tree extension of KDL::ChainHdSolver_Vereshchagin as
+     * described in:
+     *
+     * A. Shakhimardanov, "Composable robot motion stack: Implementing
+     * constrained hybrid dynamics using semantic models of kinematic
+     * chains", PhD thesis, KU Leuven, 2015.
+     *
+     * Every column of the constraint matrix alfa acts on one segment,
+     * which is given at construction. A segment can carry several
+     * constraints, and constraints can be imposed on intermediate
+     * segments as well as on leaves. The interfaces follow the chain
+     * solver:
+     *
+     *  - the root acceleration is given with the sign convention of the
+     *    chain solver (opposite to the RNE and FD solvers),
+     *  - the unit constraint forces in alfa and the external wrenches
+     *    are expressed in the base frame, with the tip of their segment
+     *    as reference point,
+     *  - the constraints are alfa^T * X_dotdot = beta, with X_dotdot the
+     *    acceleration of the segment as returned by getLinkAcceleration.
+     *
+     * The constraint forces of the subtrees are gathered in the sweep
+     * from leaf to root, where the acceleration energies of the
+     * children of a segment add up. The solver is linear in the number
+     * of segments (and quadratic in the number of constraints). All
+     * quantities are expressed in the base frame, every segment has a
+     * preallocated workspace.
+     *
+     * Only trees of single DOF joints without coupled joints are
+     * supported.
+     *
+     * @ingroup KinematicFamily
+     */
+    class TreeHdSolver_Vereshchagin : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver, it will allocate all the necessary memory
+         * \param tree The tree, an internal reference will be stored.
+         * \param root_acc The acceleration twist of the root segment (usually contains gravity).
+         * \param constraint_segments The segment on which every constraint (column of alfa) acts.
+         */
+        TreeHdSolver_Vereshchagin(const Tree& tree, const Twist& root_acc, const std::vector<std::string>& constraint_segments);
+        virtual ~TreeHdSolver_Vereshchagin();
+
+        /**
+         * Calculate the joint space constraint torques and accelerations.
+         *
+         * \param q The current joint positions
+         * \param q_dot The current joint velocities
+         * \param q_dotdot The resulting joint accelerations
+         * \param alfa The unit constraint forces, one column per constraint
+         * \param beta The acceleration energy setpoints
+         * \param f_ext The external wrenches (no gravity) on the segments
+         * \param ff_torques The feed-forward joint torques
+         * \param constraint_torques The resulting joint torques due to the constraints
+         *
+         * @return error/success code, E_OUT_OF_RANGE for an unknown
+         * constraint segment and E_NOT_IMPLEMENTED for multi-DOF or
+         * coupled joints
+         */
+        int CartToJnt(const JntArray& q, const JntArray& q_dot, JntArray& q_dotdot, const Jacobian& alfa, const JntArray& beta,
+                      const WrenchMap& f_ext, const JntArray& ff_torques, JntArray& constraint_torques);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+        /**
+         * Request the acceleration of a segment of the last call to
+         * CartToJnt, in the base frame with the tip of the segment as
+         * reference point.
+         *
+         * @return E_OUT_OF_RANGE for an unknown segment
+         */
+        int getLinkAcceleration(const std::string& segment_name, Twist& x_dotdot);
+        /// Returns the total torque acting on every joint (constraints + nature + external forces)
+        void getTotalTorque(JntArray& total_tau) const;
+        /// Returns the magnitudes of the constraint forces (Lagrange multipliers)
+        void getConstraintForceMagnitude(Eigen::VectorXd& nu_) const;
+
+    private:
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        unsigned int nc;
+        bool supported;
+        Twist acc_root;
+        std::vector<std::string> constraint_segments;
+        //element on which every constraint acts, -1 if unknown
+        std::vector<int> constraint_elements;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::vector<Frame> T;
+        std::vector<Twist> v;
+        //per segment: unit twist, velocity product acceleration,
+        //acceleration, articulated inertia and bias force, and their
+        //projections on the joint
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > c;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > a;
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > IA;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > pA;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > U;
+        std::vector<double> D;
+        std::vector<double> u;
+        //per segment: unit constraint forces, acceleration energy due to
+        //the unit constraint forces and due to the bias forces of the
+        //subtree, and the projection of the constraint forces on the joint
+        std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic> > E;
+        std::vector<Eigen::MatrixXd> M;
+        std::vector<Eigen::VectorXd> G;
+        std::vector<Eigen::VectorXd> EZ;
+        Eigen::MatrixXd Um;
+        Eigen::MatrixXd Vm;
+        Eigen::VectorXd Sm;
+        Eigen::VectorXd tmpm;
+        Eigen::VectorXd nu;
+        Eigen::VectorXd nu_sum;
+        Eigen::VectorXd total_torques;
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treeidsolver_gravity.hpp"
+
+namespace KDL
+{
+    TreeIdSolver_Gravity::TreeIdSolver_Gravity(const Tree& _tree, Vector _grav):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments()), grav(_grav)
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeIdSolver_Gravity::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        tree.getDepthFirstSegments(elements, parents);
+        M.assign(elements.size(), 0.0);
+        mc.resize(elements.size());
+        S.resize(elements.size());
+        X.resize(elements.size());
+        g.resize(elements.size());
+        h.resize(elements.size());
+        JntArray q(nj);
+        //children come after their parents
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            const RigidBodyInertia& I = segment.getInertia();
+            M[i] += I.getMass();
+            if (parents[i] >= 0)
+                M[parents[i]] += M[i];
+            mc[i] = I.getMass() * I.getCOG();
+            //a joint does not move its own axis, so the unit twist of a
+            //single DOF joint is the same in the tip frame for all q
+            if (segment.getJoint().getNrOfDofs() == 1) {
+                unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+                S[i] = segment.pose(q, q_nr).M.Inverse(segment.unitTwist(q, q_nr, 0));
+            }
+        }
+    }
+
+    TreeIdSolver_Gravity::~TreeIdSolver_Gravity()
+    {
+    }
+
+    int TreeIdSolver_Gravity::JntToGravity(const JntArray& q, JntArray& gravity)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || gravity.rows() != nj)
+            return (error = E_SIZE_MISMATCH);
+
+        //Sweep from root to leaf: gravity in the segment frames
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            X[i] = GetTreeElementSegment(elements[i]->second).pose(q, GetTreeElementQNr(elements[i]->second));
+            g[i] = X[i].M.Inverse(parents[i] < 0 ? grav : g[parents[i]]);
+            h[i] = mc[i];
+        }
+
+        //Sweep from leaf to root: first moment of the subtree, the
+        //wrench that holds it and its projection on the joint
+        SetToZero(gravity);
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            Wrench W(-M[i] * g[i], g[i] * h[i]);
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            if (segment.getJoint().getNrOfDofs() == 1)
+                gravity(q_nr) += dot(S[i], W);
+            else {
+                for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++)
+                    gravity(q_nr + d) += dot(X[i].M.Inverse(segment.unitTwist(q, q_nr, d)), W);
+            }
+            if (parents[i] >= 0)
+                h[parents[i]] += X[i].M * h[i] + M[i] * X[i].p;
+        }
+        return (error = E_NOERROR);
+    }
+}
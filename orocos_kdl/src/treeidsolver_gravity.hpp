@@ -0,0 +1,81 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREE_IDSOLVER_GRAVITY_HPP
+#define KDL_TREE_IDSOLVER_GRAVITY_HPP
+
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "solveri.hpp"
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the joint torques that compensate gravity in a
+     * KDL::Tree.
+     *
+     * This is the tree version of KDL::ChainIdSolver_Gravity: the
+     * masses of the subtrees, the first moments of the segments and
+     * the unit twists of the single DOF joints are calculated at
+     * construction, and the segments are visited in depth-first order
+     * from preallocated arrays. The result equals
+     * TreeIdSolver_RNE::CartToJnt with zero velocities and
+     * accelerations.
+     */
+    class TreeIdSolver_Gravity : public SolverI
+    {
+    public:
+        /**
+         * Constructor for the solver
+         * \param tree The kinematic tree, an internal reference will be stored.
+         * \param grav The gravity vector to use during the calculation.
+         */
+        TreeIdSolver_Gravity(const Tree& tree, Vector grav);
+        virtual ~TreeIdSolver_Gravity();
+
+        /**
+         * Calculate the joint torques that compensate gravity.
+         *
+         * @param q input joint positions
+         * @param gravity output joint torques
+         * @return success/error code
+         */
+        int JntToGravity(const JntArray& q, JntArray& gravity);
+
+        void setGravity(const Vector& _grav) {grav = _grav;};
+        const Vector& getGravity() const {return grav;};
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        Vector grav;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        //mass of the subtree of every segment
+        std::vector<double> M;
+        //first mass moment of every segment in its own frame
+        std::vector<Vector> mc;
+        //unit twist of single DOF joints in the tip frame
+        std::vector<Twist> S;
+        std::vector<Frame> X;
+        std::vector<Vector> g;
+        std::vector<Vector> h;
+    };
+}
+
+#endif
@@ -22,6 +22,7 @@
 #include "treeidsolver_recursive_newton_euler.hpp"
 #include "frames_io.hpp"
 #include <stdexcept>
+#include "tracing.hpp"
 
 namespace KDL{
 
@@ -51,6 +52,7 @@ namespace KDL{
 
     int TreeIdSolver_RNE::CartToJnt(const JntArray &q, const JntArray &q_dot, const JntArray &q_dotdot, const WrenchMap& f_ext, JntArray &torques)
     {
+      KDL_TRACE_SPAN("TreeIdSolver_RNE::CartToJnt");
       //Check that the tree was not modified externally
       if(nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
         return (error = E_NOT_UP_TO_DATE);
@@ -59,6 +61,9 @@ namespace KDL{
       if(q.rows()!=nj || q_dot.rows()!=nj || q_dotdot.rows()!=nj || torques.rows()!=nj)
         return (error = E_SIZE_MISMATCH);
 
+      //Coupled joints add their effort to the one of their coordinate
+      SetToZero(torques);
+
       try {
         //Do the recursion here
         rne_step(tree.getRootSegment(), q, q_dot, q_dotdot, f_ext, torques);
@@ -81,33 +86,36 @@ namespace KDL{
       const std::string& parname = GetTreeElementParent(segment->second)->first;
 
       //Do forward calculations involving velocity & acceleration of this segment
-      double q_, qdot_, qdotdot_;
       unsigned int j = GetTreeElementQNr(segment->second);
-      if(seg.getJoint().getType()!=Joint::Fixed) {
-        q_ = q(j);
-        qdot_ = q_dot(j);
-        qdotdot_ = q_dotdot(j);
-      }
-      else
-        q_ = qdot_ = qdotdot_ = 0.0;
 
       //Calculate segment properties: X,S,vj,cj
 
       //Remark this is the inverse of the frame for transformations from the parent to the current coord frame
-      X.at(segname) = seg.pose(q_);
+      X.at(segname) = seg.pose(q,j);
 
       //Transform velocity and unit velocity to segment frame
-      Twist vj = X.at(segname).M.Inverse( seg.twist(q_,qdot_) );
-      S.at(segname) = X.at(segname).M.Inverse( seg.twist(q_,1.0) );
+      const Rotation& M = X.at(segname).M;
+      Twist vj, aj;
+      if(seg.getJoint().getNrOfDofs()==1) {
+        //cj=0 for single axis joints, their unit velocity S is time constant
+        S.at(segname) = M.Inverse( seg.unitTwist(q,j,0,M) );
+        vj = S.at(segname)*q_dot(j);
+        aj = S.at(segname)*q_dotdot(j);
+      }
+      else {
+        //joint acceleration, including the velocity-product term cj of multi-DOF joints
+        vj = M.Inverse( seg.twist(q,q_dot,j,M) );
+        aj = M.Inverse( seg.twist(q,q_dotdot,j,M) + seg.biasTwist(q,q_dot,j,M) );
+      }
 
       //calculate velocity and acceleration of the segment (in segment coordinates)
       if(segment == tree.getRootSegment()) {
         v.at(segname) = vj;
-        a.at(segname) = X.at(segname).Inverse(ag) + S.at(segname)*qdotdot_+ v.at(segname)*vj;
+        a.at(segname) = X.at(segname).Inverse(ag) + aj + v.at(segname)*vj;
       }
       else {
         v.at(segname) = X.at(segname).Inverse(v.at(parname)) + vj;
-        a.at(segname) = X.at(segname).Inverse(a.at(parname)) + S.at(segname)*qdotdot_ + v.at(segname)*vj;
+        a.at(segname) = X.at(segname).Inverse(a.at(parname)) + aj + v.at(segname)*vj;
       }
 
       //Calculate the force for the joint
@@ -127,10 +135,15 @@ namespace KDL{
       //do backward calculations involving wrenches and joint efforts
 
       //If there is a moving joint, evaluate its effort
-      if(seg.getJoint().getType()!=Joint::Fixed) {
-        torques(j) = dot(S.at(segname), f.at(segname));
+      if(seg.getJoint().getNrOfDofs()==1) {
+        torques(j) += dot(S.at(segname), f.at(segname));
         torques(j) += seg.getJoint().getInertia()*q_dotdot(j);  // add torque from joint inertia
       }
+      else {
+        //one generalized force per DOF of a multi-DOF joint
+        for(unsigned int d=0; d<seg.getJoint().getNrOfDofs(); d++)
+          torques(j+d) = dot(X.at(segname).M.Inverse( seg.unitTwist(q,j,d,X.at(segname).M) ), f.at(segname));
+      }
 
       //add reaction forces to parent segment
       if(segment != tree.getRootSegment())
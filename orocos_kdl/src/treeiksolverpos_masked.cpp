@@ -0,0 +1,88 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treeiksolverpos_masked.hpp"
+#include <algorithm>
+
+namespace KDL {
+    TreeIkSolverPos_Masked::TreeIkSolverPos_Masked(const Tree& _tree, const std::vector<std::string>& _endpoints,
+                                                   const std::vector<TaskMask>& _masks,
+                                                   unsigned int _maxiter, double _eps, double _eps_svd) :
+        tree(_tree), endpoints(_endpoints), masks(_masks),
+        fksolver(tree), jacsolver(tree),
+        jac(tree.getNrOfJoints()), delta_q(tree.getNrOfJoints()),
+        maxiter(_maxiter), eps(_eps), eps_svd(_eps_svd)
+    {
+    }
+
+    double TreeIkSolverPos_Masked::CartToJnt(const JntArray& q_init, const Frames& p_in, JntArray& q_out) {
+        unsigned int nj = tree.getNrOfJoints();
+        if (q_init.rows() != nj || q_out.rows() != nj || masks.size() != endpoints.size())
+            return -1;
+
+        //First check if all elements in p_in are available, and count the rows of their tasks
+        std::vector<unsigned int> targets;
+        unsigned int rows = 0;
+        for (Frames::const_iterator f_des_it = p_in.begin(); f_des_it != p_in.end(); ++f_des_it) {
+            std::vector<std::string>::const_iterator it = std::find(endpoints.begin(), endpoints.end(), f_des_it->first);
+            if (it == endpoints.end())
+                return -2;
+            targets.push_back(it - endpoints.begin());
+            rows += masks[targets.back()].getNrOfRows();
+        }
+        if (J.rows() != (int)rows || J.cols() != (int)nj) {
+            J.resize(rows, nj);
+            e.resize(rows);
+            tmp.resize(std::min(rows, nj));
+            svd = Eigen::JacobiSVD<Eigen::MatrixXd>(rows, nj, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        }
+
+        q_out = q_init;
+        for (unsigned int k = 0; k < maxiter; k++) {
+            unsigned int row = 0;
+            Frames::const_iterator f_des_it = p_in.begin();
+            for (unsigned int t = 0; t < targets.size(); t++, ++f_des_it) {
+                const TaskMask& mask = masks[targets[t]];
+                fksolver.JntToCart(q_out, f, f_des_it->first);
+                mask.selectError(f, f_des_it->second, e, row);
+                row += mask.getNrOfRows();
+            }
+            double res = rows == 0 ? 0.0 : e.cwiseAbs().maxCoeff();
+            if (res < eps)
+                return res;
+
+            row = 0;
+            f_des_it = p_in.begin();
+            for (unsigned int t = 0; t < targets.size(); t++, ++f_des_it) {
+                const TaskMask& mask = masks[targets[t]];
+                jacsolver.JntToJac(q_out, jac, f_des_it->first);
+                mask.selectJacobian(f_des_it->second, jac, J, row);
+                row += mask.getNrOfRows();
+            }
+
+            //delta_q = V*S^-1*U'*e, with the small singular values truncated
+            svd.compute(J);
+            tmp.noalias() = svd.matrixU().transpose() * e;
+            for (int i = 0; i < tmp.size(); i++)
+                tmp(i) = svd.singularValues()(i) > eps_svd ? tmp(i) / svd.singularValues()(i) : 0.0;
+            delta_q.data.noalias() = svd.matrixV() * tmp;
+            Add(q_out, delta_q, q_out);
+        }
+        return -3;
+    }
+
+    TreeIkSolverPos_Masked::~TreeIkSolverPos_Masked() {
+    }
+
+}//namespace
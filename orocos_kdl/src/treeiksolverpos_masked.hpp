@@ -0,0 +1,88 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDLTREEIKSOLVERPOS_MASKED_HPP
+#define KDLTREEIKSOLVERPOS_MASKED_HPP
+
+#include "treeiksolver.hpp"
+#include "treefksolverpos_recursive.hpp"
+#include "treejnttojacsolver.hpp"
+#include "taskmask.hpp"
+#include <Eigen/Dense>
+#include <vector>
+#include <string>
+
+namespace KDL {
+
+/**
+ * Implementation of an inverse position kinematics algorithm based on
+ * Newton-Raphson iterations for a KDL::Tree whose endpoints have tasks
+ * with less than six coordinates (see KDL::TaskMask).
+ *
+ * This is the tree version of KDL::ChainIkSolverPos_Masked: the
+ * selected coordinates of all endpoints are stacked and solved with a
+ * truncated SVD of the reduced Jacobian.
+ *
+ * @ingroup KinematicFamily
+ */
+class TreeIkSolverPos_Masked: public TreeIkSolverPos {
+public:
+    /**
+     * Constructor of the solver.
+     *
+     * @param tree the tree to calculate the inverse position for
+     * @param endpoints the list of endpoints you are interested in
+     * @param masks the coordinates of the task of every endpoint
+     * @param maxiter the maximum Newton-Raphson iterations,
+     * default: 100
+     * @param eps the precision for the selected coordinates of the
+     * pose errors, used to end the iterations, default: 1e-6
+     * @param eps_svd singular values below this value are truncated,
+     * default: 1e-9
+     */
+    TreeIkSolverPos_Masked(const Tree& tree, const std::vector<std::string>& endpoints, const std::vector<TaskMask>& masks,
+                           unsigned int maxiter=100, double eps=1e-6, double eps_svd=1e-9);
+    ~TreeIkSolverPos_Masked();
+
+    /**
+     * Calculate the joint positions for the given poses of (some of)
+     * the endpoints.
+     *
+     * @return the largest remaining selected error when converged, -1
+     * on a size mismatch, -2 for an unknown endpoint and -3 when the
+     * maximum number of iterations is exceeded
+     */
+    virtual double CartToJnt(const JntArray& q_init, const Frames& p_in, JntArray& q_out);
+
+private:
+    const Tree tree;
+    std::vector<std::string> endpoints;
+    std::vector<TaskMask> masks;
+    TreeFkSolverPos_recursive fksolver;
+    TreeJntToJacSolver jacsolver;
+    Frame f;
+    Jacobian jac;
+    Eigen::MatrixXd J;
+    Eigen::VectorXd e;
+    Eigen::VectorXd tmp;
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd;
+    JntArray delta_q;
+    unsigned int maxiter;
+    double eps;
+    double eps_svd;
+};
+
+}
+
+#endif
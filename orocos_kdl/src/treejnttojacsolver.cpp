@@ -8,6 +8,7 @@
 #include "treejnttojacsolver.hpp"
 #include <iostream>
 #include "kinfam_io.hpp"
+#include "tracing.hpp"
 
 namespace KDL {
 
@@ -19,6 +20,7 @@ TreeJntToJacSolver::~TreeJntToJacSolver() {
 }
 
 int TreeJntToJacSolver::JntToJac(const JntArray& q_in, Jacobian& jac, const std::string& segmentname) {
+    KDL_TRACE_SPAN("TreeJntToJacSolver::JntToJac");
     //First we check all the sizes:
     if (q_in.rows() != tree.getNrOfJoints() || jac.columns() != tree.getNrOfJoints())
         return -1;
@@ -42,20 +44,21 @@ int TreeJntToJacSolver::JntToJac(const JntArray& q_in, Jacobian& jac, const std:
         unsigned int q_nr = GetTreeElementQNr(it->second);
         
         //get the pose of the segment:
-        Frame T_local = GetTreeElementSegment(it->second).pose(q_in(q_nr));
+        const Segment& segment = GetTreeElementSegment(it->second);
+        Frame T_local = segment.pose(q_in, q_nr);
         //calculate new T_end:
         T_total = T_local * T_total;
         
-        //get the twist of the segment:
-        if (GetTreeElementSegment(it->second).getJoint().getType() != Joint::Fixed) {
-            Twist t_local = GetTreeElementSegment(it->second).twist(q_in(q_nr), 1.0);
+        //get the twist of the segment, one per DOF of its joint:
+        for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++) {
+            Twist t_local = segment.unitTwist(q_in, q_nr, d, T_local.M);
             //transform the endpoint of the local twist to the global endpoint:
             t_local = t_local.RefPoint(T_total.p - T_local.p);
             //transform the base of the twist to the endpoint
             t_local = T_total.M.Inverse(t_local);
-            //store the twist in the jacobian:
-            jac.setColumn(q_nr,t_local);
-        }//endif
+            //store the twist in the jacobian, coupled joints add to the column of their coordinate:
+            jac.setColumn(q_nr + d, jac.getColumn(q_nr + d) + t_local);
+        }
         //goto the parent
         it = GetTreeElementParent(it->second);
     }//endwhile
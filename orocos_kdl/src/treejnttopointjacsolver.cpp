@@ -0,0 +1,123 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treejnttopointjacsolver.hpp"
+
+namespace KDL
+{
+    TreeJntToPointJacSolver::TreeJntToPointJacSolver(const Tree& _tree):
+        tree(_tree)
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeJntToPointJacSolver::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        indices.clear();
+        tree.getDepthFirstSegments(elements, parents);
+        T.resize(elements.size());
+        offsets.resize(elements.size()+1);
+        offsets[0] = 0;
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            indices[elements[i]->first] = i;
+            offsets[i+1] = offsets[i] + GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs();
+        }
+        S.resize(offsets[elements.size()]);
+    }
+
+    TreeJntToPointJacSolver::~TreeJntToPointJacSolver()
+    {
+    }
+
+    int TreeJntToPointJacSolver::getSegmentIndex(const std::string& segmentName) const
+    {
+        std::map<std::string, unsigned int>::const_iterator index = indices.find(segmentName);
+        if (index == indices.end())
+            return -1;
+        return index->second;
+    }
+
+    int TreeJntToPointJacSolver::sweep(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q_in.rows() != nj || segments.size() != points.size())
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int k = 0; k < segments.size(); k++)
+            if (segments[k] >= elements.size())
+                return (error = E_OUT_OF_RANGE);
+        //parents come before their children
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q_in, q_nr);
+            T[i] = parents[i] < 0 ? X : T[parents[i]] * X;
+            for (unsigned int d = 0; d < segment.getJoint().getNrOfDofs(); d++)
+                S[offsets[i]+d] = T[i] * X.M.Inverse(segment.unitTwist(q_in, q_nr, d));
+        }
+        p.resize(points.size());
+        for (unsigned int k = 0; k < points.size(); k++)
+            p[k] = T[segments[k]] * points[k];
+        return (error = E_NOERROR);
+    }
+
+    int TreeJntToPointJacSolver::JntToJac(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points, std::vector<Jacobian>& jacs)
+    {
+        if (jacs.size() != points.size())
+            return (error = E_SIZE_MISMATCH);
+        for (unsigned int k = 0; k < jacs.size(); k++)
+            if (jacs[k].columns() != tree.getNrOfJoints())
+                return (error = E_SIZE_MISMATCH);
+        if (sweep(q_in, segments, points))
+            return error;
+        for (unsigned int k = 0; k < jacs.size(); k++) {
+            SetToZero(jacs[k]);
+            for (int i = segments[k]; i >= 0; i = parents[i]) {
+                unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+                //coupled joints add to the column of their coordinate
+                for (unsigned int d = offsets[i]; d < offsets[i+1]; d++)
+                    jacs[k].setColumn(q_nr + d - offsets[i], jacs[k].getColumn(q_nr + d - offsets[i]) + S[d].RefPoint(p[k]));
+            }
+        }
+        return (error = E_NOERROR);
+    }
+
+    int TreeJntToPointJacSolver::JntToJac(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points, Eigen::MatrixXd& jac)
+    {
+        unsigned int rows;
+        if (jac.rows() == (int)(6*points.size()))
+            rows = 6;
+        else if (jac.rows() == (int)(3*points.size()))
+            rows = 3;
+        else
+            return (error = E_SIZE_MISMATCH);
+        if (jac.cols() != (int)tree.getNrOfJoints())
+            return (error = E_SIZE_MISMATCH);
+        if (sweep(q_in, segments, points))
+            return error;
+        jac.setZero();
+        for (unsigned int k = 0; k < points.size(); k++) {
+            for (int i = segments[k]; i >= 0; i = parents[i]) {
+                unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+                for (unsigned int d = offsets[i]; d < offsets[i+1]; d++) {
+                    Twist t = S[d].RefPoint(p[k]);
+                    for (unsigned int r = 0; r < rows; r++)
+                        jac(rows*k + r, q_nr + d - offsets[i]) += t(r);
+                }
+            }
+        }
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,98 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREEJNTTOPOINTJACSOLVER_HPP
+#define KDL_TREEJNTTOPOINTJACSOLVER_HPP
+
+#include "solveri.hpp"
+#include "frames.hpp"
+#include "jacobian.hpp"
+#include "jntarray.hpp"
+#include "tree.hpp"
+#include <map>
+
+namespace KDL
+{
+    /**
+     * @brief Class to calculate the jacobians of a set of points fixed
+     * to the segments of a KDL::Tree, e.g. contact points.
+     *
+     * This is the tree version of KDL::ChainJntToPointJacSolver. The
+     * frames and the joint twists of all segments are calculated in a
+     * single sweep from the root to the leaves, after which the columns
+     * of every point are filled by walking from its segment to the
+     * root. Segments are referred to by their index, see
+     * getSegmentIndex().
+     */
+    class TreeJntToPointJacSolver : public SolverI
+    {
+    public:
+
+        explicit TreeJntToPointJacSolver(const Tree& tree);
+        virtual ~TreeJntToPointJacSolver();
+
+        /**
+         * Calculate the jacobians of a set of points, expressed in the
+         * frame of the root segment with reference point at the point.
+         *
+         * @param q_in input joint positions
+         * @param segments per point the index of the segment it is fixed to
+         * @param points per point its position in the tip frame of that segment
+         * @param jacs output jacobian per point
+         * @return success/error code
+         */
+        int JntToJac(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points, std::vector<Jacobian>& jacs);
+
+        /**
+         * Calculate the jacobians of a set of points stacked in one
+         * matrix, with 6 rows (velocity and rotational velocity) per
+         * point, or only the 3 velocity rows per point.
+         *
+         * @param q_in input joint positions
+         * @param segments per point the index of the segment it is fixed to
+         * @param points per point its position in the tip frame of that segment
+         * @param jac output matrix of 6 or 3 times the number of points rows
+         * @return success/error code
+         */
+        int JntToJac(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points, Eigen::MatrixXd& jac);
+
+        /**
+         * Request the index of a segment.
+         *
+         * @return the index, -1 if the segment is not part of the tree
+         */
+        int getSegmentIndex(const std::string& segmentName) const;
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        ///Helper function to calculate the frames, the joint twists and the points in the base frame
+        int sweep(const JntArray& q_in, const std::vector<unsigned int>& segments, const std::vector<Vector>& points);
+
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        std::map<std::string, unsigned int> indices;
+        std::vector<Frame> T;
+        //unit twists of all DOFs in the base frame with reference point
+        //in the base origin, those of segment i start at offsets[i]
+        std::vector<Twist> S;
+        std::vector<unsigned int> offsets;
+        std::vector<Vector> p;
+    };
+}
+#endif
@@ -0,0 +1,139 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "treemassinversesolver.hpp"
+#include <algorithm>
+
+namespace KDL
+{
+    TreeMassInverseSolver::TreeMassInverseSolver(const Tree& _tree):
+        tree(_tree), nj(tree.getNrOfJoints()), ns(tree.getNrOfSegments())
+    {
+        updateInternalDataStructures();
+    }
+
+    void TreeMassInverseSolver::updateInternalDataStructures() {
+        nj = tree.getNrOfJoints();
+        ns = tree.getNrOfSegments();
+        joints.clear();
+        begins.clear();
+        ends.clear();
+        q_nrs.clear();
+        tree.getDepthFirstSegments(elements, parents);
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            begins.push_back(q_nrs.size());
+            if (GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs() == 0)
+                joints.push_back(-1);
+            else {
+                joints.push_back(q_nrs.size());
+                q_nrs.push_back(GetTreeElementQNr(elements[i]->second));
+            }
+        }
+        //the DOFs of a subtree are contiguous and end with those of its last segment
+        ends.resize(elements.size());
+        for (unsigned int i = 0; i < elements.size(); i++)
+            ends[i] = joints[i] < 0 ? begins[i] : begins[i]+1;
+        for (unsigned int i = elements.size()-1; i > 0; i--)
+            ends[parents[i]] = std::max(ends[parents[i]], ends[i]);
+        //every joint has to be the only one that moves its DOF
+        supported = q_nrs.size() == nj;
+        std::vector<bool> used(nj, false);
+        for (unsigned int i = 0; supported && i < elements.size(); i++) {
+            int a = joints[i];
+            if (a < 0)
+                continue;
+            supported = GetTreeElementSegment(elements[i]->second).getJoint().getNrOfDofs() == 1 && !used[q_nrs[a]];
+            used[q_nrs[a]] = true;
+        }
+        T.resize(elements.size());
+        IA.resize(elements.size());
+        S.resize(q_nrs.size());
+        U.resize(q_nrs.size());
+        D.resize(q_nrs.size());
+        F.resize(elements.size());
+        for (unsigned int i = 0; i < elements.size(); i++)
+            F[i].resize(6, q_nrs.size());
+        M.resize(q_nrs.size(), q_nrs.size());
+    }
+
+    TreeMassInverseSolver::~TreeMassInverseSolver()
+    {
+    }
+
+    int TreeMassInverseSolver::JntToMassInverse(const JntArray& q, JntSpaceInertiaMatrix& H_inv)
+    {
+        if (nj != tree.getNrOfJoints() || ns != tree.getNrOfSegments())
+            return (error = E_NOT_UP_TO_DATE);
+        if (q.rows() != nj || H_inv.rows() != nj || H_inv.columns() != nj)
+            return (error = E_SIZE_MISMATCH);
+        if (!supported)
+            return (error = E_NOT_IMPLEMENTED);
+
+        //Sweep from root to leaf: inertias and unit twists in the base frame
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            const Segment& segment = GetTreeElementSegment(elements[i]->second);
+            unsigned int q_nr = GetTreeElementQNr(elements[i]->second);
+            Frame X = segment.pose(q, q_nr);
+            T[i] = parents[i] < 0 ? X : T[parents[i]] * X;
+            if (joints[i] >= 0)
+                S[joints[i]] = toVector(T[i] * X.M.Inverse(segment.unitTwist(q, q_nr, 0)));
+            inertiaMatrix(T[i] * segment.getInertia(), IA[i]);
+            F[i].setZero();
+        }
+
+        //Sweep from leaf to root: the articulated inertias and the rows
+        //of the inverse for the joints in the subtree, the children of a
+        //segment come after it so its subtree is complete when reached
+        M.setZero();
+        for (int i = elements.size() - 1; i >= 0; i--) {
+            int a = joints[i];
+            if (a >= 0) {
+                unsigned int n = ends[i] - begins[i];
+                U[a].noalias() = IA[i] * S[a];
+                D[a] = S[a].dot(U[a]) + GetTreeElementSegment(elements[i]->second).getJoint().getInertia();
+                M(a, a) = 1.0 / D[a];
+                M.row(a).segment(a + 1, n - 1).noalias() = -S[a].transpose() * F[i].middleCols(a + 1, n - 1) / D[a];
+                F[i].middleCols(a, n).noalias() += U[a] * M.row(a).segment(a, n);
+                IA[i].noalias() -= U[a] * U[a].transpose() / D[a];
+            }
+            if (parents[i] >= 0) {
+                IA[parents[i]] += IA[i];
+                unsigned int n = ends[i] - begins[i];
+                F[parents[i]].middleCols(begins[i], n) += F[i].middleCols(begins[i], n);
+            }
+        }
+
+        //Sweep from root to leaf: correct the rows for the acceleration
+        //of the ancestors, F now holds the accelerations
+        for (unsigned int i = 0; i < elements.size(); i++) {
+            int a = joints[i];
+            if (parents[i] < 0)
+                F[i].setZero();
+            else
+                F[i] = F[parents[i]];
+            if (a >= 0) {
+                unsigned int n = q_nrs.size() - a;
+                M.row(a).tail(n).noalias() -= U[a].transpose() * F[i].rightCols(n) / D[a];
+                F[i].rightCols(n).noalias() += S[a] * M.row(a).tail(n);
+            }
+        }
+
+        //Only the upper triangle is calculated, the joints are numbered
+        //in depth-first order
+        for (unsigned int a = 0; a < q_nrs.size(); a++)
+            for (unsigned int b = a; b < q_nrs.size(); b++)
+                H_inv(q_nrs[a], q_nrs[b]) = H_inv(q_nrs[b], q_nrs[a]) = M(a, b);
+        return (error = E_NOERROR);
+    }
+}
@@ -0,0 +1,83 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_TREEMASSINVERSESOLVER_HPP
+#define KDL_TREEMASSINVERSESOLVER_HPP
+
+#include "tree.hpp"
+#include "jntarray.hpp"
+#include "jntspaceinertiamatrix.hpp"
+#include "solveri.hpp"
+#include "utilities/spatial_eigen.hpp"
+#include <Eigen/StdVector>
+
+namespace KDL
+{
+    /**
+     * \brief Solver for the inverse of the joint space inertia matrix of
+     * a KDL::Tree.
+     *
+     * This is the tree version of KDL::ChainMassInverseSolver. The
+     * joints are numbered in depth-first order internally, so that the
+     * joints of every subtree form a contiguous range and the forces of
+     * the unit torques only have to be propagated over that range.
+     *
+     * Only trees of single DOF joints without coupled joints are
+     * supported.
+     */
+    class TreeMassInverseSolver : public SolverI
+    {
+    public:
+        explicit TreeMassInverseSolver(const Tree& tree);
+        virtual ~TreeMassInverseSolver();
+
+        /**
+         * Calculate the inverse of the joint space inertia matrix.
+         *
+         * @param q input joint positions
+         * @param H_inv output inverse of the mass matrix
+         * @return success/error code, E_NOT_IMPLEMENTED for multi-DOF
+         * or coupled joints
+         */
+        int JntToMassInverse(const JntArray& q, JntSpaceInertiaMatrix& H_inv);
+
+        /// @copydoc KDL::SolverI::updateInternalDataStructures
+        virtual void updateInternalDataStructures();
+
+    private:
+        const Tree& tree;
+        unsigned int nj;
+        unsigned int ns;
+        bool supported;
+        std::vector<SegmentMap::const_iterator> elements;
+        std::vector<int> parents;
+        //depth-first number of the joint of every segment (-1 for fixed
+        //joints), and the range of numbers in its subtree
+        std::vector<int> joints;
+        std::vector<unsigned int> begins;
+        std::vector<unsigned int> ends;
+        std::vector<unsigned int> q_nrs;
+        std::vector<Frame> T;
+        std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > IA;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > S;
+        std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > U;
+        std::vector<double> D;
+        //forces (leaf to root) and accelerations (root to leaf) of every
+        //segment caused by the unit torques, one column per joint
+        std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic> > F;
+        Eigen::MatrixXd M;
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "binary_io.h"
+#include "error.h"
+#include <stdint.h>
+#include <string.h>
+
+namespace KDL {
+
+namespace {
+
+    const char BINARY_MAGIC[4] = {'K', 'D', 'L', 'B'};
+
+    void writeBytes(std::ostream& os, uint64_t value, unsigned int n)
+    {
+        char bytes[8];
+        for (unsigned int i = 0; i < n; i++)
+            bytes[i] = (char)((value >> (8*i)) & 0xff);
+        os.write(bytes, n);
+    }
+
+    uint64_t readBytes(std::istream& is, unsigned int n)
+    {
+        unsigned char bytes[8];
+        if (!is.read((char*)bytes, n))
+            throw Error_BasicIO_File();
+        uint64_t value = 0;
+        for (unsigned int i = 0; i < n; i++)
+            value |= (uint64_t)bytes[i] << (8*i);
+        return value;
+    }
+
+}
+
+void WriteBinaryHeader(std::ostream& os)
+{
+    os.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    WriteBinary(os, BINARY_VERSION);
+}
+
+unsigned int ReadBinaryHeader(std::istream& is)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    if (!is.read(magic, sizeof(magic)) || memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+        throw Error_BasicIO_Binary();
+    unsigned int version;
+    ReadBinary(is, version);
+    if (version == 0 || version > BINARY_VERSION)
+        throw Error_BasicIO_Binary();
+    return version;
+}
+
+void WriteBinary(std::ostream& os, double d)
+{
+    uint64_t value;
+    memcpy(&value, &d, sizeof(d));
+    writeBytes(os, value, 8);
+}
+
+void WriteBinary(std::ostream& os, unsigned int i)
+{
+    writeBytes(os, i, 4);
+}
+
+void WriteBinary(std::ostream& os, bool b)
+{
+    writeBytes(os, b ? 1 : 0, 1);
+}
+
+void WriteBinary(std::ostream& os, const std::string& str)
+{
+    WriteBinary(os, (unsigned int)str.size());
+    os.write(str.data(), str.size());
+}
+
+void ReadBinary(std::istream& is, double& d)
+{
+    uint64_t value = readBytes(is, 8);
+    memcpy(&d, &value, sizeof(d));
+}
+
+void ReadBinary(std::istream& is, unsigned int& i)
+{
+    i = (unsigned int)readBytes(is, 4);
+}
+
+void ReadBinary(std::istream& is, bool& b)
+{
+    b = readBytes(is, 1) != 0;
+}
+
+void ReadBinary(std::istream& is, std::string& str)
+{
+    unsigned int size;
+    ReadBinary(is, size);
+    //read in pieces, a corrupt size must not allocate a huge string
+    str.clear();
+    char buffer[256];
+    while (size > 0) {
+        unsigned int n = size < sizeof(buffer) ? size : sizeof(buffer);
+        if (!is.read(buffer, n))
+            throw Error_BasicIO_File();
+        str.append(buffer, n);
+        size -= n;
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_BINARY_IO_H
+#define KDL_BINARY_IO_H
+
+#include <iostream>
+#include <string>
+
+namespace KDL {
+
+/**
+ * Version of the binary format of the motion classes, written by
+ * WriteBinaryHeader(). Increase when the encoding of an existing type
+ * changes.
+ */
+const unsigned int BINARY_VERSION = 1;
+
+/**
+ * Writes the magic number and the version that start a binary stream.
+ */
+void WriteBinaryHeader(std::ostream& os);
+
+/**
+ * Reads the start of a binary stream and returns its version.
+ * Throws Error_BasicIO_Binary if the stream does not start with the
+ * magic number or has a newer version than BINARY_VERSION.
+ */
+unsigned int ReadBinaryHeader(std::istream& is);
+
+/**
+ * Numbers are stored little endian, doubles in IEEE 754 format,
+ * strings as their length followed by their characters.
+ * Reading beyond the end of the stream throws Error_BasicIO_File.
+ */
+void WriteBinary(std::ostream& os, double d);
+void WriteBinary(std::ostream& os, unsigned int i);
+void WriteBinary(std::ostream& os, bool b);
+void WriteBinary(std::ostream& os, const std::string& str);
+void ReadBinary(std::istream& is, double& d);
+void ReadBinary(std::istream& is, unsigned int& i);
+void ReadBinary(std::istream& is, bool& b);
+void ReadBinary(std::istream& is, std::string& str);
+
+}
+
+#endif
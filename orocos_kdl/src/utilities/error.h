@@ -107,6 +107,11 @@ public:
     virtual const char* Description() const {return "File cannot be opened";}
     virtual int GetType() const {return 6;}
 };
+class Error_BasicIO_Binary : public Error_BasicIO {
+public:
+    virtual const char* Description() const {return "Not a binary stream of a supported version";}
+    virtual int GetType() const {return 7;}
+};
 class Error_FrameIO : public Error_IO {};
 class Error_Frame_Vector_Unexpected_id : public Error_FrameIO {
 public:
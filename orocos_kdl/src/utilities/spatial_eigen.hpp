@@ -0,0 +1,83 @@
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef KDL_SPATIAL_EIGEN_HPP
+#define KDL_SPATIAL_EIGEN_HPP
+
+#include "../frames.hpp"
+#include "../rigidbodyinertia.hpp"
+#include <Eigen/Core>
+
+namespace KDL
+{
+    //Conversions between the 6D types and Eigen vectors and matrices,
+    //linear (force) part first as in Twist(i) and Wrench(i)
+    typedef Eigen::Matrix<double,6,6> Matrix6d;
+    typedef Eigen::Matrix<double,6,1> Vector6d;
+
+    inline Vector6d toVector(const Twist& t)
+    {
+        Vector6d v;
+        for (unsigned int r = 0; r < 6; r++)
+            v(r) = t(r);
+        return v;
+    }
+
+    inline Vector6d toVector(const Wrench& w)
+    {
+        Vector6d v;
+        for (unsigned int r = 0; r < 6; r++)
+            v(r) = w(r);
+        return v;
+    }
+
+    inline Twist toTwist(const Vector6d& v)
+    {
+        return Twist(Vector(v(0), v(1), v(2)), Vector(v(3), v(4), v(5)));
+    }
+
+    inline Wrench toWrench(const Vector6d& v)
+    {
+        return Wrench(Vector(v(0), v(1), v(2)), Vector(v(3), v(4), v(5)));
+    }
+
+    /**
+     * The inertia of a body as a 6x6 matrix.
+     */
+    inline void inertiaMatrix(const RigidBodyInertia& I, Matrix6d& Im)
+    {
+        for (unsigned int c = 0; c < 6; c++) {
+            Twist e = Twist::Zero();
+            e(c) = 1.0;
+            Im.col(c) = toVector(I * e);
+        }
+    }
+
+    /**
+     * The inertia of a body as a 6x6 matrix, and its time derivative
+     * v x* I - I v x when the body moves with twist v.
+     */
+    inline void inertiaMatrices(const RigidBodyInertia& I, const Twist& v, Matrix6d& Im, Matrix6d& Im_dot)
+    {
+        for (unsigned int c = 0; c < 6; c++) {
+            Twist e = Twist::Zero();
+            e(c) = 1.0;
+            Wrench f = I * e;
+            Im.col(c) = toVector(f);
+            Im_dot.col(c) = toVector(v * f - I * (v * e));
+        }
+    }
+}
+
+#endif
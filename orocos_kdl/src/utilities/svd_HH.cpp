@@ -23,6 +23,7 @@
 //Based on the svd of the KDL-0.2 library by Erwin Aertbelien
 
 #include "svd_HH.hpp"
+#include "../tracing.hpp"
 
 namespace KDL
 {
@@ -59,6 +60,7 @@ namespace KDL
 
     int SVD_HH::calculate(const Jacobian& jac,std::vector<JntArray>& U,JntArray& w,std::vector<JntArray>& v,int maxiter)
     {
+        KDL_TRACE_SPAN("SVD_HH::calculate");
 
         //get the rows/columns of the jacobian
         const int rows = jac.rows();
@@ -20,11 +20,13 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "svd_eigen_HH.hpp"
+#include "../tracing.hpp"
 
 namespace KDL{
     
     int svd_eigen_HH(const Eigen::MatrixXd &A, Eigen::MatrixXd &U, Eigen::VectorXd &S, Eigen::MatrixXd &V, Eigen::VectorXd &tmp, int maxiter, double epsilon)
     {
+        KDL_TRACE_SPAN("svd_eigen_HH");
         //get the rows/columns of the matrix
         const int rows = static_cast<int>(A.rows());
         const int cols = static_cast<int>(A.cols());
@@ -46,6 +46,7 @@
 #include "velocityprofile_dirac.hpp"
 #include "velocityprofile_trap.hpp"
 #include "velocityprofile_traphalf.hpp"
+#include "velocityprofile_spline.hpp"
 #include <string.h>
 
 namespace KDL {
@@ -93,4 +94,27 @@ VelocityProfile* VelocityProfile::Read(std::istream& is) {
     return 0;
 }
 
+void VelocityProfile::WriteBinary(std::ostream& /*os*/) const {
+	throw Error_Not_Implemented();
+}
+
+VelocityProfile* VelocityProfile::ReadBinary(std::istream& is) {
+	unsigned int type;
+	KDL::ReadBinary(is,type);
+	switch (type) {
+	case BINARY_TRAP:
+		return VelocityProfile_Trap::ReadBinaryContent(is);
+	case BINARY_TRAPHALF:
+		return VelocityProfile_TrapHalf::ReadBinaryContent(is);
+	case BINARY_RECTANGULAR:
+		return VelocityProfile_Rectangular::ReadBinaryContent(is);
+	case BINARY_DIRAC:
+		return VelocityProfile_Dirac::ReadBinaryContent(is);
+	case BINARY_SPLINE:
+		return VelocityProfile_Spline::ReadBinaryContent(is);
+	default:
+		throw Error_MotionIO_Unexpected_MotProf();
+	}
+}
+
 }
@@ -47,6 +47,7 @@
 
 #include "utilities/utility.h"
 #include "utilities/utility_io.h"
+#include "utilities/binary_io.h"
 
 
 namespace KDL {
@@ -96,6 +97,24 @@ class VelocityProfile
 		static VelocityProfile* Read(std::istream& is);
 		// reads a VelocityProfile object from the stream and returns it.
 
+		enum BinaryType {
+			BINARY_TRAP=1,
+			BINARY_TRAPHALF=2,
+			BINARY_RECTANGULAR=3,
+			BINARY_DIRAC=4,
+			BINARY_SPLINE=5
+		};
+		// type tags of the binary format.
+
+		virtual void WriteBinary(std::ostream& os) const;
+		// Writes the complete state of the object, including the
+		// profile that is set, in the format of utilities/binary_io.h.
+		// Throws Error_Not_Implemented if the derived class does not
+		// support it.
+
+		static VelocityProfile* ReadBinary(std::istream& is);
+		// reads an object written by WriteBinary() and returns it.
+
 		virtual VelocityProfile* Clone() const = 0;
 		// returns copy of current VelocityProfile object. (virtual constructor)
 
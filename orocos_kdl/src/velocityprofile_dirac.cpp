@@ -27,6 +27,7 @@
 
 #include "utilities/error.h"
 #include "velocityprofile_dirac.hpp"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -85,6 +86,21 @@ namespace KDL {
         os << "DIRACVEL[ ]";
     }
 
+    void VelocityProfile_Dirac::WriteBinary(std::ostream& os) const {
+        KDL::WriteBinary(os,(unsigned int)BINARY_DIRAC);
+        KDL::WriteBinary(os,p1);
+        KDL::WriteBinary(os,p2);
+        KDL::WriteBinary(os,t);
+    }
+
+    VelocityProfile_Dirac* VelocityProfile_Dirac::ReadBinaryContent(std::istream& is) {
+        scoped_ptr<VelocityProfile_Dirac> profile( new VelocityProfile_Dirac() );
+        KDL::ReadBinary(is,profile->p1);
+        KDL::ReadBinary(is,profile->p2);
+        KDL::ReadBinary(is,profile->t);
+        return profile.release();
+    }
+
 
 
 }
@@ -56,6 +56,11 @@ namespace KDL {
         virtual double Vel(double time) const;
         virtual double Acc(double time) const;
         virtual void Write(std::ostream& os) const;
+        virtual void WriteBinary(std::ostream& os) const;
+        /**
+         * Reads the state written by WriteBinary() after its type tag.
+         */
+        static VelocityProfile_Dirac* ReadBinaryContent(std::istream& is);
         virtual VelocityProfile* Clone() const {
             VelocityProfile_Dirac* res =  new VelocityProfile_Dirac();
             res->SetProfileDuration( p1, p2, t );
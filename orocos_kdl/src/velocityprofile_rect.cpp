@@ -42,6 +42,7 @@
 
 #include "utilities/error.h"
 #include "velocityprofile_rect.hpp"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -128,6 +129,23 @@ void VelocityProfile_Rectangular::Write(std::ostream& os) const {
 	os << "CONSTVEL[" << maxvel << "]";
 }
 
+void VelocityProfile_Rectangular::WriteBinary(std::ostream& os) const {
+	KDL::WriteBinary(os,(unsigned int)BINARY_RECTANGULAR);
+	KDL::WriteBinary(os,d);
+	KDL::WriteBinary(os,p);
+	KDL::WriteBinary(os,v);
+	KDL::WriteBinary(os,maxvel);
+}
+
+VelocityProfile_Rectangular* VelocityProfile_Rectangular::ReadBinaryContent(std::istream& is) {
+	scoped_ptr<VelocityProfile_Rectangular> profile( new VelocityProfile_Rectangular() );
+	KDL::ReadBinary(is,profile->d);
+	KDL::ReadBinary(is,profile->p);
+	KDL::ReadBinary(is,profile->v);
+	KDL::ReadBinary(is,profile->maxvel);
+	return profile.release();
+}
+
 
 }
 
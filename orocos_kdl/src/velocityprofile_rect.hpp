@@ -75,6 +75,11 @@ namespace KDL {
 		virtual double Vel(double time) const;
 		virtual double Acc(double time) const;
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static VelocityProfile_Rectangular* ReadBinaryContent(std::istream& is);
 		virtual VelocityProfile* Clone() const{
 			VelocityProfile_Rectangular* res =  new VelocityProfile_Rectangular(maxvel);
 			res->SetProfileDuration( p, p+v*d, d );
@@ -2,6 +2,7 @@
 #include <limits>
 
 #include "velocityprofile_spline.hpp"
+#include "utilities/scoped_ptr.hpp"
 
 namespace KDL {
 
@@ -15,6 +16,23 @@ static inline void generatePowers(int n, double x, double* powers)
   return;
 }
 
+void VelocityProfile_Spline::WriteBinary(std::ostream& os) const
+{
+  KDL::WriteBinary(os, (unsigned int)BINARY_SPLINE);
+  for (int i = 0; i < 6; ++i)
+    KDL::WriteBinary(os, coeff_[i]);
+  KDL::WriteBinary(os, duration_);
+}
+
+VelocityProfile_Spline* VelocityProfile_Spline::ReadBinaryContent(std::istream& is)
+{
+  scoped_ptr<VelocityProfile_Spline> profile(new VelocityProfile_Spline());
+  for (int i = 0; i < 6; ++i)
+    KDL::ReadBinary(is, profile->coeff_[i]);
+  KDL::ReadBinary(is, profile->duration_);
+  return profile.release();
+}
+
 VelocityProfile_Spline::VelocityProfile_Spline()
 {
   duration_ = 0.0;
@@ -57,6 +57,11 @@ public:
     virtual double Vel(double time) const;
     virtual double Acc(double time) const;
     virtual void Write(std::ostream& os) const;
+    virtual void WriteBinary(std::ostream& os) const;
+    /**
+     * Reads the state written by WriteBinary() after its type tag.
+     */
+    static VelocityProfile_Spline* ReadBinaryContent(std::istream& is);
     virtual VelocityProfile* Clone() const;
 private:
 
@@ -101,6 +101,11 @@ class VelocityProfile_Trap : public VelocityProfile
 		virtual double Vel(double time) const;
 		virtual double Acc(double time) const;
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static VelocityProfile_Trap* ReadBinaryContent(std::istream& is);
 		virtual VelocityProfile* Clone() const;
 		// returns copy of current VelocityProfile object. (virtual constructor)
 		virtual ~VelocityProfile_Trap();
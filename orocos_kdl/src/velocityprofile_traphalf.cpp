@@ -42,6 +42,7 @@
 
 //#include "error.h"
 #include "velocityprofile_traphalf.hpp"
+#include "utilities/scoped_ptr.hpp"
 #include <algorithm>
 
 namespace KDL {
@@ -195,6 +196,49 @@ void VelocityProfile_TrapHalf::Write(std::ostream& os) const {
 	os << "TRAPEZOIDALHALF[" << maxvel << "," << maxacc << "," << starting << "]";
 }
 
+void VelocityProfile_TrapHalf::WriteBinary(std::ostream& os) const {
+	KDL::WriteBinary(os,(unsigned int)BINARY_TRAPHALF);
+	KDL::WriteBinary(os,a1);
+	KDL::WriteBinary(os,a2);
+	KDL::WriteBinary(os,a3);
+	KDL::WriteBinary(os,b1);
+	KDL::WriteBinary(os,b2);
+	KDL::WriteBinary(os,b3);
+	KDL::WriteBinary(os,c1);
+	KDL::WriteBinary(os,c2);
+	KDL::WriteBinary(os,c3);
+	KDL::WriteBinary(os,duration);
+	KDL::WriteBinary(os,t1);
+	KDL::WriteBinary(os,t2);
+	KDL::WriteBinary(os,startpos);
+	KDL::WriteBinary(os,endpos);
+	KDL::WriteBinary(os,maxvel);
+	KDL::WriteBinary(os,maxacc);
+	KDL::WriteBinary(os,starting);
+}
+
+VelocityProfile_TrapHalf* VelocityProfile_TrapHalf::ReadBinaryContent(std::istream& is) {
+	scoped_ptr<VelocityProfile_TrapHalf> profile( new VelocityProfile_TrapHalf() );
+	KDL::ReadBinary(is,profile->a1);
+	KDL::ReadBinary(is,profile->a2);
+	KDL::ReadBinary(is,profile->a3);
+	KDL::ReadBinary(is,profile->b1);
+	KDL::ReadBinary(is,profile->b2);
+	KDL::ReadBinary(is,profile->b3);
+	KDL::ReadBinary(is,profile->c1);
+	KDL::ReadBinary(is,profile->c2);
+	KDL::ReadBinary(is,profile->c3);
+	KDL::ReadBinary(is,profile->duration);
+	KDL::ReadBinary(is,profile->t1);
+	KDL::ReadBinary(is,profile->t2);
+	KDL::ReadBinary(is,profile->startpos);
+	KDL::ReadBinary(is,profile->endpos);
+	KDL::ReadBinary(is,profile->maxvel);
+	KDL::ReadBinary(is,profile->maxacc);
+	KDL::ReadBinary(is,profile->starting);
+	return profile.release();
+}
+
 
 
 
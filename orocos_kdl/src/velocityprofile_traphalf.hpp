@@ -123,6 +123,11 @@ class VelocityProfile_TrapHalf : public VelocityProfile
 		virtual double Vel(double time) const;
 		virtual double Acc(double time) const;
 		virtual void Write(std::ostream& os) const;
+		virtual void WriteBinary(std::ostream& os) const;
+		/**
+		 * Reads the state written by WriteBinary() after its type tag.
+		 */
+		static VelocityProfile_TrapHalf* ReadBinaryContent(std::istream& is);
 		virtual VelocityProfile* Clone() const;
 
 		virtual ~VelocityProfile_TrapHalf();
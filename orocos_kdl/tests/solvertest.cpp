@@ -2,9 +2,12 @@
 #include <frames_io.hpp>
 #include <framevel_io.hpp>
 #include <kinfam_io.hpp>
+#include <atomic>
 #include <random>
+#include <thread>
 #include <time.h>
 #include <utilities/utility.h>
+#include <utilities/error.h>
 
 CPPUNIT_TEST_SUITE_REGISTRATION( SolverTest );
 
@@ -1827,3 +1830,2186 @@ void SolverTest::ExternalWrenchEstimatorTest()
 
     return;
 }
+
+void SolverTest::CoupledJointsTest()
+{
+    std::cout<<"Coupled Joints Test"<<std::endl;
+    double eps=1e-9;
+
+    // Finger with an abduction joint and a flexion coordinate driving
+    // the three flexion joints, compared with the same finger modelled
+    // with independent joints
+    RigidBodyInertia inertia(0.1, Vector(0.0,0.01,0.02), RotationalInertia(1e-4,2e-4,1e-5));
+    Segment base("base", Joint("abduction", Joint::RotZ), Frame(Vector(0.0,0.0,0.05)), inertia);
+    Segment proximal("proximal", Joint("mcp", Joint::RotX), Frame(Vector(0.0,0.0,0.04)), inertia);
+    Segment middle("middle", Joint("pip", Joint::RotX, 0.8, 0.1), Frame(Vector(0.0,0.0,0.03)), inertia);
+    Segment distal("distal", Joint("dip", Joint::RotX, 0.5), Frame(Vector(0.0,0.0,0.02)), inertia);
+    Segment nail("nail", Joint("nail", Joint::None), Frame(Vector(0.0,0.01,0.0)));
+
+    Chain coupled, full;
+    coupled.addSegment(base);
+    coupled.addSegment(proximal);
+    CPPUNIT_ASSERT(coupled.addCoupledSegment(middle, 1));
+    CPPUNIT_ASSERT(coupled.addCoupledSegment(distal, 1));
+    CPPUNIT_ASSERT(!coupled.addCoupledSegment(nail, 1));
+    CPPUNIT_ASSERT(!coupled.addCoupledSegment(distal, 2));
+    coupled.addSegment(nail);
+    full.addSegment(base);
+    full.addSegment(proximal);
+    full.addSegment(middle);
+    full.addSegment(distal);
+    full.addSegment(nail);
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, coupled.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, coupled.getNrOfCoupledJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)1, coupled.getQNr(3));
+    Chain copy(coupled);
+    copy.addChain(coupled);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)4, copy.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)4, copy.getNrOfCoupledJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3, copy.getQNr(8));
+
+    // Map from the reduced to the full joint coordinates
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(4,2);
+    A(0,0) = A(1,1) = A(2,1) = A(3,1) = 1.0;
+
+    JntArray q(2), qdot(2), qdotdot(2), q_full(4), qdot_full(4), qdotdot_full(4);
+    for(unsigned int i=0; i<2; i++)
+    {
+        random(q(i));
+        random(qdot(i));
+        random(qdotdot(i));
+    }
+    q_full.data = A*q.data;
+    qdot_full.data = A*qdot.data;
+    qdotdot_full.data = A*qdotdot.data;
+
+    // Kinematics
+    ChainFkSolverPos_recursive fksolver(coupled), fksolver_full(full);
+    Frame f, f_full;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fksolver.JntToCart(q, f));
+    fksolver_full.JntToCart(q_full, f_full);
+    CPPUNIT_ASSERT(Equal(f, f_full, eps));
+
+    ChainFkSolverVel_recursive fkvelsolver(coupled), fkvelsolver_full(full);
+    FrameVel fv, fv_full;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fkvelsolver.JntToCart(JntArrayVel(q, qdot), fv));
+    fkvelsolver_full.JntToCart(JntArrayVel(q_full, qdot_full), fv_full);
+    CPPUNIT_ASSERT(Equal(fv, fv_full, eps));
+
+    ChainJntToJacSolver jacsolver(coupled), jacsolver_full(full);
+    Jacobian jac(2), jac_full(4);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, jacsolver.JntToJac(q, jac));
+    jacsolver_full.JntToJac(q_full, jac_full);
+    CPPUNIT_ASSERT(jac.data.isApprox(jac_full.data*A, eps));
+
+    // Dynamics
+    Vector gravity(0.0, 0.0, -9.81);
+    ChainIdSolver_RNE idsolver(coupled, gravity), idsolver_full(full, gravity);
+    Wrenches f_ext(coupled.getNrOfSegments(), Wrench::Zero());
+    JntArray torques(2), torques_full(4);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, idsolver.CartToJnt(q, qdot, qdotdot, f_ext, torques));
+    idsolver_full.CartToJnt(q_full, qdot_full, qdotdot_full, f_ext, torques_full);
+    CPPUNIT_ASSERT(torques.data.isApprox(A.transpose()*torques_full.data, eps));
+
+    ChainDynParam dynparam(coupled, gravity), dynparam_full(full, gravity);
+    JntSpaceInertiaMatrix H(2), H_full(4);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToMass(q, H));
+    dynparam_full.JntToMass(q_full, H_full);
+    CPPUNIT_ASSERT(H.data.isApprox(A.transpose()*H_full.data*A, eps));
+
+    // Inverse kinematics in the reduced coordinates
+    ChainIkSolverVel_pinv iksolvervel(coupled);
+    ChainIkSolverPos_NR iksolverpos(coupled, fksolver, iksolvervel);
+    Eigen::Matrix<double,6,1> L;
+    L << 1.0, 1.0, 1.0, 0.0, 0.0, 0.0;
+    ChainIkSolverPos_LMA iksolverpos_lma(coupled, L);
+    JntArray q_init(2), q_sol(2);
+    q_init(0) = q(0) + 0.1;
+    q_init(1) = q(1) - 0.1;
+    CPPUNIT_ASSERT(0 <= iksolverpos.CartToJnt(q_init, f, q_sol));
+    fksolver.JntToCart(q_sol, f_full);
+    CPPUNIT_ASSERT(Equal(f, f_full, 1e-5));
+    CPPUNIT_ASSERT(0 <= iksolverpos_lma.CartToJnt(q_init, f, q_sol));
+    fksolver.JntToCart(q_sol, f_full);
+    CPPUNIT_ASSERT(Equal(f.p, f_full.p, 1e-5));
+
+    // Tree with the coupled finger, also after copying and extracting it
+    Tree tree("palm");
+    CPPUNIT_ASSERT(tree.addChain(coupled, "palm"));
+    CPPUNIT_ASSERT(tree.addChain(coupled, "palm") == false);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, tree.getNrOfJoints());
+    Tree tree_copy(tree);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, tree_copy.getNrOfJoints());
+    Chain extracted;
+    CPPUNIT_ASSERT(tree_copy.getChain("palm", "nail", extracted));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, extracted.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, extracted.getNrOfCoupledJoints());
+    Chain reversed;
+    CPPUNIT_ASSERT(tree_copy.getChain("nail", "palm", reversed));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, reversed.getNrOfJoints());
+    ChainFkSolverPos_recursive fksolver_reversed(reversed);
+    JntArray q_reversed(2);
+    q_reversed(0) = q(1);
+    q_reversed(1) = q(0);
+    fksolver_reversed.JntToCart(q_reversed, f_full);
+    CPPUNIT_ASSERT(Equal(f.Inverse(), f_full, eps));
+
+    TreeJntToJacSolver treejacsolver(tree_copy);
+    Jacobian jac_tree(2);
+    CPPUNIT_ASSERT_EQUAL(0, treejacsolver.JntToJac(q, jac_tree, "nail"));
+    CPPUNIT_ASSERT(jac.data.isApprox(jac_tree.data, eps));
+
+    TreeIdSolver_RNE treeidsolver(tree_copy, gravity);
+    JntArray torques_tree(2);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treeidsolver.CartToJnt(q, qdot, qdotdot, WrenchMap(), torques_tree));
+    CPPUNIT_ASSERT(torques.data.isApprox(torques_tree.data, eps));
+
+    // Solvers that need one coordinate per joint refuse coupled chains
+    ChainJntToJacDotSolver jacdotsolver(coupled);
+    Jacobian jacdot(2);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, jacdotsolver.JntToJacDot(JntArrayVel(q, qdot), jacdot));
+}
+
+void SolverTest::MultiDofJointsTest()
+{
+    std::cout<<"Multi-DOF Joints Test"<<std::endl;
+    double eps=1e-9;
+    double h=1e-5;
+
+    // Floating pelvis, spherical hip, knee and a foot on a planar joint
+    Chain leg;
+    leg.addSegment(Segment("pelvis", Joint("base", Joint::Floating), Frame(Vector(0.0,0.1,-0.1)),
+                           RigidBodyInertia(10.0, Vector(0.0,0.0,0.05), RotationalInertia(0.1,0.2,0.15,0.01))));
+    leg.addSegment(Segment("thigh", Joint("hip", Joint::Spherical), Frame(Vector(0.0,0.0,-0.4)),
+                           RigidBodyInertia(5.0, Vector(0.01,0.0,-0.2), RotationalInertia(0.05,0.05,0.01))));
+    leg.addSegment(Segment("shank", Joint("knee", Joint::RotY), Frame(Vector(0.0,0.0,-0.4)),
+                           RigidBodyInertia(3.0, Vector(0.0,0.0,-0.2), RotationalInertia(0.03,0.03,0.005))));
+    leg.addSegment(Segment("foot", Joint("sole", Joint::Planar), Frame(Rotation::RotX(0.3), Vector(0.05,0.0,-0.05)),
+                           RigidBodyInertia(1.0, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))));
+    leg.addSegment(Segment("toe", Joint("toe", Joint::None), Frame(Vector(0.1,0.0,0.0))));
+
+    CPPUNIT_ASSERT_EQUAL((unsigned int)13, leg.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)3, leg.getNrOfMultiDofJoints());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)6, leg.getQNr(1));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)10, leg.getQNr(3));
+    CPPUNIT_ASSERT(!leg.addCoupledSegment(leg.getSegment(1), 6));
+    CPPUNIT_ASSERT(Joint("hip", Joint::Spherical).getTypeName() == "Spherical");
+
+    unsigned int nj = leg.getNrOfJoints();
+    JntArray q(nj), qdot(nj), qdotdot(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qdot(i));
+        random(qdotdot(i));
+    }
+    // keep the hip close to the zero rotation to cover the series expansions
+    q(6) = 1e-3;
+    q(7) = -2e-3;
+    q(8) = 5e-4;
+
+    // Orientations are exponential coordinates
+    Vector w(q(3), q(4), q(5));
+    CPPUNIT_ASSERT(Equal(leg.getSegment(0).getJoint().pose(q, 0).M, Rotation::Rot(w, w.Norm()), eps));
+
+    // Jacobian against finite differences of the forward kinematics
+    ChainFkSolverPos_recursive fksolver(leg);
+    ChainJntToJacSolver jacsolver(leg);
+    Jacobian jac(nj);
+    Frame f, f_plus, f_minus;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fksolver.JntToCart(q, f));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, jacsolver.JntToJac(q, jac));
+    for(unsigned int k=0; k<nj; k++)
+    {
+        JntArray q_plus(q), q_minus(q);
+        q_plus(k) += h;
+        q_minus(k) -= h;
+        fksolver.JntToCart(q_plus, f_plus);
+        fksolver.JntToCart(q_minus, f_minus);
+        CPPUNIT_ASSERT(Equal(jac.getColumn(k), diff(f_minus, f_plus, 2*h), 1e-6));
+    }
+
+    ChainFkSolverVel_recursive fkvelsolver(leg);
+    FrameVel fv;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fkvelsolver.JntToCart(JntArrayVel(q, qdot), fv));
+    Twist t;
+    MultiplyJacobian(jac, qdot, t);
+    CPPUNIT_ASSERT(Equal(fv.GetTwist(), t, eps));
+
+    // Mass matrix against the sum of the body jacobians J_i^T I_i J_i
+    Vector gravity(0.0, 0.0, -9.81);
+    ChainDynParam dynparam(leg, gravity);
+    JntSpaceInertiaMatrix H(nj), H_bodies(nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToMass(q, H));
+    SetToZero(H_bodies);
+    for(unsigned int i=0; i<leg.getNrOfSegments(); i++)
+    {
+        Jacobian jac_body(nj);
+        jacsolver.JntToJac(q, jac_body, i+1);
+        fksolver.JntToCart(q, f, i+1);
+        jac_body.changeBase(f.M.Inverse());
+        for(unsigned int r=0; r<nj; r++)
+            for(unsigned int c=0; c<nj; c++)
+                H_bodies(r,c) += dot(jac_body.getColumn(r), leg.getSegment(i).getInertia()*jac_body.getColumn(c));
+    }
+    CPPUNIT_ASSERT(H.data.isApprox(H_bodies.data, 1e-9));
+
+    // Inverse dynamics against the Lagrange equations, with the time and
+    // position derivatives of the mass matrix and potential energy
+    // obtained by finite differences
+    ChainIdSolver_RNE idsolver(leg, gravity);
+    Wrenches f_ext(leg.getNrOfSegments(), Wrench::Zero());
+    JntArray torques(nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, idsolver.CartToJnt(q, qdot, qdotdot, f_ext, torques));
+
+    std::vector<Frame> frames(leg.getNrOfSegments());
+    auto potential = [&](const JntArray& q_) {
+        fksolver.JntToCart(q_, frames);
+        double V = 0.0;
+        for(unsigned int i=0; i<leg.getNrOfSegments(); i++)
+            V -= leg.getSegment(i).getInertia().getMass()*dot(gravity, frames[i]*leg.getSegment(i).getInertia().getCOG());
+        return V;
+    };
+    JntSpaceInertiaMatrix H_plus(nj), H_minus(nj);
+    JntArray q_plus(q), q_minus(q);
+    q_plus.data += h*qdot.data;
+    q_minus.data -= h*qdot.data;
+    dynparam.JntToMass(q_plus, H_plus);
+    dynparam.JntToMass(q_minus, H_minus);
+    Eigen::VectorXd lagrange = H.data*qdotdot.data + (H_plus.data-H_minus.data)/(2*h)*qdot.data;
+    for(unsigned int k=0; k<nj; k++)
+    {
+        q_plus = q;
+        q_minus = q;
+        q_plus(k) += h;
+        q_minus(k) -= h;
+        dynparam.JntToMass(q_plus, H_plus);
+        dynparam.JntToMass(q_minus, H_minus);
+        double dT = 0.5*qdot.data.dot((H_plus.data-H_minus.data)*qdot.data)/(2*h);
+        double dV = (potential(q_plus)-potential(q_minus))/(2*h);
+        lagrange(k) += dV - dT;
+    }
+    CPPUNIT_ASSERT(torques.data.isApprox(lagrange, 1e-6));
+
+    // Inverse kinematics
+    Eigen::Matrix<double,6,1> L;
+    L << 1.0, 1.0, 1.0, 1.0, 1.0, 1.0;
+    ChainIkSolverPos_LMA iksolverpos_lma(leg, L);
+    JntArray q_init(q), q_sol(nj);
+    fksolver.JntToCart(q, f);
+    for(unsigned int k=0; k<nj; k++)
+        q_init(k) += 0.05;
+    CPPUNIT_ASSERT(0 <= iksolverpos_lma.CartToJnt(q_init, f, q_sol));
+    fksolver.JntToCart(q_sol, f_plus);
+    CPPUNIT_ASSERT(Equal(f, f_plus, 1e-5));
+
+    // Tree solvers, multi-DOF joints can not be reversed
+    Tree tree("world");
+    CPPUNIT_ASSERT(tree.addChain(leg, "world"));
+    CPPUNIT_ASSERT_EQUAL(nj, tree.getNrOfJoints());
+    Chain extracted;
+    CPPUNIT_ASSERT(tree.getChain("world", "toe", extracted));
+    CPPUNIT_ASSERT_EQUAL(nj, extracted.getNrOfJoints());
+    CPPUNIT_ASSERT(!tree.getChain("toe", "world", extracted));
+
+    TreeFkSolverPos_recursive treefksolver(tree);
+    CPPUNIT_ASSERT_EQUAL(0, treefksolver.JntToCart(q, f_plus, "toe"));
+    CPPUNIT_ASSERT(Equal(f, f_plus, eps));
+
+    TreeJntToJacSolver treejacsolver(tree);
+    Jacobian jac_tree(nj);
+    CPPUNIT_ASSERT_EQUAL(0, treejacsolver.JntToJac(q, jac_tree, "toe"));
+    CPPUNIT_ASSERT(jac.data.isApprox(jac_tree.data, eps));
+
+    TreeIdSolver_RNE treeidsolver(tree, gravity);
+    JntArray torques_tree(nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treeidsolver.CartToJnt(q, qdot, qdotdot, WrenchMap(), torques_tree));
+    CPPUNIT_ASSERT(torques.data.isApprox(torques_tree.data, eps));
+
+    // Solvers that need one coordinate per joint refuse multi-DOF joints
+    ChainJntToJacDotSolver jacdotsolver(leg);
+    Jacobian jacdot(nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, jacdotsolver.JntToJacDot(JntArrayVel(q, qdot), jacdot));
+}
+
+void SolverTest::JointLockingTest()
+{
+    std::cout<<"Joint Locking Test"<<std::endl;
+    double eps=1e-9;
+
+    // KUKA LWR with named segments and the joints 1 and 3 locked
+    Chain arm;
+    for(unsigned int i=0; i<kukaLWR.getNrOfSegments(); i++)
+    {
+        const Segment& segment = kukaLWR.getSegment(i);
+        std::ostringstream name;
+        name << "link" << i;
+        arm.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()));
+    }
+    unsigned int nj = arm.getNrOfJoints();
+    std::vector<bool> locked(nj, false);
+    locked[1] = locked[3] = true;
+
+    JntArray q(nj), qdot(nj), qdotdot(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qdot(i));
+        random(qdotdot(i));
+    }
+    qdot(1) = qdot(3) = qdotdot(1) = qdotdot(3) = 0.0;
+
+    Chain reduced;
+    std::vector<unsigned int> q_nrs;
+    CPPUNIT_ASSERT(!arm.getReducedChain(std::vector<bool>(nj-1, false), q, reduced, q_nrs));
+    CPPUNIT_ASSERT(arm.getReducedChain(locked, q, reduced, q_nrs));
+    unsigned int nr = reduced.getNrOfJoints();
+    CPPUNIT_ASSERT_EQUAL(nj-2, nr);
+    CPPUNIT_ASSERT_EQUAL(arm.getNrOfSegments(), reduced.getNrOfSegments());
+    CPPUNIT_ASSERT_EQUAL((size_t)nr, q_nrs.size());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)2, q_nrs[1]);
+
+    JntArray q_red(nr), qdot_red(nr), qdotdot_red(nr);
+    for(unsigned int i=0; i<nr; i++)
+    {
+        q_red(i) = q(q_nrs[i]);
+        qdot_red(i) = qdot(q_nrs[i]);
+        qdotdot_red(i) = qdotdot(q_nrs[i]);
+    }
+
+    ChainFkSolverPos_recursive fksolver(arm), fksolver_red(reduced);
+    Frame f, f_red;
+    fksolver.JntToCart(q, f);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fksolver_red.JntToCart(q_red, f_red));
+    CPPUNIT_ASSERT(Equal(f, f_red, eps));
+
+    ChainJntToJacSolver jacsolver(arm), jacsolver_red(reduced);
+    Jacobian jac(nj), jac_red(nr);
+    jacsolver.JntToJac(q, jac);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, jacsolver_red.JntToJac(q_red, jac_red));
+    for(unsigned int i=0; i<nr; i++)
+        CPPUNIT_ASSERT(Equal(jac.getColumn(q_nrs[i]), jac_red.getColumn(i), eps));
+
+    Vector gravity(0.0, 0.0, -9.81);
+    ChainIdSolver_RNE idsolver(arm, gravity), idsolver_red(reduced, gravity);
+    Wrenches f_ext(arm.getNrOfSegments(), Wrench::Zero());
+    JntArray torques(nj), torques_red(nr);
+    idsolver.CartToJnt(q, qdot, qdotdot, f_ext, torques);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, idsolver_red.CartToJnt(q_red, qdot_red, qdotdot_red, f_ext, torques_red));
+    ChainDynParam dynparam(arm, gravity), dynparam_red(reduced, gravity);
+    JntSpaceInertiaMatrix H(nj), H_red(nr);
+    dynparam.JntToMass(q, H);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam_red.JntToMass(q_red, H_red));
+    for(unsigned int i=0; i<nr; i++)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(torques(q_nrs[i]), torques_red(i), eps);
+        for(unsigned int j=0; j<nr; j++)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(H(q_nrs[i],q_nrs[j]), H_red(i,j), eps);
+    }
+
+    // The same for a tree with the arm and a second, unlocked branch
+    Tree tree("base");
+    CPPUNIT_ASSERT(tree.addChain(arm, "base"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("head", Joint("pan", Joint::RotZ), Frame(Vector(0.0,0.0,0.5))), "base"));
+    JntArray q_tree(nj+1);
+    q_tree.data.head(nj) = q.data;
+    q_tree(nj) = 0.3;
+    std::vector<bool> locked_tree(locked);
+    locked_tree.push_back(false);
+    Tree tree_red;
+    CPPUNIT_ASSERT(tree.getReducedTree(locked_tree, q_tree, tree_red, q_nrs));
+    CPPUNIT_ASSERT_EQUAL(nr+1, tree_red.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((size_t)nr+1, q_nrs.size());
+    JntArray q_tree_red(nr+1);
+    for(unsigned int i=0; i<nr+1; i++)
+        q_tree_red(i) = q_tree(q_nrs[i]);
+    TreeFkSolverPos_recursive treefksolver(tree_red);
+    CPPUNIT_ASSERT_EQUAL(0, treefksolver.JntToCart(q_tree_red, f_red, "link6"));
+    CPPUNIT_ASSERT(Equal(f, f_red, eps));
+    TreeJntToJacSolver treejacsolver(tree_red);
+    Jacobian jac_tree(nr+1);
+    CPPUNIT_ASSERT_EQUAL(0, treejacsolver.JntToJac(q_tree_red, jac_tree, "link6"));
+    for(unsigned int i=0; i<nr+1; i++)
+    {
+        if(q_nrs[i] < nj)
+            CPPUNIT_ASSERT(Equal(jac.getColumn(q_nrs[i]), jac_tree.getColumn(i), eps));
+    }
+
+    // Multi-DOF joints can only be locked as a whole
+    Chain ball;
+    ball.addSegment(Segment("ball", Joint("ball", Joint::Spherical), Frame(Vector(0.0,0.0,0.1))));
+    std::vector<bool> locked_ball(3, false);
+    locked_ball[1] = true;
+    JntArray q_ball(3);
+    CPPUNIT_ASSERT(!ball.getReducedChain(locked_ball, q_ball, reduced, q_nrs));
+    locked_ball.assign(3, true);
+    CPPUNIT_ASSERT(ball.getReducedChain(locked_ball, q_ball, reduced, q_nrs));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)0, reduced.getNrOfJoints());
+}
+
+void SolverTest::FkCacheTest()
+{
+    std::cout<<"FK Cache Test"<<std::endl;
+    double eps=1e-12;
+    unsigned int nj = motomansia10.getNrOfJoints();
+    unsigned int ns = motomansia10.getNrOfSegments();
+
+    ChainFkSolverPos_recursive fksolver(motomansia10);
+    ChainFkSolverPos_cached cachedsolver(motomansia10, 4);
+    std::vector<JntArray> qs(6, JntArray(nj));
+    for(unsigned int k=0; k<qs.size(); k++)
+        for(unsigned int i=0; i<nj; i++)
+            random(qs[k](i));
+
+    // Every request gives the frames of the recursive solver, repeated
+    // requests and requests for other segments are hits
+    Frame f, f_cached;
+    std::vector<Frame> frames(ns), frames_cached(ns);
+    for(unsigned int k=0; k<qs.size(); k++)
+    {
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, cachedsolver.JntToCart(qs[k], f_cached));
+        fksolver.JntToCart(qs[k], f);
+        CPPUNIT_ASSERT(Equal(f, f_cached, eps));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, cachedsolver.JntToCart(qs[k], f_cached, 3));
+        fksolver.JntToCart(qs[k], f, 3);
+        CPPUNIT_ASSERT(Equal(f, f_cached, eps));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, cachedsolver.JntToCart(qs[k], frames_cached));
+        fksolver.JntToCart(qs[k], frames);
+        for(unsigned int i=0; i<ns; i++)
+            CPPUNIT_ASSERT(Equal(frames[i], frames_cached[i], eps));
+    }
+    CPPUNIT_ASSERT_EQUAL((unsigned long)qs.size(), cachedsolver.getCache().getNrOfMisses());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)2*qs.size(), cachedsolver.getCache().getNrOfHits());
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, cachedsolver.JntToCart(qs[0], f_cached, 0));
+    CPPUNIT_ASSERT(Equal(Frame::Identity(), f_cached, eps));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, cachedsolver.JntToCart(JntArray(nj+1), f_cached));
+
+    // The capacity bounds the number of stored configurations
+    cachedsolver.resetStatistics();
+    for(unsigned int k=0; k<qs.size(); k++)
+        cachedsolver.JntToCart(qs[k], f_cached);
+    CPPUNIT_ASSERT(cachedsolver.getCache().getNrOfHits() <= 4);
+    cachedsolver.clearCache();
+    cachedsolver.resetStatistics();
+    cachedsolver.JntToCart(qs[0], f_cached);
+    CPPUNIT_ASSERT_EQUAL((unsigned long)1, cachedsolver.getCache().getNrOfMisses());
+
+    // With a quantized key, configurations in the same cell share frames
+    ChainFkSolverPos_cached quantizedsolver(motomansia10, 16, 1e-3);
+    JntArray q_near(qs[0]);
+    q_near(0) = std::floor(qs[0](0)/1e-3 + 0.5)*1e-3 + 4e-4;
+    q_near(1) = std::floor(qs[0](1)/1e-3 + 0.5)*1e-3 - 4e-4;
+    quantizedsolver.JntToCart(qs[0], f);
+    quantizedsolver.JntToCart(q_near, f_cached);
+    CPPUNIT_ASSERT_EQUAL((unsigned long)1, quantizedsolver.getCache().getNrOfHits());
+    CPPUNIT_ASSERT(Equal(f, f_cached, eps));
+
+    // One thread inserts and reads while another one reads. The small
+    // capacity makes the writer replace slots all the time, a hit must
+    // still give the frames of the requested configuration.
+    const unsigned int nr_of_configs = 32, nr_of_lookups = 2000000;
+    std::vector<JntArray> qs_threads(nr_of_configs, JntArray(nj));
+    std::vector<std::vector<Frame> > frames_threads(nr_of_configs, std::vector<Frame>(ns));
+    for(unsigned int k=0; k<nr_of_configs; k++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+            random(qs_threads[k](i));
+        fksolver.JntToCart(qs_threads[k], frames_threads[k]);
+    }
+    FrameCache cache(nj, ns, 4);
+    std::atomic<bool> reading(true);
+    unsigned int reader_hits = 0, reader_errors = 0;
+    std::thread reader([&]() {
+        std::vector<Frame> read(ns);
+        for(unsigned int n=0; n<nr_of_lookups; n++)
+        {
+            unsigned int k = (7*n) % nr_of_configs;
+            if(!cache.lookup(qs_threads[k], 0, ns, &read[0]))
+                continue;
+            reader_hits++;
+            for(unsigned int i=0; i<ns; i++)
+                if(!Equal(read[i], frames_threads[k][i], eps))
+                    reader_errors++;
+        }
+        reading = false;
+    });
+    unsigned int writer_errors = 0;
+    std::vector<Frame> read(ns);
+    for(unsigned int n=0; reading; n++)
+    {
+        unsigned int k = (5*n) % nr_of_configs;
+        cache.insert(qs_threads[k], &frames_threads[k][0]);
+        k = (3*n) % nr_of_configs;
+        if(cache.lookup(qs_threads[k], 0, ns, &read[0]))
+            for(unsigned int i=0; i<ns; i++)
+                if(!Equal(read[i], frames_threads[k][i], eps))
+                    writer_errors++;
+    }
+    reader.join();
+    CPPUNIT_ASSERT(reader_hits > 0);
+    CPPUNIT_ASSERT_EQUAL(0u, reader_errors);
+    CPPUNIT_ASSERT_EQUAL(0u, writer_errors);
+
+    // The same with two threads requesting frames from the solver
+    ChainFkSolverPos_cached sharedsolver(motomansia10, 4);
+    unsigned int solver_errors[2] = {0, 0};
+    std::thread other([&]() {
+        Frame p;
+        for(unsigned int n=0; n<nr_of_lookups/10; n++)
+        {
+            unsigned int k = (7*n) % nr_of_configs;
+            if(sharedsolver.JntToCart(qs_threads[k], p) != SolverI::E_NOERROR || !Equal(p, frames_threads[k][ns-1], eps))
+                solver_errors[1]++;
+        }
+    });
+    for(unsigned int n=0; n<nr_of_lookups/10; n++)
+    {
+        unsigned int k = (3*n) % nr_of_configs;
+        if(sharedsolver.JntToCart(qs_threads[k], f_cached) != SolverI::E_NOERROR || !Equal(f_cached, frames_threads[k][ns-1], eps))
+            solver_errors[0]++;
+    }
+    other.join();
+    CPPUNIT_ASSERT_EQUAL(0u, solver_errors[0]);
+    CPPUNIT_ASSERT_EQUAL(0u, solver_errors[1]);
+
+    // Tree: one miss stores the frames of all segments
+    Tree tree("base");
+    CPPUNIT_ASSERT(tree.addSegment(Segment("torso", Joint("waist", Joint::RotZ), Frame(Vector(0.0,0.0,0.5))), "base"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left", Joint("left_shoulder", Joint::RotY), Frame(Vector(0.0,0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right", Joint("right_shoulder", Joint::RotY), Frame(Vector(0.0,-0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right_hand", Joint("right_wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0))), "right"));
+    TreeFkSolverPos_recursive treefksolver(tree);
+    TreeFkSolverPos_cached treecachedsolver(tree);
+    JntArray q(tree.getNrOfJoints());
+    for(unsigned int i=0; i<q.rows(); i++)
+        random(q(i));
+    const char* names[] = {"base", "torso", "left", "right", "right_hand"};
+    for(unsigned int i=0; i<5; i++)
+    {
+        CPPUNIT_ASSERT_EQUAL(0, treecachedsolver.JntToCart(q, f_cached, names[i]));
+        treefksolver.JntToCart(q, f, names[i]);
+        CPPUNIT_ASSERT(Equal(f, f_cached, eps));
+    }
+    CPPUNIT_ASSERT_EQUAL((unsigned long)1, treecachedsolver.getCache().getNrOfMisses());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)4, treecachedsolver.getCache().getNrOfHits());
+    CPPUNIT_ASSERT_EQUAL(-2, treecachedsolver.JntToCart(q, f_cached, "foot"));
+}
+
+void SolverTest::TreeFkVelTest()
+{
+    std::cout<<"Tree FK Vel Test"<<std::endl;
+    double eps=1e-12;
+    Tree tree("base");
+    CPPUNIT_ASSERT(tree.addSegment(Segment("torso", Joint("waist", Joint::RotZ), Frame(Vector(0.0,0.0,0.5))), "base"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left", Joint("left_shoulder", Joint::Spherical), Frame(Rotation::RPY(0.1,0.2,0.3),Vector(0.0,0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left_hand", Joint("left_wrist", Joint::TransX), Frame(Vector(0.3,0.0,0.1))), "left"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right", Joint("right_shoulder", Joint::RotY), Frame(Vector(0.0,-0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right_hand", Joint("right_wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0))), "right"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("head", Joint("head_fixed", Joint::Fixed), Frame(Vector(0.0,0.0,0.3))), "torso"));
+    unsigned int nj = tree.getNrOfJoints();
+
+    TreeFkSolverVel_recursive fksolver(tree);
+    TreeFkSolverPos_recursive fksolverpos(tree);
+    TreeJntToJacSolver jacsolver(tree);
+    JntArrayVel q(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q.q(i));
+        random(q.qdot(i));
+    }
+
+    // All segments in one pass: poses of the position solver and twists
+    // of the Jacobian
+    const std::vector<std::string>& names = fksolver.getSegmentNames();
+    CPPUNIT_ASSERT_EQUAL((size_t)tree.getNrOfSegments()+1, names.size());
+    std::vector<FrameVel> frames(names.size());
+    CPPUNIT_ASSERT_EQUAL(0, fksolver.JntToCart(q, frames));
+    Frame f;
+    Jacobian jac(nj);
+    FrameVel fv;
+    for(unsigned int i=0; i<names.size(); i++)
+    {
+        CPPUNIT_ASSERT_EQUAL((int)i, fksolver.getSegmentIndex(names[i]));
+        fksolverpos.JntToCart(q.q, f, names[i]);
+        jacsolver.JntToJac(q.q, jac, names[i]);
+        Twist t = Twist::Zero();
+        for(unsigned int j=0; j<nj; j++)
+            t += jac.getColumn(j)*q.qdot(j);
+        CPPUNIT_ASSERT(Equal(f, frames[i].GetFrame(), eps));
+        CPPUNIT_ASSERT(Equal(t, frames[i].GetTwist(), eps));
+        CPPUNIT_ASSERT_EQUAL(0, fksolver.JntToCart(q, fv, names[i]));
+        CPPUNIT_ASSERT(Equal(frames[i], fv, eps));
+    }
+
+    // A subset of the segments
+    std::vector<unsigned int> subset;
+    subset.push_back(fksolver.getSegmentIndex("right_hand"));
+    subset.push_back(fksolver.getSegmentIndex("left"));
+    std::vector<FrameVel> subset_frames(subset.size());
+    CPPUNIT_ASSERT_EQUAL(0, fksolver.JntToCart(q, subset, subset_frames));
+    for(unsigned int k=0; k<subset.size(); k++)
+        CPPUNIT_ASSERT(Equal(frames[subset[k]], subset_frames[k], eps));
+
+    CPPUNIT_ASSERT_EQUAL(-1, fksolver.getSegmentIndex("foot"));
+    CPPUNIT_ASSERT_EQUAL(-2, fksolver.JntToCart(q, fv, "foot"));
+    CPPUNIT_ASSERT_EQUAL(-1, fksolver.JntToCart(JntArrayVel(nj+1), fv, "torso"));
+    subset.push_back(names.size());
+    subset_frames.resize(subset.size());
+    CPPUNIT_ASSERT_EQUAL(-2, fksolver.JntToCart(q, subset, subset_frames));
+}
+
+void SolverTest::CentroidalTest()
+{
+    std::cout<<"Centroidal Test"<<std::endl;
+    double eps=1e-10;
+    double dt=1e-6;
+
+    // A tree with a branch on the chain, whose joints come after the
+    // joints of the chain
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    std::string branch_parent = "link2";
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::Spherical), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), branch_parent));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "arm"));
+
+    ChainCentroidalSolver chainsolver(motomansia10dyn);
+    TreeCentroidalSolver treesolver(tree);
+    ChainFkSolverVel_recursive chainfksolver(motomansia10dyn);
+    TreeFkSolverVel_recursive treefksolver(tree);
+
+    for(unsigned int test=0; test<2; test++)
+    {
+        unsigned int nj = test==0 ? motomansia10dyn.getNrOfJoints() : tree.getNrOfJoints();
+        JntArrayVel q(nj);
+        for(unsigned int i=0; i<nj; i++)
+        {
+            random(q.q(i));
+            random(q.qdot(i));
+        }
+
+        // Mass, centre of mass and momentum of the segments from the
+        // forward velocity kinematics
+        double m=0.0;
+        Vector mc=Vector::Zero();
+        Wrench h=Wrench::Zero();
+        std::vector<FrameVel> frames(test==0 ? motomansia10dyn.getNrOfSegments() : tree.getNrOfSegments()+1);
+        std::vector<RigidBodyInertia> inertias(frames.size());
+        if(test==0)
+        {
+            chainfksolver.JntToCart(q, frames);
+            for(unsigned int i=0; i<frames.size(); i++)
+                inertias[i]=motomansia10dyn.getSegment(i).getInertia();
+        }
+        else
+        {
+            treefksolver.JntToCart(q, frames);
+            for(unsigned int i=0; i<frames.size(); i++)
+                inertias[i]=tree.getSegments().find(treefksolver.getSegmentNames()[i])->second.segment.getInertia();
+        }
+        for(unsigned int i=0; i<frames.size(); i++)
+        {
+            RigidBodyInertia I=frames[i].GetFrame()*inertias[i];
+            m+=I.getMass();
+            mc+=I.getMass()*I.getCOG();
+            h+=I*frames[i].GetTwist().RefPoint(-frames[i].GetFrame().p);
+        }
+
+        Vector com, com_from_jac;
+        Eigen::MatrixXd jac(3, nj), cmm(6, nj);
+        Wrench cmm_dot_qdot;
+        if(test==0)
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(m, chainsolver.getMass(), eps);
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, chainsolver.JntToCoM(q.q, com));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, chainsolver.JntToCoMJac(q.q, com_from_jac, jac));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, chainsolver.JntToCentroidalMomentumMatrix(q.q, cmm));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, chainsolver.JntToCentroidalMomentumMatrixDotQDot(q, cmm_dot_qdot));
+        }
+        else
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(m, treesolver.getMass(), eps);
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToCoM(q.q, com));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToCoMJac(q.q, com_from_jac, jac));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToCentroidalMomentumMatrix(q.q, cmm));
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToCentroidalMomentumMatrixDotQDot(q, cmm_dot_qdot));
+        }
+        CPPUNIT_ASSERT(Equal(mc/m, com, eps));
+        CPPUNIT_ASSERT(Equal(com, com_from_jac, eps));
+
+        // The centroidal momentum matrix maps the joint velocities on
+        // the momentum about the centre of mass
+        Eigen::VectorXd hc = cmm*q.qdot.data;
+        Wrench h_com = h.RefPoint(com);
+        CPPUNIT_ASSERT(Equal(h_com, Wrench(Vector(hc(0),hc(1),hc(2)), Vector(hc(3),hc(4),hc(5))), eps));
+
+        // Finite differences along the joint velocity for the Jacobian
+        // of the centre of mass and the time derivative of the matrix
+        JntArray q_plus(nj), q_min(nj);
+        Multiply(q.qdot, dt, q_plus);
+        Add(q.q, q_plus, q_plus);
+        Multiply(q.qdot, -dt, q_min);
+        Add(q.q, q_min, q_min);
+        Vector com_plus, com_min;
+        Eigen::MatrixXd cmm_plus(6, nj), cmm_min(6, nj);
+        if(test==0)
+        {
+            chainsolver.JntToCoM(q_plus, com_plus);
+            chainsolver.JntToCoM(q_min, com_min);
+            chainsolver.JntToCentroidalMomentumMatrix(q_plus, cmm_plus);
+            chainsolver.JntToCentroidalMomentumMatrix(q_min, cmm_min);
+        }
+        else
+        {
+            treesolver.JntToCoM(q_plus, com_plus);
+            treesolver.JntToCoM(q_min, com_min);
+            treesolver.JntToCentroidalMomentumMatrix(q_plus, cmm_plus);
+            treesolver.JntToCentroidalMomentumMatrix(q_min, cmm_min);
+        }
+        Eigen::Vector3d vc = jac*q.qdot.data;
+        CPPUNIT_ASSERT(Equal((com_plus-com_min)/(2*dt), Vector(vc(0),vc(1),vc(2)), 1e-6));
+        Eigen::VectorXd hdot = (cmm_plus-cmm_min)*q.qdot.data/(2*dt);
+        CPPUNIT_ASSERT(Equal(Wrench(Vector(hdot(0),hdot(1),hdot(2)), Vector(hdot(3),hdot(4),hdot(5))), cmm_dot_qdot, 1e-5));
+    }
+
+    Eigen::MatrixXd cmm(6, 1);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, chainsolver.JntToCentroidalMomentumMatrix(JntArray(motomansia10dyn.getNrOfJoints()), cmm));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, treesolver.JntToCentroidalMomentumMatrix(JntArray(tree.getNrOfJoints()), cmm));
+}
+
+void SolverTest::PointJacTest()
+{
+    std::cout<<"Point Jacobian Test"<<std::endl;
+    double eps=1e-12;
+
+    // Chain: every point has the jacobian of its segment tip with the
+    // reference point moved to the point
+    unsigned int nj = kukaLWR.getNrOfJoints();
+    ChainJntToJacSolver jacsolver(kukaLWR);
+    ChainFkSolverPos_recursive fksolver(kukaLWR);
+    ChainJntToPointJacSolver pointjacsolver(kukaLWR);
+    JntArray q(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    std::vector<unsigned int> seg_nrs;
+    std::vector<Vector> points;
+    for(unsigned int i=0; i<=kukaLWR.getNrOfSegments(); i++)
+    {
+        seg_nrs.push_back(i);
+        points.push_back(Vector(0.01*i, 0.05, -0.02*i));
+        seg_nrs.push_back(i);
+        points.push_back(Vector(-0.03, 0.02*i, 0.1));
+    }
+    std::vector<Jacobian> jacs(points.size(), Jacobian(nj));
+    Eigen::MatrixXd stacked(6*points.size(), nj), stacked_vel(3*points.size(), nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, pointjacsolver.JntToJac(q, seg_nrs, points, jacs));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, pointjacsolver.JntToJac(q, seg_nrs, points, stacked));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, pointjacsolver.JntToJac(q, seg_nrs, points, stacked_vel));
+    Jacobian jac(nj), jac_point(nj);
+    Frame f;
+    for(unsigned int k=0; k<points.size(); k++)
+    {
+        jacsolver.JntToJac(q, jac, seg_nrs[k]);
+        fksolver.JntToCart(q, f, seg_nrs[k]);
+        changeRefPoint(jac, f.M*points[k], jac_point);
+        CPPUNIT_ASSERT(Equal(jac_point, jacs[k], eps));
+        CPPUNIT_ASSERT((jac_point.data - stacked.middleRows(6*k, 6)).isZero(eps));
+        CPPUNIT_ASSERT((jac_point.data.topRows(3) - stacked_vel.middleRows(3*k, 3)).isZero(eps));
+    }
+    seg_nrs[0] = kukaLWR.getNrOfSegments()+1;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_OUT_OF_RANGE, pointjacsolver.JntToJac(q, seg_nrs, points, jacs));
+    Eigen::MatrixXd wrong(4*points.size(), nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, pointjacsolver.JntToJac(q, seg_nrs, points, wrong));
+
+    // Tree: the same with the jacobians of the tree solver
+    Tree tree("base");
+    CPPUNIT_ASSERT(tree.addSegment(Segment("torso", Joint("waist", Joint::RotZ), Frame(Vector(0.0,0.0,0.5))), "base"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left", Joint("left_shoulder", Joint::Spherical), Frame(Vector(0.0,0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left_hand", Joint("left_wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0))), "left"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right", Joint("right_shoulder", Joint::RotY), Frame(Vector(0.0,-0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right_hand", Joint("right_wrist", Joint::TransX), Frame(Vector(0.3,0.0,0.0))), "right"));
+    nj = tree.getNrOfJoints();
+    TreeJntToJacSolver treejacsolver(tree);
+    TreeFkSolverPos_recursive treefksolver(tree);
+    TreeJntToPointJacSolver treepointjacsolver(tree);
+    JntArray q_tree(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q_tree(i));
+    const char* names[] = {"base", "left_hand", "right_hand", "left", "left_hand"};
+    std::vector<unsigned int> segments;
+    points.clear();
+    for(unsigned int k=0; k<5; k++)
+    {
+        segments.push_back(treepointjacsolver.getSegmentIndex(names[k]));
+        points.push_back(Vector(0.05, -0.01*k, 0.02));
+    }
+    jacs.assign(points.size(), Jacobian(nj));
+    stacked.resize(6*points.size(), nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treepointjacsolver.JntToJac(q_tree, segments, points, jacs));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treepointjacsolver.JntToJac(q_tree, segments, points, stacked));
+    jac.resize(nj);
+    jac_point.resize(nj);
+    for(unsigned int k=0; k<points.size(); k++)
+    {
+        treejacsolver.JntToJac(q_tree, jac, names[k]);
+        treefksolver.JntToCart(q_tree, f, names[k]);
+        changeRefPoint(jac, f.M*points[k], jac_point);
+        CPPUNIT_ASSERT(Equal(jac_point, jacs[k], eps));
+        CPPUNIT_ASSERT((jac_point.data - stacked.middleRows(6*k, 6)).isZero(eps));
+    }
+    CPPUNIT_ASSERT_EQUAL(-1, treepointjacsolver.getSegmentIndex("foot"));
+}
+
+void SolverTest::CalibrationTest()
+{
+    std::cout<<"Calibration Test"<<std::endl;
+    double eps=1e-6;
+    double h=1e-5;
+
+    Chain nominal;
+    nominal.addSegment(Segment("link0", Joint("j0", Joint::RotZ), Frame(Rotation::RPY(0.1,0.0,0.2), Vector(0.0,0.0,0.3))));
+    nominal.addSegment(Segment("link1", Joint("j1", Joint::TransX, 1.0, 0.1), Frame(Vector(0.1,0.2,0.0))));
+    nominal.addSegment(Segment("link2", Joint("j2", Vector(0.0,0.05,0.0), Vector(1.0,1.0,0.0), Joint::RotAxis), Frame(Vector(0.4,0.0,0.0))));
+    nominal.addSegment(Segment("link3", Joint("j3", Joint::Fixed), Frame(Rotation::RotY(0.5), Vector(0.0,0.1,0.0))));
+    nominal.addSegment(Segment("link4", Joint("j4", Joint::RotY, 2.0, -0.3), Frame(Vector(0.0,0.0,0.2))));
+    unsigned int nj = nominal.getNrOfJoints();
+
+    ChainCalibrationSolver solver(nominal);
+    CPPUNIT_ASSERT_EQUAL(4*7u+6u, solver.getNrOfParameters());
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, solver.setParameters(3, ChainCalibrationSolver::JOINT_OFFSET));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_OUT_OF_RANGE, solver.setParameters(5, ChainCalibrationSolver::TIP_FRAME));
+    int all = ChainCalibrationSolver::TIP_FRAME | ChainCalibrationSolver::JOINT_OFFSET | ChainCalibrationSolver::JOINT_AXIS;
+    for(unsigned int i=0; i<nominal.getNrOfSegments(); i++)
+        if(i!=3)
+            CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.setParameters(i, all));
+    unsigned int np = solver.getNrOfParameters();
+    CPPUNIT_ASSERT_EQUAL(4*9u+6u, np);
+
+    // The Jacobian against finite differences of updated chains
+    JntArray q(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    Frame pose, pose_plus, pose_min;
+    Eigen::MatrixXd jac(6, np);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToParamJac(q, pose, jac));
+    for(unsigned int p=0; p<np; p++)
+    {
+        Chain plus(nominal), min(nominal);
+        ChainCalibrationSolver solver_plus(plus), solver_min(min);
+        for(unsigned int i=0; i<nominal.getNrOfSegments(); i++)
+            if(i!=3)
+            {
+                solver_plus.setParameters(i, all);
+                solver_min.setParameters(i, all);
+            }
+        Eigen::VectorXd delta = Eigen::VectorXd::Zero(np);
+        delta(p) = h;
+        solver_plus.updateChain(delta);
+        solver_min.updateChain(-delta);
+        ChainFkSolverPos_recursive(plus).JntToCart(q, pose_plus);
+        ChainFkSolverPos_recursive(min).JntToCart(q, pose_min);
+        // the rotation is taken from the skew part, diff() truncates
+        // rotations this small
+        Rotation R = pose_plus.M*pose_min.M.Inverse();
+        Twist t((pose_plus.p - pose_min.p)/(2*h),
+                Vector(R(2,1) - R(1,2), R(0,2) - R(2,0), R(1,0) - R(0,1))/(4*h));
+        for(unsigned int r=0; r<6; r++)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(t(r), jac(r, p), eps);
+    }
+
+    // Measurements of a perturbed chain are reproduced after calibration
+    Chain real(nominal);
+    ChainCalibrationSolver solver_real(real);
+    for(unsigned int i=0; i<real.getNrOfSegments(); i++)
+        if(i!=3)
+            solver_real.setParameters(i, all);
+    Eigen::VectorXd delta(np);
+    for(unsigned int p=0; p<np; p++)
+        random(delta(p));
+    solver_real.updateChain(0.05*delta);
+    ChainFkSolverPos_recursive fksolver_real(real), fksolver(nominal);
+    std::vector<JntArray> qs(40, JntArray(nj));
+    std::vector<Frame> measured(qs.size());
+    for(unsigned int s=0; s<qs.size(); s++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+            random(qs[s](i));
+        fksolver_real.JntToCart(qs[s], measured[s]);
+    }
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.calibrate(qs, measured));
+    CPPUNIT_ASSERT(solver.getResidual() < 1e-9);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    fksolver_real.JntToCart(q, pose_plus);
+    fksolver.JntToCart(q, pose);
+    CPPUNIT_ASSERT(Equal(pose_plus, pose, 1e-8));
+
+    std::vector<Frame> too_few(1);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.identify(qs, too_few, delta));
+
+    // Samples split over threads give the same update
+    Chain perturbed(nominal);
+    ChainCalibrationSolver solver_serial(perturbed), solver_threads(perturbed, 4);
+    CPPUNIT_ASSERT_EQUAL(4u, solver_threads.getNrOfThreads());
+    for(unsigned int i=0; i<perturbed.getNrOfSegments(); i++)
+        if(i!=3)
+        {
+            solver_serial.setParameters(i, all);
+            solver_threads.setParameters(i, all);
+        }
+    solver_serial.updateChain(0.05*delta);
+    qs.resize(1000, JntArray(nj));
+    measured.resize(qs.size());
+    for(unsigned int s=0; s<qs.size(); s++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+            random(qs[s](i));
+        fksolver_real.JntToCart(qs[s], measured[s]);
+    }
+    Eigen::VectorXd delta_serial(np), delta_threads(np);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver_serial.identify(qs, measured, delta_serial));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver_threads.identify(qs, measured, delta_threads));
+    CPPUNIT_ASSERT(delta_serial.norm() > 1e-3);
+    CPPUNIT_ASSERT((delta_serial - delta_threads).norm() < 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(solver_serial.getResidual(), solver_threads.getResidual(), 1e-12);
+    qs[500] = JntArray(nj+1);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver_threads.identify(qs, measured, delta_threads));
+}
+
+void SolverTest::MaskedIkTest()
+{
+    std::cout<<"Masked IK Test"<<std::endl;
+    double eps=1e-6;
+
+    // A 5 DOF arm without tool roll: poses rotated about the tool axis
+    // can not be reached, but their position and tool axis can
+    Chain arm;
+    arm.addSegment(Segment(Joint(Joint::RotZ), Frame(Vector(0.0,0.0,0.3))));
+    arm.addSegment(Segment(Joint(Joint::RotY), Frame(Vector(0.0,0.0,0.4))));
+    arm.addSegment(Segment(Joint(Joint::RotY), Frame(Vector(0.0,0.0,0.35))));
+    arm.addSegment(Segment(Joint(Joint::RotX), Frame(Vector(0.0,0.0,0.1))));
+    arm.addSegment(Segment(Joint(Joint::RotY), Frame(Vector(0.0,0.0,0.12))));
+    unsigned int nj = arm.getNrOfJoints();
+    ChainFkSolverPos_recursive fksolver(arm);
+    ChainIkSolverVel_pinv iksolvervel(arm);
+    ChainIkSolverPos_NR iksolver6d(arm, fksolver, iksolvervel, 100, eps);
+    ChainIkSolverPos_Masked iksolver(arm, TaskMask::FreeToolZ(), 100, eps);
+    CPPUNIT_ASSERT_EQUAL(5u, iksolver.getTaskMask().getNrOfRows());
+
+    // fixed targets, the solver starts from a nearby configuration
+    const unsigned int nr_targets = 10;
+    double q_targets[nr_targets][5] = {
+        { 0.0,  0.5,  0.8,  0.3,  0.6},
+        { 1.2, -0.4,  1.1, -0.6,  0.4},
+        {-0.8,  0.9, -0.5,  1.0, -0.7},
+        { 2.1,  0.2,  0.6,  0.4, -0.5},
+        {-1.9, -0.7,  1.3, -0.2,  0.9},
+        { 0.4,  1.1, -1.0,  0.7,  0.3},
+        {-0.3, -1.2,  0.4, -1.1, -0.4},
+        { 2.8,  0.6,  0.9,  0.5,  0.8},
+        {-2.5,  0.3, -1.2, -0.9,  0.5},
+        { 0.9, -0.9,  0.7,  1.2, -0.8}};
+    JntArray q_target(nj), q_init(nj), q_out(nj);
+    Frame f_target, f_out;
+    unsigned int solved = 0, solved6d = 0;
+    for(unsigned int trial=0; trial<nr_targets; trial++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+        {
+            q_target(i) = q_targets[trial][i];
+            q_init(i) = q_target(i) + 0.3;
+        }
+        fksolver.JntToCart(q_target, f_target);
+        f_target.M = f_target.M*Rotation::RotZ(0.8);
+        if(iksolver6d.CartToJnt(q_init, f_target, q_out) >= 0)
+            solved6d++;
+        if(iksolver.CartToJnt(q_init, f_target, q_out) >= 0)
+        {
+            solved++;
+            fksolver.JntToCart(q_out, f_out);
+            CPPUNIT_ASSERT(Equal(f_target.p, f_out.p, 1e-5));
+            CPPUNIT_ASSERT(Equal(f_target.M.UnitZ(), f_out.M.UnitZ(), 1e-5));
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(0u, solved6d);
+    CPPUNIT_ASSERT_EQUAL(nr_targets, solved);
+
+    // A tool axis opposite to the one of the target is not aligned yet
+    fksolver.JntToCart(q_init, f_target);
+    f_target.M = f_target.M*Rotation::RotX(PI);
+    CPPUNIT_ASSERT(iksolver.CartToJnt(q_init, f_target, q_out) >= 0);
+    fksolver.JntToCart(q_out, f_out);
+    CPPUNIT_ASSERT(Equal(f_target.p, f_out.p, 1e-5));
+    CPPUNIT_ASSERT(Equal(f_target.M.UnitZ(), f_out.M.UnitZ(), 1e-5));
+
+    // Position only
+    iksolver.setTaskMask(TaskMask::Position());
+    fksolver.JntToCart(q_target, f_target);
+    f_target.M = Rotation::RPY(0.3,-0.2,1.0);
+    CPPUNIT_ASSERT(iksolver.CartToJnt(q_init, f_target, q_out) >= 0);
+    fksolver.JntToCart(q_out, f_out);
+    CPPUNIT_ASSERT(Equal(f_target.p, f_out.p, 1e-5));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, iksolver.CartToJnt(JntArray(nj+1), f_target, q_out));
+
+    // Tree: the positions of two hands
+    Tree tree("base");
+    CPPUNIT_ASSERT(tree.addSegment(Segment("torso", Joint("waist", Joint::RotZ), Frame(Vector(0.0,0.0,0.5))), "base"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left", Joint("left_shoulder", Joint::RotY), Frame(Vector(0.0,0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left_elbow", Joint("left_elbow_joint", Joint::RotX), Frame(Vector(0.3,0.0,0.0))), "left"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("left_hand", Joint("left_wrist", Joint::RotY), Frame(Vector(0.3,0.0,0.0))), "left_elbow"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right", Joint("right_shoulder", Joint::RotY), Frame(Vector(0.0,-0.2,0.0))), "torso"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right_elbow", Joint("right_elbow_joint", Joint::RotX), Frame(Vector(0.3,0.0,0.0))), "right"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("right_hand", Joint("right_wrist", Joint::RotY), Frame(Vector(0.3,0.0,0.0))), "right_elbow"));
+    std::vector<std::string> endpoints;
+    endpoints.push_back("left_hand");
+    endpoints.push_back("right_hand");
+    std::vector<TaskMask> masks(2, TaskMask::Position());
+    TreeIkSolverPos_Masked treeiksolver(tree, endpoints, masks, 100, eps);
+    TreeFkSolverPos_recursive treefksolver(tree);
+    nj = tree.getNrOfJoints();
+    JntArray q_tree(nj), q_tree_init(nj), q_tree_out(nj);
+    // the elbows only move the hands when the wrists are bent
+    double q_tree_values[] = {0.3, -0.5, 0.4, 0.8, 0.6, -0.3, -0.7};
+    for(unsigned int i=0; i<nj; i++)
+    {
+        q_tree(i) = q_tree_values[i];
+        q_tree_init(i) = q_tree(i) + 0.2;
+    }
+    Frames targets;
+    for(unsigned int k=0; k<endpoints.size(); k++)
+    {
+        treefksolver.JntToCart(q_tree, f_target, endpoints[k]);
+        f_target.M = Rotation::Identity();
+        targets[endpoints[k]] = f_target;
+    }
+    CPPUNIT_ASSERT(treeiksolver.CartToJnt(q_tree_init, targets, q_tree_out) >= 0);
+    for(unsigned int k=0; k<endpoints.size(); k++)
+    {
+        treefksolver.JntToCart(q_tree_out, f_out, endpoints[k]);
+        CPPUNIT_ASSERT(Equal(targets[endpoints[k]].p, f_out.p, 1e-5));
+    }
+    targets["foot"] = Frame::Identity();
+    CPPUNIT_ASSERT_EQUAL(-2.0, treeiksolver.CartToJnt(q_tree_init, targets, q_tree_out));
+
+    // The opposite tool axis for a tree, only the axis of a hand is given
+    std::vector<std::string> hand(1, "left_hand");
+    std::vector<TaskMask> axis_mask(1, TaskMask(false, false, false, true, true, false, TaskMask::TARGET));
+    TreeIkSolverPos_Masked treeaxissolver(tree, hand, axis_mask, 100, eps);
+    Frames axis_target;
+    treefksolver.JntToCart(q_tree_init, f_target, "left_hand");
+    f_target.M = f_target.M*Rotation::RotX(PI);
+    axis_target["left_hand"] = f_target;
+    CPPUNIT_ASSERT(treeaxissolver.CartToJnt(q_tree_init, axis_target, q_tree_out) >= 0);
+    treefksolver.JntToCart(q_tree_out, f_out, "left_hand");
+    CPPUNIT_ASSERT(Equal(f_target.M.UnitZ(), f_out.M.UnitZ(), 1e-5));
+}
+
+void SolverTest::BroydenIkTest()
+{
+    std::cout<<"Broyden IK Test"<<std::endl;
+    double eps=1e-6;
+
+    ChainFkSolverPos_recursive fksolver(kukaLWR);
+    ChainIkSolverPos_Masked exact(kukaLWR, TaskMask(), 100, eps);
+    ChainIkSolverPos_Masked broyden(kukaLWR, TaskMask(), 100, eps);
+    broyden.setBroydenUpdates(5);
+    CPPUNIT_ASSERT_EQUAL(5u, broyden.getBroydenUpdates());
+
+    unsigned int nj = kukaLWR.getNrOfJoints();
+    JntArray q_target(nj), q_init(nj), q_out(nj);
+    Frame f_target, f_out;
+    unsigned int jacobians_exact = 0, jacobians_broyden = 0;
+    for(unsigned int trial=0; trial<50; trial++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+        {
+            random(q_target(i));
+            q_init(i) = q_target(i) + 0.1;
+        }
+        fksolver.JntToCart(q_target, f_target);
+
+        CPPUNIT_ASSERT(exact.CartToJnt(q_init, f_target, q_out) >= 0);
+        CPPUNIT_ASSERT_EQUAL(exact.getNrOfIterations(), exact.getNrOfJacobians());
+        jacobians_exact += exact.getNrOfJacobians();
+
+        CPPUNIT_ASSERT(broyden.CartToJnt(q_init, f_target, q_out) >= 0);
+        CPPUNIT_ASSERT(broyden.getNrOfJacobians() < broyden.getNrOfIterations());
+        jacobians_broyden += broyden.getNrOfJacobians();
+        fksolver.JntToCart(q_out, f_out);
+        CPPUNIT_ASSERT(Equal(f_target, f_out, 1e-5));
+    }
+    CPPUNIT_ASSERT(jacobians_broyden < jacobians_exact);
+
+    // The maximum number of iterations is still respected
+    ChainIkSolverPos_Masked limited(kukaLWR, TaskMask(), 2, eps);
+    limited.setBroydenUpdates(5);
+    for(unsigned int i=0; i<nj; i++)
+        q_init(i) = q_target(i) + 0.5;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_MAX_ITERATIONS_EXCEEDED, limited.CartToJnt(q_init, f_target, q_out));
+    CPPUNIT_ASSERT_EQUAL(2u, limited.getNrOfIterations());
+}
+
+void SolverTest::SnsIkVelTest()
+{
+    std::cout<<"SNS IK Vel Test"<<std::endl;
+    double eps=1e-8;
+    double dt=0.01;
+
+    unsigned int nj = kukaLWR.getNrOfJoints();
+    JntArray q_min(nj), q_max(nj), v_max(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        q_min(i) = -2.5;
+        q_max(i) = 2.5;
+        v_max(i) = 0.5;
+    }
+    ChainIkSolverVel_sns sns(kukaLWR, q_min, q_max, v_max, dt);
+    ChainIkSolverVel_pinv pinv(kukaLWR);
+    ChainJntToJacSolver jacsolver(kukaLWR);
+    Jacobian jac(nj);
+    JntArray q(nj), qdot(nj), qdot_pinv(nj);
+    Twist v, v_out;
+
+    // Within the limits the solution is the pseudo-inverse solution
+    for(unsigned int i=0; i<nj; i++)
+        q(i) = (i%2 ? 0.6 : -0.3);
+    v = Twist(Vector(0.01,-0.02,0.01), Vector(0.0,0.02,0.01));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, sns.CartToJnt(q, v, qdot));
+    CPPUNIT_ASSERT_EQUAL(1.0, sns.getTaskScale());
+    CPPUNIT_ASSERT_EQUAL(0u, sns.getNrOfSaturatedJoints());
+    pinv.CartToJnt(q, v, qdot_pinv);
+    CPPUNIT_ASSERT(Equal(qdot, qdot_pinv, 1e-6));
+
+    // Large commands: the bounds hold, the direction of the twist is
+    // kept and a larger part of it is realized than by scaling the
+    // pseudo-inverse solution as a whole
+    double sum_sns = 0.0, sum_uniform = 0.0;
+    for(unsigned int trial=0; trial<20; trial++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+            random(q(i));
+        for(unsigned int i=0; i<6; i++)
+            random(v[i]);
+        int ret = sns.CartToJnt(q, v, qdot);
+        CPPUNIT_ASSERT(ret >= 0);
+        for(unsigned int i=0; i<nj; i++)
+            CPPUNIT_ASSERT(fabs(qdot(i)) <= v_max(i) + eps);
+        jacsolver.JntToJac(q, jac);
+        pinv.CartToJnt(q, v, qdot_pinv);
+        MultiplyJacobian(jac, qdot_pinv, v_out);
+        if(Equal(v, v_out, 1e-6))
+        {
+            // not singular
+            MultiplyJacobian(jac, qdot, v_out);
+            CPPUNIT_ASSERT(Equal(v*sns.getTaskScale(), v_out, 1e-6));
+        }
+        double ratio = 1.0;
+        for(unsigned int i=0; i<nj; i++)
+            ratio = std::max(ratio, fabs(qdot_pinv(i))/v_max(i));
+        sum_sns += sns.getTaskScale();
+        sum_uniform += 1.0/ratio;
+        CPPUNIT_ASSERT(sns.getTaskScale() >= 1.0/ratio - 1e-6);
+    }
+    CPPUNIT_ASSERT(sum_sns > sum_uniform);
+
+    // A joint at its upper position limit can only move back
+    for(unsigned int i=0; i<nj; i++)
+        q(i) = 0.3;
+    q(3) = q_max(3);
+    v = Twist(Vector(0.05,0.0,0.05), Vector(0.0,0.0,0.0));
+    CPPUNIT_ASSERT(sns.CartToJnt(q, v, qdot) >= 0);
+    CPPUNIT_ASSERT(qdot(3) <= eps);
+    v = -v;
+    CPPUNIT_ASSERT(sns.CartToJnt(q, v, qdot) >= 0);
+    CPPUNIT_ASSERT(qdot(3) <= eps);
+
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, sns.setVelocityLimits(JntArray(nj+1)));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, sns.CartToJnt(JntArray(nj+1), v, qdot));
+}
+
+void SolverTest::FloatingBaseDynTest()
+{
+    std::cout<<"Floating Base Dynamics Test"<<std::endl;
+    double eps=1e-9;
+
+    Tree tree("root");
+    CPPUNIT_ASSERT(tree.addSegment(Segment("pelvis", Joint("pelvis_fixed", Joint::Fixed), Frame(Vector(0.0,0.0,0.1)),
+                                           RigidBodyInertia(5.0, Vector(0.0,0.0,0.05), RotationalInertia(0.1,0.1,0.05))), "root"));
+    std::string parent = "pelvis";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::Spherical), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), "pelvis"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "arm"));
+
+    Vector grav(0.0,0.0,-9.81);
+    TreeDynSolver_FloatingBase solver(tree, grav);
+    TreeIdSolver_RNE fixedsolver(tree, grav);
+    TreeCentroidalSolver centroidalsolver(tree);
+    unsigned int nj = tree.getNrOfJoints();
+    JntArray q(nj), q_dot(nj), q_dotdot(nj), torques(nj), torques_fixed(nj), bias(nj), zero(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(q_dot(i));
+        random(q_dotdot(i));
+    }
+    WrenchMap f_ext;
+    f_ext["hand"] = Wrench(Vector(1.0,-2.0,0.5), Vector(0.1,0.2,-0.3));
+    Wrench f_base, f_bias;
+
+    // A base at rest in the world frame is a fixed base
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.CartToJnt(Rotation::Identity(), Twist::Zero(), Twist::Zero(), q, q_dot, q_dotdot, f_ext, f_base, torques));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, fixedsolver.CartToJnt(q, q_dot, q_dotdot, f_ext, torques_fixed));
+    CPPUNIT_ASSERT(Equal(torques, torques_fixed, eps));
+
+    // Holding the tree in place takes its weight
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.CartToJnt(Rotation::RotX(0.4), Twist::Zero(), Twist::Zero(), q, zero, zero, WrenchMap(), f_base, torques));
+    CPPUNIT_ASSERT(Equal(f_base.force, -centroidalsolver.getMass()*Rotation::RotX(0.4).Inverse(grav), eps));
+
+    // Inverse dynamics = mass matrix * accelerations + bias forces
+    Rotation R_base = Rotation::RPY(0.3,-0.5,1.2);
+    Twist v_base(Vector(0.2,-0.1,0.4), Vector(0.5,0.3,-0.2));
+    Twist a_base(Vector(-1.0,0.5,0.2), Vector(0.1,-0.7,0.4));
+    JntSpaceInertiaMatrix H(6+nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToMass(q, H));
+    CPPUNIT_ASSERT(H.data.isApprox(H.data.transpose(), eps));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(centroidalsolver.getMass(), H(0,0), eps);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.CartToJnt(R_base, v_base, a_base, q, q_dot, q_dotdot, WrenchMap(), f_base, torques));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToBias(R_base, v_base, q, q_dot, f_bias, bias));
+    Eigen::VectorXd acc(6+nj), force(6+nj);
+    for(unsigned int r=0; r<6; r++)
+    {
+        acc(r) = a_base(r);
+        force(r) = f_base(r) - f_bias(r);
+    }
+    acc.tail(nj) = q_dotdot.data;
+    force.tail(nj) = torques.data - bias.data;
+    CPPUNIT_ASSERT((H.data*acc - force).isZero(1e-8));
+
+    // The base rows are the momentum matrix about the root
+    Eigen::MatrixXd cmm(6, nj);
+    Vector com;
+    centroidalsolver.JntToCentroidalMomentumMatrix(q, cmm);
+    centroidalsolver.JntToCoM(q, com);
+    for(unsigned int c=0; c<nj; c++)
+    {
+        Wrench h(Vector(H(0,6+c), H(1,6+c), H(2,6+c)), Vector(H(3,6+c), H(4,6+c), H(5,6+c)));
+        h = h.RefPoint(com);
+        for(unsigned int r=0; r<6; r++)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(cmm(r,c), h(r), eps);
+    }
+
+    JntSpaceInertiaMatrix H_small(nj);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToMass(q, H_small));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToBias(R_base, v_base, JntArray(nj+1), q_dot, f_bias, bias));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("extra", Joint("extra_joint", Joint::RotZ)), "hand"));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_UP_TO_DATE, solver.JntToMass(q, H));
+}
+
+void SolverTest::GravitySolverTest()
+{
+    std::cout<<"Gravity Solver Test"<<std::endl;
+    double eps=1e-10;
+    Vector grav(0.3,-1.2,-9.81);
+
+    // Chains against ChainDynParam
+    Chain* chains[] = {&chaindyn, &motomansia10dyn, &kukaLWR};
+    for(unsigned int c=0; c<3; c++)
+    {
+        unsigned int nj = chains[c]->getNrOfJoints();
+        ChainIdSolver_Gravity solver(*chains[c], grav);
+        ChainDynParam dynparam(*chains[c], grav);
+        JntArray q(nj), gravity(nj), gravity_ref(nj);
+        for(unsigned int i=0; i<nj; i++)
+            random(q(i));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToGravity(q, gravity));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToGravity(q, gravity_ref));
+        CPPUNIT_ASSERT(Equal(gravity, gravity_ref, eps));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToGravity(JntArray(nj+1), gravity));
+    }
+
+    // A tree with a multi-DOF joint and a coupled joint against TreeIdSolver_RNE
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::Spherical), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), "link2"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "arm"));
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("finger", Joint("finger_joint", Joint::RotY, 0.5), Frame(Vector(0.1,0.0,0.0)),
+                                                  RigidBodyInertia(0.2, Vector(0.05,0.0,0.0))), "hand",
+                                          GetTreeElementQNr(tree.getSegment("hand")->second)));
+    unsigned int nj = tree.getNrOfJoints();
+    TreeIdSolver_Gravity treesolver(tree, grav);
+    TreeIdSolver_RNE rnesolver(tree, grav);
+    JntArray q(nj), zero(nj), gravity(nj), gravity_ref(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToGravity(q, gravity));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, rnesolver.CartToJnt(q, zero, zero, WrenchMap(), gravity_ref));
+    CPPUNIT_ASSERT(Equal(gravity, gravity_ref, eps));
+
+    treesolver.setGravity(Vector::Zero());
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToGravity(q, gravity));
+    CPPUNIT_ASSERT(Equal(gravity, zero, eps));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("extra", Joint("extra_joint", Joint::RotZ)), "hand"));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_UP_TO_DATE, treesolver.JntToGravity(q, gravity));
+}
+
+void SolverTest::CoriolisMatrixTest()
+{
+    std::cout<<"Coriolis Matrix Test"<<std::endl;
+    double eps=1e-9;
+    double h=1e-6;
+
+    // Chains against ChainDynParam and a finite difference of the mass matrix
+    Chain* chains[] = {&chaindyn, &motomansia10dyn, &kukaLWR};
+    for(unsigned int c=0; c<3; c++)
+    {
+        unsigned int nj = chains[c]->getNrOfJoints();
+        ChainCoriolisSolver solver(*chains[c]);
+        ChainDynParam dynparam(*chains[c], Vector::Zero());
+        JntArray q(nj), qd(nj), coriolis(nj), coriolis_ref(nj), q_plus(nj), q_min(nj);
+        JntSpaceInertiaMatrix H(nj), H_ref(nj), H_plus(nj), H_min(nj);
+        Eigen::MatrixXd C(nj,nj), H_dot(nj,nj);
+        for(unsigned int i=0; i<nj; i++)
+        {
+            random(q(i));
+            random(qd(i));
+        }
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToMassAndCoriolis(q, qd, H, C));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToCoriolis(q, qd, coriolis_ref));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToMass(q, H_ref));
+        coriolis.data = C*qd.data;
+        CPPUNIT_ASSERT(Equal(coriolis, coriolis_ref, eps));
+        CPPUNIT_ASSERT(Equal(H, H_ref, eps));
+
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToMassDot(q, qd, H_dot));
+        for(unsigned int i=0; i<nj; i++)
+        {
+            q_plus(i) = q(i) + h*qd(i);
+            q_min(i) = q(i) - h*qd(i);
+        }
+        dynparam.JntToMass(q_plus, H_plus);
+        dynparam.JntToMass(q_min, H_min);
+        CPPUNIT_ASSERT((H_dot - (H_plus.data - H_min.data)/(2*h)).norm() < 1e-6);
+        // Hdot - 2C is skew-symmetric
+        Eigen::MatrixXd N = H_dot - 2*C;
+        CPPUNIT_ASSERT((N + N.transpose()).norm() < eps);
+
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToCoriolisMatrix(q, qd, C));
+        coriolis.data = C*qd.data;
+        CPPUNIT_ASSERT(Equal(coriolis, coriolis_ref, eps));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToCoriolisMatrix(JntArray(nj+1), qd, C));
+    }
+
+    // A branched tree with a coupled joint against TreeIdSolver_RNE
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::RotZ), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), "link2"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "arm"));
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("finger", Joint("finger_joint", Joint::RotY, 0.5), Frame(Vector(0.1,0.0,0.0)),
+                                                  RigidBodyInertia(0.2, Vector(0.05,0.0,0.0))), "hand",
+                                          GetTreeElementQNr(tree.getSegment("arm")->second)));
+    unsigned int nj = tree.getNrOfJoints();
+    TreeCoriolisSolver treesolver(tree);
+    TreeIdSolver_RNE rnesolver(tree, Vector::Zero());
+    JntArray q(nj), qd(nj), zero(nj), unit(nj), coriolis(nj), torques(nj);
+    JntSpaceInertiaMatrix H(nj);
+    Eigen::MatrixXd C(nj,nj), H_dot(nj,nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qd(i));
+    }
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToMassAndCoriolis(q, qd, H, C));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, rnesolver.CartToJnt(q, qd, zero, WrenchMap(), torques));
+    coriolis.data = C*qd.data;
+    CPPUNIT_ASSERT(Equal(coriolis, torques, eps));
+    for(unsigned int i=0; i<nj; i++)
+    {
+        SetToZero(unit);
+        unit(i) = 1.0;
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, rnesolver.CartToJnt(q, zero, unit, WrenchMap(), torques));
+        CPPUNIT_ASSERT((H.data.col(i) - torques.data).norm() < eps);
+    }
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToMassDot(q, qd, H_dot));
+    Eigen::MatrixXd N = H_dot - 2*C;
+    CPPUNIT_ASSERT((N + N.transpose()).norm() < eps);
+
+    // Multi-DOF joints are not supported
+    CPPUNIT_ASSERT(tree.addSegment(Segment("ball", Joint("ball_joint", Joint::Spherical)), "hand"));
+    treesolver.updateInternalDataStructures();
+    JntArray q_ball(tree.getNrOfJoints());
+    Eigen::MatrixXd C_ball(tree.getNrOfJoints(), tree.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, treesolver.JntToCoriolisMatrix(q_ball, q_ball, C_ball));
+}
+
+void SolverTest::MassInverseTest()
+{
+    std::cout<<"Mass Inverse Test"<<std::endl;
+    double eps=1e-8;
+
+    // Chains against the inverse of ChainDynParam::JntToMass
+    Chain* chains[] = {&chaindyn, &motomansia10dyn, &kukaLWR};
+    for(unsigned int c=0; c<3; c++)
+    {
+        unsigned int nj = chains[c]->getNrOfJoints();
+        ChainMassInverseSolver solver(*chains[c]);
+        ChainDynParam dynparam(*chains[c], Vector::Zero());
+        JntArray q(nj);
+        JntSpaceInertiaMatrix H(nj), H_inv(nj);
+        for(unsigned int i=0; i<nj; i++)
+            random(q(i));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToMassInverse(q, H_inv));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, dynparam.JntToMass(q, H));
+        CPPUNIT_ASSERT((H_inv.data*H.data - Eigen::MatrixXd::Identity(nj,nj)).norm() < eps);
+        CPPUNIT_ASSERT((H_inv.data - H_inv.data.transpose()).norm() == 0.0);
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToMassInverse(JntArray(nj+1), H_inv));
+    }
+
+    // A branched tree, of which the joints are not numbered depth-first,
+    // against the inverse of the mass matrix from TreeIdSolver_RNE
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::RotZ, 1.0, 0.0, 0.1), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), "link2"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("mount", Joint("mount_joint", Joint::Fixed), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.3, Vector(0.02,0.0,0.0))), "arm"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::TransX), Frame(Vector(0.1,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "mount"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("thumb", Joint("thumb_joint", Joint::RotY), Frame(Vector(0.0,0.1,0.0)),
+                                           RigidBodyInertia(0.2, Vector(0.05,0.0,0.0))), "mount"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("tool", Joint("tool_joint", Joint::RotX), Frame(Vector(0.0,0.0,0.1)),
+                                           RigidBodyInertia(0.4, Vector(0.0,0.0,0.05))), parent));
+    unsigned int nj = tree.getNrOfJoints();
+    TreeMassInverseSolver treesolver(tree);
+    TreeIdSolver_RNE rnesolver(tree, Vector::Zero());
+    JntArray q(nj), zero(nj), unit(nj), torques(nj);
+    JntSpaceInertiaMatrix H(nj), H_inv(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    for(unsigned int i=0; i<nj; i++)
+    {
+        SetToZero(unit);
+        unit(i) = 1.0;
+        rnesolver.CartToJnt(q, zero, unit, WrenchMap(), torques);
+        H.data.col(i) = torques.data;
+    }
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToMassInverse(q, H_inv));
+    CPPUNIT_ASSERT((H_inv.data*H.data - Eigen::MatrixXd::Identity(nj,nj)).norm() < eps);
+
+    // Coupled joints are not supported
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("finger", Joint("finger_joint", Joint::RotY, 0.5)), "hand",
+                                          GetTreeElementQNr(tree.getSegment("hand")->second)));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_UP_TO_DATE, treesolver.JntToMassInverse(q, H_inv));
+    treesolver.updateInternalDataStructures();
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, treesolver.JntToMassInverse(q, H_inv));
+}
+
+void SolverTest::EnergySolverTest()
+{
+    std::cout<<"Energy Solver Test"<<std::endl;
+    double eps=1e-9;
+    double h=1e-6;
+    Vector grav(0.3,-1.2,-9.81);
+
+    // Chains against the mass matrix, the gravity torques and ChainIdSolver_RNE
+    Chain* chains[] = {&chaindyn, &motomansia10dyn, &kukaLWR};
+    for(unsigned int c=0; c<3; c++)
+    {
+        unsigned int nj = chains[c]->getNrOfJoints();
+        unsigned int ns = chains[c]->getNrOfSegments();
+        ChainEnergySolver solver(*chains[c], grav);
+        ChainDynParam dynparam(*chains[c], grav);
+        ChainIdSolver_RNE rnesolver(*chains[c], grav);
+        JntArray q(nj), qd(nj), qdd(nj), zero(nj), gravity(nj), torques(nj), q_plus(nj), q_min(nj);
+        JntSpaceInertiaMatrix H(nj);
+        for(unsigned int i=0; i<nj; i++)
+        {
+            random(q(i));
+            random(qd(i));
+            random(qdd(i));
+        }
+        double kinetic, potential, kinetic_plus, kinetic_min, potential_plus, potential_min, power;
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToEnergy(q, qd, kinetic, potential));
+        dynparam.JntToMass(q, H);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5*qd.data.dot(H.data*qd.data), kinetic, eps);
+
+        // The gravity torques are the gradient of the potential energy
+        dynparam.JntToGravity(q, gravity);
+        for(unsigned int i=0; i<nj; i++)
+        {
+            q_plus = q;
+            q_min = q;
+            q_plus(i) += h;
+            q_min(i) -= h;
+            solver.JntToEnergy(q_plus, zero, kinetic_plus, potential_plus);
+            solver.JntToEnergy(q_min, zero, kinetic_min, potential_min);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(gravity(i), (potential_plus - potential_min)/(2*h), 1e-6);
+        }
+
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToPower(q, qd, qdd, power));
+        rnesolver.CartToJnt(q, qd, qdd, Wrenches(ns, Wrench::Zero()), torques);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(torques.data.dot(qd.data), power, eps);
+
+        std::vector<double> kinetic_segments(ns), potential_segments(ns);
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, solver.JntToSegmentEnergy(q, qd, kinetic_segments, potential_segments));
+        double kinetic_sum = 0.0, potential_sum = 0.0;
+        for(unsigned int i=0; i<ns; i++)
+        {
+            kinetic_sum += kinetic_segments[i];
+            potential_sum += potential_segments[i];
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(kinetic, kinetic_sum, eps);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(potential, potential_sum, eps);
+        kinetic_segments.resize(ns+1);
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToSegmentEnergy(q, qd, kinetic_segments, potential_segments));
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, solver.JntToEnergy(JntArray(nj+1), qd, kinetic, potential));
+    }
+
+    // A tree with a multi-DOF joint and a coupled joint against TreeIdSolver_RNE
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("shoulder", Joint::Spherical), Frame(Vector(0.0,0.2,0.1)),
+                                           RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), "link2"));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("hand", Joint("wrist", Joint::RotX), Frame(Vector(0.3,0.0,0.0)),
+                                           RigidBodyInertia(0.5, Vector(0.05,0.0,0.0), RotationalInertia(0.001,0.002,0.002))), "arm"));
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("finger", Joint("finger_joint", Joint::RotY, 0.5), Frame(Vector(0.1,0.0,0.0)),
+                                                  RigidBodyInertia(0.2, Vector(0.05,0.0,0.0))), "hand",
+                                          GetTreeElementQNr(tree.getSegment("hand")->second)));
+    unsigned int nj = tree.getNrOfJoints();
+    unsigned int ns = tree.getNrOfSegments();
+    TreeEnergySolver treesolver(tree, grav);
+    TreeIdSolver_RNE rnesolver(tree, grav);
+    TreeIdSolver_RNE rnesolver_nograv(tree, Vector::Zero());
+    JntArray q(nj), qd(nj), qdd(nj), zero(nj), unit(nj), torques(nj);
+    JntSpaceInertiaMatrix H(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qd(i));
+        random(qdd(i));
+    }
+    for(unsigned int i=0; i<nj; i++)
+    {
+        SetToZero(unit);
+        unit(i) = 1.0;
+        rnesolver_nograv.CartToJnt(q, zero, unit, WrenchMap(), torques);
+        H.data.col(i) = torques.data;
+    }
+    double kinetic, potential, power;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToEnergy(q, qd, kinetic, potential));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5*qd.data.dot(H.data*qd.data), kinetic, eps);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToPower(q, qd, qdd, power));
+    rnesolver.CartToJnt(q, qd, qdd, WrenchMap(), torques);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(torques.data.dot(qd.data), power, eps);
+
+    // The segments are reported in the order of the segment map
+    std::vector<double> kinetic_segments(ns), potential_segments(ns);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.JntToSegmentEnergy(q, qd, kinetic_segments, potential_segments));
+    TreeFkSolverPos_recursive fksolver(tree);
+    unsigned int k = 0;
+    for(SegmentMap::const_iterator it=tree.getSegments().begin(); it!=tree.getSegments().end(); ++it)
+    {
+        if(it == tree.getRootSegment())
+            continue;
+        Frame frame;
+        fksolver.JntToCart(q, frame, it->first);
+        const RigidBodyInertia& I = GetTreeElementSegment(it->second).getInertia();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(-I.getMass()*dot(grav, frame*I.getCOG()), potential_segments[k++], eps);
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("extra", Joint("extra_joint", Joint::RotZ)), "hand"));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_UP_TO_DATE, treesolver.JntToEnergy(q, qd, kinetic, potential));
+}
+
+void SolverTest::TreeVereshchaginTest()
+{
+    std::cout<<"Tree Vereshchagin Test"<<std::endl;
+    double eps=1e-9;
+    Vector grav(0.0,0.0,-9.81);
+    Twist root_acc(-grav, Vector::Zero());
+
+    // The KUKA LWR as a tree against ChainHdSolver_Vereshchagin
+    unsigned int nj = kukaLWR.getNrOfJoints();
+    unsigned int ns = kukaLWR.getNrOfSegments();
+    Tree lwr("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<ns; i++)
+    {
+        const Segment& segment = kukaLWR.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(lwr.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    JntArray q(nj), qd(nj), qdd(nj), qdd_ref(nj), ff_tau(nj), constraint_tau(nj), constraint_tau_ref(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qd(i));
+        random(ff_tau(i));
+    }
+    Jacobian alpha(4);
+    alpha.setColumn(0, Twist(Vector(1.0,0.0,0.0), Vector::Zero()));
+    alpha.setColumn(1, Twist(Vector(0.0,1.0,0.0), Vector::Zero()));
+    alpha.setColumn(2, Twist(Vector::Zero(), Vector(0.0,0.0,1.0)));
+    alpha.setColumn(3, Twist(Vector(0.0,0.6,0.8), Vector(0.1,0.0,0.0)));
+    JntArray beta(4);
+    beta(0) = -0.5;
+    beta(1) = 0.3;
+    beta(2) = 0.2;
+    beta(3) = 0.0;
+    Wrenches f_ext(ns, Wrench::Zero());
+    f_ext[ns-1] = Wrench(Vector(10.0,15.0,0.0), Vector(0.0,0.0,5.0));
+    WrenchMap f_ext_map;
+    f_ext_map[parent] = f_ext[ns-1];
+
+    ChainHdSolver_Vereshchagin chainsolver(kukaLWR, root_acc, 4);
+    TreeHdSolver_Vereshchagin lwrsolver(lwr, root_acc, std::vector<std::string>(4, parent));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, chainsolver.CartToJnt(q, qd, qdd_ref, alpha, beta, f_ext, ff_tau, constraint_tau_ref));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, lwrsolver.CartToJnt(q, qd, qdd, alpha, beta, f_ext_map, ff_tau, constraint_tau));
+    CPPUNIT_ASSERT(Equal(qdd, qdd_ref, 1e-7));
+    CPPUNIT_ASSERT(Equal(constraint_tau, constraint_tau_ref, 1e-7));
+    JntArray total_tau(nj), total_tau_ref(nj);
+    chainsolver.getTotalTorque(total_tau_ref);
+    lwrsolver.getTotalTorque(total_tau);
+    CPPUNIT_ASSERT(Equal(total_tau, total_tau_ref, 1e-7));
+    std::vector<Twist> x_dotdot_ref(ns+1);
+    chainsolver.getTransformedLinkAcceleration(x_dotdot_ref);
+    Twist x_dotdot;
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, lwrsolver.getLinkAcceleration(parent, x_dotdot));
+    CPPUNIT_ASSERT(Equal(x_dotdot, x_dotdot_ref[ns], 1e-7));
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_OUT_OF_RANGE, lwrsolver.getLinkAcceleration("nothing", x_dotdot));
+
+    // A branched tree with constraints on two leaves and on an
+    // intermediate segment
+    Tree tree("root");
+    parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    const char* arm_names[] = {"arm0", "arm1", "arm2", "arm3"};
+    std::string arm_parent = "link1";
+    for(unsigned int i=0; i<4; i++)
+    {
+        CPPUNIT_ASSERT(tree.addSegment(Segment(arm_names[i], Joint(arm_names[i], i%2 ? Joint::RotY : Joint::RotZ, 1.0, 0.0, 0.05),
+                                               Frame(Rotation::RPY(0.1,0.2,0.3), Vector(0.0,0.2,0.1)),
+                                               RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), arm_parent));
+        arm_parent = arm_names[i];
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("tool", Joint("tool_joint", Joint::Fixed), Frame(Vector(0.0,0.0,0.1)),
+                                           RigidBodyInertia(0.4, Vector(0.0,0.0,0.05))), "arm3"));
+    nj = tree.getNrOfJoints();
+    std::vector<std::string> constraint_segments;
+    constraint_segments.push_back(parent);
+    constraint_segments.push_back(parent);
+    constraint_segments.push_back("tool");
+    constraint_segments.push_back("tool");
+    constraint_segments.push_back("link4");
+    unsigned int nc = constraint_segments.size();
+    Jacobian alpha_tree(nc);
+    alpha_tree.setColumn(0, Twist(Vector(1.0,0.0,0.0), Vector::Zero()));
+    alpha_tree.setColumn(1, Twist(Vector(0.0,0.0,1.0), Vector::Zero()));
+    alpha_tree.setColumn(2, Twist(Vector(0.0,1.0,0.0), Vector::Zero()));
+    alpha_tree.setColumn(3, Twist(Vector::Zero(), Vector(0.0,0.0,1.0)));
+    alpha_tree.setColumn(4, Twist(Vector(0.0,0.0,1.0), Vector::Zero()));
+    JntArray beta_tree(nc);
+    for(unsigned int k=0; k<nc; k++)
+        random(beta_tree(k));
+    WrenchMap f_ext_tree;
+    f_ext_tree["arm1"] = Wrench(Vector(2.0,-1.0,3.0), Vector(0.5,0.0,0.2));
+
+    TreeHdSolver_Vereshchagin treesolver(tree, root_acc, constraint_segments);
+    q.resize(nj);
+    qd.resize(nj);
+    qdd.resize(nj);
+    ff_tau.resize(nj);
+    constraint_tau.resize(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        random(q(i));
+        random(qd(i));
+        random(ff_tau(i));
+    }
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.CartToJnt(q, qd, qdd, alpha_tree, beta_tree, f_ext_tree, ff_tau, constraint_tau));
+    // The constraints are met
+    for(unsigned int k=0; k<nc; k++)
+    {
+        treesolver.getLinkAcceleration(constraint_segments[k], x_dotdot);
+        Twist column = alpha_tree.getColumn(k);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(beta_tree(k), dot(x_dotdot, Wrench(column.vel, column.rot)), 1e-8);
+    }
+    // The motion is that of the feed-forward torques with the constraint
+    // forces -alpha*nu acting as external wrenches on their segments
+    Eigen::VectorXd nu(nc);
+    treesolver.getConstraintForceMagnitude(nu);
+    TreeFkSolverPos_recursive fksolver(tree);
+    WrenchMap f_total;
+    Frame frame;
+    fksolver.JntToCart(q, frame, "arm1");
+    f_total["arm1"] = frame.M.Inverse(f_ext_tree["arm1"]);
+    for(unsigned int k=0; k<nc; k++)
+    {
+        fksolver.JntToCart(q, frame, constraint_segments[k]);
+        Twist column = alpha_tree.getColumn(k);
+        f_total[constraint_segments[k]] -= frame.M.Inverse(Wrench(column.vel, column.rot)*nu(k));
+    }
+    TreeIdSolver_RNE rnesolver(tree, grav);
+    JntArray torques(nj);
+    rnesolver.CartToJnt(q, qd, qdd, f_total, torques);
+    CPPUNIT_ASSERT(Equal(torques, ff_tau, 1e-8));
+
+    // Without constraint forces this is forward dynamics
+    Jacobian alpha_zero(nc);
+    SetToZero(alpha_zero);
+    JntArray qdd_fd(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(qdd_fd(i));
+    rnesolver.CartToJnt(q, qd, qdd_fd, WrenchMap(), torques);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, treesolver.CartToJnt(q, qd, qdd, alpha_zero, beta_tree, WrenchMap(), torques, constraint_tau));
+    CPPUNIT_ASSERT(Equal(qdd, qdd_fd, 1e-8));
+    for(unsigned int i=0; i<nj; i++)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, constraint_tau(i), eps);
+
+    // Unknown constraint segments and coupled joints are refused
+    TreeHdSolver_Vereshchagin unknown(tree, root_acc, std::vector<std::string>(1, "nothing"));
+    Jacobian alpha_one(1);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_OUT_OF_RANGE, unknown.CartToJnt(q, qd, qdd, alpha_one, JntArray(1), WrenchMap(), ff_tau, constraint_tau));
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("finger", Joint("finger_joint", Joint::RotY, 0.5)), "tool",
+                                          GetTreeElementQNr(tree.getSegment("arm3")->second)));
+    treesolver.updateInternalDataStructures();
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOT_IMPLEMENTED, treesolver.CartToJnt(q, qd, qdd, alpha_tree, beta_tree, f_ext_tree, ff_tau, constraint_tau));
+}
+
+void SolverTest::TreeExternalWrenchEstimatorTest()
+{
+    std::cout<<"Tree External Wrench Estimator Test"<<std::endl;
+    Vector grav(0.0,0.0,-9.81);
+
+    // Two arms on a common torso, with a contact at the end of each arm
+    Tree tree("root");
+    std::string parent = "root";
+    for(unsigned int i=0; i<motomansia10dyn.getNrOfSegments(); i++)
+    {
+        const Segment& segment = motomansia10dyn.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    std::string arm_parent = "link1";
+    for(unsigned int i=0; i<6; i++)
+    {
+        std::ostringstream name;
+        name<<"arm"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), Joint(name.str(), i%2 ? Joint::RotY : Joint::RotZ),
+                                               Frame(Rotation::RPY(0.3,-0.2,0.1), Vector(0.0,0.2,0.1)),
+                                               RigidBodyInertia(1.5, Vector(0.1,0.0,0.0), RotationalInertia(0.01,0.02,0.03))), arm_parent));
+        arm_parent = name.str();
+    }
+    unsigned int nj = tree.getNrOfJoints();
+    std::vector<std::string> contacts;
+    contacts.push_back(parent);
+    contacts.push_back(arm_parent);
+
+    std::vector<Wrench> wrenches(2), wrenches_ref(2);
+    wrenches_ref[0] = Wrench(Vector(1.0,-2.0,3.0), Vector(0.1,0.2,-0.3));
+    wrenches_ref[1] = Wrench(Vector(-2.0,0.5,1.0), Vector(0.0,-0.2,0.1));
+    WrenchMap f_ext;
+    f_ext[contacts[0]] = wrenches_ref[0];
+    f_ext[contacts[1]] = wrenches_ref[1];
+
+    // Static robot: the joint torques balance gravity and the contact wrenches
+    JntArray q(nj), qd(nj), qdd(nj), torques(nj), ext_torques(nj);
+    for(unsigned int i=0; i<nj; i++)
+        q(i) = 0.3 + 0.1*i;
+    TreeIdSolver_RNE rnesolver(tree, grav);
+    rnesolver.CartToJnt(q, qd, qdd, f_ext, torques);
+
+    double frequency = 1000.0;
+    TreeExternalWrenchEstimator estimator(tree, grav, contacts, frequency, 100.0, 0.0);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, estimator.setInitialMomentum(q, qd));
+    for(unsigned int k=0; k<500; k++)
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, estimator.JntToExtWrench(q, qd, torques, wrenches));
+    for(unsigned int c=0; c<2; c++)
+        CPPUNIT_ASSERT(Equal(wrenches[c], wrenches_ref[c], 1e-4));
+    // The configuration did not change, so the factorization was reused
+    CPPUNIT_ASSERT_EQUAL(1u, estimator.getNrOfFactorizations());
+
+    // Moving robot: the contact wrenches follow from the motion and the
+    // joint torques, a small tolerance reuses the factorization
+    TreeExternalWrenchEstimator moving(tree, grav, contacts, frequency, 200.0, 0.0);
+    moving.setRefactorizationTolerance(1e-3);
+    JntArray q0 = q;
+    unsigned int steps = 1000;
+    for(unsigned int k=0; k<=steps; k++)
+    {
+        double t = k/frequency;
+        for(unsigned int i=0; i<nj; i++)
+        {
+            q(i) = q0(i) + 0.1*sin(t + i);
+            qd(i) = 0.1*cos(t + i);
+            qdd(i) = -0.1*sin(t + i);
+        }
+        if(k == 0)
+            moving.setInitialMomentum(q, qd);
+        rnesolver.CartToJnt(q, qd, qdd, f_ext, torques);
+        CPPUNIT_ASSERT_EQUAL((int)SolverI::E_NOERROR, moving.JntToExtWrench(q, qd, torques, wrenches));
+    }
+    for(unsigned int c=0; c<2; c++)
+        CPPUNIT_ASSERT(Equal(wrenches[c], wrenches_ref[c], 0.05));
+    CPPUNIT_ASSERT(moving.getNrOfFactorizations() < steps/2);
+    // The external joint torques are those that the contact wrenches
+    // take off the joints
+    JntArray torques_free(nj);
+    rnesolver.CartToJnt(q, qd, qdd, WrenchMap(), torques_free);
+    moving.getEstimatedJntTorque(ext_torques);
+    for(unsigned int i=0; i<nj; i++)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(torques_free(i) - torques(i), ext_torques(i), 0.05);
+
+    // Errors
+    wrenches.resize(1);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_SIZE_MISMATCH, moving.JntToExtWrench(q, qd, torques, wrenches));
+    TreeExternalWrenchEstimator unknown(tree, grav, std::vector<std::string>(1, "nothing"), frequency, 100.0, 0.0);
+    CPPUNIT_ASSERT_EQUAL((int)SolverI::E_OUT_OF_RANGE, unknown.JntToExtWrench(q, qd, torques, wrenches));
+}
+
+void SolverTest::TracingTest()
+{
+    std::cout<<"Tracing Test"<<std::endl;
+    ChainFkSolverPos_recursive fksolver(chain2);
+    ChainIkSolverVel_pinv iksolvervel(chain2);
+    ChainIkSolverPos_NR_JL iksolverpos(chain2,fksolver,iksolvervel);
+    unsigned int nj = chain2.getNrOfJoints();
+    JntArray q(nj), q_init(nj), q_out(nj);
+    for(unsigned int i=0; i<nj; i++)
+        random(q(i));
+    Frame f;
+    fksolver.JntToCart(q, f);
+
+    ClearTrace();
+    iksolverpos.CartToJnt(q_init, f, q_out);
+    std::ostringstream os;
+    WriteChromeTrace(os);
+    std::string trace = os.str();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, trace.find("{\"traceEvents\":["));
+    if(!TracingEnabled())
+    {
+        CPPUNIT_ASSERT(trace.find("\"ph\"") == std::string::npos);
+        return;
+    }
+    // The position solver span contains the spans of its phases
+    CPPUNIT_ASSERT(trace.find("\"ChainIkSolverPos_NR_JL::CartToJnt\"") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("\"ChainFkSolverPos_recursive::JntToCart\"") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("\"ChainIkSolverVel_pinv::CartToJnt\"") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("\"SVD_HH::calculate\"") != std::string::npos);
+
+    // Spans of other threads are exported with their own thread id
+    ClearTrace();
+    std::thread worker([&]() { fksolver.JntToCart(q, f); });
+    worker.join();
+    fksolver.JntToCart(q, f);
+    os.str("");
+    WriteChromeTrace(os);
+    trace = os.str();
+    CPPUNIT_ASSERT(trace.find("ChainIkSolverPos_NR_JL") == std::string::npos);
+    size_t first = trace.find("\"tid\":");
+    CPPUNIT_ASSERT(first != std::string::npos);
+    size_t second = trace.find("\"tid\":", first + 1);
+    CPPUNIT_ASSERT(second != std::string::npos);
+    CPPUNIT_ASSERT(trace.substr(first, trace.find(',', first) - first) != trace.substr(second, trace.find(',', second) - second));
+
+    // A full buffer keeps the most recent spans
+    ClearTrace();
+    for(unsigned int k=0; k<TRACE_BUFFER_SIZE+10; k++)
+        fksolver.JntToCart(q, f);
+    os.str("");
+    WriteChromeTrace(os);
+    trace = os.str();
+    size_t nr_of_spans = 0;
+    for(size_t pos = trace.find("\"ph\""); pos != std::string::npos; pos = trace.find("\"ph\"", pos + 1))
+        nr_of_spans++;
+    CPPUNIT_ASSERT_EQUAL((size_t)TRACE_BUFFER_SIZE, nr_of_spans);
+}
+
+void SolverTest::RecordReplayTest()
+{
+    std::cout<<"Record and Replay Test"<<std::endl;
+    Vector gravity(0.0,0.0,-9.81);
+    const Chain& chain = motomansia10dyn;
+
+    // A tree with two branches, a coupled joint and a fixed segment
+    Tree tree("base");
+    std::string parent = "base";
+    for(unsigned int i=0; i<chain.getNrOfSegments(); i++)
+    {
+        const Segment& segment = chain.getSegment(i);
+        std::ostringstream name;
+        name<<"link"<<i;
+        CPPUNIT_ASSERT(tree.addSegment(Segment(name.str(), segment.getJoint(), segment.getFrameToTip(), segment.getInertia()), parent));
+        parent = name.str();
+    }
+    CPPUNIT_ASSERT(tree.addSegment(Segment("arm", Joint("arm", Joint::RotY), Frame(Vector(0.0,0.0,0.3)),
+                                           RigidBodyInertia(1.0, Vector(0.0,0.0,0.15))), "base"));
+    CPPUNIT_ASSERT(tree.addCoupledSegment(Segment("hand", Joint("hand", Joint::RotX, 0.5), Frame(Vector(0.0,0.0,0.1)),
+                                                  RigidBodyInertia(0.5, Vector(0.0,0.0,0.05))), "arm", 1));
+    CPPUNIT_ASSERT(tree.addSegment(Segment("tool", Joint("tool", Joint::Fixed), Frame(Vector(0.1,0.0,0.0))), "hand"));
+
+    std::stringstream stream;
+    SolverLogWriter writer(stream);
+    ChainFkSolverPos_recursive fksolver(chain);
+    ChainIkSolverVel_pinv iksolvervel(chain);
+    unsigned int nj = chain.getNrOfJoints();
+    JntArray q_min(nj), q_max(nj);
+    for(unsigned int i=0; i<nj; i++)
+    {
+        q_min(i) = -2.0;
+        q_max(i) = 2.0;
+    }
+    ChainIkSolverPos_NR_JL iksolverpos(chain, q_min, q_max, fksolver, iksolvervel, 50, 1e-8);
+    SolverParameters parameters;
+    parameters["q_min"] = q_min;
+    parameters["q_max"] = q_max;
+    parameters["maxiter"] = JntArray(1);
+    parameters["maxiter"](0) = 50;
+    parameters["eps"] = JntArray(1);
+    parameters["eps"](0) = 1e-8;
+    ChainIdSolver_RNE idsolver(chain, gravity);
+    TreeFkSolverPos_recursive treefksolver(tree);
+    TreeIdSolver_RNE treeidsolver(tree, gravity);
+    ChainFkSolverPos_recorded fk(fksolver, chain, writer, "ChainFkSolverPos_recursive");
+    ChainIkSolverVel_recorded ikvel(iksolvervel, chain, writer, "ChainIkSolverVel_pinv");
+    ChainIkSolverPos_recorded ikpos(iksolverpos, chain, writer, "ChainIkSolverPos_NR_JL", parameters);
+    ChainIdSolver_recorded id(idsolver, chain, gravity, writer, "ChainIdSolver_RNE");
+    TreeFkSolverPos_recorded treefk(treefksolver, tree, writer, "TreeFkSolverPos_recursive");
+    TreeIdSolver_recorded treeid(treeidsolver, tree, gravity, writer, "TreeIdSolver_RNE");
+
+    unsigned int ntj = tree.getNrOfJoints();
+    JntArray q(nj), qdot(nj), qdotdot(nj), qdot_out(nj), q_out(nj), q_seed(nj), torques(nj);
+    JntArray tq(ntj), tqdot(ntj), tqdotdot(ntj), ttorques(ntj);
+    Wrenches f_ext(chain.getNrOfSegments(), Wrench(Vector(1.0,2.0,3.0), Vector(0.1,0.2,0.3)));
+    WrenchMap tf_ext;
+    tf_ext["tool"] = Wrench(Vector(0.0,0.0,-5.0), Vector::Zero());
+    Twist t(Vector(0.1,0.0,0.0), Vector(0.0,0.1,0.0));
+    Frame f;
+    const unsigned int steps = 10;
+    for(unsigned int k=0; k<steps; k++)
+    {
+        for(unsigned int i=0; i<nj; i++)
+        {
+            random(q(i));
+            random(qdot(i));
+            random(qdotdot(i));
+            q_out(i) = q(i) + 0.1;
+        }
+        for(unsigned int i=0; i<ntj; i++)
+        {
+            random(tq(i));
+            random(tqdot(i));
+            random(tqdotdot(i));
+        }
+        if(k == 0)
+            q_seed = q_out;
+        fk.JntToCart(q, f, k%2 ? -1 : 3);
+        ikvel.CartToJnt(q, t, qdot_out);
+        // the seed is overwritten by the solution
+        ikpos.CartToJnt(q_out, f, q_out);
+        id.CartToJnt(q, qdot, qdotdot, f_ext, torques);
+        treefk.JntToCart(tq, f, "tool");
+        treeid.CartToJnt(tq, tqdot, tqdotdot, tf_ext, ttorques);
+    }
+    CPPUNIT_ASSERT_EQUAL((unsigned int)6, writer.getNrOfStreams());
+    CPPUNIT_ASSERT_EQUAL((unsigned long)6*steps, writer.getNrOfCalls());
+
+    SolverLog log(stream);
+    CPPUNIT_ASSERT(!log.isTruncated());
+    const std::vector<SolverLogStream>& streams = log.getStreams();
+    const std::vector<SolverCall>& calls = log.getCalls();
+    CPPUNIT_ASSERT_EQUAL((size_t)6, streams.size());
+    CPPUNIT_ASSERT_EQUAL((size_t)6*steps, calls.size());
+    CPPUNIT_ASSERT(streams[2].type == SolverLogStream::CHAIN_IK_POS);
+    CPPUNIT_ASSERT_EQUAL(std::string("ChainIkSolverPos_NR_JL"), streams[2].solver);
+    CPPUNIT_ASSERT(streams[1].parameters.empty());
+    CPPUNIT_ASSERT_EQUAL((size_t)4, streams[2].parameters.size());
+    CPPUNIT_ASSERT(Equal(q_min, streams[2].parameters.find("q_min")->second, 0.0));
+    CPPUNIT_ASSERT(Equal(q_max, streams[2].parameters.find("q_max")->second, 0.0));
+    CPPUNIT_ASSERT_EQUAL(1e-8, streams[2].parameters.find("eps")->second(0));
+    CPPUNIT_ASSERT(streams[5].gravity == gravity);
+    CPPUNIT_ASSERT_EQUAL(nj, streams[0].chain.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL(chain.getNrOfSegments(), streams[0].chain.getNrOfSegments());
+    // The models keep their joint numbering
+    const Tree& tree_log = streams[4].tree;
+    CPPUNIT_ASSERT_EQUAL(ntj, tree_log.getNrOfJoints());
+    CPPUNIT_ASSERT_EQUAL(tree.getNrOfSegments(), tree_log.getNrOfSegments());
+    for(SegmentMap::const_iterator it = tree.getSegments().begin(); it != tree.getSegments().end(); ++it)
+    {
+        SegmentMap::const_iterator it_log = tree_log.getSegment(it->first);
+        CPPUNIT_ASSERT(it_log != tree_log.getSegments().end());
+        CPPUNIT_ASSERT_EQUAL(GetTreeElementQNr(it->second), GetTreeElementQNr(it_log->second));
+    }
+    // The inputs are stored as they were before the call
+    CPPUNIT_ASSERT(Equal(q_seed, calls[2].q, 1e-15));
+
+    // Replaying on the models of the log gives the recorded outputs
+    ChainFkSolverPos_recursive fksolver_log(streams[0].chain);
+    ChainIkSolverVel_pinv iksolvervel_log(streams[1].chain);
+    ChainFkSolverPos_recursive fksolver_log2(streams[2].chain);
+    ChainIkSolverVel_pinv iksolvervel_log2(streams[2].chain);
+    const SolverParameters& parameters_log = streams[2].parameters;
+    ChainIkSolverPos_NR_JL iksolverpos_log(streams[2].chain, parameters_log.find("q_min")->second, parameters_log.find("q_max")->second,
+                                           fksolver_log2, iksolvervel_log2, (unsigned int)parameters_log.find("maxiter")->second(0),
+                                           parameters_log.find("eps")->second(0));
+    ChainIdSolver_RNE idsolver_log(streams[3].chain, streams[3].gravity);
+    TreeFkSolverPos_recursive treefksolver_log(streams[4].tree);
+    TreeIdSolver_RNE treeidsolver_log(streams[5].tree, streams[5].gravity);
+    SolverCall result;
+    for(unsigned int c=0; c<calls.size(); c++)
+    {
+        const SolverCall& call = calls[c];
+        switch(call.stream)
+        {
+        case 0: Replay(call, fksolver_log, result); break;
+        case 1: Replay(call, iksolvervel_log, result); break;
+        case 2: Replay(call, iksolverpos_log, result); break;
+        case 3: Replay(call, idsolver_log, result); break;
+        case 4: Replay(call, treefksolver_log, result); break;
+        case 5: Replay(call, treeidsolver_log, result); break;
+        }
+        CPPUNIT_ASSERT_EQUAL(call.result, result.result);
+        CPPUNIT_ASSERT(Divergence(streams[call.stream].type, call, result) < 1e-12);
+    }
+    result.q_out(0) += 1e-3;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1e-3, Divergence(SolverLogStream::TREE_ID, calls.back(), result), 1e-9);
+
+    // A log that is cut off is read up to its last complete record
+    std::string data = stream.str();
+    std::istringstream cut(data.substr(0, data.size() - 3));
+    SolverLog log_cut(cut);
+    CPPUNIT_ASSERT(log_cut.isTruncated());
+    CPPUNIT_ASSERT_EQUAL((size_t)6*steps - 1, log_cut.getCalls().size());
+
+    std::istringstream garbage("not a solver log");
+    bool thrown = false;
+    try {
+        SolverLog log_bad(garbage);
+    }
+    catch(const Error_BasicIO_Binary&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+}
+
+void SolverTest::CpuDispatchTest()
+{
+    std::cout<<"CpuDispatch Test"<<std::endl;
+    const CpuLevel initial = GetCpuLevel();
+    CPPUNIT_ASSERT(initial <= GetSupportedCpuLevel());
+    if(GetSupportedCpuLevel() < CPU_AVX512)
+        CPPUNIT_ASSERT(!SetCpuLevel(CPU_AVX512));
+
+    const unsigned int n = 37;
+    std::vector<Frame> lhs(n), rhs(n), out(n);
+    std::vector<Vector> in(n), tout(n);
+    Frame f;
+    random(f);
+    for(unsigned int i=0; i<n; i++) {
+        random(lhs[i]);
+        random(rhs[i]);
+        random(in[i]);
+    }
+
+    // Every supported variant equals the operators of frames.hpp
+    for(unsigned int l=CPU_SCALAR; l<=(unsigned int)GetSupportedCpuLevel(); l++) {
+        CPPUNIT_ASSERT(SetCpuLevel((CpuLevel)l));
+        CPPUNIT_ASSERT_EQUAL((int)l, (int)GetCpuLevel());
+        BatchMultiply(&lhs[0], &rhs[0], &out[0], n);
+        BatchTransform(f, &in[0], &tout[0], n);
+        for(unsigned int i=0; i<n; i++) {
+            CPPUNIT_ASSERT(Equal(lhs[i]*rhs[i], out[i], 1e-12));
+            CPPUNIT_ASSERT(Equal(f*in[i], tout[i], 1e-12));
+        }
+        // The output may be one of the inputs
+        out = lhs;
+        BatchMultiply(&out[0], &rhs[0], &out[0], n);
+        tout = in;
+        BatchTransform(f, &tout[0], &tout[0], n);
+        for(unsigned int i=0; i<n; i++) {
+            CPPUNIT_ASSERT(Equal(lhs[i]*rhs[i], out[i], 1e-12));
+            CPPUNIT_ASSERT(Equal(f*in[i], tout[i], 1e-12));
+        }
+    }
+
+    // The check mode runs all variants and returns the result of the selected one
+    CPPUNIT_ASSERT(SetCpuLevel(initial));
+    const bool check = GetCpuDispatchCheck();
+    const unsigned long mismatches = GetNrOfCpuDispatchMismatches();
+    SetCpuDispatchCheck(true);
+    BatchMultiply(&lhs[0], &rhs[0], &out[0], n);
+    BatchTransform(f, &in[0], &tout[0], n);
+    BatchMultiply(&lhs[0], &rhs[0], &out[0], 0);
+    SetCpuDispatchCheck(check);
+    CPPUNIT_ASSERT_EQUAL(mismatches, GetNrOfCpuDispatchMismatches());
+    for(unsigned int i=0; i<n; i++) {
+        CPPUNIT_ASSERT(Equal(lhs[i]*rhs[i], out[i], 1e-12));
+        CPPUNIT_ASSERT(Equal(f*in[i], tout[i], 1e-12));
+    }
+    ReportCpuDispatchMismatch("CpuDispatchTest", initial, 1.0);
+    CPPUNIT_ASSERT_EQUAL(mismatches + 1, GetNrOfCpuDispatchMismatches());
+}
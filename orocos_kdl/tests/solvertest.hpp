@@ -6,6 +6,7 @@
 #include <chain.hpp>
 #include <chainfksolverpos_recursive.hpp>
 #include <chainfksolvervel_recursive.hpp>
+#include <chainfksolverpos_cached.hpp>
 #include <chainiksolvervel_pinv.hpp>
 #include <chainiksolvervel_pinv_givens.hpp>
 #include <chainiksolvervel_pinv_nso.hpp>
@@ -13,7 +14,14 @@
 #include <chainiksolverpos_nr.hpp>
 #include <chainiksolverpos_lma.hpp>
 #include <chainiksolverpos_nr_jl.hpp>
+#include <chainiksolverpos_masked.hpp>
+#include <chainiksolvervel_sns.hpp>
+#include <treedynsolver_floatingbase.hpp>
+#include <chainidsolver_gravity.hpp>
+#include <treeidsolver_gravity.hpp>
 #include <chainjnttojacsolver.hpp>
+#include <chainjnttopointjacsolver.hpp>
+#include <chaincalibrationsolver.hpp>
 #include <chainjnttojacdotsolver.hpp>
 #include <chainhdsolver_vereshchagin.hpp>
 #include <chainidsolver_recursive_newton_euler.hpp>
@@ -21,7 +29,29 @@
 #include <chainidsolver_recursive_newton_euler.hpp>
 #include <chainfdsolver_recursive_newton_euler.hpp>
 #include <chainexternalwrenchestimator.hpp>
+#include <chaincentroidalsolver.hpp>
+#include <chaincoriolissolver.hpp>
+#include <chainmassinversesolver.hpp>
+#include <chainenergysolver.hpp>
+#include <tree.hpp>
+#include <treefksolverpos_recursive.hpp>
+#include <treefksolverpos_cached.hpp>
+#include <treefksolvervel_recursive.hpp>
+#include <treecentroidalsolver.hpp>
+#include <treejnttojacsolver.hpp>
+#include <treejnttopointjacsolver.hpp>
+#include <treeiksolverpos_masked.hpp>
+#include <treeidsolver_recursive_newton_euler.hpp>
+#include <treecoriolissolver.hpp>
+#include <treemassinversesolver.hpp>
+#include <treeenergysolver.hpp>
+#include <treehdsolver_vereshchagin.hpp>
+#include <treeexternalwrenchestimator.hpp>
 #include <utilities/ldl_solver_eigen.hpp>
+#include <tracing.hpp>
+#include <solverrecorder.hpp>
+#include <frames_batch.hpp>
+#include <cpudispatch.hpp>
 
 
 using namespace KDL;
@@ -44,6 +74,27 @@ class SolverTest : public CppUnit::TestFixture
     CPPUNIT_TEST(LDLdecompTest);
     CPPUNIT_TEST(FdAndVereshchaginSolversConsistencyTest );
     CPPUNIT_TEST(UpdateChainTest );
+    CPPUNIT_TEST(CoupledJointsTest );
+    CPPUNIT_TEST(MultiDofJointsTest );
+    CPPUNIT_TEST(JointLockingTest );
+    CPPUNIT_TEST(FkCacheTest );
+    CPPUNIT_TEST(TreeFkVelTest );
+    CPPUNIT_TEST(CentroidalTest );
+    CPPUNIT_TEST(PointJacTest );
+    CPPUNIT_TEST(CalibrationTest );
+    CPPUNIT_TEST(MaskedIkTest );
+    CPPUNIT_TEST(BroydenIkTest );
+    CPPUNIT_TEST(SnsIkVelTest );
+    CPPUNIT_TEST(FloatingBaseDynTest );
+    CPPUNIT_TEST(GravitySolverTest );
+    CPPUNIT_TEST(CoriolisMatrixTest );
+    CPPUNIT_TEST(MassInverseTest );
+    CPPUNIT_TEST(EnergySolverTest );
+    CPPUNIT_TEST(TreeVereshchaginTest );
+    CPPUNIT_TEST(TreeExternalWrenchEstimatorTest );
+    CPPUNIT_TEST(TracingTest );
+    CPPUNIT_TEST(RecordReplayTest );
+    CPPUNIT_TEST(CpuDispatchTest );
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -65,6 +116,27 @@ public:
     void LDLdecompTest();
     void FdAndVereshchaginSolversConsistencyTest();
     void UpdateChainTest();
+    void CoupledJointsTest();
+    void MultiDofJointsTest();
+    void JointLockingTest();
+    void FkCacheTest();
+    void TreeFkVelTest();
+    void CentroidalTest();
+    void PointJacTest();
+    void CalibrationTest();
+    void MaskedIkTest();
+    void BroydenIkTest();
+    void SnsIkVelTest();
+    void FloatingBaseDynTest();
+    void GravitySolverTest();
+    void CoriolisMatrixTest();
+    void MassInverseTest();
+    void EnergySolverTest();
+    void TreeVereshchaginTest();
+    void TreeExternalWrenchEstimatorTest();
+    void TracingTest();
+    void RecordReplayTest();
+    void CpuDispatchTest();
 
 private:
 
@@ -0,0 +1,405 @@
+#include "trajectorytest.hpp"
+#include <frames_io.hpp>
+#include <utilities/error.h>
+#include <path_line.hpp>
+#include <rotational_interpolation_sa.hpp>
+#include <velocityprofile_trap.hpp>
+#include <trajectory_segment.hpp>
+#include <trajectory_composite.hpp>
+#include <trajectory_stationary.hpp>
+#include <path_circle.hpp>
+#include <path_point.hpp>
+#include <path_cyclic_closed.hpp>
+#include <velocityprofile_traphalf.hpp>
+#include <velocityprofile_rect.hpp>
+#include <velocityprofile_dirac.hpp>
+#include <velocityprofile_spline.hpp>
+#include <sstream>
+#include <time.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( TrajectoryTest );
+
+using namespace KDL;
+
+void TrajectoryTest::setUp()
+{
+    srand( (unsigned)time( NULL ));
+}
+
+void TrajectoryTest::tearDown()
+{
+}
+
+void TrajectoryTest::TestPathSpline()
+{
+    std::vector<Frame> frames(6);
+    for (unsigned int i=0;i<frames.size();i++)
+        random(frames[i]);
+    Path_Spline path(frames,0.1);
+    double L = path.PathLength();
+    unsigned int nseg = frames.size()-1;
+    CPPUNIT_ASSERT(L>0);
+    CPPUNIT_ASSERT_EQUAL((int)Path::ID_SPLINE,(int)path.getIdentifier());
+
+    //the path passes through the frames
+    for (unsigned int i=0;i<frames.size();i++)
+        CPPUNIT_ASSERT(Equal(frames[i],path.Pos(L*i/nseg),1e-9));
+
+    //the derivatives match finite differences of the path
+    double h = 1e-6*L;
+    for (unsigned int k=0;k<20;k++) {
+        double s;
+        posrandom(s);
+        s *= L;
+        Twist vel = path.Vel(s,1.0);
+        CPPUNIT_ASSERT(Equal(vel,diff(path.Pos(s-h),path.Pos(s+h),2*h),1e-5));
+        Twist acc = path.Acc(s,1.0,0.0);
+        CPPUNIT_ASSERT(Equal(acc,(path.Vel(s+h,1.0)-path.Vel(s-h,1.0))/(2*h),1e-4));
+        CPPUNIT_ASSERT(Equal(vel,path.Acc(s,0.0,1.0),1e-12));
+        CPPUNIT_ASSERT(Equal(vel*2.0,path.Vel(s,2.0),1e-12));
+    }
+
+    //velocity and acceleration are continuous at the way-points
+    for (unsigned int i=1;i<nseg;i++) {
+        double s = L*i/nseg;
+        CPPUNIT_ASSERT(Equal(path.Vel(s-1e-9,1.0),path.Vel(s+1e-9,1.0),1e-6));
+        CPPUNIT_ASSERT(Equal(path.Acc(s-1e-9,1.0,0.0),path.Acc(s+1e-9,1.0,0.0),1e-6));
+    }
+
+    //the linear arc length up to LengthToS(l) is l
+    double length = 0;
+    double send = path.LengthToS(0.5);
+    unsigned int n = 10000;
+    for (unsigned int k=0;k<n;k++)
+        length += path.Vel((k+0.5)*send/n,1.0).vel.Norm()*send/n;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5,length,1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0,path.LengthToS(0.0),1e-12);
+
+    //a spline through two frames with the same orientation is a line
+    Path_Spline line(std::vector<Frame>{Frame(Vector(0,0,0)),Frame(Vector(1,2,2))},0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0,line.PathLength(),1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5,line.LengthToS(1.5),1e-12);
+    CPPUNIT_ASSERT(Equal(Frame(Vector(0.5,1,1)),line.Pos(1.5),1e-12));
+    CPPUNIT_ASSERT(Equal(Twist::Zero(),line.Acc(1.0,1.0,0.0),1e-12));
+
+    //text round trip and copies
+    std::stringstream ss;
+    path.Write(ss);
+    Path* read = Path::Read(ss);
+    Path* clone = path.Clone();
+    CPPUNIT_ASSERT_EQUAL((int)Path::ID_SPLINE,(int)read->getIdentifier());
+    for (unsigned int k=0;k<10;k++) {
+        double s;
+        posrandom(s);
+        s *= L;
+        CPPUNIT_ASSERT(Equal(path.Pos(s),read->Pos(s*read->PathLength()/L),1e-5));
+        CPPUNIT_ASSERT(Equal(path.Pos(s),clone->Pos(s),1e-12));
+    }
+    delete read;
+    delete clone;
+
+    bool thrown = false;
+    try {
+        Path_Spline single(std::vector<Frame>(1),0.1);
+    } catch (Error_MotionPlanning_Not_Feasible&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+}
+
+void TrajectoryTest::TestTrajectoryStream()
+{
+    //a reference composite of random line segments
+    std::vector<Trajectory*> segments(10);
+    Trajectory_Composite composite;
+    Frame start;
+    random(start);
+    for (unsigned int i=0;i<segments.size();i++) {
+        Frame end;
+        random(end);
+        VelocityProfile_Trap* prof = new VelocityProfile_Trap(0.5,0.2);
+        Path_Line* path = new Path_Line(start,end,new RotationalInterpolation_SingleAxis(),0.1);
+        prof->SetProfile(0,path->PathLength());
+        segments[i] = new Trajectory_Segment(path,prof);
+        composite.Add(segments[i]->Clone());
+        start = end;
+    }
+
+    double starttime = 2.0;
+    Trajectory_Stream stream(4,starttime);
+    CPPUNIT_ASSERT(Equal(Frame::Identity(),stream.Pos(1.0)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(starttime,stream.Duration(),1e-12);
+
+    //fill up to the capacity
+    unsigned int added = 0;
+    while (added<segments.size() && stream.Add(segments[added]))
+        added++;
+    CPPUNIT_ASSERT_EQUAL(4u,added);
+    CPPUNIT_ASSERT_EQUAL(4u,stream.GetNrOfSegments());
+
+    //evaluate, retire and append like a consumer and producer would
+    double dt = 0.01;
+    double t = 0.0;
+    while (t<composite.Duration()+0.5) {
+        CPPUNIT_ASSERT(Equal(composite.Pos(t),stream.Pos(starttime+t),1e-12));
+        CPPUNIT_ASSERT(Equal(composite.Vel(t),stream.Vel(starttime+t),1e-12));
+        CPPUNIT_ASSERT(Equal(composite.Acc(t),stream.Acc(starttime+t),1e-12));
+        stream.Retire(starttime+t);
+        while (added<segments.size() && stream.Add(segments[added]))
+            added++;
+        CPPUNIT_ASSERT(stream.GetNrOfSegments()<=stream.GetCapacity());
+        CPPUNIT_ASSERT(stream.StartTime()<=starttime+t);
+        t += dt;
+    }
+    CPPUNIT_ASSERT_EQUAL((unsigned int)segments.size(),added);
+    CPPUNIT_ASSERT_EQUAL(1u,stream.GetNrOfSegments());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(starttime+composite.Duration(),stream.Duration(),1e-12);
+
+    //evaluating before the retained segments stays at their start
+    double laststart = stream.StartTime();
+    CPPUNIT_ASSERT(Equal(stream.Pos(laststart),stream.Pos(0.0),1e-12));
+
+    //the copy keeps the timing of the retained segments
+    Trajectory* clone = stream.Clone();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(stream.Duration(),clone->Duration(),1e-12);
+    for (double t=laststart;t<stream.Duration();t+=dt)
+        CPPUNIT_ASSERT(Equal(stream.Pos(t),clone->Pos(t),1e-12));
+    delete clone;
+}
+
+void TrajectoryTest::TestPathSimplifier()
+{
+    double pos_tol = 1e-3;
+    double rot_tol = 1e-2;
+    double eqradius = 0.1;
+    PathSimplifier simplifier(pos_tol,rot_tol,eqradius);
+
+    //dense, slightly noisy samples of three lines
+    std::vector<Frame> corners(4);
+    corners[0] = Frame(Rotation::RPY(0.1,0.2,0.3),Vector(0,0,0));
+    corners[1] = Frame(Rotation::RPY(0.5,-0.2,0.3),Vector(1,0,0));
+    corners[2] = Frame(Rotation::RPY(0.5,-0.2,1.3),Vector(1,1,0));
+    corners[3] = Frame(Rotation::RPY(-0.3,0.2,1.0),Vector(1,1,1));
+    unsigned int nsamples = 200;
+    std::vector<Frame> frames;
+    for (unsigned int i=0;i+1<corners.size();i++) {
+        Path_Line line(corners[i],corners[i+1],new RotationalInterpolation_SingleAxis(),eqradius);
+        for (unsigned int k=0;k<nsamples;k++) {
+            Vector noise;
+            random(noise);
+            frames.push_back(line.Pos(line.PathLength()*k/nsamples));
+            frames.back().p += noise*(0.1*pos_tol);
+        }
+    }
+    frames.push_back(corners.back());
+
+    std::vector<unsigned int> indices;
+    simplifier.Simplify(frames,indices);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)corners.size(),(unsigned int)indices.size());
+    for (unsigned int i=0;i<corners.size();i++)
+        CPPUNIT_ASSERT_EQUAL(i*nsamples,indices[i]);
+
+    //samples of a helix stay within the position tolerance of the
+    //reduced polyline
+    frames.clear();
+    for (unsigned int k=0;k<=1000;k++) {
+        double a = 0.01*k;
+        frames.push_back(Frame(Rotation::RotZ(a),Vector(cos(a),sin(a),0.1*a)));
+    }
+    simplifier.Simplify(frames,indices);
+    CPPUNIT_ASSERT(indices.size()>2);
+    CPPUNIT_ASSERT(indices.size()<frames.size()/4);
+    CPPUNIT_ASSERT_EQUAL(0u,indices.front());
+    CPPUNIT_ASSERT_EQUAL((unsigned int)frames.size()-1,indices.back());
+    for (unsigned int i=0;i+1<indices.size();i++) {
+        Vector a = frames[indices[i]].p;
+        Vector d = frames[indices[i+1]].p-a;
+        for (unsigned int k=indices[i];k<=indices[i+1];k++) {
+            double t = std::max(0.0,std::min(1.0,dot(frames[k].p-a,d)/dot(d,d)));
+            CPPUNIT_ASSERT((frames[k].p-a-d*t).Norm()<=pos_tol);
+        }
+    }
+
+    //the errors of a long sequence evaluated by several threads
+    std::vector<Frame> dense;
+    for (unsigned int k=0;k<=20000;k++) {
+        double a = 0.0005*k;
+        dense.push_back(Frame(Rotation::RotZ(a),Vector(cos(a),sin(a),0.1*a)));
+    }
+    PathSimplifier parallel(pos_tol,rot_tol,eqradius,4);
+    std::vector<unsigned int> indices_parallel;
+    simplifier.Simplify(dense,indices);
+    parallel.Simplify(dense,indices_parallel);
+    CPPUNIT_ASSERT(indices.size()>2);
+    CPPUNIT_ASSERT(indices==indices_parallel);
+    bool thrown = false;
+    try {
+        PathSimplifier no_threads(pos_tol,rot_tol,eqradius,0);
+    } catch (Error_MotionPlanning_Not_Feasible&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+    simplifier.Simplify(frames,indices);
+
+    //paths through the kept frames
+    std::vector<Frame> reduced;
+    simplifier.Simplify(frames,reduced);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)indices.size(),(unsigned int)reduced.size());
+    Path_Spline* spline = simplifier.Spline(frames);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)reduced.size(),spline->GetNrOfFrames());
+    CPPUNIT_ASSERT(Equal(frames.back(),spline->Pos(spline->PathLength()),1e-9));
+    delete spline;
+    Path_RoundedComposite* rounded = simplifier.RoundedComposite(frames,0.01,new RotationalInterpolation_SingleAxis());
+    CPPUNIT_ASSERT(Equal(frames.front(),rounded->Pos(0.0),1e-9));
+    CPPUNIT_ASSERT(Equal(frames.back(),rounded->Pos(rounded->PathLength()),1e-9));
+    delete rounded;
+}
+
+void TrajectoryTest::TestBinaryIO()
+{
+    //a composite with every type of path and velocity profile
+    Trajectory_Composite composite;
+    Frame f1, f2, f3;
+    random(f1);
+    random(f2);
+    random(f3);
+
+    Path* path = new Path_Line(f1,f2,new RotationalInterpolation_SingleAxis(),0.1);
+    VelocityProfile* prof = new VelocityProfile_Trap(0.5,0.2);
+    prof->SetProfile(0,path->PathLength());
+    composite.Add(new Trajectory_Segment(path,prof));
+
+    path = new Path_Circle(Frame(f2.M,Vector(1,0,0)),Vector(0,0,0),Vector(0,1,0),f3.M,PI/2,
+                           new RotationalInterpolation_SingleAxis(),0.1);
+    prof = new VelocityProfile_TrapHalf(0.5,0.2,false);
+    prof->SetProfileDuration(0,path->PathLength(),10.0);
+    composite.Add(new Trajectory_Segment(path,prof));
+
+    Path_RoundedComposite* rounded = new Path_RoundedComposite(0.05,0.1,new RotationalInterpolation_SingleAxis());
+    rounded->Add(f1);
+    rounded->Add(Frame(f2.M,f1.p+Vector(1,0,0)));
+    rounded->Add(Frame(f3.M,f1.p+Vector(1,1,0)));
+    rounded->Finish();
+    prof = new VelocityProfile_Rectangular(0.3);
+    prof->SetProfile(0,rounded->PathLength());
+    composite.Add(new Trajectory_Segment(rounded,prof));
+
+    std::vector<Frame> frames(4);
+    for (unsigned int i=0;i<frames.size();i++)
+        random(frames[i]);
+    path = new Path_Spline(frames,0.1);
+    VelocityProfile_Spline* spline = new VelocityProfile_Spline();
+    spline->SetProfileDuration(0,0,0,path->PathLength(),0,0,3.0);
+    composite.Add(new Trajectory_Segment(path,spline));
+
+    path = new Path_Cyclic_Closed(new Path_Line(f3,f1,new RotationalInterpolation_SingleAxis(),0.1),2);
+    prof = new VelocityProfile_Dirac();
+    prof->SetProfileDuration(0,path->PathLength(),1.0);
+    composite.Add(new Trajectory_Segment(path,prof));
+
+    prof = new VelocityProfile_Trap(0.5,0.2);
+    prof->SetProfileDuration(0,0,1.0);
+    composite.Add(new Trajectory_Segment(new Path_Point(f1),prof));
+    composite.Add(new Trajectory_Stationary(0.5,f2));
+
+    //a stream that has retired its first segment
+    Trajectory_Stream stream(3,1.0);
+    stream.Add(composite.Clone());
+    stream.Add(new Trajectory_Stationary(1.0,f3));
+    stream.Retire(1.0+composite.Duration());
+
+    //several trajectories in one stream
+    std::stringstream ss;
+    WriteBinaryHeader(ss);
+    composite.WriteBinary(ss);
+    stream.WriteBinary(ss);
+    std::string data = ss.str();
+
+    CPPUNIT_ASSERT_EQUAL(BINARY_VERSION,ReadBinaryHeader(ss));
+    Trajectory* composite_read = Trajectory::ReadBinary(ss);
+    Trajectory* stream_read = Trajectory::ReadBinary(ss);
+    CPPUNIT_ASSERT(ss.peek()==EOF);
+
+    //the round trip is exact
+    std::stringstream ss2;
+    WriteBinaryHeader(ss2);
+    composite_read->WriteBinary(ss2);
+    stream_read->WriteBinary(ss2);
+    CPPUNIT_ASSERT(data==ss2.str());
+    for (double t=-0.5;t<composite.Duration()+0.5;t+=0.01) {
+        CPPUNIT_ASSERT(Equal(composite.Pos(t),composite_read->Pos(t),1e-15));
+        CPPUNIT_ASSERT(Equal(composite.Vel(t),composite_read->Vel(t),1e-15));
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(stream.Duration(),stream_read->Duration(),1e-15);
+    CPPUNIT_ASSERT(Equal(stream.Pos(stream.Duration()),stream_read->Pos(stream.Duration()),1e-15));
+    delete composite_read;
+    delete stream_read;
+
+    //corrupt and truncated streams
+    std::stringstream bad("KDLX");
+    bool thrown = false;
+    try {
+        ReadBinaryHeader(bad);
+    } catch (Error_BasicIO_Binary&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+    std::stringstream truncated(data.substr(0,data.size()/2));
+    ReadBinaryHeader(truncated);
+    thrown = false;
+    try {
+        delete Trajectory::ReadBinary(truncated);
+    } catch (Error_BasicIO_File&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+
+    //a corrupt count or capacity does not allocate memory for it
+    std::stringstream huge_spline;
+    WriteBinary(huge_spline,(unsigned int)Trajectory::BINARY_SEGMENT);
+    WriteBinary(huge_spline,(unsigned int)Path::ID_SPLINE);
+    WriteBinary(huge_spline,0.1);
+    WriteBinary(huge_spline,0xFFFFFFFFu);
+    thrown = false;
+    try {
+        delete Trajectory::ReadBinary(huge_spline);
+    } catch (Error_BasicIO_File&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+    std::stringstream huge_stream;
+    WriteBinary(huge_stream,(unsigned int)Trajectory::BINARY_STREAM);
+    WriteBinary(huge_stream,0xFFFFFFFFu);
+    WriteBinary(huge_stream,0.0);
+    WriteBinary(huge_stream,0u);
+    thrown = false;
+    try {
+        delete Trajectory::ReadBinary(huge_stream);
+    } catch (Error_BasicIO_Binary&) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT(thrown);
+
+    //the text format of a stream of segments, it does not contain the
+    //state of the velocity profiles
+    Trajectory_Stream segments(4,2.0);
+    path = new Path_Line(Frame(Vector(1,0,0)),Frame(Vector(1,2,0)),new RotationalInterpolation_SingleAxis(),0.1);
+    prof = new VelocityProfile_Trap(0.5,0.2);
+    prof->SetProfile(0,path->PathLength());
+    segments.Add(new Trajectory_Segment(path,prof));
+    path = new Path_Line(Frame(Vector(1,2,0)),Frame(Vector(0,2,1)),new RotationalInterpolation_SingleAxis(),0.1);
+    prof = new VelocityProfile_Trap(0.5,0.2);
+    prof->SetProfile(0,path->PathLength());
+    segments.Add(new Trajectory_Segment(path,prof));
+    std::stringstream text;
+    segments.Write(text);
+    Trajectory* segments_read = Trajectory::Read(text);
+    Trajectory_Stream* stream_text = dynamic_cast<Trajectory_Stream*>(segments_read);
+    CPPUNIT_ASSERT(stream_text != NULL);
+    CPPUNIT_ASSERT_EQUAL(4u,stream_text->GetCapacity());
+    CPPUNIT_ASSERT_EQUAL(2u,stream_text->GetNrOfSegments());
+    CPPUNIT_ASSERT_EQUAL(2.0,stream_text->StartTime());
+    std::stringstream text2;
+    segments_read->Write(text2);
+    CPPUNIT_ASSERT(text.str()==text2.str());
+    delete segments_read;
+}
@@ -0,0 +1,28 @@
+#ifndef TRAJECTORYTEST_HPP
+#define TRAJECTORYTEST_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <path_spline.hpp>
+#include <trajectory_stream.hpp>
+#include <path_simplifier.hpp>
+
+class TrajectoryTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(TrajectoryTest);
+    CPPUNIT_TEST(TestPathSpline);
+    CPPUNIT_TEST(TestTrajectoryStream);
+    CPPUNIT_TEST(TestPathSimplifier);
+    CPPUNIT_TEST(TestBinaryIO);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void TestPathSpline();
+    void TestTrajectoryStream();
+    void TestPathSimplifier();
+    void TestBinaryIO();
+};
+
+#endif
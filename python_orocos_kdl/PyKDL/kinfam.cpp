@@ -66,6 +66,9 @@ void init_kinfam(pybind11::module &m)
         joint_type.value("TransY", Joint::JointType::TransY);
         joint_type.value("TransZ", Joint::JointType::TransZ);
         joint_type.value("Fixed", Joint::JointType::Fixed);
+        joint_type.value("Spherical", Joint::JointType::Spherical);
+        joint_type.value("Planar", Joint::JointType::Planar);
+        joint_type.value("Floating", Joint::JointType::Floating);
         joint_type.export_values();
 
     joint.def(py::init<>());
@@ -82,8 +85,14 @@ void init_kinfam(pybind11::module &m)
               py::arg("origin"), py::arg("axis"), py::arg("type"), py::arg("scale")=1, py::arg("offset")=0,
               py::arg("inertia")=0, py::arg("damping")=0, py::arg("stiffness")=0);
     joint.def(py::init<const Joint&>());
-    joint.def("pose", &Joint::pose, py::arg("q"));
-    joint.def("twist", &Joint::twist, py::arg("q_dot"));
+    joint.def("pose", (Frame (Joint::*)(const double&) const) &Joint::pose, py::arg("q"));
+    joint.def("pose", (Frame (Joint::*)(const JntArray&, unsigned int) const) &Joint::pose, py::arg("q"), py::arg("q_nr"));
+    joint.def("twist", (Twist (Joint::*)(const double&) const) &Joint::twist, py::arg("q_dot"));
+    joint.def("twist", (Twist (Joint::*)(const JntArray&, const JntArray&, unsigned int) const) &Joint::twist,
+              py::arg("q"), py::arg("q_dot"), py::arg("q_nr"));
+    joint.def("unitTwist", &Joint::unitTwist, py::arg("q"), py::arg("q_nr"), py::arg("dof"));
+    joint.def("biasTwist", &Joint::biasTwist, py::arg("q"), py::arg("q_dot"), py::arg("q_nr"));
+    joint.def("getNrOfDofs", &Joint::getNrOfDofs);
     joint.def("JointAxis", &Joint::JointAxis);
     joint.def("JointOrigin", &Joint::JointOrigin);
     joint.def("getName", &Joint::getName);
@@ -155,8 +164,13 @@ void init_kinfam(pybind11::module &m)
                 py::arg_v("I", RigidBodyInertia::Zero(), "RigidBodyInertia.Zero"));
     segment.def(py::init<const Segment&>());
     segment.def("getFrameToTip", &Segment::getFrameToTip);
-    segment.def("pose", &Segment::pose, py::arg("q"));
-    segment.def("twist", &Segment::twist, py::arg("q"), py::arg("q_dot"));
+    segment.def("pose", (Frame (Segment::*)(const double&) const) &Segment::pose, py::arg("q"));
+    segment.def("pose", (Frame (Segment::*)(const JntArray&, unsigned int) const) &Segment::pose, py::arg("q"), py::arg("q_nr"));
+    segment.def("twist", (Twist (Segment::*)(const double&, const double&) const) &Segment::twist, py::arg("q"), py::arg("q_dot"));
+    segment.def("twist", (Twist (Segment::*)(const JntArray&, const JntArray&, unsigned int) const) &Segment::twist,
+                py::arg("q"), py::arg("q_dot"), py::arg("q_nr"));
+    segment.def("unitTwist", &Segment::unitTwist, py::arg("q"), py::arg("q_nr"), py::arg("dof"));
+    segment.def("biasTwist", &Segment::biasTwist, py::arg("q"), py::arg("q_dot"), py::arg("q_nr"));
     segment.def("getName", &Segment::getName);
     segment.def("getJoint", &Segment::getJoint);
     segment.def("getInertia", &Segment::getInertia);
@@ -170,11 +184,23 @@ void init_kinfam(pybind11::module &m)
     chain.def(py::init<>());
     chain.def(py::init<const Chain&>());
     chain.def("addSegment", &Chain::addSegment, py::arg("segment"));
+    chain.def("addCoupledSegment", &Chain::addCoupledSegment, py::arg("segment"), py::arg("q_nr"));
     chain.def("addChain", &Chain::addChain, py::arg("chain"));
     chain.def("getNrOfJoints", &Chain::getNrOfJoints);
+    chain.def("getNrOfMultiDofJoints", &Chain::getNrOfMultiDofJoints);
     chain.def("getNrOfSegments", &Chain::getNrOfSegments);
+    chain.def("getNrOfCoupledJoints", &Chain::getNrOfCoupledJoints);
+    chain.def("getQNr", &Chain::getQNr, py::arg("index"));
     chain.def("getSegment", (Segment& (Chain::*)(unsigned int)) &Chain::getSegment, py::arg("index"));
     chain.def("getSegment", (const Segment& (Chain::*)(unsigned int) const) &Chain::getSegment, py::arg("index"));
+    chain.def("getReducedChain", [](const Chain &chain, const std::vector<bool>& locked_joints, const JntArray& q_locked)
+    {
+        Chain reduced;
+        std::vector<unsigned int> full_q_nrs;
+        if (!chain.getReducedChain(locked_joints, q_locked, reduced, full_q_nrs))
+            throw std::invalid_argument("Invalid locked joints");
+        return py::make_tuple(reduced, full_q_nrs);
+    }, py::arg("locked_joints"), py::arg("q_locked"));
     chain.def("__repr__", [](const Chain &c)
     {
         std::ostringstream oss;
@@ -189,6 +215,7 @@ void init_kinfam(pybind11::module &m)
     py::class_<Tree> tree(m, "Tree");
     tree.def(py::init<const std::string&>(), py::arg("root_name")="root");
     tree.def("addSegment", &Tree::addSegment, py::arg("segment"), py::arg("hook_name"));
+    tree.def("addCoupledSegment", &Tree::addCoupledSegment, py::arg("segment"), py::arg("hook_name"), py::arg("q_nr"));
     tree.def("addChain", &Tree::addChain, py::arg("chain"), py::arg("hook_name"));
     tree.def("addTree", &Tree::addTree, py::arg("tree"), py::arg("hook_name"));
     tree.def("getNrOfJoints", &Tree::getNrOfJoints);
@@ -199,6 +226,14 @@ void init_kinfam(pybind11::module &m)
         tree.getChain(chain_root, chain_tip, *chain);
         return chain;
     }, py::arg("chain_root"), py::arg("chain_tip"));
+    tree.def("getReducedTree", [](const Tree &tree, const std::vector<bool>& locked_joints, const JntArray& q_locked)
+    {
+        Tree reduced;
+        std::vector<unsigned int> full_q_nrs;
+        if (!tree.getReducedTree(locked_joints, q_locked, reduced, full_q_nrs))
+            throw std::invalid_argument("Invalid locked joints");
+        return py::make_tuple(reduced, full_q_nrs);
+    }, py::arg("locked_joints"), py::arg("q_locked"));
     tree.def("__repr__", [](const Tree &t)
     {
         std::ostringstream oss;